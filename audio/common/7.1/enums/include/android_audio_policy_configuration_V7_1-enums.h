@@ -18,11 +18,13 @@
 #define ANDROID_AUDIO_POLICY_CONFIGURATION_V7_1__ENUMS_H
 
 #include <sys/types.h>
-#include <regex>
 #include <string>
+#include <string_view>
 
 #include <android_audio_policy_configuration_V7_1_enums.h>
 
+#include "android_audio_policy_configuration_V7_1-enum_tables.h"
+
 namespace android::audio::policy::configuration::V7_1 {
 
 static inline size_t getChannelCount(AudioChannelMask mask) {
@@ -131,7 +133,7 @@ static inline size_t getChannelCount(AudioChannelMask mask) {
 }
 
 static inline ssize_t getChannelCount(const std::string& mask) {
-    return getChannelCount(stringToAudioChannelMask(mask));
+    return getChannelCount(lookupAudioChannelMask(mask));
 }
 
 static inline bool isOutputDevice(AudioDevice device) {
@@ -216,7 +218,7 @@ static inline bool isOutputDevice(AudioDevice device) {
 }
 
 static inline bool isOutputDevice(const std::string& device) {
-    return isOutputDevice(stringToAudioDevice(device));
+    return isOutputDevice(lookupAudioDevice(device));
 }
 
 static inline bool isTelephonyDevice(AudioDevice device) {
@@ -225,55 +227,66 @@ static inline bool isTelephonyDevice(AudioDevice device) {
 }
 
 static inline bool isTelephonyDevice(const std::string& device) {
-    return isTelephonyDevice(stringToAudioDevice(device));
+    return isTelephonyDevice(lookupAudioDevice(device));
 }
 
-static inline bool maybeVendorExtension(const std::string& s) {
+static inline bool maybeVendorExtension(std::string_view s) {
     // Only checks whether the string starts with the "vendor prefix".
-    static const std::string vendorPrefix = "VX_";
+    constexpr std::string_view vendorPrefix = "VX_";
     return s.size() > vendorPrefix.size() && s.substr(0, vendorPrefix.size()) == vendorPrefix;
 }
 
-static inline bool isVendorExtension(const std::string& s) {
-    // Must be the same as the "vendorExtension" rule from the XSD file.
-    static const std::regex vendorExtension("VX_[A-Z0-9]{3,}_[_A-Z0-9]+");
-    return std::regex_match(s.begin(), s.end(), vendorExtension);
+static inline bool isVendorExtension(std::string_view s) {
+    // Must be the same as the "vendorExtension" rule from the XSD file:
+    // "VX_[A-Z0-9]{3,}_[_A-Z0-9]+". Since the vendor name can't contain '_',
+    // it always ends at the first '_' after the prefix.
+    constexpr std::string_view vendorPrefix = "VX_";
+    if (s.substr(0, vendorPrefix.size()) != vendorPrefix) return false;
+    s.remove_prefix(vendorPrefix.size());
+    const size_t vendorEnd = s.find('_');
+    if (vendorEnd == std::string_view::npos || vendorEnd < 3 || vendorEnd + 1 == s.size()) {
+        return false;
+    }
+    for (char c : s) {
+        if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')) return false;
+    }
+    return true;
 }
 
 static inline bool isUnknownAudioChannelMask(const std::string& mask) {
-    return stringToAudioChannelMask(mask) == AudioChannelMask::UNKNOWN;
+    return lookupAudioChannelMask(mask) == AudioChannelMask::UNKNOWN;
 }
 
 static inline bool isUnknownAudioContentType(const std::string& contentType) {
-    return stringToAudioContentType(contentType) == AudioContentType::UNKNOWN;
+    return lookupAudioContentType(contentType) == AudioContentType::UNKNOWN;
 }
 
 static inline bool isUnknownAudioDevice(const std::string& device) {
-    return stringToAudioDevice(device) == AudioDevice::UNKNOWN && !isVendorExtension(device);
+    return lookupAudioDevice(device) == AudioDevice::UNKNOWN && !isVendorExtension(device);
 }
 
 static inline bool isUnknownAudioFormat(const std::string& format) {
-    return stringToAudioFormat(format) == AudioFormat::UNKNOWN && !isVendorExtension(format);
+    return lookupAudioFormat(format) == AudioFormat::UNKNOWN && !isVendorExtension(format);
 }
 
 static inline bool isUnknownAudioGainMode(const std::string& mode) {
-    return stringToAudioGainMode(mode) == AudioGainMode::UNKNOWN;
+    return lookupAudioGainMode(mode) == AudioGainMode::UNKNOWN;
 }
 
 static inline bool isUnknownAudioInOutFlag(const std::string& flag) {
-    return stringToAudioInOutFlag(flag) == AudioInOutFlag::UNKNOWN;
+    return lookupAudioInOutFlag(flag) == AudioInOutFlag::UNKNOWN;
 }
 
 static inline bool isUnknownAudioSource(const std::string& source) {
-    return stringToAudioSource(source) == AudioSource::UNKNOWN;
+    return lookupAudioSource(source) == AudioSource::UNKNOWN;
 }
 
 static inline bool isUnknownAudioStreamType(const std::string& streamType) {
-    return stringToAudioStreamType(streamType) == AudioStreamType::UNKNOWN;
+    return lookupAudioStreamType(streamType) == AudioStreamType::UNKNOWN;
 }
 
 static inline bool isUnknownAudioUsage(const std::string& usage) {
-    return stringToAudioUsage(usage) == AudioUsage::UNKNOWN;
+    return lookupAudioUsage(usage) == AudioUsage::UNKNOWN;
 }
 
 static inline bool isLinearPcm(AudioFormat format) {
@@ -291,11 +304,11 @@ static inline bool isLinearPcm(AudioFormat format) {
 }
 
 static inline bool isLinearPcm(const std::string& format) {
-    return isLinearPcm(stringToAudioFormat(format));
+    return isLinearPcm(lookupAudioFormat(format));
 }
 
 static inline bool isUnknownAudioEncapsulationType(const std::string& encapsulationType) {
-    return stringToAudioEncapsulationType(encapsulationType) == AudioEncapsulationType::UNKNOWN;
+    return lookupAudioEncapsulationType(encapsulationType) == AudioEncapsulationType::UNKNOWN;
 }
 
 }  // namespace android::audio::policy::configuration::V7_1
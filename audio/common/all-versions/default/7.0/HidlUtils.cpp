@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <algorithm>
+#include <string_view>
 
 #define LOG_TAG "HidlUtils"
 #include <log/log.h>
@@ -43,36 +44,69 @@ using namespace ::android::audio::policy::configuration::CPP_VERSION;
         result = status;                                \
     }
 
+namespace {
+
+std::string_view asStringView(const char* s) {
+    return s != nullptr ? std::string_view(s) : std::string_view();
+}
+
+std::string_view asStringView(const hidl_string& s) {
+    return std::string_view(s.c_str(), s.size());
+}
+
+// Makes 'str' refer to the interned name of 'value', which avoids allocating a copy
+// of it. Returns false for the UNKNOWN value.
+template <typename E>
+bool setToInterned(E value, hidl_string* str) {
+    const xsd::InternedString name = xsd::toInternedString(value);
+    if (name.empty()) return false;
+    str->setToExternal(name.c_str(), name.size());
+    return true;
+}
+
+bool isKnownAudioDevice(std::string_view device) {
+    return xsd::lookupAudioDevice(device) != xsd::AudioDevice::UNKNOWN ||
+           xsd::isVendorExtension(device);
+}
+
+bool isKnownAudioFormat(std::string_view format) {
+    return xsd::lookupAudioFormat(format) != xsd::AudioFormat::UNKNOWN ||
+           xsd::isVendorExtension(format);
+}
+
+}  // namespace
+
 status_t HidlUtils::audioIndexChannelMaskFromHal(audio_channel_mask_t halChannelMask,
                                                  AudioChannelMask* channelMask) {
-    *channelMask = audio_channel_index_mask_to_string(halChannelMask);
-    if (!channelMask->empty() && !xsd::isUnknownAudioChannelMask(*channelMask)) {
+    const std::string_view halName =
+            asStringView(audio_channel_index_mask_to_string(halChannelMask));
+    if (setToInterned(xsd::lookupAudioChannelMask(halName), channelMask)) {
         return NO_ERROR;
     }
     ALOGE("Unknown index channel mask value 0x%X", halChannelMask);
-    *channelMask = toString(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE);
+    setToInterned(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE, channelMask);
     return BAD_VALUE;
 }
 
 status_t HidlUtils::audioInputChannelMaskFromHal(audio_channel_mask_t halChannelMask,
                                                  AudioChannelMask* channelMask) {
-    *channelMask = audio_channel_in_mask_to_string(halChannelMask);
-    if (!channelMask->empty() && !xsd::isUnknownAudioChannelMask(*channelMask)) {
+    const std::string_view halName = asStringView(audio_channel_in_mask_to_string(halChannelMask));
+    if (setToInterned(xsd::lookupAudioChannelMask(halName), channelMask)) {
         return NO_ERROR;
     }
     ALOGE("Unknown input channel mask value 0x%X", halChannelMask);
-    *channelMask = toString(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE);
+    setToInterned(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE, channelMask);
     return BAD_VALUE;
 }
 
 status_t HidlUtils::audioOutputChannelMaskFromHal(audio_channel_mask_t halChannelMask,
                                                   AudioChannelMask* channelMask) {
-    *channelMask = audio_channel_out_mask_to_string(halChannelMask);
-    if (!channelMask->empty() && !xsd::isUnknownAudioChannelMask(*channelMask)) {
+    const std::string_view halName = asStringView(audio_channel_out_mask_to_string(halChannelMask));
+    if (setToInterned(xsd::lookupAudioChannelMask(halName), channelMask)) {
         return NO_ERROR;
     }
     ALOGE("Unknown output channel mask value 0x%X", halChannelMask);
-    *channelMask = toString(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE);
+    setToInterned(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE, channelMask);
     return BAD_VALUE;
 }
 
@@ -90,10 +124,10 @@ status_t HidlUtils::audioChannelMaskFromHal(audio_channel_mask_t halChannelMask,
                     // no default
             }
         }
-        *channelMask = toString(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE);
+        setToInterned(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE, channelMask);
         return BAD_VALUE;
     }
-    *channelMask = toString(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE);
+    setToInterned(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE, channelMask);
     return NO_ERROR;
 }
 
@@ -103,8 +137,9 @@ status_t HidlUtils::audioChannelMasksFromHal(const std::vector<std::string>& hal
     tempChannelMasks.resize(halChannelMasks.size());
     size_t tempPos = 0;
     for (const auto& halChannelMask : halChannelMasks) {
-        if (!halChannelMask.empty() && !xsd::isUnknownAudioChannelMask(halChannelMask)) {
-            tempChannelMasks[tempPos++] = halChannelMask;
+        if (setToInterned(xsd::lookupAudioChannelMask(halChannelMask),
+                          &tempChannelMasks[tempPos])) {
+            ++tempPos;
         }
     }
     if (tempPos == tempChannelMasks.size()) {
@@ -118,7 +153,8 @@ status_t HidlUtils::audioChannelMasksFromHal(const std::vector<std::string>& hal
 
 status_t HidlUtils::audioChannelMaskToHal(const AudioChannelMask& channelMask,
                                           audio_channel_mask_t* halChannelMask) {
-    if (!xsd::isUnknownAudioChannelMask(channelMask) &&
+    if (xsd::lookupAudioChannelMask(asStringView(channelMask)) !=
+                xsd::AudioChannelMask::UNKNOWN &&
         audio_channel_mask_from_string(channelMask.c_str(), halChannelMask)) {
         return NO_ERROR;
     }
@@ -203,18 +239,20 @@ status_t HidlUtils::audioConfigBaseOptionalToHal(const AudioConfigBaseOptional&
 
 status_t HidlUtils::audioContentTypeFromHal(const audio_content_type_t halContentType,
                                             AudioContentType* contentType) {
-    *contentType = audio_content_type_to_string(halContentType);
-    if (!contentType->empty() && !xsd::isUnknownAudioContentType(*contentType)) {
+    if (setToInterned(xsd::lookupAudioContentType(
+                              asStringView(audio_content_type_to_string(halContentType))),
+                      contentType)) {
         return NO_ERROR;
     }
     ALOGE("Unknown audio content type value 0x%X", halContentType);
-    *contentType = toString(xsd::AudioContentType::AUDIO_CONTENT_TYPE_UNKNOWN);
+    setToInterned(xsd::AudioContentType::AUDIO_CONTENT_TYPE_UNKNOWN, contentType);
     return BAD_VALUE;
 }
 
 status_t HidlUtils::audioContentTypeToHal(const AudioContentType& contentType,
                                           audio_content_type_t* halContentType) {
-    if (!xsd::isUnknownAudioContentType(contentType) &&
+    if (xsd::lookupAudioContentType(asStringView(contentType)) !=
+                xsd::AudioContentType::UNKNOWN &&
         audio_content_type_from_string(contentType.c_str(), halContentType)) {
         return NO_ERROR;
     }
@@ -224,17 +262,22 @@ status_t HidlUtils::audioContentTypeToHal(const AudioContentType& contentType,
 }
 
 status_t HidlUtils::audioDeviceTypeFromHal(audio_devices_t halDevice, AudioDevice* device) {
-    *device = audio_device_to_string(halDevice);
-    if (!device->empty() && !xsd::isUnknownAudioDevice(*device)) {
+    const std::string_view halName = asStringView(audio_device_to_string(halDevice));
+    if (setToInterned(xsd::lookupAudioDevice(halName), device)) {
+        return NO_ERROR;
+    }
+    if (xsd::isVendorExtension(halName)) {
+        *device = std::string(halName);
         return NO_ERROR;
     }
     ALOGE("Unknown audio device value 0x%X", halDevice);
-    *device = toString(xsd::AudioDevice::AUDIO_DEVICE_NONE);
+    setToInterned(xsd::AudioDevice::AUDIO_DEVICE_NONE, device);
     return BAD_VALUE;
 }
 
 status_t HidlUtils::audioDeviceTypeToHal(const AudioDevice& device, audio_devices_t* halDevice) {
-    if (!xsd::isUnknownAudioDevice(device) && audio_device_from_string(device.c_str(), halDevice)) {
+    if (isKnownAudioDevice(asStringView(device)) &&
+        audio_device_from_string(device.c_str(), halDevice)) {
         return NO_ERROR;
     }
     ALOGE("Unknown audio device \"%s\"", device.c_str());
@@ -243,8 +286,12 @@ status_t HidlUtils::audioDeviceTypeToHal(const AudioDevice& device, audio_device
 }
 
 status_t HidlUtils::audioFormatFromHal(audio_format_t halFormat, AudioFormat* format) {
-    *format = audio_format_to_string(halFormat);
-    if (!format->empty() && !xsd::isUnknownAudioFormat(*format)) {
+    const std::string_view halName = asStringView(audio_format_to_string(halFormat));
+    if (setToInterned(xsd::lookupAudioFormat(halName), format)) {
+        return NO_ERROR;
+    }
+    *format = std::string(halName);
+    if (xsd::isVendorExtension(halName)) {
         return NO_ERROR;
     }
     ALOGE("Unknown audio format value 0x%X", halFormat);
@@ -257,7 +304,9 @@ status_t HidlUtils::audioFormatsFromHal(const std::vector<std::string>& halForma
     tempFormats.resize(halFormats.size());
     size_t tempPos = 0;
     for (const auto& halFormat : halFormats) {
-        if (!halFormat.empty() && !xsd::isUnknownAudioFormat(halFormat)) {
+        if (setToInterned(xsd::lookupAudioFormat(halFormat), &tempFormats[tempPos])) {
+            ++tempPos;
+        } else if (xsd::isVendorExtension(halFormat)) {
             tempFormats[tempPos++] = halFormat;
         }
     }
@@ -270,7 +319,8 @@ status_t HidlUtils::audioFormatsFromHal(const std::vector<std::string>& halForma
 }
 
 status_t HidlUtils::audioFormatToHal(const AudioFormat& format, audio_format_t* halFormat) {
-    if (!xsd::isUnknownAudioFormat(format) && audio_format_from_string(format.c_str(), halFormat)) {
+    if (isKnownAudioFormat(asStringView(format)) &&
+        audio_format_from_string(format.c_str(), halFormat)) {
         return NO_ERROR;
     }
     ALOGE("Unknown audio format \"%s\"", format.c_str());
@@ -281,13 +331,16 @@ status_t HidlUtils::audioFormatToHal(const AudioFormat& format, audio_format_t*
 status_t HidlUtils::audioGainModeMaskFromHal(audio_gain_mode_t halGainModeMask,
                                              hidl_vec<AudioGainMode>* gainModeMask) {
     status_t status = NO_ERROR;
-    std::vector<AudioGainMode> result;
+    hidl_vec<AudioGainMode> result;
+    result.resize(__builtin_popcount(halGainModeMask));
+    size_t resultPos = 0;
     for (uint32_t bit = 0; halGainModeMask != 0 && bit < sizeof(audio_gain_mode_t) * 8; ++bit) {
         audio_gain_mode_t flag = static_cast<audio_gain_mode_t>(1u << bit);
         if ((flag & halGainModeMask) == flag) {
-            AudioGainMode flagStr = audio_gain_mode_to_string(flag);
-            if (!flagStr.empty() && !xsd::isUnknownAudioGainMode(flagStr)) {
-                result.push_back(flagStr);
+            if (setToInterned(xsd::lookupAudioGainMode(
+                                      asStringView(audio_gain_mode_to_string(flag))),
+                              &result[resultPos])) {
+                ++resultPos;
             } else {
                 ALOGE("Unknown audio gain mode value 0x%X", flag);
                 status = BAD_VALUE;
@@ -295,7 +348,10 @@ status_t HidlUtils::audioGainModeMaskFromHal(audio_gain_mode_t halGainModeMask,
             halGainModeMask = static_cast<audio_gain_mode_t>(halGainModeMask & ~flag);
         }
     }
-    *gainModeMask = result;
+    if (resultPos != result.size()) {
+        result.resize(resultPos);
+    }
+    *gainModeMask = std::move(result);
     return status;
 }
 
@@ -305,7 +361,7 @@ status_t HidlUtils::audioGainModeMaskToHal(const hidl_vec<AudioGainMode>& gainMo
     *halGainModeMask = {};
     for (const auto& gainMode : gainModeMask) {
         audio_gain_mode_t halGainMode;
-        if (!xsd::isUnknownAudioGainMode(gainMode) &&
+        if (xsd::lookupAudioGainMode(asStringView(gainMode)) != xsd::AudioGainMode::UNKNOWN &&
             audio_gain_mode_from_string(gainMode.c_str(), &halGainMode)) {
             *halGainModeMask = static_cast<audio_gain_mode_t>(*halGainModeMask | halGainMode);
         } else {
@@ -317,17 +373,18 @@ status_t HidlUtils::audioGainModeMaskToHal(const hidl_vec<AudioGainMode>& gainMo
 }
 
 status_t HidlUtils::audioSourceFromHal(audio_source_t halSource, AudioSource* source) {
-    *source = audio_source_to_string(halSource);
-    if (!source->empty() && !xsd::isUnknownAudioSource(*source)) {
+    if (setToInterned(xsd::lookupAudioSource(asStringView(audio_source_to_string(halSource))),
+                      source)) {
         return NO_ERROR;
     }
     ALOGE("Unknown audio source value 0x%X", halSource);
-    *source = toString(xsd::AudioSource::AUDIO_SOURCE_DEFAULT);
+    setToInterned(xsd::AudioSource::AUDIO_SOURCE_DEFAULT, source);
     return BAD_VALUE;
 }
 
 status_t HidlUtils::audioSourceToHal(const AudioSource& source, audio_source_t* halSource) {
-    if (!xsd::isUnknownAudioSource(source) && audio_source_from_string(source.c_str(), halSource)) {
+    if (xsd::lookupAudioSource(asStringView(source)) != xsd::AudioSource::UNKNOWN &&
+        audio_source_from_string(source.c_str(), halSource)) {
         return NO_ERROR;
     }
     ALOGE("Unknown audio source \"%s\"", source.c_str());
@@ -339,10 +396,11 @@ status_t HidlUtils::audioSourceToHal(const AudioSource& source, audio_source_t*
 status_t HidlUtils::audioStreamTypeFromHal(audio_stream_type_t halStreamType,
                                            AudioStreamType* streamType) {
     if (halStreamType != AUDIO_STREAM_DEFAULT) {
-        *streamType = audio_stream_type_to_string(halStreamType);
-        if (!streamType->empty() && !xsd::isUnknownAudioStreamType(*streamType)) {
+        const std::string_view halName = asStringView(audio_stream_type_to_string(halStreamType));
+        if (setToInterned(xsd::lookupAudioStreamType(halName), streamType)) {
             return NO_ERROR;
         }
+        *streamType = std::string(halName);
         ALOGE("Unknown audio stream type value 0x%X", halStreamType);
         return BAD_VALUE;
     } else {
@@ -354,7 +412,8 @@ status_t HidlUtils::audioStreamTypeFromHal(audio_stream_type_t halStreamType,
 status_t HidlUtils::audioStreamTypeToHal(const AudioStreamType& streamType,
                                          audio_stream_type_t* halStreamType) {
     if (!streamType.empty()) {
-        if (!xsd::isUnknownAudioStreamType(streamType) &&
+        if (xsd::lookupAudioStreamType(asStringView(streamType)) !=
+                    xsd::AudioStreamType::UNKNOWN &&
             audio_stream_type_from_string(streamType.c_str(), halStreamType)) {
             return NO_ERROR;
         }
@@ -493,17 +552,18 @@ status_t HidlUtils::audioUsageFromHal(audio_usage_t halUsage, AudioUsage* usage)
 #endif
         halUsage = AUDIO_USAGE_NOTIFICATION;
     }
-    *usage = audio_usage_to_string(halUsage);
-    if (!usage->empty() && !xsd::isUnknownAudioUsage(*usage)) {
+    if (setToInterned(xsd::lookupAudioUsage(asStringView(audio_usage_to_string(halUsage))),
+                      usage)) {
         return NO_ERROR;
     }
     ALOGE("Unknown audio usage %d", halUsage);
-    *usage = toString(xsd::AudioUsage::AUDIO_USAGE_UNKNOWN);
+    setToInterned(xsd::AudioUsage::AUDIO_USAGE_UNKNOWN, usage);
     return BAD_VALUE;
 }
 
 status_t HidlUtils::audioUsageToHal(const AudioUsage& usage, audio_usage_t* halUsage) {
-    if (!xsd::isUnknownAudioUsage(usage) && audio_usage_from_string(usage.c_str(), halUsage)) {
+    if (xsd::lookupAudioUsage(asStringView(usage)) != xsd::AudioUsage::UNKNOWN &&
+        audio_usage_from_string(usage.c_str(), halUsage)) {
         return NO_ERROR;
     }
     ALOGE("Unknown audio usage \"%s\"", usage.c_str());
@@ -686,8 +746,10 @@ status_t HidlUtils::audioPortExtendedInfoToHal(const AudioPortExtendedInfo& ext,
             *type = AUDIO_PORT_TYPE_NONE;
             break;
         case AudioPortExtendedInfo::hidl_discriminator::device:
-            *role = xsd::isOutputDevice(ext.device().deviceType) ? AUDIO_PORT_ROLE_SINK
-                                                                 : AUDIO_PORT_ROLE_SOURCE;
+            *role = xsd::isOutputDevice(
+                            xsd::lookupAudioDevice(asStringView(ext.device().deviceType)))
+                            ? AUDIO_PORT_ROLE_SINK
+                            : AUDIO_PORT_ROLE_SOURCE;
             *type = AUDIO_PORT_TYPE_DEVICE;
             CONVERT_CHECKED(deviceAddressToHal(ext.device(), &device->type, device->address),
                             result);
@@ -721,17 +783,20 @@ status_t HidlUtils::audioPortExtendedInfoToHal(const AudioPortExtendedInfo& ext,
 
 status_t HidlUtils::encapsulationTypeFromHal(audio_encapsulation_type_t halEncapsulationType,
                                              AudioEncapsulationType* encapsulationType) {
-    *encapsulationType = audio_encapsulation_type_to_string(halEncapsulationType);
-    if (!encapsulationType->empty() && !xsd::isUnknownAudioEncapsulationType(*encapsulationType)) {
+    const std::string_view halName =
+            asStringView(audio_encapsulation_type_to_string(halEncapsulationType));
+    if (setToInterned(xsd::lookupAudioEncapsulationType(halName), encapsulationType)) {
         return NO_ERROR;
     }
+    *encapsulationType = std::string(halName);
     ALOGE("Unknown audio encapsulation type value 0x%X", halEncapsulationType);
     return BAD_VALUE;
 }
 
 status_t HidlUtils::encapsulationTypeToHal(const AudioEncapsulationType& encapsulationType,
                                            audio_encapsulation_type_t* halEncapsulationType) {
-    if (!xsd::isUnknownAudioEncapsulationType(encapsulationType) &&
+    if (xsd::lookupAudioEncapsulationType(asStringView(encapsulationType)) !=
+                xsd::AudioEncapsulationType::UNKNOWN &&
         audio_encapsulation_type_from_string(encapsulationType.c_str(), halEncapsulationType)) {
         return NO_ERROR;
     }
@@ -1017,7 +1082,8 @@ status_t HidlUtils::audioTagsToHal(const hidl_vec<AudioTag>& tags, char* halTags
         if (hasValue) {
             halTagsBuffer << sAudioTagSeparator;
         }
-        if (xsd::isVendorExtension(tag) && strchr(tag.c_str(), sAudioTagSeparator) == nullptr) {
+        if (xsd::isVendorExtension(asStringView(tag)) &&
+            strchr(tag.c_str(), sAudioTagSeparator) == nullptr) {
             halTagsBuffer << tag;
             hasValue = true;
         } else {
@@ -1037,7 +1103,7 @@ hidl_vec<AudioTag> HidlUtils::filterOutNonVendorTags(const hidl_vec<AudioTag>& t
     result.resize(tags.size());
     size_t resultIdx = 0;
     for (const auto& tag : tags) {
-        if (xsd::maybeVendorExtension(tag)) {
+        if (xsd::maybeVendorExtension(asStringView(tag))) {
             result[resultIdx++] = tag;
         }
     }
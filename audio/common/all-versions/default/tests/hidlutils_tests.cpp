@@ -16,6 +16,7 @@
 
 #include <array>
 #include <string>
+#include <string_view>
 
 #include <gtest/gtest.h>
 
@@ -448,6 +449,31 @@ TEST(HidlUtils, VendorExtension) {
     EXPECT_FALSE(xsd::isVendorExtension("VX_$CM_SPK"));
 }
 
+template <typename E>
+static void checkEnumTable(E (*lookup)(std::string_view)) {
+    for (const auto enumVal : xsdc_enum_range<E>{}) {
+        const std::string name = toString(enumVal);
+        EXPECT_EQ(enumVal, lookup(name)) << name;
+        EXPECT_EQ(name, xsd::toInternedString(enumVal).view());
+        EXPECT_EQ(E::UNKNOWN, lookup(name + "$")) << name;
+    }
+    EXPECT_EQ(E::UNKNOWN, lookup(""));
+    EXPECT_TRUE(xsd::toInternedString(E::UNKNOWN).empty());
+}
+
+TEST(HidlUtils, EnumTablesMatchXsd) {
+    checkEnumTable(xsd::lookupAudioChannelMask);
+    checkEnumTable(xsd::lookupAudioContentType);
+    checkEnumTable(xsd::lookupAudioDevice);
+    checkEnumTable(xsd::lookupAudioEncapsulationType);
+    checkEnumTable(xsd::lookupAudioFormat);
+    checkEnumTable(xsd::lookupAudioGainMode);
+    checkEnumTable(xsd::lookupAudioInOutFlag);
+    checkEnumTable(xsd::lookupAudioSource);
+    checkEnumTable(xsd::lookupAudioStreamType);
+    checkEnumTable(xsd::lookupAudioUsage);
+}
+
 TEST(HidlUtils, ConvertInvalidDeviceAddress) {
     DeviceAddress invalid;
     EXPECT_EQ(BAD_VALUE, HidlUtils::deviceAddressFromHal(AUDIO_DEVICE_OUT_BLUETOOTH_A2DP_SPEAKER,
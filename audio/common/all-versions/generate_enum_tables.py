@@ -0,0 +1,339 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2022 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates perfect hash tables for the audio policy configuration XSD enums.
+
+The xsdc-generated 'stringToX' functions look names up in a std::map of
+std::string, and 'toString' returns a freshly allocated std::string. The HIDL
+conversion utilities call them for every channel mask, format, device, usage,
+etc. they convert. This script produces a header with constexpr perfect
+hash tables for the same enums, so that a name lookup is one hash of the input
+plus one string comparison, and the name of a value is a static string.
+
+Since the XSD of a released HAL version is frozen, the output is checked in:
+
+  audio/common/all-versions/generate_enum_tables.py 7.0
+  audio/common/all-versions/generate_enum_tables.py 7.1
+
+The generated header verifies the tables with static_asserts, and every entry
+refers to the xsdc enumerator by name, so any mismatch fails the build.
+"""
+
+import argparse
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+AUDIO_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..'))
+XS = '{http://www.w3.org/2001/XMLSchema}'
+
+# XSD simple types which are converted by the HIDL utilities. Other XSD enums
+# are only used when parsing the configuration file.
+ENUM_TYPES = [
+    'audioChannelMask',
+    'audioContentType',
+    'audioDevice',
+    'audioEncapsulationType',
+    'audioFormat',
+    'audioGainMode',
+    'audioInOutFlag',
+    'audioSource',
+    'audioStreamType',
+    'audioUsage',
+]
+
+FNV_OFFSET = 0x811c9dc5
+FNV_PRIME = 0x01000193
+GOLDEN = 0x9e3779b9
+MASK32 = 0xffffffff
+MAX_LINE = 100
+
+
+def hash_name(name):
+    h = FNV_OFFSET
+    for c in name.encode('ascii'):
+        h = ((h ^ c) * FNV_PRIME) & MASK32
+    return h
+
+
+def mix(h):
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & MASK32
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & MASK32
+    h ^= h >> 16
+    return h
+
+
+def slot_of(h, displacement, slot_count):
+    return mix((h + displacement * GOLDEN) & MASK32) & (slot_count - 1)
+
+
+def next_pow2(n):
+    p = 1
+    while p < n:
+        p *= 2
+    return p
+
+
+def build_table(names):
+    """Hash-and-displace: names are spread over buckets by their hash, then each
+    bucket gets a displacement that moves all its names into free slots."""
+    hashes = {name: hash_name(name) for name in names}
+    if len(set(hashes.values())) != len(names):
+        sys.exit('Hash collision between names, change hash_name()')
+    slot_count = next_pow2(len(names) + len(names) // 4)
+    bucket_count = next_pow2(max(1, len(names) // 4))
+    buckets = [[] for _ in range(bucket_count)]
+    for name in names:
+        buckets[hashes[name] & (bucket_count - 1)].append(name)
+    displacements = [0] * bucket_count
+    slots = [None] * slot_count
+    for b in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        if not buckets[b]:
+            continue
+        for d in range(1 << 16):
+            wanted = [slot_of(hashes[name], d, slot_count) for name in buckets[b]]
+            if len(set(wanted)) == len(wanted) and all(slots[s] is None for s in wanted):
+                break
+        else:
+            sys.exit('No displacement found for bucket %d' % b)
+        displacements[b] = d
+        for name, s in zip(buckets[b], wanted):
+            slots[s] = name
+    return displacements, slots
+
+
+def read_enums(xsd_path):
+    root = ET.parse(xsd_path).getroot()
+    enums = {}
+    for simple_type in root.iter(XS + 'simpleType'):
+        name = simple_type.get('name')
+        if name not in ENUM_TYPES:
+            continue
+        restriction = simple_type.find(XS + 'restriction')
+        values = [e.get('value') for e in restriction.findall(XS + 'enumeration')]
+        for value in values:
+            if not re.fullmatch(r'[A-Z_][A-Z0-9_]*', value):
+                sys.exit('"%s" of %s is not a valid C++ identifier' % (value, name))
+        enums[name] = values
+    missing = set(ENUM_TYPES) - set(enums)
+    if missing:
+        sys.exit('Types not found in %s: %s' % (xsd_path, ', '.join(sorted(missing))))
+    return enums
+
+
+def wrap_list(items, indent):
+    lines = []
+    line = ' ' * indent
+    for item in items:
+        if len(line) + len(item) + 2 > MAX_LINE:
+            lines.append(line.rstrip())
+            line = ' ' * indent
+        line += item + ', '
+    lines.append(line.rstrip())
+    return lines
+
+
+def emit_enum(out, xsd_name, names):
+    type_name = xsd_name[0].upper() + xsd_name[1:]
+    displacements, slots = build_table(names)
+    out.append('// %s' % type_name)
+    out.append('')
+    out.append('namespace enum_tables {')
+    out.append('')
+    out.append('constexpr Table<%s, %d, %d> k%sTable = {' %
+               (type_name, len(displacements), len(slots), type_name))
+    out.append('        {{')
+    out.extend(wrap_list([str(d) for d in displacements], 16))
+    out.append('        }},')
+    out.append('        {{')
+    for name in slots:
+        if name is None:
+            out.append('                {},')
+            continue
+        line = '                {"%s", %s::%s},' % (name, type_name, name)
+        if len(line) <= MAX_LINE:
+            out.append(line)
+        else:
+            out.append('                {"%s",' % name)
+            out.append('                 %s::%s},' % (type_name, name))
+    out.append('        }}};')
+    out.append('static_assert(isPerfect(k%sTable));' % type_name)
+    out.append('')
+    out.append('}  // namespace enum_tables')
+    out.append('')
+    out.append('// Returns %s::UNKNOWN if the name is not defined by the XSD.' % type_name)
+    out.append('constexpr %s lookup%s(std::string_view name) {' % (type_name, type_name))
+    out.append('    return enum_tables::find(enum_tables::k%sTable, name);' % type_name)
+    out.append('}')
+    out.append('')
+    out.append('// Returns an empty string for %s::UNKNOWN.' % type_name)
+    out.append('constexpr InternedString toInternedString(%s value) {' % type_name)
+    out.append('    switch (value) {')
+    for name in names:
+        out.append('        case %s::%s:' % (type_name, name))
+        out.append('            return "%s";' % name)
+    out.append('        case %s::UNKNOWN:' % type_name)
+    out.append('            break;')
+    out.append('    }')
+    out.append('    return {};')
+    out.append('}')
+    out.append('')
+
+
+HEADER = '''/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// This file is generated by audio/common/all-versions/generate_enum_tables.py
+// from audio/{version}/config/audio_policy_configuration.xsd. DO NOT EDIT.
+
+#ifndef {guard}
+#define {guard}
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <string>
+#include <string_view>
+
+#include <android_audio_policy_configuration_{vid}_enums.h>
+
+namespace android::audio::policy::configuration::{vid} {{
+
+// A name of an XSD enum value. Only constructible from string literals, thus the
+// pointed to string is always NUL-terminated and has static storage duration. This
+// allows handing it out without copying, e.g. via 'hidl_string::setToExternal'.
+class InternedString {{
+  public:
+    constexpr InternedString() : InternedString("") {{}}
+    template <size_t N>
+    constexpr InternedString(const char (&literal)[N]) : mData(literal), mSize(N - 1) {{}}
+
+    constexpr const char* c_str() const {{ return mData; }}
+    constexpr size_t size() const {{ return mSize; }}
+    constexpr bool empty() const {{ return mSize == 0; }}
+    constexpr std::string_view view() const {{ return std::string_view(mData, mSize); }}
+    std::string str() const {{ return std::string(mData, mSize); }}
+
+  private:
+    const char* mData;
+    size_t mSize;
+}};
+
+namespace enum_tables {{
+
+// FNV-1a.
+constexpr uint32_t hashName(std::string_view name) {{
+    uint32_t h = {fnv_offset:#x}u;
+    for (char c : name) {{
+        h = (h ^ static_cast<uint8_t>(c)) * {fnv_prime:#x}u;
+    }}
+    return h;
+}}
+
+constexpr size_t slotOf(uint32_t hash, uint32_t displacement, size_t slotCount) {{
+    uint32_t h = hash + displacement * {golden:#x}u;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h & (slotCount - 1);
+}}
+
+template <typename E>
+struct Entry {{
+    InternedString name;
+    E value = E::UNKNOWN;
+}};
+
+// Perfect hash table built by hash-and-displace: the low bits of the name
+// hash select a bucket, and the displacement of the bucket selects the slot.
+template <typename E, size_t BucketCount, size_t SlotCount>
+struct Table {{
+    static_assert((BucketCount & (BucketCount - 1)) == 0 && (SlotCount & (SlotCount - 1)) == 0);
+    std::array<uint32_t, BucketCount> displacements;
+    std::array<Entry<E>, SlotCount> slots;
+}};
+
+template <typename E, size_t B, size_t S>
+constexpr size_t slotOf(const Table<E, B, S>& table, std::string_view name) {{
+    const uint32_t h = hashName(name);
+    return slotOf(h, table.displacements[h & (B - 1)], S);
+}}
+
+template <typename E, size_t B, size_t S>
+constexpr E find(const Table<E, B, S>& table, std::string_view name) {{
+    const Entry<E>& entry = table.slots[slotOf(table, name)];
+    return entry.name.view() == name ? entry.value : E::UNKNOWN;
+}}
+
+template <typename E, size_t B, size_t S>
+constexpr bool isPerfect(const Table<E, B, S>& table) {{
+    for (size_t i = 0; i < S; ++i) {{
+        const Entry<E>& entry = table.slots[i];
+        if (!entry.name.empty() && slotOf(table, entry.name.view()) != i) return false;
+    }}
+    return true;
+}}
+
+}}  // namespace enum_tables
+
+'''
+
+FOOTER = '''}}  // namespace android::audio::policy::configuration::{vid}
+
+#endif  // {guard}
+'''
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('version', help='HAL version, e.g. 7.0')
+    args = parser.parse_args()
+    vid = 'V' + args.version.replace('.', '_')
+    xsd_path = os.path.join(AUDIO_DIR, args.version, 'config', 'audio_policy_configuration.xsd')
+    out_path = os.path.join(AUDIO_DIR, 'common', args.version, 'enums', 'include',
+                            'android_audio_policy_configuration_%s-enum_tables.h' % vid)
+    guard = 'ANDROID_AUDIO_POLICY_CONFIGURATION_%s__ENUM_TABLES_H' % vid
+    enums = read_enums(xsd_path)
+
+    out = [HEADER.format(version=args.version, guard=guard, vid=vid, fnv_offset=FNV_OFFSET,
+                         fnv_prime=FNV_PRIME, golden=GOLDEN).rstrip('\n'), '']
+    for xsd_name in ENUM_TYPES:
+        emit_enum(out, xsd_name, enums[xsd_name])
+    out.append(FOOTER.format(vid=vid, guard=guard).rstrip('\n'))
+    with open(out_path, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -483,46 +483,70 @@ Return<void> StreamIn::debug(const hidl_handle& fd, const hidl_vec<hidl_string>&
 
 #if MAJOR_VERSION >= 4
 Result StreamIn::doUpdateSinkMetadata(const SinkMetadata& sinkMetadata) {
-    std::vector<record_track_metadata> halTracks;
+    std::lock_guard<std::mutex> lock(mSinkMetadataLock);
+    bool changed;
+    status_t result = mSinkMetadata.update(
+            sinkMetadata.tracks,
+            [](const RecordTrackMetadata& track, record_track_metadata_t* halTrack) {
 #if MAJOR_VERSION <= 6
-    (void)CoreUtils::sinkMetadataToHal(sinkMetadata, &halTracks);
+                return CoreUtils::recordTrackMetadataToHal(track, halTrack);
 #else
-    // Validate whether a conversion to V7 is possible. This is needed
-    // to have a consistent behavior of the HAL regardless of the API
-    // version of the legacy HAL (and also to be consistent with openInputStream).
-    std::vector<record_track_metadata_v7> halTracksV7;
-    if (status_t status = CoreUtils::sinkMetadataToHalV7(
-                sinkMetadata, false /*ignoreNonVendorTags*/, &halTracksV7);
-        status == NO_ERROR) {
-        halTracks.reserve(halTracksV7.size());
-        for (auto metadata_v7 : halTracksV7) {
-            halTracks.push_back(std::move(metadata_v7.base));
-        }
-    } else {
-        return Stream::analyzeStatus("sinkMetadataToHal", status);
+                // Validate whether a conversion to V7 is possible. This is needed
+                // to have a consistent behavior of the HAL regardless of the API
+                // version of the legacy HAL (and also to be consistent with openInputStream).
+                record_track_metadata_v7_t halTrackV7;
+                status_t status = CoreUtils::recordTrackMetadataToHalV7(
+                        track, false /*ignoreNonVendorTags*/, &halTrackV7);
+                *halTrack = halTrackV7.base;
+                return status;
+#endif
+            },
+            &changed);
+#if MAJOR_VERSION >= 7
+    if (result != NO_ERROR) {
+        return Stream::analyzeStatus("sinkMetadataToHal", result);
     }
-#endif  // MAJOR_VERSION <= 6
+#else
+    (void)result;
+#endif
+    if (!changed) {
+        return Result::OK;
+    }
+    // The legacy HAL takes a non-const pointer, thus it is not given the cached tracks.
+    std::vector<record_track_metadata_t> halTracks = mSinkMetadata.halTracks();
     const sink_metadata_t halMetadata = {
         .track_count = halTracks.size(),
         .tracks = halTracks.data(),
     };
     mStream->update_sink_metadata(mStream, &halMetadata);
+    mSinkMetadata.commit();
     return Result::OK;
 }
 
 #if MAJOR_VERSION >= 7
 Result StreamIn::doUpdateSinkMetadataV7(const SinkMetadata& sinkMetadata) {
-    std::vector<record_track_metadata_v7> halTracks;
-    if (status_t status = CoreUtils::sinkMetadataToHalV7(sinkMetadata,
-                                                         false /*ignoreNonVendorTags*/, &halTracks);
+    std::lock_guard<std::mutex> lock(mSinkMetadataLock);
+    bool changed;
+    if (status_t status = mSinkMetadataV7.update(
+                sinkMetadata.tracks,
+                [](const RecordTrackMetadata& track, record_track_metadata_v7_t* halTrack) {
+                    return CoreUtils::recordTrackMetadataToHalV7(
+                            track, false /*ignoreNonVendorTags*/, halTrack);
+                },
+                &changed);
         status != NO_ERROR) {
         return Stream::analyzeStatus("sinkMetadataToHal", status);
     }
+    if (!changed) {
+        return Result::OK;
+    }
+    std::vector<record_track_metadata_v7_t> halTracks = mSinkMetadataV7.halTracks();
     const sink_metadata_v7_t halMetadata = {
             .track_count = halTracks.size(),
             .tracks = halTracks.data(),
     };
     mStream->update_sink_metadata_v7(mStream, &halMetadata);
+    mSinkMetadataV7.commit();
     return Result::OK;
 }
 #endif  //  MAJOR_VERSION >= 7
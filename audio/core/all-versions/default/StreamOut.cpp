@@ -592,46 +592,70 @@ Return<void> StreamOut::debug(const hidl_handle& fd, const hidl_vec<hidl_string>
 
 #if MAJOR_VERSION >= 4
 Result StreamOut::doUpdateSourceMetadata(const SourceMetadata& sourceMetadata) {
-    std::vector<playback_track_metadata_t> halTracks;
+    std::lock_guard<std::mutex> lock(mSourceMetadataLock);
+    bool changed;
+    status_t result = mSourceMetadata.update(
+            sourceMetadata.tracks,
+            [](const PlaybackTrackMetadata& track, playback_track_metadata_t* halTrack) {
 #if MAJOR_VERSION <= 6
-    (void)CoreUtils::sourceMetadataToHal(sourceMetadata, &halTracks);
+                return CoreUtils::playbackTrackMetadataToHal(track, halTrack);
 #else
-    // Validate whether a conversion to V7 is possible. This is needed
-    // to have a consistent behavior of the HAL regardless of the API
-    // version of the legacy HAL (and also to be consistent with openOutputStream).
-    std::vector<playback_track_metadata_v7> halTracksV7;
-    if (status_t status = CoreUtils::sourceMetadataToHalV7(
-                sourceMetadata, false /*ignoreNonVendorTags*/, &halTracksV7);
-        status == NO_ERROR) {
-        halTracks.reserve(halTracksV7.size());
-        for (auto metadata_v7 : halTracksV7) {
-            halTracks.push_back(std::move(metadata_v7.base));
-        }
-    } else {
-        return Stream::analyzeStatus("sourceMetadataToHal", status);
+                // Validate whether a conversion to V7 is possible. This is needed
+                // to have a consistent behavior of the HAL regardless of the API
+                // version of the legacy HAL (and also to be consistent with openOutputStream).
+                playback_track_metadata_v7_t halTrackV7;
+                status_t status = CoreUtils::playbackTrackMetadataToHalV7(
+                        track, false /*ignoreNonVendorTags*/, &halTrackV7);
+                *halTrack = halTrackV7.base;
+                return status;
+#endif
+            },
+            &changed);
+#if MAJOR_VERSION >= 7
+    if (result != NO_ERROR) {
+        return Stream::analyzeStatus("sourceMetadataToHal", result);
     }
-#endif  // MAJOR_VERSION <= 6
+#else
+    (void)result;
+#endif
+    if (!changed) {
+        return Result::OK;
+    }
+    // The legacy HAL takes a non-const pointer, thus it is not given the cached tracks.
+    std::vector<playback_track_metadata_t> halTracks = mSourceMetadata.halTracks();
     const source_metadata_t halMetadata = {
         .track_count = halTracks.size(),
         .tracks = halTracks.data(),
     };
     mStream->update_source_metadata(mStream, &halMetadata);
+    mSourceMetadata.commit();
     return Result::OK;
 }
 
 #if MAJOR_VERSION >= 7
 Result StreamOut::doUpdateSourceMetadataV7(const SourceMetadata& sourceMetadata) {
-    std::vector<playback_track_metadata_v7> halTracks;
-    if (status_t status = CoreUtils::sourceMetadataToHalV7(
-                sourceMetadata, false /*ignoreNonVendorTags*/, &halTracks);
+    std::lock_guard<std::mutex> lock(mSourceMetadataLock);
+    bool changed;
+    if (status_t status = mSourceMetadataV7.update(
+                sourceMetadata.tracks,
+                [](const PlaybackTrackMetadata& track, playback_track_metadata_v7_t* halTrack) {
+                    return CoreUtils::playbackTrackMetadataToHalV7(
+                            track, false /*ignoreNonVendorTags*/, halTrack);
+                },
+                &changed);
         status != NO_ERROR) {
         return Stream::analyzeStatus("sourceMetadataToHal", status);
     }
+    if (!changed) {
+        return Result::OK;
+    }
+    std::vector<playback_track_metadata_v7_t> halTracks = mSourceMetadataV7.halTracks();
     const source_metadata_v7_t halMetadata = {
             .track_count = halTracks.size(),
             .tracks = halTracks.data(),
     };
     mStream->update_source_metadata_v7(mStream, &halMetadata);
+    mSourceMetadataV7.commit();
     return Result::OK;
 }
 #endif  //  MAJOR_VERSION >= 7
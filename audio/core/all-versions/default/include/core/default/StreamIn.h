@@ -26,11 +26,13 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 
 #include <fmq/EventFlag.h>
 #include <fmq/MessageQueue.h>
 #include <hidl/MQDescriptor.h>
 #include <hidl/Status.h>
+#include <util/TrackMetadataCache.h>
 #include <utils/Thread.h>
 
 namespace android {
@@ -47,6 +49,7 @@ using ::android::hardware::Void;
 using namespace ::android::hardware::audio::common::COMMON_TYPES_CPP_VERSION;
 using namespace ::android::hardware::audio::CORE_TYPES_CPP_VERSION;
 using namespace ::android::hardware::audio::CPP_VERSION;
+using ::android::hardware::audio::CORE_TYPES_CPP_VERSION::implementation::TrackMetadataCache;
 
 struct StreamIn : public IStreamIn {
     typedef MessageQueue<ReadParameters, kSynchronizedReadWrite> CommandMQ;
@@ -149,6 +152,13 @@ struct StreamIn : public IStreamIn {
     EventFlag* mEfGroup;
     std::atomic<bool> mStopReadThread;
     sp<Thread> mReadThread;
+#if MAJOR_VERSION >= 4
+    std::mutex mSinkMetadataLock;
+    TrackMetadataCache<RecordTrackMetadata, record_track_metadata_t> mSinkMetadata;
+#if MAJOR_VERSION >= 7
+    TrackMetadataCache<RecordTrackMetadata, record_track_metadata_v7_t> mSinkMetadataV7;
+#endif
+#endif
 
     virtual ~StreamIn();
 };
@@ -24,12 +24,14 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 
 #include <fmq/EventFlag.h>
 #include <fmq/MessageQueue.h>
 #include <hidl/MQDescriptor.h>
 #include <hidl/Status.h>
 #include <mediautils/Synchronization.h>
+#include <util/TrackMetadataCache.h>
 #include <utils/Thread.h>
 
 namespace android {
@@ -46,6 +48,7 @@ using ::android::hardware::Void;
 using namespace ::android::hardware::audio::common::COMMON_TYPES_CPP_VERSION;
 using namespace ::android::hardware::audio::CORE_TYPES_CPP_VERSION;
 using namespace ::android::hardware::audio::CPP_VERSION;
+using ::android::hardware::audio::CORE_TYPES_CPP_VERSION::implementation::TrackMetadataCache;
 
 struct StreamOut : public IStreamOut {
     typedef MessageQueue<WriteCommand, kSynchronizedReadWrite> CommandMQ;
@@ -179,6 +182,13 @@ struct StreamOut : public IStreamOut {
     EventFlag* mEfGroup;
     std::atomic<bool> mStopWriteThread;
     sp<Thread> mWriteThread;
+#if MAJOR_VERSION >= 4
+    std::mutex mSourceMetadataLock;
+    TrackMetadataCache<PlaybackTrackMetadata, playback_track_metadata_t> mSourceMetadata;
+#if MAJOR_VERSION >= 7
+    TrackMetadataCache<PlaybackTrackMetadata, playback_track_metadata_v7_t> mSourceMetadataV7;
+#endif
+#endif
 
     virtual ~StreamOut();
 
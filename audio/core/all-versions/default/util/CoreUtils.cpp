@@ -27,6 +27,19 @@ using ::android::hardware::audio::common::COMMON_TYPES_CPP_VERSION::implementati
 namespace xsd {
 using namespace ::android::audio::policy::configuration::CPP_VERSION;
 }
+
+namespace {
+
+// Makes 'str' refer to the interned name of 'value' instead of allocating a copy.
+template <typename E>
+bool setToInterned(E value, ::android::hardware::hidl_string* str) {
+    const xsd::InternedString name = xsd::toInternedString(value);
+    if (name.empty()) return false;
+    str->setToExternal(name.c_str(), name.size());
+    return true;
+}
+
+}  // namespace
 #endif
 
 namespace android {
@@ -175,7 +188,7 @@ status_t CoreUtils::sinkMetadataFromHal(const std::vector<record_track_metadata_
             }
         }
 #if MAJOR_VERSION >= 7
-        trackMetadata.channelMask = toString(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE);
+        setToInterned(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE, &trackMetadata.channelMask);
 #endif
 #endif  // MAJOR_VERSION >= 5
         sinkMetadata->tracks[i] = std::move(trackMetadata);
@@ -214,6 +227,49 @@ status_t CoreUtils::sinkMetadataFromHalV7(const std::vector<record_track_metadat
     return result;
 }
 
+status_t CoreUtils::recordTrackMetadataToHal(const RecordTrackMetadata& trackMetadata,
+                                             record_track_metadata_t* halTrackMetadata) {
+    status_t result = NO_ERROR;
+    *halTrackMetadata = {.gain = trackMetadata.gain};
+    CONVERT_CHECKED(HidlUtils::audioSourceToHal(trackMetadata.source, &halTrackMetadata->source),
+                    result);
+#if MAJOR_VERSION >= 5
+    if (trackMetadata.destination.getDiscriminator() ==
+        RecordTrackMetadata::Destination::hidl_discriminator::device) {
+        CONVERT_CHECKED(deviceAddressToHal(trackMetadata.destination.device(),
+                                           &halTrackMetadata->dest_device,
+                                           halTrackMetadata->dest_device_address),
+                        result);
+    }
+#endif
+    return result;
+}
+
+status_t CoreUtils::recordTrackMetadataToHalV7(const RecordTrackMetadata& trackMetadata,
+                                               bool ignoreNonVendorTags,
+                                               record_track_metadata_v7_t* halTrackMetadata) {
+    record_track_metadata_t base;
+    status_t result = recordTrackMetadataToHal(trackMetadata, &base);
+    record_track_metadata_to_v7(halTrackMetadata, &base);
+#if MAJOR_VERSION >= 7
+    CONVERT_CHECKED(HidlUtils::audioChannelMaskToHal(trackMetadata.channelMask,
+                                                     &halTrackMetadata->channel_mask),
+                    result);
+    if (ignoreNonVendorTags) {
+        CONVERT_CHECKED(
+                HidlUtils::audioTagsToHal(HidlUtils::filterOutNonVendorTags(trackMetadata.tags),
+                                          halTrackMetadata->tags),
+                result);
+    } else {
+        CONVERT_CHECKED(HidlUtils::audioTagsToHal(trackMetadata.tags, halTrackMetadata->tags),
+                        result);
+    }
+#else
+    (void)ignoreNonVendorTags;
+#endif
+    return result;
+}
+
 status_t CoreUtils::sinkMetadataToHal(const SinkMetadata& sinkMetadata,
                                       std::vector<record_track_metadata_t>* halTracks) {
     status_t result = NO_ERROR;
@@ -221,18 +277,8 @@ status_t CoreUtils::sinkMetadataToHal(const SinkMetadata& sinkMetadata,
         halTracks->reserve(sinkMetadata.tracks.size());
     }
     for (auto& trackMetadata : sinkMetadata.tracks) {
-        record_track_metadata halTrackMetadata{.gain = trackMetadata.gain};
-        CONVERT_CHECKED(HidlUtils::audioSourceToHal(trackMetadata.source, &halTrackMetadata.source),
-                        result);
-#if MAJOR_VERSION >= 5
-        if (trackMetadata.destination.getDiscriminator() ==
-            RecordTrackMetadata::Destination::hidl_discriminator::device) {
-            CONVERT_CHECKED(deviceAddressToHal(trackMetadata.destination.device(),
-                                               &halTrackMetadata.dest_device,
-                                               halTrackMetadata.dest_device_address),
-                            result);
-        }
-#endif
+        record_track_metadata halTrackMetadata;
+        CONVERT_CHECKED(recordTrackMetadataToHal(trackMetadata, &halTrackMetadata), result);
         if (halTracks != nullptr) {
             halTracks->push_back(std::move(halTrackMetadata));
         }
@@ -242,33 +288,15 @@ status_t CoreUtils::sinkMetadataToHal(const SinkMetadata& sinkMetadata,
 
 status_t CoreUtils::sinkMetadataToHalV7(const SinkMetadata& sinkMetadata, bool ignoreNonVendorTags,
                                         std::vector<record_track_metadata_v7_t>* halTracks) {
-    std::vector<record_track_metadata> bases;
-    status_t result = sinkMetadataToHal(sinkMetadata, halTracks != nullptr ? &bases : nullptr);
+    status_t result = NO_ERROR;
     if (halTracks != nullptr) {
         halTracks->reserve(sinkMetadata.tracks.size());
     }
-    for (size_t i = 0; i < sinkMetadata.tracks.size(); ++i) {
+    for (auto& trackMetadata : sinkMetadata.tracks) {
         record_track_metadata_v7_t halTrackMetadata;
-        if (halTracks != nullptr) {
-            record_track_metadata_to_v7(&halTrackMetadata, &bases[i]);
-        }
-#if MAJOR_VERSION >= 7
-        const auto& trackMetadata = sinkMetadata.tracks[i];
-        CONVERT_CHECKED(HidlUtils::audioChannelMaskToHal(trackMetadata.channelMask,
-                                                         &halTrackMetadata.channel_mask),
-                        result);
-        if (ignoreNonVendorTags) {
-            CONVERT_CHECKED(
-                    HidlUtils::audioTagsToHal(HidlUtils::filterOutNonVendorTags(trackMetadata.tags),
-                                              halTrackMetadata.tags),
-                    result);
-        } else {
-            CONVERT_CHECKED(HidlUtils::audioTagsToHal(trackMetadata.tags, halTrackMetadata.tags),
-                            result);
-        }
-#else
-        (void)ignoreNonVendorTags;
-#endif
+        CONVERT_CHECKED(
+                recordTrackMetadataToHalV7(trackMetadata, ignoreNonVendorTags, &halTrackMetadata),
+                result);
         if (halTracks != nullptr) {
             halTracks->push_back(std::move(halTrackMetadata));
         }
@@ -290,7 +318,7 @@ status_t CoreUtils::sourceMetadataFromHal(const std::vector<playback_track_metad
                         result);
         trackMetadata.gain = halTrackMetadata.gain;
 #if MAJOR_VERSION >= 7
-        trackMetadata.channelMask = toString(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE);
+        setToInterned(xsd::AudioChannelMask::AUDIO_CHANNEL_NONE, &trackMetadata.channelMask);
 #endif
         sourceMetadata->tracks[i] = std::move(trackMetadata);
     }
@@ -329,6 +357,43 @@ status_t CoreUtils::sourceMetadataFromHalV7(
     return result;
 }
 
+status_t CoreUtils::playbackTrackMetadataToHal(const PlaybackTrackMetadata& trackMetadata,
+                                               playback_track_metadata_t* halTrackMetadata) {
+    status_t result = NO_ERROR;
+    *halTrackMetadata = {.gain = trackMetadata.gain};
+    CONVERT_CHECKED(HidlUtils::audioUsageToHal(trackMetadata.usage, &halTrackMetadata->usage),
+                    result);
+    CONVERT_CHECKED(HidlUtils::audioContentTypeToHal(trackMetadata.contentType,
+                                                     &halTrackMetadata->content_type),
+                    result);
+    return result;
+}
+
+status_t CoreUtils::playbackTrackMetadataToHalV7(const PlaybackTrackMetadata& trackMetadata,
+                                                 bool ignoreNonVendorTags,
+                                                 playback_track_metadata_v7_t* halTrackMetadata) {
+    playback_track_metadata_t base;
+    status_t result = playbackTrackMetadataToHal(trackMetadata, &base);
+    playback_track_metadata_to_v7(halTrackMetadata, &base);
+#if MAJOR_VERSION >= 7
+    CONVERT_CHECKED(HidlUtils::audioChannelMaskToHal(trackMetadata.channelMask,
+                                                     &halTrackMetadata->channel_mask),
+                    result);
+    if (ignoreNonVendorTags) {
+        CONVERT_CHECKED(
+                HidlUtils::audioTagsToHal(HidlUtils::filterOutNonVendorTags(trackMetadata.tags),
+                                          halTrackMetadata->tags),
+                result);
+    } else {
+        CONVERT_CHECKED(HidlUtils::audioTagsToHal(trackMetadata.tags, halTrackMetadata->tags),
+                        result);
+    }
+#else
+    (void)ignoreNonVendorTags;
+#endif
+    return result;
+}
+
 status_t CoreUtils::sourceMetadataToHal(const SourceMetadata& sourceMetadata,
                                         std::vector<playback_track_metadata_t>* halTracks) {
     status_t result = NO_ERROR;
@@ -336,12 +401,8 @@ status_t CoreUtils::sourceMetadataToHal(const SourceMetadata& sourceMetadata,
         halTracks->reserve(sourceMetadata.tracks.size());
     }
     for (auto& trackMetadata : sourceMetadata.tracks) {
-        playback_track_metadata_t halTrackMetadata{.gain = trackMetadata.gain};
-        CONVERT_CHECKED(HidlUtils::audioUsageToHal(trackMetadata.usage, &halTrackMetadata.usage),
-                        result);
-        CONVERT_CHECKED(HidlUtils::audioContentTypeToHal(trackMetadata.contentType,
-                                                         &halTrackMetadata.content_type),
-                        result);
+        playback_track_metadata_t halTrackMetadata;
+        CONVERT_CHECKED(playbackTrackMetadataToHal(trackMetadata, &halTrackMetadata), result);
         if (halTracks != nullptr) {
             halTracks->push_back(std::move(halTrackMetadata));
         }
@@ -352,33 +413,15 @@ status_t CoreUtils::sourceMetadataToHal(const SourceMetadata& sourceMetadata,
 status_t CoreUtils::sourceMetadataToHalV7(const SourceMetadata& sourceMetadata,
                                           bool ignoreNonVendorTags,
                                           std::vector<playback_track_metadata_v7_t>* halTracks) {
-    std::vector<playback_track_metadata_t> bases;
-    status_t result = sourceMetadataToHal(sourceMetadata, halTracks != nullptr ? &bases : nullptr);
+    status_t result = NO_ERROR;
     if (halTracks != nullptr) {
         halTracks->reserve(sourceMetadata.tracks.size());
     }
-    for (size_t i = 0; i < sourceMetadata.tracks.size(); ++i) {
+    for (auto& trackMetadata : sourceMetadata.tracks) {
         playback_track_metadata_v7_t halTrackMetadata;
-        if (halTracks != nullptr) {
-            playback_track_metadata_to_v7(&halTrackMetadata, &bases[i]);
-        }
-#if MAJOR_VERSION >= 7
-        const auto& trackMetadata = sourceMetadata.tracks[i];
-        CONVERT_CHECKED(HidlUtils::audioChannelMaskToHal(trackMetadata.channelMask,
-                                                         &halTrackMetadata.channel_mask),
+        CONVERT_CHECKED(playbackTrackMetadataToHalV7(trackMetadata, ignoreNonVendorTags,
+                                                     &halTrackMetadata),
                         result);
-        if (ignoreNonVendorTags) {
-            CONVERT_CHECKED(
-                    HidlUtils::audioTagsToHal(HidlUtils::filterOutNonVendorTags(trackMetadata.tags),
-                                              halTrackMetadata.tags),
-                    result);
-        } else {
-            CONVERT_CHECKED(HidlUtils::audioTagsToHal(trackMetadata.tags, halTrackMetadata.tags),
-                            result);
-        }
-#else
-        (void)ignoreNonVendorTags;
-#endif
         if (halTracks != nullptr) {
             halTracks->push_back(std::move(halTrackMetadata));
         }
@@ -388,20 +431,19 @@ status_t CoreUtils::sourceMetadataToHalV7(const SourceMetadata& sourceMetadata,
 #endif  // MAJOR_VERSION >= 4
 
 #if MAJOR_VERSION >= 7
-namespace xsd {
-using namespace ::android::audio::policy::configuration::CPP_VERSION;
-}
-
 status_t CoreUtils::audioInputFlagsFromHal(audio_input_flags_t halFlagMask,
                                            AudioInputFlags* flags) {
     status_t status = NO_ERROR;
-    std::vector<AudioInOutFlag> result;
+    hidl_vec<AudioInOutFlag> result;
+    result.resize(__builtin_popcount(halFlagMask));
+    size_t resultPos = 0;
     for (uint32_t bit = 0; halFlagMask != 0 && bit < sizeof(audio_input_flags_t) * 8; ++bit) {
         audio_input_flags_t flag = static_cast<audio_input_flags_t>(1u << bit);
         if ((flag & halFlagMask) == flag) {
-            AudioInOutFlag flagStr = audio_input_flag_to_string(flag);
-            if (!flagStr.empty() && !xsd::isUnknownAudioInOutFlag(flagStr)) {
-                result.push_back(flagStr);
+            const char* flagStr = audio_input_flag_to_string(flag);
+            if (setToInterned(xsd::lookupAudioInOutFlag(flagStr != nullptr ? flagStr : ""),
+                              &result[resultPos])) {
+                ++resultPos;
             } else {
                 ALOGE("Unknown audio input flag value 0x%X", flag);
                 status = BAD_VALUE;
@@ -409,7 +451,10 @@ status_t CoreUtils::audioInputFlagsFromHal(audio_input_flags_t halFlagMask,
             halFlagMask = static_cast<audio_input_flags_t>(halFlagMask & ~flag);
         }
     }
-    *flags = result;
+    if (resultPos != result.size()) {
+        result.resize(resultPos);
+    }
+    *flags = std::move(result);
     return status;
 }
 
@@ -419,7 +464,8 @@ status_t CoreUtils::audioInputFlagsToHal(const AudioInputFlags& flags,
     *halFlagMask = {};
     for (const auto& flag : flags) {
         audio_input_flags_t halFlag;
-        if (!xsd::isUnknownAudioInOutFlag(flag) &&
+        if (xsd::lookupAudioInOutFlag(std::string_view(flag.c_str(), flag.size())) !=
+                    xsd::AudioInOutFlag::UNKNOWN &&
             audio_input_flag_from_string(flag.c_str(), &halFlag)) {
             *halFlagMask = static_cast<audio_input_flags_t>(*halFlagMask | halFlag);
         } else {
@@ -433,13 +479,16 @@ status_t CoreUtils::audioInputFlagsToHal(const AudioInputFlags& flags,
 status_t CoreUtils::audioOutputFlagsFromHal(audio_output_flags_t halFlagMask,
                                             AudioOutputFlags* flags) {
     status_t status = NO_ERROR;
-    std::vector<AudioInOutFlag> result;
+    hidl_vec<AudioInOutFlag> result;
+    result.resize(__builtin_popcount(halFlagMask));
+    size_t resultPos = 0;
     for (uint32_t bit = 0; halFlagMask != 0 && bit < sizeof(audio_output_flags_t) * 8; ++bit) {
         audio_output_flags_t flag = static_cast<audio_output_flags_t>(1u << bit);
         if ((flag & halFlagMask) == flag) {
-            AudioInOutFlag flagStr = audio_output_flag_to_string(flag);
-            if (!flagStr.empty() && !xsd::isUnknownAudioInOutFlag(flagStr)) {
-                result.push_back(flagStr);
+            const char* flagStr = audio_output_flag_to_string(flag);
+            if (setToInterned(xsd::lookupAudioInOutFlag(flagStr != nullptr ? flagStr : ""),
+                              &result[resultPos])) {
+                ++resultPos;
             } else {
                 ALOGE("Unknown audio output flag value 0x%X", flag);
                 status = BAD_VALUE;
@@ -447,7 +496,10 @@ status_t CoreUtils::audioOutputFlagsFromHal(audio_output_flags_t halFlagMask,
             halFlagMask = static_cast<audio_output_flags_t>(halFlagMask & ~flag);
         }
     }
-    *flags = result;
+    if (resultPos != result.size()) {
+        result.resize(resultPos);
+    }
+    *flags = std::move(result);
     return status;
 }
 
@@ -457,7 +509,8 @@ status_t CoreUtils::audioOutputFlagsToHal(const AudioOutputFlags& flags,
     *halFlagMask = {};
     for (const auto& flag : flags) {
         audio_output_flags_t halFlag;
-        if (!xsd::isUnknownAudioInOutFlag(flag) &&
+        if (xsd::lookupAudioInOutFlag(std::string_view(flag.c_str(), flag.size())) !=
+                    xsd::AudioInOutFlag::UNKNOWN &&
             audio_output_flag_from_string(flag.c_str(), &halFlag)) {
             *halFlagMask = static_cast<audio_output_flags_t>(*halFlagMask | halFlag);
         } else {
@@ -53,6 +53,14 @@ struct CoreUtils {
     // Note: {Sink|Source}Metadata types are defined in 'common' (since V5), so they can be used
     // by the BT HAL. However, the converters are defined here, not in HidlUtils to avoid adding
     // conditionals to handle V4. The converters are only used by 'core' HAL anyways.
+    static status_t playbackTrackMetadataToHal(const PlaybackTrackMetadata& trackMetadata,
+            playback_track_metadata_t* halTrackMetadata);
+    static status_t playbackTrackMetadataToHalV7(const PlaybackTrackMetadata& trackMetadata,
+            bool ignoreNonVendorTags, playback_track_metadata_v7_t* halTrackMetadata);
+    static status_t recordTrackMetadataToHal(const RecordTrackMetadata& trackMetadata,
+            record_track_metadata_t* halTrackMetadata);
+    static status_t recordTrackMetadataToHalV7(const RecordTrackMetadata& trackMetadata,
+            bool ignoreNonVendorTags, record_track_metadata_v7_t* halTrackMetadata);
     static status_t sinkMetadataFromHal(const std::vector<record_track_metadata_t>& halTracks,
             SinkMetadata* sinkMetadata);
     static status_t sinkMetadataFromHalV7(const std::vector<record_track_metadata_v7_t>& halTracks,
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include <hidl/HidlSupport.h>
+#include <utils/Errors.h>
+
+namespace android {
+namespace hardware {
+namespace audio {
+namespace CORE_TYPES_CPP_VERSION {
+namespace implementation {
+
+// Remembers the track metadata last passed to the legacy HAL together with its
+// converted form. Clients update metadata each time any of their tracks changes,
+// usually with most tracks staying the same, thus only tracks that differ from
+// the previous update need to be converted again. Not thread-safe.
+template <typename Track, typename HalTrack>
+class TrackMetadataCache {
+  public:
+    // Comparison of converted tracks is bytewise, which is only reliable for
+    // structures without padding, like the ones from system/audio.h.
+    static_assert(std::is_trivially_copyable_v<HalTrack>);
+
+    // Converts 'tracks' using 'convert', a callable with the signature
+    // 'status_t(const Track&, HalTrack*)', for the tracks that are not the same
+    // as in the previous update. '*changed' is set to false if the converted
+    // tracks are identical to the ones from the previous committed update, in
+    // which case there is no need to pass them to the HAL again. The converted
+    // tracks are available via 'halTracks' even if the conversion has failed.
+    template <typename Converter>
+    status_t update(const hidl_vec<Track>& tracks, Converter convert, bool* changed) {
+        status_t result = NO_ERROR;
+        *changed = !mValid || tracks.size() != mTracks.size();
+        // Slots added by 'resize' hold default-constructed tracks which have
+        // never been converted, thus they must not be skipped.
+        const size_t cachedSize = mValid ? std::min(mTracks.size(), tracks.size()) : 0;
+        mTracks.resize(tracks.size());
+        mHalTracks.resize(tracks.size());
+        for (size_t i = 0; i < tracks.size(); ++i) {
+            if (i < cachedSize && tracks[i] == mTracks[i]) continue;
+            HalTrack halTrack;
+            memset(&halTrack, 0, sizeof(halTrack));
+            if (status_t status = convert(tracks[i], &halTrack); status != NO_ERROR) {
+                result = status;
+            }
+            if (memcmp(&halTrack, &mHalTracks[i], sizeof(halTrack)) != 0) {
+                mHalTracks[i] = halTrack;
+                *changed = true;
+            }
+            mTracks[i] = tracks[i];
+        }
+        // Changed tracks only become the reference for the next update once
+        // they have been passed to the HAL, see 'commit'. A failed conversion
+        // must not be mistaken for a cached success next time either.
+        mConverted = result == NO_ERROR;
+        mValid = mConverted && !*changed;
+        return result;
+    }
+
+    // Must be called once the tracks converted by the last 'update' have been
+    // passed to the HAL. Until then, and if the HAL could not be given them,
+    // the next update reports all tracks as changed.
+    void commit() { mValid = mConverted; }
+
+    const std::vector<HalTrack>& halTracks() const { return mHalTracks; }
+
+  private:
+    bool mValid = false;
+    bool mConverted = false;
+    std::vector<Track> mTracks;
+    std::vector<HalTrack> mHalTracks;
+};
+
+}  // namespace implementation
+}  // namespace CORE_TYPES_CPP_VERSION
+}  // namespace audio
+}  // namespace hardware
+}  // namespace android
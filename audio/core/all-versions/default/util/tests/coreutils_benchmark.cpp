@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <iterator>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#define LOG_TAG "CoreUtils_Benchmark"
+#include <log/log.h>
+
+#include PATH(APM_XSD_ENUMS_H_FILENAME)
+#include <system/audio.h>
+#include <util/CoreUtils.h>
+
+using namespace android;
+using namespace ::android::hardware::audio::common::COMMON_TYPES_CPP_VERSION;
+using namespace ::android::hardware::audio::CORE_TYPES_CPP_VERSION;
+using ::android::hardware::audio::CORE_TYPES_CPP_VERSION::implementation::CoreUtils;
+namespace xsd {
+using namespace ::android::audio::policy::configuration::CPP_VERSION;
+}
+
+// Metadata is updated by the framework each time a track is started, stopped, or
+// changes its attributes. Busy playback threads carry up to a few dozen tracks.
+static void TrackCounts(benchmark::internal::Benchmark* b) {
+    b->Arg(1)->Arg(4)->Arg(16)->Arg(32);
+}
+
+static constexpr char kHalTags[] = "VX_GOOGLE_ASSISTANT;VX_GOOGLE_NAVIGATION";
+
+static std::vector<playback_track_metadata_v7_t> makeHalPlaybackTracks(size_t count) {
+    static constexpr audio_usage_t kUsages[] = {AUDIO_USAGE_MEDIA, AUDIO_USAGE_GAME,
+                                                AUDIO_USAGE_ASSISTANCE_NAVIGATION_GUIDANCE,
+                                                AUDIO_USAGE_VOICE_COMMUNICATION};
+    static constexpr audio_channel_mask_t kMasks[] = {
+            AUDIO_CHANNEL_OUT_STEREO, AUDIO_CHANNEL_OUT_MONO, AUDIO_CHANNEL_OUT_5POINT1,
+            AUDIO_CHANNEL_OUT_7POINT1};
+    std::vector<playback_track_metadata_v7_t> tracks(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& track = tracks[i];
+        track.base.usage = kUsages[i % std::size(kUsages)];
+        track.base.content_type =
+                (i % 2) == 0 ? AUDIO_CONTENT_TYPE_MUSIC : AUDIO_CONTENT_TYPE_SPEECH;
+        track.base.gain = 1.0f;
+        track.channel_mask = kMasks[i % std::size(kMasks)];
+        if ((i % 4) == 0) {
+            strncpy(track.tags, kHalTags, AUDIO_ATTRIBUTES_TAGS_MAX_SIZE);
+        }
+    }
+    return tracks;
+}
+
+static SinkMetadata makeSinkMetadata(size_t count) {
+    static const xsd::AudioSource kSources[] = {
+            xsd::AudioSource::AUDIO_SOURCE_MIC, xsd::AudioSource::AUDIO_SOURCE_CAMCORDER,
+            xsd::AudioSource::AUDIO_SOURCE_VOICE_RECOGNITION,
+            xsd::AudioSource::AUDIO_SOURCE_VOICE_COMMUNICATION};
+    static const xsd::AudioChannelMask kMasks[] = {
+            xsd::AudioChannelMask::AUDIO_CHANNEL_IN_STEREO,
+            xsd::AudioChannelMask::AUDIO_CHANNEL_IN_MONO};
+    SinkMetadata sinkMetadata;
+    sinkMetadata.tracks.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto& track = sinkMetadata.tracks[i];
+        track.source = toString(kSources[i % std::size(kSources)]);
+        track.gain = 1.0f;
+        track.channelMask = toString(kMasks[i % std::size(kMasks)]);
+        if ((i % 4) == 0) {
+            track.tags = {"VX_GOOGLE_ASSISTANT", "VX_GOOGLE_NAVIGATION"};
+        }
+    }
+    return sinkMetadata;
+}
+
+static void BM_SourceMetadataFromHalV7(benchmark::State& state) {
+    const auto halTracks = makeHalPlaybackTracks(state.range(0));
+    for (auto _ : state) {
+        SourceMetadata sourceMetadata;
+        status_t status = CoreUtils::sourceMetadataFromHalV7(
+                halTracks, false /*ignoreNonVendorTags*/, &sourceMetadata);
+        if (status != NO_ERROR) {
+            state.SkipWithError("sourceMetadataFromHalV7 failed");
+            break;
+        }
+        benchmark::DoNotOptimize(sourceMetadata);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SourceMetadataFromHalV7)->Apply(TrackCounts);
+
+static void BM_SourceMetadataToHalV7(benchmark::State& state) {
+    SourceMetadata sourceMetadata;
+    if (CoreUtils::sourceMetadataFromHalV7(makeHalPlaybackTracks(state.range(0)),
+                                           false /*ignoreNonVendorTags*/,
+                                           &sourceMetadata) != NO_ERROR) {
+        state.SkipWithError("sourceMetadataFromHalV7 failed");
+        return;
+    }
+    for (auto _ : state) {
+        std::vector<playback_track_metadata_v7_t> halTracks;
+        status_t status = CoreUtils::sourceMetadataToHalV7(
+                sourceMetadata, false /*ignoreNonVendorTags*/, &halTracks);
+        if (status != NO_ERROR) {
+            state.SkipWithError("sourceMetadataToHalV7 failed");
+            break;
+        }
+        benchmark::DoNotOptimize(halTracks.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SourceMetadataToHalV7)->Apply(TrackCounts);
+
+static void BM_SinkMetadataToHalV7(benchmark::State& state) {
+    const SinkMetadata sinkMetadata = makeSinkMetadata(state.range(0));
+    for (auto _ : state) {
+        std::vector<record_track_metadata_v7_t> halTracks;
+        status_t status = CoreUtils::sinkMetadataToHalV7(
+                sinkMetadata, false /*ignoreNonVendorTags*/, &halTracks);
+        if (status != NO_ERROR) {
+            state.SkipWithError("sinkMetadataToHalV7 failed");
+            break;
+        }
+        benchmark::DoNotOptimize(halTracks.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SinkMetadataToHalV7)->Apply(TrackCounts);
+
+static void BM_SinkMetadataFromHalV7(benchmark::State& state) {
+    std::vector<record_track_metadata_v7_t> halTracks;
+    if (CoreUtils::sinkMetadataToHalV7(makeSinkMetadata(state.range(0)),
+                                       false /*ignoreNonVendorTags*/, &halTracks) != NO_ERROR) {
+        state.SkipWithError("sinkMetadataToHalV7 failed");
+        return;
+    }
+    for (auto _ : state) {
+        SinkMetadata sinkMetadata;
+        status_t status = CoreUtils::sinkMetadataFromHalV7(
+                halTracks, false /*ignoreNonVendorTags*/, &sinkMetadata);
+        if (status != NO_ERROR) {
+            state.SkipWithError("sinkMetadataFromHalV7 failed");
+            break;
+        }
+        benchmark::DoNotOptimize(sinkMetadata);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SinkMetadataFromHalV7)->Apply(TrackCounts);
+
+BENCHMARK_MAIN();
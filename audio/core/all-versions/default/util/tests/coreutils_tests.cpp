@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <string.h>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,7 @@
 #include PATH(APM_XSD_ENUMS_H_FILENAME)
 #include <system/audio.h>
 #include <util/CoreUtils.h>
+#include <util/TrackMetadataCache.h>
 #include <xsdc/XsdcSupport.h>
 
 using namespace android;
@@ -32,6 +34,7 @@ using namespace ::android::hardware::audio::common::COMMON_TYPES_CPP_VERSION;
 using namespace ::android::hardware::audio::CORE_TYPES_CPP_VERSION;
 using ::android::hardware::hidl_vec;
 using ::android::hardware::audio::CORE_TYPES_CPP_VERSION::implementation::CoreUtils;
+using ::android::hardware::audio::CORE_TYPES_CPP_VERSION::implementation::TrackMetadataCache;
 namespace xsd {
 using namespace ::android::audio::policy::configuration::CPP_VERSION;
 }
@@ -523,3 +526,98 @@ INSTANTIATE_TEST_SUITE_P(ValidPlaybackTrackMetadatas, SourceMetadataConvertTest,
                                            SourceTracks{generateValidPlaybackTrackMetadata()},
                                            SourceTracks{generateMinimalPlaybackTrackMetadata(),
                                                         generateValidPlaybackTrackMetadata()}));
+
+TEST(CoreUtils, TrackMetadataCacheDetectsChanges) {
+    TrackMetadataCache<PlaybackTrackMetadata, playback_track_metadata_v7_t> cache;
+    auto convert = [](const PlaybackTrackMetadata& track, playback_track_metadata_v7_t* halTrack) {
+        return CoreUtils::playbackTrackMetadataToHalV7(track, false /*ignoreNonVendorTags*/,
+                                                       halTrack);
+    };
+    SourceTracks tracks{generateMinimalPlaybackTrackMetadata(),
+                        generateValidPlaybackTrackMetadata()};
+    bool changed = false;
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_TRUE(changed);
+    cache.commit();
+    std::vector<playback_track_metadata_v7_t> halTracks;
+    SourceMetadata sourceMetadata;
+    sourceMetadata.tracks = tracks;
+    EXPECT_EQ(NO_ERROR, CoreUtils::sourceMetadataToHalV7(
+                                sourceMetadata, false /*ignoreNonVendorTags*/, &halTracks));
+    ASSERT_EQ(halTracks.size(), cache.halTracks().size());
+    for (size_t i = 0; i < halTracks.size(); ++i) {
+        EXPECT_EQ(0, memcmp(&halTracks[i], &cache.halTracks()[i], sizeof(halTracks[i])));
+    }
+
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_FALSE(changed);
+
+    tracks[1].gain = tracks[1].gain / 2;
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_TRUE(changed);
+    EXPECT_EQ(tracks[1].gain, cache.halTracks()[1].base.gain);
+    cache.commit();
+
+    tracks.resize(1);
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_TRUE(changed);
+    EXPECT_EQ(1u, cache.halTracks().size());
+    cache.commit();
+
+    // A failed conversion must not be reported as unchanged afterwards.
+    SourceTracks invalidTracks = tracks;
+    invalidTracks[0].usage = "random string";
+    EXPECT_EQ(BAD_VALUE, cache.update(invalidTracks, convert, &changed));
+    EXPECT_EQ(BAD_VALUE, cache.update(invalidTracks, convert, &changed));
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_TRUE(changed);
+}
+
+TEST(CoreUtils, TrackMetadataCacheConvertsAddedTracks) {
+    TrackMetadataCache<PlaybackTrackMetadata, playback_track_metadata_v7_t> cache;
+    int conversions = 0;
+    auto convert = [&conversions](const PlaybackTrackMetadata& track,
+                                  playback_track_metadata_v7_t* halTrack) {
+        ++conversions;
+        halTrack->base.gain = track.gain + 1;
+        return NO_ERROR;
+    };
+    SourceTracks tracks{generateValidPlaybackTrackMetadata()};
+    bool changed = false;
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    cache.commit();
+    EXPECT_EQ(1, conversions);
+
+    // An added track which is equal to a default-constructed one must be
+    // converted as well.
+    tracks.resize(2);
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_TRUE(changed);
+    EXPECT_EQ(2, conversions);
+    ASSERT_EQ(2u, cache.halTracks().size());
+    EXPECT_EQ(tracks[1].gain + 1, cache.halTracks()[1].base.gain);
+}
+
+TEST(CoreUtils, TrackMetadataCacheRequiresCommit) {
+    TrackMetadataCache<PlaybackTrackMetadata, playback_track_metadata_v7_t> cache;
+    auto convert = [](const PlaybackTrackMetadata& track, playback_track_metadata_v7_t* halTrack) {
+        return CoreUtils::playbackTrackMetadataToHalV7(track, false /*ignoreNonVendorTags*/,
+                                                       halTrack);
+    };
+    SourceTracks tracks{generateValidPlaybackTrackMetadata()};
+    bool changed = false;
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_TRUE(changed);
+    cache.commit();
+
+    // The changed tracks have not been passed to the HAL, thus they must be
+    // reported as changed again.
+    tracks[0].gain = tracks[0].gain / 2;
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_TRUE(changed);
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_TRUE(changed);
+    cache.commit();
+    EXPECT_EQ(NO_ERROR, cache.update(tracks, convert, &changed));
+    EXPECT_FALSE(changed);
+}
@@ -30,6 +30,9 @@ namespace android::hardware::automotive::can::V1_0::implementation {
 /** Whether to log sent/received packets. */
 static constexpr bool kSuperVerbose = false;
 
+/** Upper bound on the number of messages preallocated for a single batch. */
+static constexpr size_t kMaxBatchPrealloc = 256;
+
 Return<Result> CanBus::send(const CanMessage& message) {
     std::lock_guard<std::mutex> lck(mIsUpGuard);
     if (!mIsUp) return Result::INTERFACE_DOWN;
@@ -66,10 +69,52 @@ Return<void> CanBus::listen(const hidl_vec<CanMessageFilter>& filter,
     }
 
     std::lock_guard<std::mutex> lckListeners(mMsgListenersGuard);
+    _hidl_cb(Result::OK, addMsgListener(filter, listenerCb, nullptr, {}));
+    return {};
+}
+
+Return<void> CanBus::listenBatched(const hidl_vec<CanMessageFilter>& filter,
+                                   const V1_1::BatchingConfig& config,
+                                   const sp<V1_1::ICanMessageListener>& listenerCb,
+                                   listenBatched_cb _hidl_cb) {
+    std::lock_guard<std::mutex> lck(mIsUpGuard);
+
+    if (listenerCb == nullptr || (config.maxLatencyUs == 0 && config.maxMessages == 0)) {
+        _hidl_cb(Result::INVALID_ARGUMENTS, nullptr);
+        return {};
+    }
+    if (!mIsUp) {
+        _hidl_cb(Result::INTERFACE_DOWN, nullptr);
+        return {};
+    }
+
+    std::lock_guard<std::mutex> lckListeners(mMsgListenersGuard);
+    auto closeHandle = addMsgListener(filter, listenerCb, listenerCb, config);
+
+    if (config.maxLatencyUs != 0 && !mBatchFlushThreadRunning) {
+        // A previous thread has already released the lock for good, so it's safe to join here.
+        if (mBatchFlushThread.joinable()) mBatchFlushThread.join();
+        mBatchFlushThreadRunning = true;
+        mBatchFlushThread = std::thread(&CanBus::batchFlushThread, this);
+    }
+
+    _hidl_cb(Result::OK, closeHandle);
+    return {};
+}
 
+sp<ICloseHandle> CanBus::addMsgListener(const hidl_vec<CanMessageFilter>& filter,
+                                        const sp<ICanMessageListener>& listenerCb,
+                                        const sp<V1_1::ICanMessageListener>& batchCb,
+                                        const V1_1::BatchingConfig& batching) {
     sp<CloseHandle> closeHandle = new CloseHandle([this, listenerCb]() {
         std::lock_guard<std::mutex> lck(mMsgListenersGuard);
+        for (auto& e : mMsgListeners) {
+            // deliver whatever is still waiting, so closing doesn't drop any messages
+            if (e.callback == listenerCb) flushBatch(e);
+        }
         std::erase_if(mMsgListeners, [&](const auto& e) { return e.callback == listenerCb; });
+        // let the flush thread exit if this was the last listener it was serving
+        mBatchFlushCv.notify_all();
     });
     mMsgListeners.emplace_back(CanMessageListener{listenerCb, filter, closeHandle});
     auto& listener = mMsgListeners.back();
@@ -78,8 +123,14 @@ Return<void> CanBus::listen(const hidl_vec<CanMessageFilter>& filter,
     std::for_each(listener.filter.begin(), listener.filter.end(),
                   [](auto& rule) { rule.id &= rule.mask; });
 
-    _hidl_cb(Result::OK, closeHandle);
-    return {};
+    if (batchCb != nullptr) {
+        listener.batchCallback = batchCb;
+        listener.batching = batching;
+        const size_t maxMessages = batching.maxMessages != 0 ? batching.maxMessages : SIZE_MAX;
+        listener.pending.reserve(std::min(maxMessages, kMaxBatchPrealloc));
+    }
+
+    return closeHandle;
 }
 
 CanBus::CanBus() {}
@@ -167,6 +218,50 @@ void CanBus::clearMsgListeners() {
     CHECK(mMsgListeners.empty()) << "Listeners list wasn't emptied";
 }
 
+void CanBus::flushBatch(CanMessageListener& listener) {
+    if (listener.pending.empty()) return;
+
+    hidl_vec<CanMessage> batch;
+    batch.setToExternal(listener.pending.data(), listener.pending.size());
+    if (!listener.batchCallback->onReceiveBatch(batch).isOk() && !listener.failedOnce) {
+        listener.failedOnce = true;
+        LOG(WARNING) << "Failed to notify listener about message batch";
+    }
+    listener.pending.clear();
+}
+
+void CanBus::batchFlushThread() {
+    std::unique_lock<std::mutex> lck(mMsgListenersGuard);
+    while (true) {
+        const auto now = std::chrono::steady_clock::now();
+        auto nextDeadline = std::chrono::steady_clock::time_point::max();
+        bool hasLatencyBound = false;
+        for (auto& listener : mMsgListeners) {
+            if (listener.batching.maxLatencyUs == 0) continue;
+            hasLatencyBound = true;
+            if (listener.pending.empty()) continue;
+            if (listener.deadline <= now) {
+                flushBatch(listener);
+            } else {
+                nextDeadline = std::min(nextDeadline, listener.deadline);
+            }
+        }
+
+        if (!hasLatencyBound) break;
+
+        if (nextDeadline == std::chrono::steady_clock::time_point::max()) {
+            mBatchFlushCv.wait(lck);
+        } else {
+            mBatchFlushCv.wait_until(lck, nextDeadline);
+        }
+    }
+    mBatchFlushThreadRunning = false;
+}
+
+void CanBus::joinBatchFlushThread() {
+    if (mBatchFlushThread.joinable()) mBatchFlushThread.join();
+}
+
 void CanBus::clearErrListeners() {
     std::lock_guard<std::mutex> lck(mErrListenersGuard);
     mErrListeners.clear();
@@ -203,6 +298,7 @@ bool CanBus::down() {
 
     clearMsgListeners();
     clearErrListeners();
+    joinBatchFlushThread();
     mSocket.reset();
 
     bool success = true;
@@ -321,6 +417,18 @@ void CanBus::onRead(const struct canfd_frame& frame, std::chrono::nanoseconds ti
         if (!match(listener.filter, message.id, message.remoteTransmissionRequest,
                    message.isExtendedId))
             continue;
+        if (listener.batchCallback != nullptr) {
+            listener.pending.push_back(message);
+            const auto& batching = listener.batching;
+            if (batching.maxMessages != 0 && listener.pending.size() >= batching.maxMessages) {
+                flushBatch(listener);
+            } else if (listener.pending.size() == 1 && batching.maxLatencyUs != 0) {
+                listener.deadline = std::chrono::steady_clock::now() +
+                                    std::chrono::microseconds(batching.maxLatencyUs);
+                mBatchFlushCv.notify_one();
+            }
+            continue;
+        }
         if (!listener.callback->onReceive(message).isOk() && !listener.failedOnce) {
             listener.failedOnce = true;
             LOG(WARNING) << "Failed to notify listener about message";
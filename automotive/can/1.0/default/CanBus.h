@@ -21,14 +21,16 @@
 #include <android-base/unique_fd.h>
 #include <android/hardware/automotive/can/1.0/ICanBus.h>
 #include <android/hardware/automotive/can/1.0/ICanController.h>
+#include <android/hardware/automotive/can/1.1/ICanBus.h>
 #include <utils/Mutex.h>
 
 #include <atomic>
+#include <condition_variable>
 #include <thread>
 
 namespace android::hardware::automotive::can::V1_0::implementation {
 
-struct CanBus : public ICanBus {
+struct CanBus : public V1_1::ICanBus {
     using ErrorCallback = std::function<void()>;
 
     virtual ~CanBus();
@@ -37,6 +39,10 @@ struct CanBus : public ICanBus {
     Return<void> listen(const hidl_vec<CanMessageFilter>& filter,
                         const sp<ICanMessageListener>& listener, listen_cb _hidl_cb) override;
     Return<sp<ICloseHandle>> listenForErrors(const sp<ICanErrorListener>& listener) override;
+    Return<void> listenBatched(const hidl_vec<CanMessageFilter>& filter,
+                               const V1_1::BatchingConfig& config,
+                               const sp<V1_1::ICanMessageListener>& listener,
+                               listenBatched_cb _hidl_cb) override;
 
     void setErrorCallback(ErrorCallback errcb);
     ICanController::Result up();
@@ -80,7 +86,23 @@ struct CanBus : public ICanBus {
         hidl_vec<CanMessageFilter> filter;
         wp<ICloseHandle> closeHandle;
         bool failedOnce = false;
+
+        /** Batched delivery target, or nullptr if messages are delivered one by one. */
+        sp<V1_1::ICanMessageListener> batchCallback;
+        V1_1::BatchingConfig batching = {};
+        /** Messages waiting for delivery; keeps its capacity between batches. */
+        std::vector<CanMessage> pending;
+        std::chrono::steady_clock::time_point deadline;
     };
+    sp<ICloseHandle> addMsgListener(const hidl_vec<CanMessageFilter>& filter,
+                                    const sp<ICanMessageListener>& callback,
+                                    const sp<V1_1::ICanMessageListener>& batchCallback,
+                                    const V1_1::BatchingConfig& batching)
+            REQUIRES(mMsgListenersGuard);
+    void flushBatch(CanMessageListener& listener) REQUIRES(mMsgListenersGuard);
+    void batchFlushThread();
+    /** Waits for the flush thread to exit, must be called after all listeners are closed. */
+    void joinBatchFlushThread();
     void clearMsgListeners();
     void clearErrListeners();
 
@@ -92,6 +114,14 @@ struct CanBus : public ICanBus {
     std::mutex mMsgListenersGuard;
     std::vector<CanMessageListener> mMsgListeners GUARDED_BY(mMsgListenersGuard);
 
+    /**
+     * Delivers batches whose latency budget expired. Started by listenBatched calls with a latency
+     * bound, and exits once no such listener is left.
+     */
+    std::thread mBatchFlushThread;
+    std::condition_variable mBatchFlushCv;
+    bool mBatchFlushThreadRunning GUARDED_BY(mMsgListenersGuard) = false;
+
     std::mutex mErrListenersGuard;
     std::vector<sp<ICanErrorListener>> mErrListeners GUARDED_BY(mErrListenersGuard);
 
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <libprotocan/MessageCodec.h>
+
+#include <android-base/logging.h>
+#include <endian.h>
+
+#include <cmath>
+
+namespace android::hardware::automotive::protocan {
+
+using can::V1_0::CanMessage;
+
+/** Largest CAN FD payload. */
+static constexpr size_t kMaxPayload = 64;
+
+/** Zero-filled payload copy, so 64-bit windows (and their spill-over byte) never read out of it. */
+struct PaddedPayload {
+  uint8_t data[kMaxPayload + sizeof(uint64_t) + 1];
+
+  PaddedPayload(const hidl_vec<uint8_t>& payload, size_t minLen) {
+    const auto len = std::min(payload.size(), kMaxPayload);
+    memcpy(data, payload.data(), len);
+    memset(data + len, 0, sizeof(data) - len);
+    CHECK(minLen <= kMaxPayload) << "Message length exceeds CAN FD payload";
+  }
+
+  uint64_t load(const SignalLayout& s) const {
+    uint64_t window;
+    memcpy(&window, data + s.byte, sizeof(window));
+    return s.order == ByteOrder::LittleEndian ? le64toh(window) : be64toh(window);
+  }
+
+  void store(const SignalLayout& s, uint64_t window) {
+    window = s.order == ByteOrder::LittleEndian ? htole64(window) : htobe64(window);
+    memcpy(data + s.byte, &window, sizeof(window));
+  }
+};
+
+static MessageCodec::raw extractRaw(const SignalLayout& s, const PaddedPayload& buf) {
+  const auto window = buf.load(s);
+  const uint8_t spill = buf.data[s.byte + sizeof(uint64_t)];
+
+  uint64_t v;
+  if (s.order == ByteOrder::LittleEndian) {
+    v = window >> s.shift;
+    if (s.spills()) v |= uint64_t(spill) << (64 - s.shift);
+  } else if (s.shift >= 0) {
+    v = window >> s.shift;
+  } else {
+    v = (window << -s.shift) | (spill >> (8 + s.shift));
+  }
+  v &= s.mask;
+
+  if (s.isSigned && s.length < 64) {
+    const uint64_t signBit = uint64_t(1) << (s.length - 1);
+    v = (v ^ signBit) - signBit;
+  }
+  return static_cast<MessageCodec::raw>(v);
+}
+
+static void insertRaw(const SignalLayout& s, PaddedPayload& buf, MessageCodec::raw val) {
+  const uint64_t v = static_cast<uint64_t>(val) & s.mask;
+  auto window = buf.load(s);
+  uint8_t& spill = buf.data[s.byte + sizeof(uint64_t)];
+
+  if (s.order == ByteOrder::LittleEndian) {
+    window = (window & ~(s.mask << s.shift)) | (v << s.shift);
+    if (s.spills()) {
+      const uint8_t spillMask = s.mask >> (64 - s.shift);
+      spill = (spill & ~spillMask) | ((v >> (64 - s.shift)) & spillMask);
+    }
+  } else if (s.shift >= 0) {
+    window = (window & ~(s.mask << s.shift)) | (v << s.shift);
+  } else {
+    const int spillBits = -s.shift;
+    window = (window & ~(s.mask >> spillBits)) | (v >> spillBits);
+    const uint8_t spillMask = ((1u << spillBits) - 1) << (8 - spillBits);
+    spill = (spill & ~spillMask) | ((v << (8 - spillBits)) & spillMask);
+  }
+
+  buf.store(s, window);
+}
+
+bool MessageCodec::decodeRaw(const CanMessage& msg, std::span<raw> values) const {
+  CHECK(values.size() >= signals.size()) << "Output is too small for all signals";
+  if (msg.payload.size() < len) return false;
+
+  const PaddedPayload buf(msg.payload, len);
+  for (size_t i = 0; i < signals.size(); i++) {
+    if (signals[i].minLen > msg.payload.size()) return false;
+    values[i] = extractRaw(signals[i], buf);
+  }
+  return true;
+}
+
+bool MessageCodec::decode(const CanMessage& msg, std::span<double> values) const {
+  CHECK(values.size() >= signals.size()) << "Output is too small for all signals";
+  if (msg.payload.size() < len) return false;
+
+  const PaddedPayload buf(msg.payload, len);
+  for (size_t i = 0; i < signals.size(); i++) {
+    const auto& s = signals[i];
+    if (s.minLen > msg.payload.size()) return false;
+    const auto v = extractRaw(s, buf);
+    const double rawVal = s.isSigned ? double(v) : double(static_cast<uint64_t>(v));
+    values[i] = rawVal * s.scale + s.offset;
+  }
+  return true;
+}
+
+void MessageCodec::encodeRaw(std::span<const raw> values, CanMessage& msg) const {
+  CHECK(values.size() >= signals.size()) << "Input is too small for all signals";
+  if (msg.payload.size() < len) msg.payload.resize(len);
+
+  PaddedPayload buf(msg.payload, len);
+  for (size_t i = 0; i < signals.size(); i++) {
+    CHECK(signals[i].minLen <= msg.payload.size())
+        << "Signal " << signals[i].name << " doesn't fit in message of length "
+        << msg.payload.size();
+    insertRaw(signals[i], buf, values[i]);
+  }
+  memcpy(msg.payload.data(), buf.data, std::min(msg.payload.size(), kMaxPayload));
+}
+
+void MessageCodec::encode(std::span<const double> values, CanMessage& msg) const {
+  CHECK(values.size() >= signals.size()) << "Input is too small for all signals";
+  if (msg.payload.size() < len) msg.payload.resize(len);
+
+  PaddedPayload buf(msg.payload, len);
+  for (size_t i = 0; i < signals.size(); i++) {
+    const auto& s = signals[i];
+    CHECK(s.minLen <= msg.payload.size())
+        << "Signal " << s.name << " doesn't fit in message of length " << msg.payload.size();
+    insertRaw(s, buf, std::llround((values[i] - s.offset) / s.scale));
+  }
+  memcpy(msg.payload.data(), buf.data, std::min(msg.payload.size(), kMaxPayload));
+}
+
+}  // namespace android::hardware::automotive::protocan
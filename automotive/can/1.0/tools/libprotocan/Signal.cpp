@@ -34,7 +34,7 @@ static uint8_t calculateFirstByteMask(uint16_t firstByte, uint8_t firstBit, uint
 }
 
 Signal::Signal(uint16_t start, uint8_t length, value defVal)
-    : maxValue((1u << length) - 1),
+    : maxValue(length >= 64 ? ~value(0) : (value(1) << length) - 1),
       kFirstByte(start / 8),
       kFirstBit(start % 8),
       kFirstByteBits(8 - kFirstBit),
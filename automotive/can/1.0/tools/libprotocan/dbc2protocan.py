@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2022 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Compiles message definitions from a DBC file into libprotocan MessageCodec tables.
+
+Only BO_ (message) and SG_ (signal) entries are used. A multiplexer switch (M) is compiled as a
+plain signal, but signals that depend on one (m<n>) can't be described by a MessageCodec, so they
+are an error unless --skip-multiplexed drops them.
+
+Usage: dbc2protocan.py input.dbc [--namespace ns] [--skip-multiplexed] > output.h
+"""
+
+import argparse
+import re
+import sys
+
+MESSAGE_RE = re.compile(r'^BO_\s+(\d+)\s+(\w+)\s*:\s*(\d+)\s+\w+')
+SIGNAL_RE = re.compile(
+    r'^SG_\s+(\w+)\s*(M|m\d+M?)?\s*:\s*(\d+)\|(\d+)@([01])([+-])\s*\(([^,]+),([^)]+)\)')
+
+HEADER = '''/*
+ * Generated by dbc2protocan.py from {source}. DO NOT EDIT.
+ */
+
+#pragma once
+
+#include <libprotocan/MessageCodec.h>
+
+namespace {namespace} {{
+
+using ::android::hardware::automotive::protocan::ByteOrder;
+using ::android::hardware::automotive::protocan::MessageCodec;
+using ::android::hardware::automotive::protocan::SignalLayout;
+'''
+
+FOOTER = '''
+}}  // namespace {namespace}
+'''
+
+
+def parse(lines, skipMultiplexed=False):
+    messages = []
+    for lineNo, line in enumerate(lines, 1):
+        line = line.strip()
+        m = MESSAGE_RE.match(line)
+        if m:
+            msgId = int(m.group(1))
+            # bit 31 marks extended frame IDs in DBC files
+            messages.append({'id': msgId & 0x1FFFFFFF, 'name': m.group(2),
+                             'len': int(m.group(3)), 'signals': []})
+            continue
+        # SG_MUL_VAL_ and the like share the prefix but aren't signal definitions
+        if not re.match(r'SG_\s', line):
+            continue
+        s = SIGNAL_RE.match(line)
+        if not s:
+            sys.exit('Line %d: malformed signal definition: %s' % (lineNo, line))
+        if not messages:
+            sys.exit('Signal %s defined outside of any message' % s.group(1))
+        if s.group(2) and s.group(2).startswith('m'):
+            where = 'Line %d: signal %s of %s is multiplexed (%s)' % (
+                lineNo, s.group(1), messages[-1]['name'], s.group(2))
+            if not skipMultiplexed:
+                sys.exit(where + ', use --skip-multiplexed to leave such signals out')
+            print('warning: %s, skipping it' % where, file=sys.stderr)
+            continue
+        messages[-1]['signals'].append({
+            'name': s.group(1), 'start': int(s.group(3)), 'length': int(s.group(4)),
+            'order': 'LittleEndian' if s.group(5) == '1' else 'BigEndian',
+            'signed': s.group(6) == '-',
+            'scale': float(s.group(7)), 'offset': float(s.group(8))})
+    return messages
+
+
+def emit(messages, source, namespace, out):
+    out.write(HEADER.format(source=source, namespace=namespace))
+    for msg in messages:
+        if not msg['signals']:
+            continue
+        out.write('\ninline constexpr SignalLayout k%sSignals[] = {\n' % msg['name'])
+        for sig in msg['signals']:
+            out.write('    {"%s", %d, %d, ByteOrder::%s, %s, %r, %r},\n' % (
+                sig['name'], sig['start'], sig['length'], sig['order'],
+                'true' if sig['signed'] else 'false', sig['scale'], sig['offset']))
+        out.write('};\n')
+        out.write('inline constexpr MessageCodec k%s(0x%X, %d, k%sSignals);\n' % (
+            msg['name'], msg['id'], msg['len'], msg['name']))
+        for i, sig in enumerate(msg['signals']):
+            out.write('inline constexpr size_t k%s_%s = %d;\n' % (msg['name'], sig['name'], i))
+    out.write(FOOTER.format(namespace=namespace))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('dbc', help='input DBC file')
+    parser.add_argument('--namespace', default='protocan_generated',
+                        help='C++ namespace for generated tables')
+    parser.add_argument('--skip-multiplexed', action='store_true',
+                        help='leave out multiplexed signals with a warning instead of failing')
+    args = parser.parse_args()
+
+    with open(args.dbc, encoding='latin-1') as f:
+        messages = parse(f, args.skip_multiplexed)
+    emit(messages, args.dbc.split('/')[-1], args.namespace, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
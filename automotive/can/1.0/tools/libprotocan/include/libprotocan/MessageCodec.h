@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <android/hardware/automotive/can/1.0/types.h>
+
+#include <span>
+
+namespace android::hardware::automotive::protocan {
+
+enum class ByteOrder : uint8_t {
+  LittleEndian,  ///< Intel byte order, start bit is the least significant bit
+  BigEndian,     ///< Motorola byte order, start bit is the most significant bit (DBC numbering)
+};
+
+/**
+ * Layout of a single signal within a message, with its bit shifts and masks resolved at compile
+ * time.
+ *
+ * Every signal is extracted from a single 64-bit window of the payload loaded at a precomputed byte
+ * offset (plus one spill-over byte for signals that don't fit in the window due to their bit
+ * offset), so decoding doesn't need any per-byte loops.
+ */
+struct SignalLayout {
+  const char* name;
+  double scale;
+  double offset;
+  uint64_t mask;     ///< Mask of the raw value (after shifting)
+  uint16_t byte;     ///< First byte of the 64-bit window
+  int8_t shift;      ///< Right shift of the window; negative if the signal spills over the window
+  uint8_t length;    ///< Signal length in bits
+  uint16_t minLen;   ///< Minimum payload length to hold the signal
+  ByteOrder order;
+  bool isSigned;
+
+  /**
+   * Resolve signal layout.
+   *
+   * \param name Signal name
+   * \param start Start bit, as in DBC files
+   * \param length Signal length in bits (1-64)
+   * \param order Byte order
+   * \param isSigned Whether the raw value is a two's complement signed integer
+   * \param scale Physical value scale
+   * \param offset Physical value offset
+   */
+  constexpr SignalLayout(const char* name, uint16_t start, uint8_t length,
+                         ByteOrder order = ByteOrder::LittleEndian, bool isSigned = false,
+                         double scale = 1.0, double offset = 0.0)
+      : name(name),
+        scale(scale),
+        offset(offset),
+        mask(length >= 64 ? ~uint64_t(0) : (uint64_t(1) << length) - 1),
+        byte(start / 8),
+        shift(order == ByteOrder::LittleEndian ? start % 8 : 56 + start % 8 + 1 - length),
+        length(length),
+        minLen(order == ByteOrder::LittleEndian
+                       ? (start + length - 1) / 8 + 1
+                       : start / 8 + (length + 6 - start % 8) / 8 + 1),
+        order(order),
+        isSigned(isSigned) {}
+
+  /** Whether the signal doesn't fit in the 64-bit window and needs one more byte. */
+  constexpr bool spills() const {
+    return order == ByteOrder::LittleEndian ? shift + length > 64 : shift < 0;
+  }
+};
+
+/**
+ * Message-level codec, decoding or encoding all signals of a message in a single pass.
+ *
+ * Unlike Signal, which is meant for occasional access to individual signals, this class is meant
+ * for bulk processing of bus traffic. Layouts may be written by hand or generated from a DBC file
+ * with dbc2protocan.py, in which case they're fully resolved at compile time.
+ */
+class MessageCodec {
+ public:
+  using raw = int64_t;
+
+  const can::V1_0::CanMessageId id;
+  const uint16_t len;
+  const std::span<const SignalLayout> signals;
+
+  constexpr MessageCodec(can::V1_0::CanMessageId id, uint16_t len,
+                         std::span<const SignalLayout> signals)
+      : id(id), len(len), signals(signals) {}
+
+  /**
+   * Decode raw values of all signals.
+   *
+   * Signed signals are sign-extended, unsigned ones are returned as is.
+   *
+   * \param msg Message to decode
+   * \param values Output for raw signal values, in the order of signal layouts
+   * \return false if the payload is too short for any of the signals, true otherwise
+   */
+  bool decodeRaw(const can::V1_0::CanMessage& msg, std::span<raw> values) const;
+
+  /**
+   * Decode physical (scaled and offset) values of all signals.
+   *
+   * \see decodeRaw
+   */
+  bool decode(const can::V1_0::CanMessage& msg, std::span<double> values) const;
+
+  /**
+   * Encode raw values of all signals in place.
+   *
+   * Payload bits not covered by any signal are left intact. The payload is resized to the message
+   * length if it's too short.
+   *
+   * \param values Raw signal values, in the order of signal layouts
+   * \param msg Message to update
+   */
+  void encodeRaw(std::span<const raw> values, can::V1_0::CanMessage& msg) const;
+
+  /**
+   * Encode physical values of all signals in place.
+   *
+   * \see encodeRaw
+   */
+  void encode(std::span<const double> values, can::V1_0::CanMessage& msg) const;
+};
+
+}  // namespace android::hardware::automotive::protocan
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <libprotocan/MessageCodec.h>
+#include <libprotocan/Signal.h>
+
+#include <android-base/file.h>
+#include <android-base/logging.h>
+#include <android-base/parseint.h>
+#include <android-base/strings.h>
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <random>
+
+/**
+ * Decodes a replayed bus log with MessageCodec and compares it with per-signal Signal::get calls.
+ *
+ * The log is read from the file pointed to by PROTOCAN_BUS_LOG environment variable, in candump
+ * format (i.e. "(1436509052.249713) can0 123#DEADBEEF" lines). If it's not set, a synthetic log is
+ * generated instead.
+ *
+ * Example invocation:
+ * adb shell PROTOCAN_BUS_LOG=/data/local/tmp/drive.log \
+ *     /data/benchmarktest64/libprotocan_codec_benchmark/libprotocan_codec_benchmark
+ */
+namespace android::hardware::automotive::protocan::benchmark {
+
+using can::V1_0::CanMessage;
+
+static constexpr SignalLayout kEngineSignals[] = {
+    {"speed", 0, 16, ByteOrder::LittleEndian, false, 0.125},
+    {"coolant", 16, 8, ByteOrder::LittleEndian, true, 1, -40},
+    {"throttle", 24, 10, ByteOrder::LittleEndian, false, 0.1},
+    {"load", 34, 7},
+    {"gear", 41, 4},
+    {"torque", 48, 16, ByteOrder::LittleEndian, true, 0.5},
+};
+
+static constexpr SignalLayout kWheelSignals[] = {
+    {"fl", 7, 16, ByteOrder::BigEndian, false, 0.01},
+    {"fr", 23, 16, ByteOrder::BigEndian, false, 0.01},
+    {"rl", 39, 16, ByteOrder::BigEndian, false, 0.01},
+    {"rr", 55, 16, ByteOrder::BigEndian, false, 0.01},
+};
+
+static constexpr SignalLayout kBodySignals[] = {
+    {"doors", 0, 4},       {"lights", 4, 3},   {"wipers", 7, 2},  {"hvac", 9, 5},
+    {"seatbelts", 14, 5},  {"locks", 19, 4},   {"mirror", 23, 9}, {"odometer", 32, 32},
+};
+
+static const std::map<can::V1_0::CanMessageId, MessageCodec> kCodecs = {
+    {0x100, MessageCodec(0x100, 8, kEngineSignals)},
+    {0x200, MessageCodec(0x200, 8, kWheelSignals)},
+    {0x300, MessageCodec(0x300, 8, kBodySignals)},
+};
+
+static std::optional<CanMessage> parseCandumpLine(const std::string& line) {
+  const auto fields = base::Split(base::Trim(line), " ");
+  if (fields.size() < 3) return std::nullopt;
+  const auto frame = base::Split(fields[2], "#");
+  if (frame.size() != 2 || frame[1].size() % 2 != 0) return std::nullopt;
+
+  CanMessage msg = {};
+  if (!base::ParseUint("0x" + frame[0], &msg.id)) return std::nullopt;
+  msg.payload.resize(frame[1].size() / 2);
+  for (size_t i = 0; i < msg.payload.size(); i++) {
+    if (!base::ParseUint("0x" + frame[1].substr(2 * i, 2), &msg.payload[i])) return std::nullopt;
+  }
+  return msg;
+}
+
+static std::vector<CanMessage> loadBusLog() {
+  std::vector<CanMessage> log;
+
+  const char* path = getenv("PROTOCAN_BUS_LOG");
+  if (path != nullptr) {
+    std::string contents;
+    CHECK(base::ReadFileToString(path, &contents)) << "Can't read " << path;
+    for (const auto& line : base::Split(contents, "\n")) {
+      auto msg = parseCandumpLine(line);
+      if (msg) log.push_back(std::move(*msg));
+    }
+    CHECK(!log.empty()) << "No frames found in " << path;
+    return log;
+  }
+
+  std::mt19937 rng(42);
+  const can::V1_0::CanMessageId ids[] = {0x100, 0x200, 0x300, 0x400};
+  for (unsigned i = 0; i < 10000; i++) {
+    CanMessage msg = {};
+    msg.id = ids[rng() % std::size(ids)];
+    msg.payload.resize(8);
+    for (auto& b : msg.payload) b = rng();
+    log.push_back(std::move(msg));
+  }
+  return log;
+}
+
+static const std::vector<CanMessage>& busLog() {
+  static const auto log = loadBusLog();
+  return log;
+}
+
+static void BM_MessageCodecDecode(::benchmark::State& state) {
+  const auto& log = busLog();
+  double values[std::size(kBodySignals)];
+
+  for (auto _ : state) {
+    for (const auto& msg : log) {
+      const auto it = kCodecs.find(msg.id);
+      if (it == kCodecs.end()) continue;
+      ::benchmark::DoNotOptimize(it->second.decode(msg, values));
+      ::benchmark::ClobberMemory();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * log.size());
+}
+BENCHMARK(BM_MessageCodecDecode);
+
+static void BM_SignalGet(::benchmark::State& state) {
+  std::map<can::V1_0::CanMessageId, std::vector<std::pair<Signal, double>>> signals;
+  for (const auto& [id, codec] : kCodecs) {
+    for (const auto& layout : codec.signals) {
+      if (layout.order != ByteOrder::LittleEndian) continue;  // not supported by Signal
+      signals[id].emplace_back(Signal(layout.byte * 8 + layout.shift, layout.length),
+                               layout.scale);
+    }
+  }
+
+  const auto& log = busLog();
+  for (auto _ : state) {
+    for (const auto& msg : log) {
+      const auto it = signals.find(msg.id);
+      if (it == signals.end() || msg.payload.size() < 8) continue;
+      for (const auto& [signal, scale] : it->second) {
+        ::benchmark::DoNotOptimize(signal.get(msg) * scale);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * log.size());
+}
+BENCHMARK(BM_SignalGet);
+
+}  // namespace android::hardware::automotive::protocan::benchmark
+
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <libprotocan/MessageCodec.h>
+#include <libprotocan/Signal.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace android::hardware::automotive::protocan::unittest {
+
+using can::V1_0::CanMessage;
+
+/* Data generated with Python3:
+ *
+ * from cantools.database.can import *
+ * md = Message(1, 'm', 8, [
+ *     Signal('le', 4, 20, byte_order='little_endian', is_signed=True),
+ *     Signal('be', 39, 12, byte_order='big_endian'),
+ *     Signal('phys', 48, 16, byte_order='little_endian', scale=0.125, offset=-100)])
+ * md.decode(b'\xde\xad\xbe\xef\x12\x34\x56\x78', scaling=False)
+ */
+static constexpr SignalLayout kTestSignals[] = {
+    {"le", 4, 20, ByteOrder::LittleEndian, true},
+    {"be", 39, 12, ByteOrder::BigEndian},
+    {"phys", 48, 16, ByteOrder::LittleEndian, false, 0.125, -100},
+};
+static constexpr MessageCodec kTestCodec(1, 8, kTestSignals);
+
+static CanMessage makeMessage(std::initializer_list<uint8_t> payload) {
+  CanMessage msg = {};
+  msg.payload = payload;
+  return msg;
+}
+
+TEST(MessageCodecTest, TestDecodeRaw) {
+  const auto msg = makeMessage({0xDE, 0xAD, 0xBE, 0xEF, 0x12, 0x34, 0x56, 0x78});
+
+  MessageCodec::raw values[3];
+  ASSERT_TRUE(kTestCodec.decodeRaw(msg, values));
+  ASSERT_EQ(-0x41523, values[0]);
+  ASSERT_EQ(0x123, values[1]);
+  ASSERT_EQ(0x7856, values[2]);
+}
+
+TEST(MessageCodecTest, TestDecodePhysical) {
+  const auto msg = makeMessage({0xDE, 0xAD, 0xBE, 0xEF, 0x12, 0x34, 0x56, 0x78});
+
+  double values[3];
+  ASSERT_TRUE(kTestCodec.decode(msg, values));
+  ASSERT_DOUBLE_EQ(0x7856 * 0.125 - 100, values[2]);
+}
+
+TEST(MessageCodecTest, TestDecodeTooShort) {
+  const auto msg = makeMessage({0xDE, 0xAD, 0xBE, 0xEF});
+
+  MessageCodec::raw values[3];
+  ASSERT_FALSE(kTestCodec.decodeRaw(msg, values));
+}
+
+TEST(MessageCodecTest, TestEncodeRoundTrip) {
+  const auto original = makeMessage({0xDE, 0xAD, 0xBE, 0xEF, 0x12, 0x34, 0x56, 0x78});
+
+  MessageCodec::raw values[3];
+  ASSERT_TRUE(kTestCodec.decodeRaw(original, values));
+
+  auto msg = makeMessage({0, 0, 0, 0, 0, 0, 0, 0});
+  kTestCodec.encodeRaw(values, msg);
+
+  MessageCodec::raw decoded[3];
+  ASSERT_TRUE(kTestCodec.decodeRaw(msg, decoded));
+  ASSERT_EQ(std::vector(values, values + 3), std::vector(decoded, decoded + 3));
+
+  // bits not covered by any signal must stay untouched
+  auto msgOnes = makeMessage({0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF});
+  kTestCodec.encodeRaw(values, msgOnes);
+  ASSERT_EQ(0x0F, msgOnes.payload[0] & 0x0F);
+  ASSERT_EQ(0x0F, msgOnes.payload[5] & 0x0F);
+}
+
+TEST(MessageCodecTest, TestEncodePhysical) {
+  auto msg = makeMessage({});
+  const double values[] = {-1, 0xABC, 42.5};
+  kTestCodec.encode(values, msg);
+  ASSERT_EQ(8u, msg.payload.size());
+
+  double decoded[3];
+  ASSERT_TRUE(kTestCodec.decode(msg, decoded));
+  ASSERT_DOUBLE_EQ(-1, decoded[0]);
+  ASSERT_DOUBLE_EQ(0xABC, decoded[1]);
+  ASSERT_DOUBLE_EQ(42.5, decoded[2]);
+}
+
+TEST(MessageCodecTest, TestSignalMaxValue) {
+  ASSERT_EQ(1u, Signal(0, 1).maxValue);
+  ASSERT_EQ(0xFFFFFFFFu, Signal(0, 32).maxValue);
+  ASSERT_EQ(0x1FFFFFFFFFFFFFFu, Signal(3, 57).maxValue);
+  ASSERT_EQ(~Signal::value(0), Signal(0, 64).maxValue);
+}
+
+TEST(MessageCodecTest, TestMatchesSignal) {
+  std::mt19937 rng(1);
+  CanMessage msg = {};
+  msg.payload.resize(16);
+  for (auto& b : msg.payload) b = rng();
+
+  for (uint16_t start = 0; start < 64; start++) {
+    for (uint8_t length = 1; length <= 64; length++) {
+      const SignalLayout layout[] = {{"s", start, length}};
+      const MessageCodec codec(1, 16, layout);
+      MessageCodec::raw value;
+      ASSERT_TRUE(codec.decodeRaw(msg, {&value, 1}));
+
+      ASSERT_EQ(Signal(start, length).get(msg), static_cast<Signal::value>(value))
+          << "start=" << start << " length=" << unsigned(length);
+    }
+  }
+}
+
+}  // namespace android::hardware::automotive::protocan::unittest
@@ -19,6 +19,7 @@
 #include <android/hardware/automotive/can/1.0/ICanBus.h>
 #include <android/hardware/automotive/can/1.0/ICanController.h>
 #include <android/hardware/automotive/can/1.0/types.h>
+#include <android/hardware/automotive/can/1.1/ICanBus.h>
 #include <android/hidl/manager/1.2/IServiceManager.h>
 #include <can-vts-utils/bus-enumerator.h>
 #include <can-vts-utils/can-hal-printers.h>
@@ -77,6 +78,60 @@ struct CanMessageListener : public can::V1_0::ICanMessageListener {
     std::vector<can::V1_0::CanMessage> mMessages GUARDED_BY(mMessagesGuard);
 };
 
+struct CanBatchListener : public can::V1_1::ICanMessageListener {
+    DISALLOW_COPY_AND_ASSIGN(CanBatchListener);
+
+    CanBatchListener() {}
+
+    virtual Return<void> onReceive(const can::V1_0::CanMessage&) override {
+        ADD_FAILURE() << "Batched listener got a non-batched message";
+        return {};
+    }
+
+    virtual Return<void> onReceiveBatch(const hidl_vec<can::V1_0::CanMessage>& msgs) override {
+        std::unique_lock<std::mutex> lk(mBatchesGuard);
+        mBatches.emplace_back(msgs.begin(), msgs.end());
+        mBatchesUpdated.notify_one();
+        return {};
+    }
+
+    virtual ~CanBatchListener() {
+        if (mCloseHandle) mCloseHandle->close();
+    }
+
+    void assignCloseHandle(sp<ICloseHandle> closeHandle) {
+        EXPECT_TRUE(closeHandle);
+        EXPECT_FALSE(mCloseHandle);
+        mCloseHandle = closeHandle;
+    }
+
+    void close() {
+        mCloseHandle->close();
+        mCloseHandle = nullptr;
+    }
+
+    /** Waits until batches with at least \p atLeastMessages messages in total were received. */
+    std::vector<std::vector<can::V1_0::CanMessage>> fetchBatches(std::chrono::milliseconds timeout,
+                                                                 size_t atLeastMessages = 1) {
+        std::unique_lock<std::mutex> lk(mBatchesGuard);
+        mBatchesUpdated.wait_for(lk, timeout, [&] {
+            size_t messages = 0;
+            for (const auto& batch : mBatches) messages += batch.size();
+            return messages >= atLeastMessages;
+        });
+        const auto batches = mBatches;
+        mBatches.clear();
+        return batches;
+    }
+
+  private:
+    sp<ICloseHandle> mCloseHandle;
+
+    std::mutex mBatchesGuard;
+    std::condition_variable mBatchesUpdated GUARDED_BY(mBatchesGuard);
+    std::vector<std::vector<can::V1_0::CanMessage>> mBatches GUARDED_BY(mBatchesGuard);
+};
+
 struct Bus {
     DISALLOW_COPY_AND_ASSIGN(Bus);
 
@@ -119,6 +174,24 @@ struct Bus {
         return listener;
     }
 
+    /** Returns nullptr if the bus doesn't support batched delivery. */
+    sp<CanBatchListener> listenBatched(const hidl_vec<CanMessageFilter>& filter,
+                                       const can::V1_1::BatchingConfig& config) {
+        auto bus = can::V1_1::ICanBus::castFrom(mBus);
+        if (!bus) return nullptr;
+
+        sp<CanBatchListener> listener = new CanBatchListener();
+
+        Result result;
+        sp<ICloseHandle> closeHandle;
+        bus->listenBatched(filter, config, listener, hidl_utils::fill(&result, &closeHandle))
+                .assertOk();
+        EXPECT_EQ(Result::OK, result);
+        listener->assignCloseHandle(closeHandle);
+
+        return listener;
+    }
+
     void send(const CanMessage& msg) {
         EXPECT_NE(mBus, nullptr);
         if (!mBus) return;
@@ -236,6 +309,59 @@ TEST_P(CanBusVirtualHalTest, SendAndRecv) {
     ASSERT_EQ(msg, messages[0]);
 }
 
+TEST_P(CanBusVirtualHalTest, SendAndRecvBatched) {
+    if (mBusNames.size() < 2u) GTEST_SKIP() << "Not testable with less than two CAN buses.";
+    auto bus1 = makeBus();
+    auto bus2 = makeBus();
+
+    /* The count limit caps batches at three messages. As five are sent, the last ones are only
+     * delivered once the latency limit flushes them, however long sending takes. */
+    auto listener = bus2.listenBatched({}, {.maxLatencyUs = 20000, .maxMessages = 3});
+    if (!listener) GTEST_SKIP() << "Batched delivery not supported.";
+
+    std::vector<can::V1_0::CanMessage> sent;
+    for (uint8_t i = 0; i < 5; i++) {
+        CanMessage msg = {};
+        msg.id = 0x123;
+        msg.payload = {i};
+        bus1.send(msg);
+        sent.push_back(msg);
+    }
+
+    auto batches = listener->fetchBatches(5s, sent.size());
+    std::vector<can::V1_0::CanMessage> received;
+    for (auto& batch : batches) {
+        EXPECT_LE(batch.size(), 3u);
+        received.insert(received.end(), batch.begin(), batch.end());
+    }
+    clearTimestamps(received);
+    ASSERT_EQ(sent, received);
+}
+
+TEST_P(CanBusVirtualHalTest, RecvBatchedAfterRelisten) {
+    if (mBusNames.size() < 2u) GTEST_SKIP() << "Not testable with less than two CAN buses.";
+    auto bus1 = makeBus();
+    auto bus2 = makeBus();
+
+    // closing the only latency-bounded listener must not stop later ones from being flushed
+    for (uint8_t i = 0; i < 2; i++) {
+        auto listener = bus2.listenBatched({}, {.maxLatencyUs = 20000, .maxMessages = 0});
+        if (!listener) GTEST_SKIP() << "Batched delivery not supported.";
+
+        CanMessage msg = {};
+        msg.id = 0x123;
+        msg.payload = {i};
+        bus1.send(msg);
+
+        auto batches = listener->fetchBatches(5s);
+        ASSERT_EQ(1u, batches.size());
+        ASSERT_EQ(1u, batches[0].size());
+        clearTimestamps(batches[0]);
+        ASSERT_EQ(msg, batches[0][0]);
+        listener->close();
+    }
+}
+
 TEST_P(CanBusVirtualHalTest, DownOneOfTwo) {
     if (mBusNames.size() < 2u) GTEST_SKIP() << "Not testable with less than two CAN buses.";
 
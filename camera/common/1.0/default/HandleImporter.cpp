@@ -39,22 +39,63 @@ using MapperErrorV4 = android::hardware::graphics::mapper::V4_0::Error;
 using IMapperV3 = android::hardware::graphics::mapper::V3_0::IMapper;
 using IMapperV4 = android::hardware::graphics::mapper::V4_0::IMapper;
 
-HandleImporter::HandleImporter() : mInitialized(false) {}
+template <>
+const sp<IMapper>& HandleImporter::getMapper<IMapper>() const {
+    return mMapperV2;
+}
+
+template <>
+const sp<IMapperV3>& HandleImporter::getMapper<IMapperV3>() const {
+    return mMapperV3;
+}
+
+template <>
+const sp<IMapperV4>& HandleImporter::getMapper<IMapperV4>() const {
+    return mMapperV4;
+}
+
+// Specialized below, declared before kMapperOps takes their address
+template <>
+void* HandleImporter::lockInternal<IMapperV3, MapperErrorV3>(
+        buffer_handle_t& buf, uint64_t cpuUsage, const IMapper::Rect& accessRegion);
+template <>
+YCbCrLayout HandleImporter::lockYCbCrInternal<IMapperV4, MapperErrorV4>(
+        buffer_handle_t& buf, uint64_t cpuUsage, const IMapper::Rect& accessRegion);
+
+template <class M, class E>
+const HandleImporter::MapperOps HandleImporter::kMapperOps = {
+        &HandleImporter::lockInternal<M, E>,
+        &HandleImporter::lockYCbCrInternal<M, E>,
+        &HandleImporter::unlockInternal<M, E>,
+};
+
+HandleImporter::HandleImporter() : mMapperOps(nullptr) {}
+
+const HandleImporter::MapperOps* HandleImporter::getMapperOps() {
+    const MapperOps* ops = mMapperOps.load(std::memory_order_acquire);
+    if (ops == nullptr) {
+        Mutex::Autolock lock(mLock);
+        initializeLocked();
+        ops = mMapperOps.load(std::memory_order_relaxed);
+    }
+    return ops;
+}
 
 void HandleImporter::initializeLocked() {
-    if (mInitialized) {
+    if (mMapperOps.load(std::memory_order_relaxed) != nullptr) {
         return;
     }
 
+    // The mappers are published by the release store of mMapperOps
     mMapperV4 = IMapperV4::getService();
     if (mMapperV4 != nullptr) {
-        mInitialized = true;
+        mMapperOps.store(&kMapperOps<IMapperV4, MapperErrorV4>, std::memory_order_release);
         return;
     }
 
     mMapperV3 = IMapperV3::getService();
     if (mMapperV3 != nullptr) {
-        mInitialized = true;
+        mMapperOps.store(&kMapperOps<IMapperV3, MapperErrorV3>, std::memory_order_release);
         return;
     }
 
@@ -64,15 +105,15 @@ void HandleImporter::initializeLocked() {
         return;
     }
 
-    mInitialized = true;
+    mMapperOps.store(&kMapperOps<IMapper, MapperErrorV2>, std::memory_order_release);
     return;
 }
 
 void HandleImporter::cleanup() {
+    mMapperOps.store(nullptr, std::memory_order_relaxed);
     mMapperV4.clear();
     mMapperV3.clear();
     mMapperV2.clear();
-    mInitialized = false;
 }
 
 template<class M, class E>
@@ -101,15 +142,56 @@ bool HandleImporter::importBufferInternal(const sp<M> mapper, buffer_handle_t& h
 }
 
 template<class M, class E>
-YCbCrLayout HandleImporter::lockYCbCrInternal(const sp<M> mapper, buffer_handle_t& buf,
+void* HandleImporter::lockInternal(buffer_handle_t& buf, uint64_t cpuUsage,
+        const IMapper::Rect& accessRegion) {
+    hidl_handle acquireFenceHandle;
+    auto buffer = const_cast<native_handle_t*>(buf);
+    void* ret = nullptr;
+
+    typename M::Rect accessRegionCopy = {accessRegion.left, accessRegion.top,
+            accessRegion.width, accessRegion.height};
+    getMapper<M>()->lock(buffer, cpuUsage, accessRegionCopy, acquireFenceHandle,
+            [&](const auto& tmpError, const auto& tmpPtr) {
+                if (tmpError == E::NONE) {
+                    ret = tmpPtr;
+                } else {
+                    ALOGE("%s: failed to lock error %d!", __FUNCTION__, tmpError);
+                }
+           });
+    return ret;
+}
+
+template <>
+void* HandleImporter::lockInternal<IMapperV3, MapperErrorV3>(buffer_handle_t& buf,
         uint64_t cpuUsage, const IMapper::Rect& accessRegion) {
     hidl_handle acquireFenceHandle;
     auto buffer = const_cast<native_handle_t*>(buf);
+    void* ret = nullptr;
+
+    IMapperV3::Rect accessRegionV3{accessRegion.left, accessRegion.top, accessRegion.width,
+                                   accessRegion.height};
+    mMapperV3->lock(buffer, cpuUsage, accessRegionV3, acquireFenceHandle,
+                    [&](const auto& tmpError, const auto& tmpPtr, const auto& /*bytesPerPixel*/,
+                        const auto& /*bytesPerStride*/) {
+                        if (tmpError == MapperErrorV3::NONE) {
+                            ret = tmpPtr;
+                        } else {
+                            ALOGE("%s: failed to lock error %d!", __FUNCTION__, tmpError);
+                        }
+                    });
+    return ret;
+}
+
+template<class M, class E>
+YCbCrLayout HandleImporter::lockYCbCrInternal(buffer_handle_t& buf, uint64_t cpuUsage,
+        const IMapper::Rect& accessRegion) {
+    hidl_handle acquireFenceHandle;
+    auto buffer = const_cast<native_handle_t*>(buf);
     YCbCrLayout layout = {};
 
     typename M::Rect accessRegionCopy = {accessRegion.left, accessRegion.top,
             accessRegion.width, accessRegion.height};
-    mapper->lockYCbCr(buffer, cpuUsage, accessRegionCopy, acquireFenceHandle,
+    getMapper<M>()->lockYCbCr(buffer, cpuUsage, accessRegionCopy, acquireFenceHandle,
             [&](const auto& tmpError, const auto& tmpLayout) {
                 if (tmpError == E::NONE) {
                     // Member by member copy from different versions of YCbCrLayout.
@@ -178,31 +260,39 @@ std::vector<PlaneLayout> getPlaneLayouts(const sp<IMapperV4> mapper, buffer_hand
     return planeLayouts;
 }
 
-template <>
-YCbCrLayout HandleImporter::lockYCbCrInternal<IMapperV4, MapperErrorV4>(
-        const sp<IMapperV4> mapper, buffer_handle_t& buf, uint64_t cpuUsage,
-        const IMapper::Rect& accessRegion) {
-    hidl_handle acquireFenceHandle;
+bool getBufferId(const sp<IMapperV4> mapper, const buffer_handle_t& buf, uint64_t* outBufferId) {
     auto buffer = const_cast<native_handle_t*>(buf);
-    YCbCrLayout layout = {};
-    void* mapped = nullptr;
-
-    typename IMapperV4::Rect accessRegionV4 = {accessRegion.left, accessRegion.top,
-                                               accessRegion.width, accessRegion.height};
-    mapper->lock(buffer, cpuUsage, accessRegionV4, acquireFenceHandle,
-                 [&](const auto& tmpError, const auto& tmpPtr) {
-                     if (tmpError == MapperErrorV4::NONE) {
-                         mapped = tmpPtr;
-                     } else {
-                         ALOGE("%s: failed to lock error %d!", __FUNCTION__, tmpError);
-                     }
-                 });
+    hidl_vec<uint8_t> encodedBufferId;
+    mapper->get(buffer, gralloc4::MetadataType_BufferId,
+                [&](const auto& tmpError, const auto& tmpEncodedBufferId) {
+                    if (tmpError == MapperErrorV4::NONE) {
+                        encodedBufferId = tmpEncodedBufferId;
+                    } else {
+                        ALOGE("%s: failed to get buffer id %d!", __FUNCTION__, tmpError);
+                    }
+                });
 
-    if (mapped == nullptr) {
-        return layout;
+    return encodedBufferId.size() > 0 &&
+           gralloc4::decodeBufferId(encodedBufferId, outBufferId) == OK;
+}
+
+HandleImporter::PlaneLayoutInfo HandleImporter::getPlaneLayoutInfo(buffer_handle_t& buf) {
+    uint64_t bufferId = 0;
+    bool hasBufferId = getBufferId(mMapperV4, buf, &bufferId);
+    if (hasBufferId) {
+        Mutex::Autolock lock(mPlaneLayoutLock);
+        auto cached = mPlaneLayoutCache.find(bufferId);
+        if (cached != mPlaneLayoutCache.end()) {
+            return cached->second;
+        }
     }
 
-    std::vector<PlaneLayout> planeLayouts = getPlaneLayouts(mapper, buf);
+    PlaneLayoutInfo info;
+    std::vector<PlaneLayout> planeLayouts = getPlaneLayouts(mMapperV4, buf);
+    info.numPlanes = planeLayouts.size();
+    if (!planeLayouts.empty()) {
+        info.firstPlaneStride = planeLayouts[0].strideInBytes;
+    }
     for (const auto& planeLayout : planeLayouts) {
         for (const auto& planeLayoutComponent : planeLayout.components) {
             const auto& type = planeLayoutComponent.type;
@@ -211,24 +301,22 @@ YCbCrLayout HandleImporter::lockYCbCrInternal<IMapperV4, MapperErrorV4>(
                 continue;
             }
 
-            uint8_t* data = reinterpret_cast<uint8_t*>(mapped);
-            data += planeLayout.offsetInBytes;
-            data += planeLayoutComponent.offsetInBits / 8;
+            int64_t offset = planeLayout.offsetInBytes + planeLayoutComponent.offsetInBits / 8;
 
             switch (static_cast<PlaneLayoutComponentType>(type.value)) {
                 case PlaneLayoutComponentType::Y:
-                    layout.y = data;
-                    layout.yStride = planeLayout.strideInBytes;
+                    info.yOffset = offset;
+                    info.yStride = planeLayout.strideInBytes;
                     break;
                 case PlaneLayoutComponentType::CB:
-                    layout.cb = data;
-                    layout.cStride = planeLayout.strideInBytes;
-                    layout.chromaStep = planeLayout.sampleIncrementInBits / 8;
+                    info.cbOffset = offset;
+                    info.cStride = planeLayout.strideInBytes;
+                    info.chromaStep = planeLayout.sampleIncrementInBits / 8;
                     break;
                 case PlaneLayoutComponentType::CR:
-                    layout.cr = data;
-                    layout.cStride = planeLayout.strideInBytes;
-                    layout.chromaStep = planeLayout.sampleIncrementInBits / 8;
+                    info.crOffset = offset;
+                    info.cStride = planeLayout.strideInBytes;
+                    info.chromaStep = planeLayout.sampleIncrementInBits / 8;
                     break;
                 default:
                     break;
@@ -236,15 +324,49 @@ YCbCrLayout HandleImporter::lockYCbCrInternal<IMapperV4, MapperErrorV4>(
         }
     }
 
+    if (hasBufferId) {
+        Mutex::Autolock lock(mPlaneLayoutLock);
+        if (mPlaneLayoutCache.size() >= kMaxPlaneLayoutCacheSize) {
+            mPlaneLayoutCache.clear();
+        }
+        mPlaneLayoutCache.emplace(bufferId, info);
+    }
+    return info;
+}
+
+template <>
+YCbCrLayout HandleImporter::lockYCbCrInternal<IMapperV4, MapperErrorV4>(
+        buffer_handle_t& buf, uint64_t cpuUsage, const IMapper::Rect& accessRegion) {
+    YCbCrLayout layout = {};
+    void* mapped = lockInternal<IMapperV4, MapperErrorV4>(buf, cpuUsage, accessRegion);
+    if (mapped == nullptr) {
+        return layout;
+    }
+
+    PlaneLayoutInfo info = getPlaneLayoutInfo(buf);
+    uint8_t* data = reinterpret_cast<uint8_t*>(mapped);
+    if (info.yOffset >= 0) {
+        layout.y = data + info.yOffset;
+    }
+    if (info.cbOffset >= 0) {
+        layout.cb = data + info.cbOffset;
+    }
+    if (info.crOffset >= 0) {
+        layout.cr = data + info.crOffset;
+    }
+    layout.yStride = info.yStride;
+    layout.cStride = info.cStride;
+    layout.chromaStep = info.chromaStep;
+
     return layout;
 }
 
 template<class M, class E>
-int HandleImporter::unlockInternal(const sp<M> mapper, buffer_handle_t& buf) {
+int HandleImporter::unlockInternal(buffer_handle_t& buf) {
     int releaseFence = -1;
     auto buffer = const_cast<native_handle_t*>(buf);
 
-    mapper->unlock(
+    getMapper<M>()->unlock(
         buffer, [&](const auto& tmpError, const auto& tmpReleaseFence) {
             if (tmpError == E::NONE) {
                 auto fenceHandle = tmpReleaseFence.getNativeHandle();
@@ -276,10 +398,7 @@ bool HandleImporter::importBuffer(buffer_handle_t& handle) {
         return true;
     }
 
-    Mutex::Autolock lock(mLock);
-    if (!mInitialized) {
-        initializeLocked();
-    }
+    getMapperOps();
 
     if (mMapperV4 != nullptr) {
         return importBufferInternal<IMapperV4, MapperErrorV4>(mMapperV4, handle);
@@ -302,12 +421,14 @@ void HandleImporter::freeBuffer(buffer_handle_t handle) {
         return;
     }
 
-    Mutex::Autolock lock(mLock);
-    if (!mInitialized) {
-        initializeLocked();
-    }
+    getMapperOps();
 
     if (mMapperV4 != nullptr) {
+        uint64_t bufferId;
+        if (getBufferId(mMapperV4, handle, &bufferId)) {
+            Mutex::Autolock lock(mPlaneLayoutLock);
+            mPlaneLayoutCache.erase(bufferId);
+        }
         auto ret = mMapperV4->freeBuffer(const_cast<native_handle_t*>(handle));
         if (!ret.isOk()) {
             ALOGE("%s: mapper freeBuffer failed: %s", __FUNCTION__, ret.description().c_str());
@@ -359,56 +480,13 @@ void* HandleImporter::lock(
 
 void* HandleImporter::lock(buffer_handle_t& buf, uint64_t cpuUsage,
                            const IMapper::Rect& accessRegion) {
-    Mutex::Autolock lock(mLock);
-
-    if (!mInitialized) {
-        initializeLocked();
-    }
-
-    void* ret = nullptr;
-
-    if (mMapperV4 == nullptr && mMapperV3 == nullptr && mMapperV2 == nullptr) {
+    const MapperOps* ops = getMapperOps();
+    if (ops == nullptr) {
         ALOGE("%s: mMapperV4, mMapperV3 and mMapperV2 are all null!", __FUNCTION__);
-        return ret;
+        return nullptr;
     }
 
-    hidl_handle acquireFenceHandle;
-    auto buffer = const_cast<native_handle_t*>(buf);
-    if (mMapperV4 != nullptr) {
-        IMapperV4::Rect accessRegionV4{accessRegion.left, accessRegion.top, accessRegion.width,
-                                       accessRegion.height};
-
-        mMapperV4->lock(buffer, cpuUsage, accessRegionV4, acquireFenceHandle,
-                        [&](const auto& tmpError, const auto& tmpPtr) {
-                            if (tmpError == MapperErrorV4::NONE) {
-                                ret = tmpPtr;
-                            } else {
-                                ALOGE("%s: failed to lock error %d!", __FUNCTION__, tmpError);
-                            }
-                        });
-    } else if (mMapperV3 != nullptr) {
-        IMapperV3::Rect accessRegionV3{accessRegion.left, accessRegion.top, accessRegion.width,
-                                       accessRegion.height};
-
-        mMapperV3->lock(buffer, cpuUsage, accessRegionV3, acquireFenceHandle,
-                        [&](const auto& tmpError, const auto& tmpPtr, const auto& /*bytesPerPixel*/,
-                            const auto& /*bytesPerStride*/) {
-                            if (tmpError == MapperErrorV3::NONE) {
-                                ret = tmpPtr;
-                            } else {
-                                ALOGE("%s: failed to lock error %d!", __FUNCTION__, tmpError);
-                            }
-                        });
-    } else {
-        mMapperV2->lock(buffer, cpuUsage, accessRegion, acquireFenceHandle,
-                [&](const auto& tmpError, const auto& tmpPtr) {
-                    if (tmpError == MapperErrorV2::NONE) {
-                        ret = tmpPtr;
-                    } else {
-                        ALOGE("%s: failed to lock error %d!", __FUNCTION__, tmpError);
-                    }
-               });
-    }
+    void* ret = (this->*ops->lock)(buf, cpuUsage, accessRegion);
 
     ALOGV("%s: ptr %p accessRegion.top: %d accessRegion.left: %d accessRegion.width: %d "
           "accessRegion.height: %d",
@@ -420,28 +498,13 @@ void* HandleImporter::lock(buffer_handle_t& buf, uint64_t cpuUsage,
 YCbCrLayout HandleImporter::lockYCbCr(
         buffer_handle_t& buf, uint64_t cpuUsage,
         const IMapper::Rect& accessRegion) {
-    Mutex::Autolock lock(mLock);
-
-    if (!mInitialized) {
-        initializeLocked();
-    }
-
-    if (mMapperV4 != nullptr) {
-        return lockYCbCrInternal<IMapperV4, MapperErrorV4>(mMapperV4, buf, cpuUsage, accessRegion);
-    }
-
-    if (mMapperV3 != nullptr) {
-        return lockYCbCrInternal<IMapperV3, MapperErrorV3>(
-                mMapperV3, buf, cpuUsage, accessRegion);
-    }
-
-    if (mMapperV2 != nullptr) {
-        return lockYCbCrInternal<IMapper, MapperErrorV2>(
-                mMapperV2, buf, cpuUsage, accessRegion);
+    const MapperOps* ops = getMapperOps();
+    if (ops == nullptr) {
+        ALOGE("%s: mMapperV4, mMapperV3 and mMapperV2 are all null!", __FUNCTION__);
+        return {};
     }
 
-    ALOGE("%s: mMapperV4, mMapperV3 and mMapperV2 are all null!", __FUNCTION__);
-    return {};
+    return (this->*ops->lockYCbCr)(buf, cpuUsage, accessRegion);
 }
 
 status_t HandleImporter::getMonoPlanarStrideBytes(buffer_handle_t &buf, uint32_t *stride /*out*/) {
@@ -449,20 +512,16 @@ status_t HandleImporter::getMonoPlanarStrideBytes(buffer_handle_t &buf, uint32_t
         return BAD_VALUE;
     }
 
-    Mutex::Autolock lock(mLock);
-
-    if (!mInitialized) {
-        initializeLocked();
-    }
+    getMapperOps();
 
     if (mMapperV4 != nullptr) {
-        std::vector<PlaneLayout> planeLayouts = getPlaneLayouts(mMapperV4, buf);
-        if (planeLayouts.size() != 1) {
-            ALOGE("%s: Unexpected number of planes %zu!",  __FUNCTION__, planeLayouts.size());
+        PlaneLayoutInfo info = getPlaneLayoutInfo(buf);
+        if (info.numPlanes != 1) {
+            ALOGE("%s: Unexpected number of planes %zu!",  __FUNCTION__, info.numPlanes);
             return BAD_VALUE;
         }
 
-        *stride = planeLayouts[0].strideInBytes;
+        *stride = info.firstPlaneStride;
     } else {
         ALOGE("%s: mMapperV4 is null! Query not supported!", __FUNCTION__);
         return NO_INIT;
@@ -472,26 +531,17 @@ status_t HandleImporter::getMonoPlanarStrideBytes(buffer_handle_t &buf, uint32_t
 }
 
 int HandleImporter::unlock(buffer_handle_t& buf) {
-    if (mMapperV4 != nullptr) {
-        return unlockInternal<IMapperV4, MapperErrorV4>(mMapperV4, buf);
-    }
-    if (mMapperV3 != nullptr) {
-        return unlockInternal<IMapperV3, MapperErrorV3>(mMapperV3, buf);
-    }
-    if (mMapperV2 != nullptr) {
-        return unlockInternal<IMapper, MapperErrorV2>(mMapperV2, buf);
+    const MapperOps* ops = getMapperOps();
+    if (ops == nullptr) {
+        ALOGE("%s: mMapperV4, mMapperV3 and mMapperV2 are all null!", __FUNCTION__);
+        return -1;
     }
 
-    ALOGE("%s: mMapperV4, mMapperV3 and mMapperV2 are all null!", __FUNCTION__);
-    return -1;
+    return (this->*ops->unlock)(buf);
 }
 
 bool HandleImporter::isSmpte2086Present(const buffer_handle_t& buf) {
-    Mutex::Autolock lock(mLock);
-
-    if (!mInitialized) {
-        initializeLocked();
-    }
+    getMapperOps();
 
     if (mMapperV4 != nullptr) {
         return isMetadataPesent(mMapperV4, buf, gralloc4::MetadataType_Smpte2086);
@@ -503,11 +553,7 @@ bool HandleImporter::isSmpte2086Present(const buffer_handle_t& buf) {
 }
 
 bool HandleImporter::isSmpte2094_10Present(const buffer_handle_t& buf) {
-    Mutex::Autolock lock(mLock);
-
-    if (!mInitialized) {
-        initializeLocked();
-    }
+    getMapperOps();
 
     if (mMapperV4 != nullptr) {
         return isMetadataPesent(mMapperV4, buf, gralloc4::MetadataType_Smpte2094_10);
@@ -519,11 +565,7 @@ bool HandleImporter::isSmpte2094_10Present(const buffer_handle_t& buf) {
 }
 
 bool HandleImporter::isSmpte2094_40Present(const buffer_handle_t& buf) {
-    Mutex::Autolock lock(mLock);
-
-    if (!mInitialized) {
-        initializeLocked();
-    }
+    getMapperOps();
 
     if (mMapperV4 != nullptr) {
         return isMetadataPesent(mMapperV4, buf, gralloc4::MetadataType_Smpte2094_40);
@@ -23,6 +23,9 @@
 #include <cutils/native_handle.h>
 #include <utils/Mutex.h>
 
+#include <atomic>
+#include <unordered_map>
+
 using android::hardware::graphics::mapper::V2_0::IMapper;
 using android::hardware::graphics::mapper::V2_0::YCbCrLayout;
 
@@ -67,22 +70,65 @@ public:
     bool isSmpte2094_40Present(const buffer_handle_t& buf);
 
 private:
+    // The lock calls of the mapper version picked by initializeLocked(). Buffers are locked and
+    // unlocked through it without taking mLock.
+    struct MapperOps {
+        void* (HandleImporter::*lock)(buffer_handle_t& buf, uint64_t cpuUsage,
+                                      const IMapper::Rect& accessRegion);
+        YCbCrLayout (HandleImporter::*lockYCbCr)(buffer_handle_t& buf, uint64_t cpuUsage,
+                                                 const IMapper::Rect& accessRegion);
+        int (HandleImporter::*unlock)(buffer_handle_t& buf);
+    };
+
+    template<class M, class E>
+    static const MapperOps kMapperOps;
+
+    // What lockYCbCr() and getMonoPlanarStrideBytes() need from the plane layouts of a buffer.
+    // Offsets are in bytes from the locked address, -1 for a missing component.
+    struct PlaneLayoutInfo {
+        size_t numPlanes = 0;
+        int64_t firstPlaneStride = 0;
+        int64_t yOffset = -1;
+        int64_t cbOffset = -1;
+        int64_t crOffset = -1;
+        uint32_t yStride = 0;
+        uint32_t cStride = 0;
+        uint32_t chromaStep = 0;
+    };
+
+    // Returns nullptr if no mapper is available.
+    const MapperOps* getMapperOps();
     void initializeLocked();
     void cleanup();
 
+    template<class M>
+    const sp<M>& getMapper() const;
+
     template<class M, class E>
     bool importBufferInternal(const sp<M> mapper, buffer_handle_t& handle);
     template<class M, class E>
-    YCbCrLayout lockYCbCrInternal(const sp<M> mapper, buffer_handle_t& buf, uint64_t cpuUsage,
+    void* lockInternal(buffer_handle_t& buf, uint64_t cpuUsage,
             const IMapper::Rect& accessRegion);
     template<class M, class E>
-    int unlockInternal(const sp<M> mapper, buffer_handle_t& buf);
+    YCbCrLayout lockYCbCrInternal(buffer_handle_t& buf, uint64_t cpuUsage,
+            const IMapper::Rect& accessRegion);
+    template<class M, class E>
+    int unlockInternal(buffer_handle_t& buf);
+
+    // Mapper 4.0 only. Plane layouts are cached by buffer id, which is unique for the lifetime
+    // of the process.
+    PlaneLayoutInfo getPlaneLayoutInfo(buffer_handle_t& buf);
 
     Mutex mLock;
-    bool mInitialized;
+    std::atomic<const MapperOps*> mMapperOps;
     sp<IMapper> mMapperV2;
     sp<graphics::mapper::V3_0::IMapper> mMapperV3;
     sp<graphics::mapper::V4_0::IMapper> mMapperV4;
+
+    // Cleared once it holds kMaxPlaneLayoutCacheSize buffers that were never freed
+    static constexpr size_t kMaxPlaneLayoutCacheSize = 256;
+    Mutex mPlaneLayoutLock;
+    std::unordered_map<uint64_t, PlaneLayoutInfo> mPlaneLayoutCache;
 };
 
 } // namespace helper
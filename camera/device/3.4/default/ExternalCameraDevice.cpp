@@ -24,7 +24,11 @@
 #include <linux/videodev2.h>
 #include <linux/v4l2-subdev.h>
 #include <linux/videodev2.h>
+#include <stdio.h>
+#include "android-base/file.h"
 #include "android-base/macros.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
 #include "CameraMetadata.h"
 #include "../../3.2/default/include/convert.h"
 #include "ExternalCameraDevice_3_4.h"
@@ -55,6 +59,65 @@ const std::array<uint32_t, /*size*/ 7> kSupportedFourCCs{
 constexpr int MAX_RETRY = 5; // Allow retry v4l2 open failures a few times.
 constexpr int OPEN_RETRY_SLEEP_US = 100000; // 100ms * MAX_RETRY = 0.5 seconds
 
+// Cache of the enumerated formats and static metadata of USB cameras, one file per
+// VID/PID/bcdDevice. The directory is created by the provider's init script; the device
+// sepolicy must label it and let the camera HAL domain create, write, rename and unlink files
+// there. Without that, loading misses, saving fails with a warning and cameras are enumerated on
+// every boot as before.
+const char kCharsCacheDir[] = "/data/vendor/external_camera/";
+constexpr uint32_t kCharsCacheMagic = 0x43484358;  // "XCHC"
+// Bump when the format enumeration or the way characteristics are computed changes
+constexpr uint32_t kCharsCacheVersion = 1;
+// larger counts are taken for corrupted cache files
+constexpr uint32_t kCharsCacheMaxCount = 4096;
+
+class CharsCacheWriter {
+public:
+    template <typename T>
+    void write(const T& value) {
+        mData.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeBytes(const void* data, size_t size) {
+        write(static_cast<uint32_t>(size));
+        mData.append(static_cast<const char*>(data), size);
+    }
+
+    const std::string& data() const { return mData; }
+
+private:
+    std::string mData;
+};
+
+class CharsCacheReader {
+public:
+    explicit CharsCacheReader(const std::string& data) : mData(data) {}
+
+    template <typename T>
+    bool read(T* outValue) {
+        if (mData.size() - mPos < sizeof(T)) {
+            return false;
+        }
+        memcpy(outValue, mData.data() + mPos, sizeof(T));
+        mPos += sizeof(T);
+        return true;
+    }
+
+    bool readBytes(std::string* outData) {
+        uint32_t size;
+        if (!read(&size) || mData.size() - mPos < size) {
+            return false;
+        }
+        outData->assign(mData, mPos, size);
+        mPos += size;
+        return true;
+    }
+
+private:
+    const std::string& mData;
+    size_t mPos = 0;
+};
+
 static uint Camera_Resolution[][2] = {{176,144},{320,240},{352,288},
                      {640,480},/*{720,540},{800,600},/*{1280,720},{1280,960},{1920,1080},{2048,1536},{2560,1440},{2592,1944},{2592,1456},*/
                      {0,0}};
@@ -296,6 +359,25 @@ status_t ExternalCameraDevice::initCameraCharacteristics() {
         }
 #endif
         status_t ret;
+        std::string cachePath;
+        std::string cacheProbe;
+        bool cacheable = getCharsCacheKey(fd.get(), &cachePath, &cacheProbe);
+        if (cacheable && loadCharsCacheLocked(cachePath, cacheProbe)) {
+            // Default keys and capabilities depend on system properties and on the HAL version
+            // rather than on the device, refresh them over the cached ones
+            ret = initDefaultCharsKeys(&mCameraCharacteristics);
+            if (ret == OK) {
+                ret = initAvailableCapabilities(&mCameraCharacteristics);
+            }
+            if (ret == OK) {
+                ALOGI("%s: camera %s characteristics loaded from %s", __FUNCTION__,
+                        mCameraId.c_str(), cachePath.c_str());
+                return OK;
+            }
+            mCameraCharacteristics.clear();
+            mSupportedFormats.clear();
+        }
+
         ret = initDefaultCharsKeys(&mCameraCharacteristics);
         if (ret != OK) {
             ALOGE("%s: init default characteristics key failed: errorno %d", __FUNCTION__, ret);
@@ -323,10 +405,178 @@ status_t ExternalCameraDevice::initCameraCharacteristics() {
             mCameraCharacteristics.clear();
             return ret;
         }
+
+        if (cacheable) {
+            saveCharsCacheLocked(cachePath, cacheProbe);
+        }
     }
     return OK;
 }
 
+bool ExternalCameraDevice::getCharsCacheKey(
+        int fd, std::string* outPath, std::string* outProbe) {
+#ifdef SUBDEVICE_ENABLE
+    // Sub devices take their formats from the enumeration of their main device, which must
+    // then run every time
+    return false;
+#else
+    if (mSubDevice || fd < 0) {
+        return false;
+    }
+
+    v4l2_capability capability{};
+    if (TEMP_FAILURE_RETRY(ioctl(fd, VIDIOC_QUERYCAP, &capability)) < 0) {
+        ALOGW("%s: v4l2 QUERYCAP failed: %s", __FUNCTION__, strerror(errno));
+        return false;
+    }
+    // HDMI inputs report the timings of whatever source is currently connected
+    if (strstr(reinterpret_cast<const char*>(capability.driver), "hdmi")) {
+        return false;
+    }
+
+    // The interface of a UVC camera is bound to the video node, its parent is the USB device
+    std::string usbDir = "/sys/class/video4linux/" +
+            mDevicePath.substr(mDevicePath.find_last_of('/') + 1) + "/device/../";
+    std::string vendorId;
+    std::string productId;
+    std::string bcdDevice;
+    if (!base::ReadFileToString(usbDir + "idVendor", &vendorId) ||
+            !base::ReadFileToString(usbDir + "idProduct", &productId) ||
+            !base::ReadFileToString(usbDir + "bcdDevice", &bcdDevice)) {
+        ALOGV("%s: %s is not a USB camera, not caching it", __FUNCTION__, mDevicePath.c_str());
+        return false;
+    }
+    // optional, and only used to tell apart firmwares sharing a bcdDevice
+    std::string product;
+    base::ReadFileToString(usbDir + "product", &product);
+
+    *outPath = base::StringPrintf("%s%s_%s_%s.bin", kCharsCacheDir,
+            base::Trim(vendorId).c_str(), base::Trim(productId).c_str(),
+            base::Trim(bcdDevice).c_str());
+
+    // Anything else the cached values depend on: the driver and the configuration limits
+    *outProbe = base::StringPrintf("%s|%s|%s|%u|%08x|%ux%u|%d|",
+            base::Trim(product).c_str(), reinterpret_cast<const char*>(capability.card),
+            reinterpret_cast<const char*>(capability.driver), capability.version,
+            capability.device_caps, mCfg.minStreamSize.width, mCfg.minStreamSize.height,
+            mCfg.depthEnabled);
+    for (const auto& limit : mCfg.fpsLimits) {
+        base::StringAppendF(outProbe, "%ux%u@%f,",
+                limit.size.width, limit.size.height, limit.fpsUpperBound);
+    }
+    outProbe->append("|");
+    for (const auto& limit : mCfg.depthFpsLimits) {
+        base::StringAppendF(outProbe, "%ux%u@%f,",
+                limit.size.width, limit.size.height, limit.fpsUpperBound);
+    }
+    return true;
+#endif
+}
+
+bool ExternalCameraDevice::loadCharsCacheLocked(
+        const std::string& path, const std::string& probe) {
+    std::string data;
+    if (!base::ReadFileToString(path, &data)) {
+        return false;
+    }
+
+    CharsCacheReader reader(data);
+    uint32_t magic;
+    uint32_t version;
+    std::string cachedProbe;
+    if (!reader.read(&magic) || !reader.read(&version) || magic != kCharsCacheMagic ||
+            version != kCharsCacheVersion || !reader.readBytes(&cachedProbe)) {
+        ALOGW("%s: ignoring invalid cache %s", __FUNCTION__, path.c_str());
+        return false;
+    }
+    if (cachedProbe != probe) {
+        ALOGI("%s: cache %s is stale", __FUNCTION__, path.c_str());
+        return false;
+    }
+
+    uint32_t croppingType;
+    uint32_t formatCount;
+    if (!reader.read(&croppingType) || !reader.read(&formatCount) ||
+            formatCount == 0 || formatCount > kCharsCacheMaxCount) {
+        ALOGW("%s: ignoring invalid cache %s", __FUNCTION__, path.c_str());
+        return false;
+    }
+    std::vector<SupportedV4L2Format> formats(formatCount);
+    for (auto& format : formats) {
+        uint32_t rateCount;
+        if (!reader.read(&format.width) || !reader.read(&format.height) ||
+                !reader.read(&format.fourcc) || !reader.read(&rateCount) ||
+                rateCount > kCharsCacheMaxCount) {
+            ALOGW("%s: ignoring invalid cache %s", __FUNCTION__, path.c_str());
+            return false;
+        }
+        format.frameRates.resize(rateCount);
+        for (auto& rate : format.frameRates) {
+            if (!reader.read(&rate.durationNumerator) ||
+                    !reader.read(&rate.durationDenominator)) {
+                ALOGW("%s: ignoring invalid cache %s", __FUNCTION__, path.c_str());
+                return false;
+            }
+        }
+    }
+
+    std::string rawMetadata;
+    if (!reader.readBytes(&rawMetadata)) {
+        ALOGW("%s: ignoring invalid cache %s", __FUNCTION__, path.c_str());
+        return false;
+    }
+    // the metadata is not aligned within the file
+    std::vector<uint64_t> alignedMetadata((rawMetadata.size() + sizeof(uint64_t) - 1) /
+            sizeof(uint64_t));
+    memcpy(alignedMetadata.data(), rawMetadata.data(), rawMetadata.size());
+    camera_metadata_t* metadata = allocate_copy_camera_metadata_checked(
+            reinterpret_cast<const camera_metadata_t*>(alignedMetadata.data()),
+            rawMetadata.size());
+    if (metadata == nullptr) {
+        ALOGW("%s: ignoring invalid metadata in cache %s", __FUNCTION__, path.c_str());
+        return false;
+    }
+
+    mCameraCharacteristics.acquire(metadata);
+    mSupportedFormats = std::move(formats);
+    mCroppingType = croppingType == VERTICAL ? VERTICAL : HORIZONTAL;
+    return true;
+}
+
+void ExternalCameraDevice::saveCharsCacheLocked(
+        const std::string& path, const std::string& probe) {
+    CharsCacheWriter writer;
+    writer.write(kCharsCacheMagic);
+    writer.write(kCharsCacheVersion);
+    writer.writeBytes(probe.data(), probe.size());
+    writer.write(static_cast<uint32_t>(mCroppingType));
+    writer.write(static_cast<uint32_t>(mSupportedFormats.size()));
+    for (const auto& format : mSupportedFormats) {
+        writer.write(format.width);
+        writer.write(format.height);
+        writer.write(format.fourcc);
+        writer.write(static_cast<uint32_t>(format.frameRates.size()));
+        for (const auto& rate : format.frameRates) {
+            writer.write(rate.durationNumerator);
+            writer.write(rate.durationDenominator);
+        }
+    }
+    const camera_metadata_t* rawMetadata = mCameraCharacteristics.getAndLock();
+    writer.writeBytes(rawMetadata, get_camera_metadata_size(rawMetadata));
+    mCameraCharacteristics.unlock(rawMetadata);
+
+    // Write then rename so that a concurrent reader or a crash never sees a partial file
+    std::string tmpPath = path + ".tmp";
+    if (!base::WriteStringToFile(writer.data(), tmpPath) ||
+            rename(tmpPath.c_str(), path.c_str()) != 0) {
+        ALOGW("%s: cannot write cache %s: %s", __FUNCTION__, path.c_str(), strerror(errno));
+        unlink(tmpPath.c_str());
+        return;
+    }
+    ALOGV("%s: camera %s characteristics saved to %s", __FUNCTION__, mCameraId.c_str(),
+            path.c_str());
+}
+
 #define ARRAY_SIZE(a) (sizeof(a) / sizeof(a[0]))
 #define UPDATE(tag, data, size)                    \
 do {                                               \
@@ -321,6 +321,7 @@ ExternalCameraDeviceSession::ExternalCameraDeviceSession(
         mCroppingType(croppingType),
         mCameraId(cameraId),
         mV4l2Fd(std::move(v4l2Fd)),
+        mResultBuilder(chars),
         mMaxThumbResolution(getMaxThumbResolution()),
         mMaxJpegResolution(getMaxJpegResolution()) {
 #ifdef SUBDEVICE_ENABLE
@@ -1233,14 +1234,21 @@ Status ExternalCameraDeviceSession::processCaptureResult(std::shared_ptr<HalRequ
         }
     }
 
-    // Fill capture result metadata
-    fillCaptureResult(req->setting, req->shutterTs);
+    // Fill capture result metadata. It is only referenced by result.result, and stays valid
+    // until the next result of this thread
+    const camera_metadata_t *rawResult = fillCaptureResult(req->setting, req->shutterTs);
+    if (rawResult == nullptr) {
+        // Return the request settings rather than no metadata at all
+        rawResult = req->setting.getAndLock();
+        req->setting.unlock(rawResult);
+    }
 #ifdef CAMEAR_DUMP_META
-    dumpResults(req->setting, result.frameNumber);
+    if (rawResult != nullptr) {
+        common::V1_0::helper::CameraMetadata dumpMd(clone_camera_metadata(rawResult));
+        dumpResults(dumpMd, result.frameNumber);
+    }
 #endif
-    const camera_metadata_t *rawResult = req->setting.getAndLock();
     V3_2::implementation::convertToHidl(rawResult, &result.result);
-    req->setting.unlock(rawResult);
 
     // update inflight records
     {
@@ -4613,14 +4621,14 @@ status_t ExternalCameraDeviceSession::initDefaultRequests() {
     return OK;
 }
 
-status_t ExternalCameraDeviceSession::fillCaptureResult(
-        common::V1_0::helper::CameraMetadata &md, nsecs_t timestamp) {
+const camera_metadata_t* ExternalCameraDeviceSession::fillCaptureResult(
+        const common::V1_0::helper::CameraMetadata &md, nsecs_t timestamp) {
     bool afTrigger = false;
     {
         std::lock_guard<std::mutex> lk(mAfTriggerLock);
         afTrigger = mAfTrigger;
         if (md.exists(ANDROID_CONTROL_AF_TRIGGER)) {
-            camera_metadata_entry entry = md.find(ANDROID_CONTROL_AF_TRIGGER);
+            camera_metadata_ro_entry entry = md.find(ANDROID_CONTROL_AF_TRIGGER);
             if (entry.data.u8[0] == ANDROID_CONTROL_AF_TRIGGER_START) {
                 mAfTrigger = afTrigger = true;
             } else if (entry.data.u8[0] == ANDROID_CONTROL_AF_TRIGGER_CANCEL) {
@@ -4638,12 +4646,8 @@ status_t ExternalCameraDeviceSession::fillCaptureResult(
     } else {
         afState = ANDROID_CONTROL_AF_STATE_INACTIVE;
     }
-    UPDATE(md, ANDROID_CONTROL_AF_STATE, &afState, 1);
-
-    camera_metadata_ro_entry activeArraySize =
-            mCameraCharacteristics.find(ANDROID_SENSOR_INFO_ACTIVE_ARRAY_SIZE);
 
-    return fillCaptureResultCommon(md, timestamp, activeArraySize);
+    return mResultBuilder.fill(md, timestamp, afState);
 }
 
 status_t ExternalCameraDeviceSession::dumpResults(
@@ -17,6 +17,7 @@
 //#define LOG_NDEBUG 0
 #include <log/log.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <sys/mman.h>
@@ -740,6 +741,96 @@ status_t fillCaptureResultCommon(
 #undef ARRAY_SIZE
 #undef UPDATE
 
+CaptureResultBuilder::CaptureResultBuilder(const common::V1_0::helper::CameraMetadata& chars) {
+    camera_metadata_ro_entry activeArraySize =
+            chars.find(ANDROID_SENSOR_INFO_ACTIVE_ARRAY_SIZE);
+    common::V1_0::helper::CameraMetadata md;
+    const uint8_t afState = ANDROID_CONTROL_AF_STATE_INACTIVE;
+    if (fillCaptureResultCommon(md, /*timestamp*/0, activeArraySize) != OK ||
+            md.update(ANDROID_CONTROL_AF_STATE, &afState, 1) != OK) {
+        ALOGE("%s: cannot build the capture result template!", __FUNCTION__);
+        return;
+    }
+    mTemplate = md.release();
+
+    size_t entryCount = get_camera_metadata_entry_count(mTemplate);
+    for (size_t i = 0; i < entryCount; i++) {
+        camera_metadata_ro_entry entry;
+        get_camera_metadata_ro_entry(mTemplate, i, &entry);
+        mTemplateTags.push_back(entry.tag);
+        switch (entry.tag) {
+            case ANDROID_CONTROL_AF_STATE: mAfStateIndex = i; break;
+            case ANDROID_SCALER_CROP_REGION: mCropRegionIndex = i; break;
+            case ANDROID_SENSOR_TIMESTAMP: mTimestampIndex = i; break;
+            default: break;
+        }
+    }
+}
+
+CaptureResultBuilder::~CaptureResultBuilder() {
+    if (mTemplate != nullptr) {
+        free_camera_metadata(mTemplate);
+    }
+}
+
+bool CaptureResultBuilder::isTemplateTag(uint32_t tag) const {
+    return std::find(mTemplateTags.begin(), mTemplateTags.end(), tag) != mTemplateTags.end();
+}
+
+const camera_metadata_t* CaptureResultBuilder::fill(
+        const common::V1_0::helper::CameraMetadata& settings,
+        nsecs_t timestamp, uint8_t afState) {
+    if (mTemplate == nullptr) {
+        return nullptr;
+    }
+
+    const camera_metadata_t* rawSettings = settings.getAndLock();
+    size_t settingsCount = 0;
+    size_t entryCapacity = get_camera_metadata_entry_count(mTemplate);
+    size_t dataCapacity = get_camera_metadata_data_count(mTemplate);
+    if (rawSettings != nullptr) {
+        settingsCount = get_camera_metadata_entry_count(rawSettings);
+        entryCapacity += settingsCount;
+        dataCapacity += get_camera_metadata_data_count(rawSettings);
+    }
+    size_t size = calculate_camera_metadata_size(entryCapacity, dataCapacity);
+    if (mBuffer.size() * sizeof(uint64_t) < size) {
+        mBuffer.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    }
+    camera_metadata_t* result = place_camera_metadata(
+            mBuffer.data(), mBuffer.size() * sizeof(uint64_t), entryCapacity, dataCapacity);
+
+    int res = (result == nullptr) ? BAD_VALUE : append_camera_metadata(result, mTemplate);
+    if (res == OK) {
+        res = update_camera_metadata_entry(result, mAfStateIndex, &afState, 1, nullptr);
+    }
+    if (res == OK) {
+        res = update_camera_metadata_entry(result, mTimestampIndex, &timestamp, 1, nullptr);
+    }
+    for (size_t i = 0; res == OK && i < settingsCount; i++) {
+        camera_metadata_ro_entry entry;
+        get_camera_metadata_ro_entry(rawSettings, i, &entry);
+        if (entry.tag == ANDROID_SCALER_CROP_REGION) {
+            // Keep the active array of the template for an invalid crop region
+            if (entry.count >= 4 && entry.data.i32[2] != 0) {
+                res = update_camera_metadata_entry(
+                        result, mCropRegionIndex, entry.data.i32, entry.count, nullptr);
+            }
+        } else if (!isTemplateTag(entry.tag)) {
+            if (add_camera_metadata_entry(result, entry.tag, entry.data.u8, entry.count) != OK) {
+                ALOGW("%s: dropping tag 0x%x from the result", __FUNCTION__, entry.tag);
+            }
+        }
+    }
+    settings.unlock(rawSettings);
+
+    if (res != OK) {
+        ALOGE("%s: cannot fill capture result: %d", __FUNCTION__, res);
+        return nullptr;
+    }
+    return result;
+}
+
 }  // namespace implementation
 }  // namespace V3_4
 
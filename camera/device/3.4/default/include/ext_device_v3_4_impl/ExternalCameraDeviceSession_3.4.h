@@ -320,7 +320,9 @@ protected:
 
     Status initStatus() const;
     status_t initDefaultRequests();
-    status_t fillCaptureResult(common::V1_0::helper::CameraMetadata& md, nsecs_t timestamp);
+    // Returns the result metadata built from the request settings md, see CaptureResultBuilder
+    const camera_metadata_t* fillCaptureResult(
+            const common::V1_0::helper::CameraMetadata& md, nsecs_t timestamp);
     status_t dumpResults(common::V1_0::helper::CameraMetadata& md, unsigned int reqId);
     Status configureStreams(const V3_2::StreamConfiguration&,
             V3_3::HalStreamConfiguration* out,
@@ -440,6 +442,9 @@ protected:
     std::mutex mAfTriggerLock; // protect mAfTrigger
     bool mAfTrigger = false;
 
+    // Only used by the OutputThread
+    CaptureResultBuilder mResultBuilder;
+
     uint32_t mBlobBufferSize = 0;
 
     static HandleImporter sHandleImporter;
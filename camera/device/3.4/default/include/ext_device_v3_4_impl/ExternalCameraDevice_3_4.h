@@ -155,6 +155,13 @@ protected:
     static void trimSupportedFormats(CroppingType cropType,
             /*inout*/std::vector<SupportedV4L2Format>* pFmts);
 
+    // On-disk cache of mSupportedFormats, mCroppingType and mCameraCharacteristics, so that a
+    // known USB camera is not enumerated again when it is reconnected or the provider restarts.
+    // Returns false if the device cannot be cached. Caller still owns fd
+    bool getCharsCacheKey(int fd, std::string* outPath, std::string* outProbe);
+    bool loadCharsCacheLocked(const std::string& path, const std::string& probe);
+    void saveCharsCacheLocked(const std::string& path, const std::string& probe);
+
     Mutex mLock;
     bool mInitialized = false;
     bool mInitFailed = false;
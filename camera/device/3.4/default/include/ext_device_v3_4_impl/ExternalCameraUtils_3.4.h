@@ -277,6 +277,35 @@ void freeReleaseFences(hidl_vec<V3_2::CaptureResult>&);
 status_t fillCaptureResultCommon(common::V1_0::helper::CameraMetadata& md, nsecs_t timestamp,
         camera_metadata_ro_entry& activeArraySize);
 
+// Builds capture result metadata in a buffer reused across frames. The tags filled by the HAL
+// come first, copied from a template made once per session with fillCaptureResultCommon, and the
+// request settings are appended after them, so a frame neither searches nor reallocates the
+// metadata. Not thread safe.
+class CaptureResultBuilder {
+public:
+    explicit CaptureResultBuilder(const common::V1_0::helper::CameraMetadata& chars);
+    ~CaptureResultBuilder();
+
+    CaptureResultBuilder(const CaptureResultBuilder&) = delete;
+    CaptureResultBuilder& operator=(const CaptureResultBuilder&) = delete;
+
+    // Returns the result metadata of a frame, valid until the next call, or nullptr on error
+    const camera_metadata_t* fill(const common::V1_0::helper::CameraMetadata& settings,
+            nsecs_t timestamp, uint8_t afState);
+
+private:
+    bool isTemplateTag(uint32_t tag) const;
+
+    camera_metadata_t* mTemplate = nullptr;
+    std::vector<uint32_t> mTemplateTags;
+    // Per frame slots, at the same index in mTemplate and in the result
+    size_t mAfStateIndex = 0;
+    size_t mCropRegionIndex = 0;
+    size_t mTimestampIndex = 0;
+    // In 64-bit words for the alignment of camera_metadata_t
+    std::vector<uint64_t> mBuffer;
+};
+
 // Interface for OutputThread calling back to parent
 struct OutputThreadInterface : public virtual RefBase {
     virtual ::android::hardware::camera::common::V1_0::Status importBuffer(
@@ -23,6 +23,8 @@
 #include <log/log.h>
 #include <media/stagefright/foundation/AString.h>
 
+#include <vector>
+
 using android::hardware::hidl_memory;
 using android::hidl::memory::V1_0::IMemory;
 
@@ -53,10 +55,20 @@ namespace implementation {
             uint32_t bufferId) {
         sp<IMemory> hidlMemory = mapMemory(base);
 
-        std::lock_guard<std::mutex> shared_buffer_lock(mSharedBufferLock);
-
         // allow mapMemory to return nullptr
-        mSharedBufferMap[bufferId] = hidlMemory;
+        SharedBufferMapping mapping = {hidlMemory, nullptr, 0};
+        if (hidlMemory != nullptr) {
+            mapping.base = static_cast<uint8_t *>(static_cast<void *>(hidlMemory->getPointer()));
+            mapping.size = hidlMemory->getSize();
+        }
+
+        std::lock_guard<std::mutex> shared_buffer_lock(mSharedBufferLock);
+        std::shared_ptr<const SharedBufferMap> current = std::atomic_load(&mSharedBufferMap);
+        auto updated = current ? std::make_shared<SharedBufferMap>(*current)
+                               : std::make_shared<SharedBufferMap>();
+        (*updated)[bufferId] = std::move(mapping);
+        std::atomic_store(&mSharedBufferMap,
+                std::shared_ptr<const SharedBufferMap>(std::move(updated)));
         return Void();
     }
 
@@ -67,15 +79,24 @@ namespace implementation {
             const SharedBuffer& source, uint64_t offset,
             const DestinationBuffer& destination,
             decrypt_cb _hidl_cb) {
-        std::unique_lock<std::mutex> shared_buffer_lock(mSharedBufferLock);
-        if (mSharedBufferMap.find(source.bufferId) == mSharedBufferMap.end()) {
+        // Keeps the buffers mapped until the legacy plugin is done with them.
+        std::shared_ptr<const SharedBufferMap> sharedBuffers =
+                std::atomic_load(&mSharedBufferMap);
+        if (sharedBuffers == nullptr) {
+            _hidl_cb(Status::ERROR_DRM_CANNOT_HANDLE, 0, "source decrypt buffer base not set");
+            return Void();
+        }
+        auto sourceMapping = sharedBuffers->find(source.bufferId);
+        if (sourceMapping == sharedBuffers->end()) {
             _hidl_cb(Status::ERROR_DRM_CANNOT_HANDLE, 0, "source decrypt buffer base not set");
             return Void();
         }
 
+        auto destMapping = sharedBuffers->end();
         if (destination.type == BufferType::SHARED_MEMORY) {
             const SharedBuffer& dest = destination.nonsecureMemory;
-            if (mSharedBufferMap.find(dest.bufferId) == mSharedBufferMap.end()) {
+            destMapping = sharedBuffers->find(dest.bufferId);
+            if (destMapping == sharedBuffers->end()) {
                 _hidl_cb(Status::ERROR_DRM_CANNOT_HANDLE, 0, "destination decrypt buffer base not set");
                 return Void();
             }
@@ -100,8 +121,10 @@ namespace implementation {
         legacyPattern.mEncryptBlocks = pattern.encryptBlocks;
         legacyPattern.mSkipBlocks = pattern.skipBlocks;
 
-        std::unique_ptr<android::CryptoPlugin::SubSample[]> legacySubSamples =
-                std::make_unique<android::CryptoPlugin::SubSample[]>(subSamples.size());
+        // Reused across calls on the same binder thread, to avoid an allocation per
+        // access unit.
+        static thread_local std::vector<android::CryptoPlugin::SubSample> legacySubSamples;
+        legacySubSamples.resize(subSamples.size());
 
         size_t destSize = 0;
         for (size_t i = 0; i < subSamples.size(); i++) {
@@ -120,8 +143,8 @@ namespace implementation {
         }
 
         AString detailMessage;
-        sp<IMemory> sourceBase = mSharedBufferMap[source.bufferId];
-        if (sourceBase == nullptr) {
+        const SharedBufferMapping& sourceBase = sourceMapping->second;
+        if (sourceBase.memory == nullptr) {
             _hidl_cb(Status::ERROR_DRM_CANNOT_HANDLE, 0, "source is a nullptr");
             return Void();
         }
@@ -129,28 +152,26 @@ namespace implementation {
         size_t totalSize = 0;
         if (__builtin_add_overflow(source.offset, offset, &totalSize) ||
             __builtin_add_overflow(totalSize, source.size, &totalSize) ||
-            totalSize > sourceBase->getSize()) {
+            totalSize > sourceBase.size) {
             android_errorWriteLog(0x534e4554, "176496160");
             _hidl_cb(Status::ERROR_DRM_CANNOT_HANDLE, 0, "invalid buffer size");
             return Void();
         }
 
-        uint8_t *base = static_cast<uint8_t *>
-                (static_cast<void *>(sourceBase->getPointer()));
-        void *srcPtr = static_cast<void *>(base + source.offset + offset);
+        void *srcPtr = static_cast<void *>(sourceBase.base + source.offset + offset);
 
         void *destPtr = NULL;
         if (destination.type == BufferType::SHARED_MEMORY) {
             const SharedBuffer& destBuffer = destination.nonsecureMemory;
-            sp<IMemory> destBase = mSharedBufferMap[destBuffer.bufferId];
-            if (destBase == nullptr) {
+            const SharedBufferMapping& destBase = destMapping->second;
+            if (destBase.memory == nullptr) {
                 _hidl_cb(Status::ERROR_DRM_CANNOT_HANDLE, 0, "destination is a nullptr");
                 return Void();
             }
 
             size_t totalSize = 0;
             if (__builtin_add_overflow(destBuffer.offset, destBuffer.size, &totalSize) ||
-                totalSize > destBase->getSize()) {
+                totalSize > destBase.size) {
                 android_errorWriteLog(0x534e4554, "176496353");
                 _hidl_cb(Status::ERROR_DRM_CANNOT_HANDLE, 0, "invalid buffer size");
                 return Void();
@@ -161,8 +182,7 @@ namespace implementation {
                 return Void();
             }
 
-            base = static_cast<uint8_t *>(static_cast<void *>(destBase->getPointer()));
-            destPtr = static_cast<void*>(base + destination.nonsecureMemory.offset);
+            destPtr = static_cast<void*>(destBase.base + destination.nonsecureMemory.offset);
         } else if (destination.type == BufferType::NATIVE_HANDLE) {
             if (!secure) {
                 _hidl_cb(Status::BAD_VALUE, 0, "native handle destination must be secure");
@@ -176,11 +196,8 @@ namespace implementation {
             return Void();
         }
 
-        // release mSharedBufferLock
-        shared_buffer_lock.unlock();
-
         ssize_t result = mLegacyPlugin->decrypt(secure, keyId.data(), iv.data(),
-                legacyMode, legacyPattern, srcPtr, legacySubSamples.get(),
+                legacyMode, legacyPattern, srcPtr, legacySubSamples.data(),
                 subSamples.size(), destPtr, &detailMessage);
 
         uint32_t status;
@@ -23,6 +23,8 @@
 #include <hidl/Status.h>
 #include <media/hardware/CryptoAPI.h>
 
+#include <map>
+#include <memory>
 #include <mutex>
 
 namespace android {
@@ -67,16 +69,29 @@ struct CryptoPlugin : public ICryptoPlugin {
             bool secure, const hidl_array<uint8_t, 16>& keyId, const hidl_array<uint8_t, 16>& iv,
             Mode mode, const Pattern& pattern, const hidl_vec<SubSample>& subSamples,
             const SharedBuffer& source, uint64_t offset, const DestinationBuffer& destination,
-            decrypt_cb _hidl_cb) override NO_THREAD_SAFETY_ANALYSIS;  // use unique_lock
+            decrypt_cb _hidl_cb) override;
 
   private:
+    // A shared buffer as mapped by setSharedBufferBase. The pointer and size are
+    // queried once, instead of on every decrypt.
+    struct SharedBufferMapping {
+        sp<IMemory> memory;
+        uint8_t *base;
+        size_t size;
+    };
+    typedef std::map<uint32_t, SharedBufferMapping> SharedBufferMap;
+
     android::CryptoPlugin *mLegacyPlugin;
-    std::map<uint32_t, sp<IMemory>> mSharedBufferMap GUARDED_BY(mSharedBufferLock);
+    // Replaced, never modified, by setSharedBufferBase, and read with atomic_load by
+    // decrypt, which therefore does not contend with other decrypt calls. Holding a
+    // reference to the map keeps its buffers mapped until decrypt has completed.
+    std::shared_ptr<const SharedBufferMap> mSharedBufferMap;
 
     CryptoPlugin() = delete;
     CryptoPlugin(const CryptoPlugin &) = delete;
     void operator=(const CryptoPlugin &) = delete;
 
+    // Serializes updates of mSharedBufferMap.
     std::mutex mSharedBufferLock;
 };
 
@@ -0,0 +1,310 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <android/hidl/allocator/1.0/IAllocator.h>
+#include <android/hidl/memory/1.0/IMemory.h>
+#include <hidlmemory/mapping.h>
+#include <media/hardware/CryptoAPI.h>
+#include <media/stagefright/MediaErrors.h>
+#include <media/stagefright/foundation/AString.h>
+#include <openssl/aes.h>
+
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <vector>
+
+#include "CryptoPlugin.h"
+
+using ::android::sp;
+using ::android::hardware::hidl_array;
+using ::android::hardware::hidl_memory;
+using ::android::hardware::hidl_string;
+using ::android::hardware::hidl_vec;
+using ::android::hardware::drm::V1_0::BufferType;
+using ::android::hardware::drm::V1_0::DestinationBuffer;
+using ::android::hardware::drm::V1_0::ICryptoPlugin;
+using ::android::hardware::drm::V1_0::Mode;
+using ::android::hardware::drm::V1_0::Pattern;
+using ::android::hardware::drm::V1_0::SharedBuffer;
+using ::android::hardware::drm::V1_0::Status;
+using ::android::hardware::drm::V1_0::SubSample;
+using ::android::hidl::allocator::V1_0::IAllocator;
+using ::android::hidl::memory::V1_0::IMemory;
+using ::benchmark::State;
+
+namespace implementation = ::android::hardware::drm::V1_0::implementation;
+typedef ::android::CryptoPlugin LegacyCryptoPlugin;
+
+namespace {
+
+constexpr uint8_t kKeyId[16] = {0x60, 0x06, 0x1e, 0x01, 0x7e, 0x47, 0x7e, 0x87,
+                                0x7e, 0x57, 0xd0, 0x0d, 0x1e, 0xd0, 0x0d, 0x1e};
+constexpr uint8_t kContentKey[16] = {0x1a, 0x8a, 0x20, 0x95, 0xe4, 0xde, 0xb2, 0xd2,
+                                     0x9e, 0xc8, 0x16, 0xac, 0x7b, 0xae, 0x20, 0x82};
+constexpr uint8_t kIv[16] = {0xf0, 0x0d, 0xca, 0xfe, 0x00, 0x01, 0x02, 0x03,
+                             0x04, 0x05, 0x06, 0x07, 0x00, 0x00, 0x00, 0x00};
+
+// Average access unit sizes: 1080p at 10 Mbit/s and 30 fps, 2160p at 50 Mbit/s
+// and 60 fps.
+constexpr int64_t k1080pSampleBytes = 10'000'000 / 8 / 30;
+constexpr int64_t k2160pSampleBytes = 50'000'000 / 8 / 60;
+
+// Bytes left in the clear at the start of each subsample, as for NAL unit and
+// slice headers.
+constexpr uint32_t kClearBytesPerSubSample = 32;
+
+// Buffer ids are recycled, so that the shared buffers of earlier runs are unmapped.
+// Only the threads of a single run use them at the same time.
+constexpr uint32_t kMaxBufferIds = 8;
+
+/**
+ * Applies clear key AES to the encrypted ranges of 'subSamples', and copies the
+ * clear ranges. AES-CTR keeps the counter running across subsamples. AES-CBC
+ * restarts from 'iv' in each subsample and, if a pattern is set, only processes
+ * 'encryptBlocks' out of every 'encryptBlocks + skipBlocks' blocks, as for 'cbcs'.
+ * Returns the number of bytes written to 'dst'.
+ */
+size_t clearKeyCrypt(bool decrypt, LegacyCryptoPlugin::Mode mode,
+                     const LegacyCryptoPlugin::Pattern& pattern, const uint8_t iv[AES_BLOCK_SIZE],
+                     const LegacyCryptoPlugin::SubSample* subSamples, size_t numSubSamples,
+                     const uint8_t* src, uint8_t* dst) {
+    const bool cbc = mode == LegacyCryptoPlugin::kMode_AES_CBC;
+    AES_KEY key;
+    if (cbc && decrypt) {
+        AES_set_decrypt_key(kContentKey, 128, &key);
+    } else {
+        AES_set_encrypt_key(kContentKey, 128, &key);
+    }
+
+    uint8_t counter[AES_BLOCK_SIZE];
+    memcpy(counter, iv, AES_BLOCK_SIZE);
+    uint8_t encryptedCounter[AES_BLOCK_SIZE] = {};
+    unsigned int counterOffset = 0;
+
+    size_t cryptBytes = pattern.mEncryptBlocks * AES_BLOCK_SIZE;
+    size_t skipBytes = pattern.mSkipBlocks * AES_BLOCK_SIZE;
+    size_t offset = 0;
+    for (size_t i = 0; i < numSubSamples; i++) {
+        const size_t clear = subSamples[i].mNumBytesOfClearData;
+        const size_t encrypted = subSamples[i].mNumBytesOfEncryptedData;
+        memcpy(dst + offset, src + offset, clear);
+        offset += clear;
+
+        if (mode == LegacyCryptoPlugin::kMode_AES_CTR) {
+            AES_ctr128_encrypt(src + offset, dst + offset, encrypted, &key, counter,
+                               encryptedCounter, &counterOffset);
+        } else if (cbc) {
+            uint8_t chain[AES_BLOCK_SIZE];
+            memcpy(chain, iv, AES_BLOCK_SIZE);
+            const size_t patternCryptBytes = cryptBytes == 0 ? encrypted : cryptBytes;
+            size_t done = 0;
+            while (done < encrypted) {
+                // A trailing partial block is left in the clear.
+                size_t n = std::min(patternCryptBytes,
+                                    (encrypted - done) & ~size_t(AES_BLOCK_SIZE - 1));
+                if (n > 0) {
+                    AES_cbc_encrypt(src + offset + done, dst + offset + done, n, &key, chain,
+                                    decrypt ? AES_DECRYPT : AES_ENCRYPT);
+                    done += n;
+                }
+                size_t skip = n == patternCryptBytes ? std::min(skipBytes, encrypted - done)
+                                                     : encrypted - done;
+                memcpy(dst + offset + done, src + offset + done, skip);
+                done += skip;
+            }
+        } else {
+            memcpy(dst + offset, src + offset, encrypted);
+        }
+        offset += encrypted;
+    }
+    return offset;
+}
+
+// An in-process clear key plugin with a single key, standing in for the vendor
+// plugin that the HIDL CryptoPlugin normally wraps.
+class ClearKeyCryptoPlugin : public LegacyCryptoPlugin {
+  public:
+    bool requiresSecureDecoderComponent(const char* /* mime */) const override { return false; }
+
+    ssize_t decrypt(bool secure, const uint8_t keyId[16], const uint8_t iv[16], Mode mode,
+                    const Pattern& pattern, const void* srcPtr, const SubSample* subSamples,
+                    size_t numSubSamples, void* dstPtr,
+                    ::android::AString* errorDetailMsg) override {
+        if (secure) {
+            errorDetailMsg->setTo("secure decryption is not supported");
+            return ::android::ERROR_DRM_CANNOT_HANDLE;
+        }
+        if (mode == kMode_AES_WV) {
+            errorDetailMsg->setTo("unsupported mode");
+            return ::android::ERROR_DRM_CANNOT_HANDLE;
+        }
+        if (memcmp(keyId, kKeyId, sizeof(kKeyId)) != 0) {
+            return ::android::ERROR_DRM_NO_LICENSE;
+        }
+        return clearKeyCrypt(true, mode, pattern, iv, subSamples, numSubSamples,
+                             static_cast<const uint8_t*>(srcPtr), static_cast<uint8_t*>(dstPtr));
+    }
+};
+
+LegacyCryptoPlugin::Mode toLegacyMode(Mode mode) {
+    switch (mode) {
+        case Mode::AES_CTR:
+            return LegacyCryptoPlugin::kMode_AES_CTR;
+        case Mode::AES_CBC:
+            return LegacyCryptoPlugin::kMode_AES_CBC;
+        case Mode::AES_CBC_CTS:
+            return LegacyCryptoPlugin::kMode_AES_WV;
+        default:
+            return LegacyCryptoPlugin::kMode_Unencrypted;
+    }
+}
+
+// Splits 'size' bytes into 'count' subsamples, each starting with a clear header.
+std::vector<SubSample> makeSubSamples(size_t size, size_t count) {
+    std::vector<SubSample> subSamples(count);
+    size_t remaining = size;
+    for (size_t i = 0; i < count; i++) {
+        size_t subSampleSize = i + 1 == count ? remaining : size / count;
+        auto& subSample = subSamples[i];
+        subSample.numBytesOfClearData = std::min<size_t>(kClearBytesPerSubSample, subSampleSize);
+        subSample.numBytesOfEncryptedData = subSampleSize - subSample.numBytesOfClearData;
+        remaining -= subSampleSize;
+    }
+    return subSamples;
+}
+
+// Allocates ashmem and sets it as shared buffer 'bufferId' of 'plugin'. Returns the
+// local mapping of the memory, or nullptr on failure.
+sp<IMemory> allocateSharedBuffer(const sp<ICryptoPlugin>& plugin, uint32_t bufferId,
+                                 size_t size) {
+    sp<IAllocator> allocator = IAllocator::getService("ashmem");
+    if (allocator == nullptr) {
+        return nullptr;
+    }
+    hidl_memory memory;
+    bool allocated = false;
+    auto ret = allocator->allocate(size, [&](bool success, const hidl_memory& m) {
+        allocated = success;
+        memory = m;
+    });
+    if (!ret.isOk() || !allocated || !plugin->setSharedBufferBase(memory, bufferId).isOk()) {
+        return nullptr;
+    }
+    return mapMemory(memory);
+}
+
+/**
+ * Decrypts one synthetic access unit per iteration through the HIDL CryptoPlugin,
+ * from the first half of a shared buffer into the second. The time per iteration
+ * is the latency of a decrypt call, and the bytes processed give the throughput.
+ * With several threads, all of them decrypt through the same plugin instance.
+ */
+void BM_Decrypt(State& state, Mode mode, Pattern pattern) {
+    static const sp<ICryptoPlugin> plugin =
+            new implementation::CryptoPlugin(new ClearKeyCryptoPlugin());
+    static std::atomic<uint32_t> nextBufferId{0};
+
+    const size_t sampleSize = state.range(0);
+    const std::vector<SubSample> subSamples = makeSubSamples(sampleSize, state.range(1));
+    const uint32_t bufferId = nextBufferId++ % kMaxBufferIds;
+    sp<IMemory> memory = allocateSharedBuffer(plugin, bufferId, sampleSize * 2);
+    if (memory == nullptr) {
+        state.SkipWithError("Failed to allocate shared memory");
+        return;
+    }
+
+    std::vector<uint8_t> clearSample(sampleSize);
+    std::mt19937 random(bufferId);
+    std::generate(clearSample.begin(), clearSample.end(), [&] { return random() & 0xff; });
+
+    std::vector<LegacyCryptoPlugin::SubSample> legacySubSamples(subSamples.size());
+    for (size_t i = 0; i < subSamples.size(); i++) {
+        legacySubSamples[i].mNumBytesOfClearData = subSamples[i].numBytesOfClearData;
+        legacySubSamples[i].mNumBytesOfEncryptedData = subSamples[i].numBytesOfEncryptedData;
+    }
+    const LegacyCryptoPlugin::Pattern legacyPattern = {pattern.encryptBlocks,
+                                                        pattern.skipBlocks};
+    uint8_t* base = static_cast<uint8_t*>(static_cast<void*>(memory->getPointer()));
+    memory->update();
+    clearKeyCrypt(false, toLegacyMode(mode), legacyPattern, kIv, legacySubSamples.data(),
+                  legacySubSamples.size(), clearSample.data(), base);
+    memory->commit();
+
+    const hidl_vec<SubSample> hidlSubSamples(subSamples);
+    const hidl_array<uint8_t, 16> keyId(kKeyId);
+    const hidl_array<uint8_t, 16> iv(kIv);
+    const SharedBuffer source = {.bufferId = bufferId, .offset = 0, .size = sampleSize};
+    const DestinationBuffer destination = {
+            .type = BufferType::SHARED_MEMORY,
+            .nonsecureMemory = {.bufferId = bufferId, .offset = sampleSize, .size = sampleSize},
+            .secureMemory = nullptr};
+
+    Status status = Status::OK;
+    uint32_t bytesWritten = 0;
+    auto decrypt = [&] {
+        return plugin->decrypt(false, keyId, iv, mode, pattern, hidlSubSamples, source, 0,
+                               destination, [&](Status s, uint32_t count, const hidl_string&) {
+                                   status = s;
+                                   bytesWritten = count;
+                               });
+    };
+
+    // Check the output once, so that a broken decrypt path cannot report good numbers.
+    if (!decrypt().isOk() || status != Status::OK || bytesWritten != sampleSize) {
+        state.SkipWithError("Decrypt failed");
+        return;
+    }
+    memory->read();
+    bool matches = memcmp(base + sampleSize, clearSample.data(), sampleSize) == 0;
+    memory->commit();
+    if (!matches) {
+        state.SkipWithError("Decrypted data does not match");
+        return;
+    }
+
+    for (auto _ : state) {
+        if (!decrypt().isOk() || status != Status::OK) {
+            state.SkipWithError("Decrypt failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * sampleSize);
+}
+
+void SampleArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"bytes", "subsamples"});
+    for (int64_t bytes : {k1080pSampleBytes, k2160pSampleBytes}) {
+        for (int64_t subSamples : {1, 4, 16}) {
+            b->Args({bytes, subSamples});
+        }
+    }
+    b->Unit(benchmark::kMicrosecond)->UseRealTime()->Threads(1)->Threads(4);
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Decrypt, unencrypted, Mode::UNENCRYPTED, Pattern{})->Apply(SampleArgs);
+BENCHMARK_CAPTURE(BM_Decrypt, aes_ctr, Mode::AES_CTR, Pattern{})->Apply(SampleArgs);
+BENCHMARK_CAPTURE(BM_Decrypt, aes_cbc, Mode::AES_CBC, Pattern{})->Apply(SampleArgs);
+BENCHMARK_CAPTURE(BM_Decrypt, aes_cbcs, Mode::AES_CBC,
+                  (Pattern{.encryptBlocks = 1, .skipBlocks = 9}))
+        ->Apply(SampleArgs);
+
+BENCHMARK_MAIN();
@@ -19,11 +19,11 @@
 #include "Gnss.h"
 #include <inttypes.h>
 #include <log/log.h>
+#include <utils/SystemClock.h>
 #include <utils/Timers.h>
 #include "AGnss.h"
 #include "AGnssRil.h"
 #include "DeviceFileReader.h"
-#include "FixLocationParser.h"
 #include "GnssAntennaInfo.h"
 #include "GnssBatching.h"
 #include "GnssConfiguration.h"
@@ -79,12 +79,15 @@ ScopedAStatus Gnss::setCallback(const std::shared_ptr<IGnssCallback>& callback)
 }
 
 std::unique_ptr<GnssLocation> Gnss::getLocationFromHW() {
-    if (!::android::hardware::gnss::common::ReplayUtils::hasFixedLocationDeviceFile()) {
+    const auto location =
+            ::android::hardware::gnss::common::DeviceFileReader::Instance().getLocation();
+    if (location == nullptr) {
         return nullptr;
     }
-    std::string inputStr =
-            ::android::hardware::gnss::common::DeviceFileReader::Instance().getLocationData();
-    return ::android::hardware::gnss::common::FixLocationParser::getLocationFromInputStr(inputStr);
+    auto currentLocation = std::make_unique<GnssLocation>(*location);
+    // The sample was parsed when it arrived, refresh its timestamp.
+    currentLocation->elapsedRealtime.timestampNs = ::android::elapsedRealtimeNano();
+    return currentLocation;
 }
 
 ScopedAStatus Gnss::start() {
@@ -20,15 +20,11 @@
 #include <aidl/android/hardware/gnss/BnGnss.h>
 #include <log/log.h>
 #include "DeviceFileReader.h"
-#include "GnssRawMeasurementParser.h"
-#include "GnssReplayUtils.h"
 #include "Utils.h"
 
 namespace aidl::android::hardware::gnss {
 
 using Utils = ::android::hardware::gnss::common::Utils;
-using ReplayUtils = ::android::hardware::gnss::common::ReplayUtils;
-using GnssRawMeasurementParser = ::android::hardware::gnss::common::GnssRawMeasurementParser;
 using DeviceFileReader = ::android::hardware::gnss::common::DeviceFileReader;
 
 std::shared_ptr<IGnssMeasurementCallback> GnssMeasurementInterface::sCallback = nullptr;
@@ -109,18 +105,10 @@ void GnssMeasurementInterface::start(const bool enableCorrVecOutputs) {
             if (!mIsActive) {
                 break;
             }
-            std::string rawMeasurementStr = "";
-            if (ReplayUtils::hasGnssDeviceFile() &&
-                ReplayUtils::isGnssRawMeasurement(
-                        rawMeasurementStr =
-                                DeviceFileReader::Instance().getGnssRawMeasurementData())) {
-                ALOGD("rawMeasurementStr(size: %zu) from device file: %s", rawMeasurementStr.size(),
-                      rawMeasurementStr.c_str());
-                auto measurement =
-                        GnssRawMeasurementParser::getMeasurementFromStrs(rawMeasurementStr);
-                if (measurement != nullptr) {
-                    this->reportMeasurement(*measurement);
-                }
+            const auto measurement = DeviceFileReader::Instance().getGnssRawMeasurement();
+            if (measurement != nullptr) {
+                ALOGD("%zu raw measurements from device file", measurement->measurements.size());
+                this->reportMeasurement(*measurement);
             } else {
                 auto measurement = Utils::getMockMeasurement(enableCorrVecOutputs);
                 this->reportMeasurement(measurement);
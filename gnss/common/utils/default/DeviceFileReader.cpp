@@ -15,106 +15,329 @@
  */
 #include "DeviceFileReader.h"
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+
+#include "FixLocationParser.h"
+#include "GnssRawMeasurementParser.h"
+
 namespace android {
 namespace hardware {
 namespace gnss {
 namespace common {
 
-void DeviceFileReader::getDataFromDeviceFile(const std::string& command, int mMinIntervalMs) {
-    char inputBuffer[INPUT_BUFFER_SIZE];
-    std::string deviceFilePath = "";
-    if (command == CMD_GET_LOCATION) {
-        deviceFilePath = ReplayUtils::getFixedLocationPath();
-    } else if (command == CMD_GET_RAWMEASUREMENT) {
-        deviceFilePath = ReplayUtils::getGnssPath();
-    } else {
-        // Invalid command
-        return;
-    }
+using aidl::android::hardware::gnss::GnssData;
+using aidl::android::hardware::gnss::GnssLocation;
+using Clock = std::chrono::steady_clock;
 
-    int gnss_fd, epoll_fd;
-    if ((gnss_fd = open(deviceFilePath.c_str(), O_RDWR | O_NONBLOCK)) == -1) {
-        return;
+namespace {
+// A response not completed within this time is dropped.
+constexpr auto kResponseTimeout = std::chrono::milliseconds(1000);
+// Retry interval for device files which failed to open.
+constexpr auto kReopenInterval = std::chrono::milliseconds(1000);
+// How long a getter waits for the response to its request (the old poll timeout).
+constexpr auto kFreshResponseWait = std::chrono::milliseconds(20);
+constexpr int kReadBufferSize = 4096;
+// Responses are terminated by an end of file mark (\n\n\n\n), i.e. three empty lines.
+constexpr int kEndOfResponseEmptyLines = 3;
+}  // namespace
+
+DeviceFileReader::DeviceFileReader() {
+    mStreams[LOCATION].command = CMD_GET_LOCATION;
+    mStreams[RAW_MEASUREMENT].command = CMD_GET_RAWMEASUREMENT;
+}
+
+DeviceFileReader::~DeviceFileReader() {
+    mStopping = true;
+    if (mThread.joinable()) {
+        const uint64_t value = 1;
+        TEMP_FAILURE_RETRY(write(mWakeupFd, &value, sizeof(value)));
+        mThread.join();
     }
-    if (write(gnss_fd, command.c_str(), command.size()) <= 0) {
-        close(gnss_fd);
-        return;
+    for (auto& file : mFiles) {
+        closeDeviceFile(*file);
+    }
+    if (mWakeupFd >= 0) {
+        close(mWakeupFd);
     }
+    if (mEpollFd >= 0) {
+        close(mEpollFd);
+    }
+}
+
+std::string DeviceFileReader::getLocationData() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    noteDemand(LOCATION, lock);
+    return mStreams[LOCATION].data;
+}
 
-    // Create an epoll instance.
-    if ((epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
-        close(gnss_fd);
+std::string DeviceFileReader::getGnssRawMeasurementData() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    noteDemand(RAW_MEASUREMENT, lock);
+    return mStreams[RAW_MEASUREMENT].data;
+}
+
+std::shared_ptr<const GnssLocation> DeviceFileReader::getLocation() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    noteDemand(LOCATION, lock);
+    return mStreams[LOCATION].location;
+}
+
+std::shared_ptr<const GnssData> DeviceFileReader::getGnssRawMeasurement() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    noteDemand(RAW_MEASUREMENT, lock);
+    return mStreams[RAW_MEASUREMENT].measurement;
+}
+
+void DeviceFileReader::noteDemand(StreamId id, std::unique_lock<std::mutex>& lock) {
+    std::call_once(mStartOnce, [this]() {
+        // Device files may be shared between the streams.
+        const std::string paths[NUM_STREAMS] = {ReplayUtils::getFixedLocationPath(),
+                                                ReplayUtils::getGnssPath()};
+        for (int i = 0; i < NUM_STREAMS; i++) {
+            for (auto& file : mFiles) {
+                if (file->path == paths[i]) {
+                    mStreams[i].file = file.get();
+                }
+            }
+            if (mStreams[i].file == nullptr) {
+                mFiles.push_back(std::make_unique<DeviceFile>());
+                mFiles.back()->path = paths[i];
+                mStreams[i].file = mFiles.back().get();
+            }
+        }
+        if ((mEpollFd = epoll_create1(EPOLL_CLOEXEC)) < 0 ||
+            (mWakeupFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0) {
+            ALOGE("Failed to create the device file reader epoll instance: %s", strerror(errno));
+            return;
+        }
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.data.ptr = nullptr;
+        ev.events = EPOLLIN;
+        if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeupFd, &ev) == -1) {
+            ALOGE("Failed to add the wakeup fd to the epoll instance: %s", strerror(errno));
+            return;
+        }
+        mThread = std::thread(&DeviceFileReader::readerLoop, this);
+    });
+
+    if (!mThread.joinable()) {
         return;
     }
+    // Every poll asks for one fresh sample, so the device is read at the consumer's rate. Polls
+    // arriving while a request is still queued share it.
+    Stream& stream = mStreams[id];
+    stream.requested = true;
+    const uint64_t value = 1;
+    TEMP_FAILURE_RETRY(write(mWakeupFd, &value, sizeof(value)));
+    const uint64_t responseCount = stream.responseCount;
+    mResponseCv.wait_for(lock, kFreshResponseWait, [&stream, responseCount] {
+        return stream.responseCount != responseCount;
+    });
+}
+
+void DeviceFileReader::readerLoop() {
+    struct epoll_event events[NUM_STREAMS + 1];
+    while (!mStopping) {
+        const auto now = Clock::now();
+        auto deadline = Clock::time_point::max();
+        for (auto& file : mFiles) {
+            if (file->pendingStream >= 0) {
+                if (now - file->requestTime < kResponseTimeout) {
+                    deadline = std::min(deadline, file->requestTime + kResponseTimeout);
+                } else {
+                    ALOGW("Timed out waiting for the %s response",
+                          mStreams[file->pendingStream].command);
+                    file->pendingStream = -1;
+                    file->lines.clear();
+                    file->emptyLines = 0;
+                }
+            }
+        }
+        bool requested[NUM_STREAMS];
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            for (int id = 0; id < NUM_STREAMS; id++) {
+                requested[id] = mStreams[id].requested;
+            }
+        }
+        for (int id = 0; id < NUM_STREAMS; id++) {
+            if (!requested[id]) {
+                continue;
+            }
+            DeviceFile& file = *mStreams[id].file;
+            if (file.pendingStream >= 0) {
+                // Issued once the pending response completes.
+                deadline = std::min(deadline, file.requestTime + kResponseTimeout);
+                continue;
+            }
+            // A request which can't be sent is dropped; the next poll asks again.
+            if (file.fd >= 0 || (now >= file.nextOpenTime && openDeviceFile(file))) {
+                requestData(static_cast<StreamId>(id), now);
+            }
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mStreams[id].requested = false;
+            }
+            if (file.pendingStream >= 0) {
+                deadline = std::min(deadline, file.requestTime + kResponseTimeout);
+            }
+        }
+
+        // Without a pending response there is nothing to do until a getter wakes us up.
+        int timeoutMs = -1;
+        if (deadline != Clock::time_point::max()) {
+            timeoutMs = std::max<int64_t>(
+                    0, std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count());
+        }
+        const int numEvents = epoll_wait(mEpollFd, events, NUM_STREAMS + 1, timeoutMs);
+        if (numEvents == -1) {
+            if (errno != EINTR) {
+                ALOGE("Device file reader epoll_wait failed: %s", strerror(errno));
+                return;
+            }
+            continue;
+        }
+        for (int i = 0; i < numEvents; i++) {
+            if (events[i].data.ptr == nullptr) {
+                uint64_t value;
+                TEMP_FAILURE_RETRY(read(mWakeupFd, &value, sizeof(value)));
+                continue;
+            }
+            DeviceFile& file = *static_cast<DeviceFile*>(events[i].data.ptr);
+            if (events[i].events & EPOLLIN) {
+                readDeviceFile(file);
+            }
+            if (file.fd >= 0 && (events[i].events & (EPOLLHUP | EPOLLERR))) {
+                closeDeviceFile(file);
+            }
+        }
+    }
+}
 
-    // Add file descriptor to epoll instance.
-    struct epoll_event ev, events[1];
+bool DeviceFileReader::openDeviceFile(DeviceFile& file) {
+    file.nextOpenTime = Clock::now() + kReopenInterval;
+    if ((file.fd = open(file.path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC)) == -1) {
+        return false;
+    }
+    struct epoll_event ev;
     memset(&ev, 0, sizeof(ev));
-    ev.data.fd = gnss_fd;
+    ev.data.ptr = &file;
     ev.events = EPOLLIN;
-    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, gnss_fd, &ev) == -1) {
-        close(gnss_fd);
-        close(epoll_fd);
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD, file.fd, &ev) == -1) {
+        ALOGE("Failed to add %s to the epoll instance: %s", file.path.c_str(), strerror(errno));
+        close(file.fd);
+        file.fd = -1;
+        return false;
+    }
+    return true;
+}
+
+void DeviceFileReader::closeDeviceFile(DeviceFile& file) {
+    if (file.fd < 0) {
         return;
     }
+    epoll_ctl(mEpollFd, EPOLL_CTL_DEL, file.fd, nullptr);
+    close(file.fd);
+    file.fd = -1;
+    file.partialLine.clear();
+    file.lines.clear();
+    file.emptyLines = 0;
+    file.pendingStream = -1;
+    file.nextOpenTime = Clock::now() + kReopenInterval;
+}
 
-    // Wait for device file event.
-    if (epoll_wait(epoll_fd, events, 1, mMinIntervalMs) == -1) {
-        close(gnss_fd);
-        close(epoll_fd);
+void DeviceFileReader::requestData(StreamId id, Clock::time_point now) {
+    Stream& stream = mStreams[id];
+    DeviceFile& file = *stream.file;
+    const size_t size = strlen(stream.command);
+    if (TEMP_FAILURE_RETRY(write(file.fd, stream.command, size)) <= 0) {
+        if (errno != EAGAIN) {
+            closeDeviceFile(file);
+        }
         return;
     }
+    file.pendingStream = id;
+    file.requestTime = now;
+}
 
-    // Handle event and write data to string buffer.
-    int bytes_read = -1;
-    std::string inputStr = "";
+void DeviceFileReader::readDeviceFile(DeviceFile& file) {
+    char buffer[kReadBufferSize];
     while (true) {
-        memset(inputBuffer, 0, INPUT_BUFFER_SIZE);
-        bytes_read = read(gnss_fd, &inputBuffer, INPUT_BUFFER_SIZE);
-        if (bytes_read <= 0) {
-            break;
+        const ssize_t bytesRead = TEMP_FAILURE_RETRY(read(file.fd, buffer, sizeof(buffer)));
+        if (bytesRead == 0 || (bytesRead < 0 && errno == EAGAIN)) {
+            return;
+        }
+        if (bytesRead < 0) {
+            ALOGE("Failed to read %s: %s", file.path.c_str(), strerror(errno));
+            closeDeviceFile(file);
+            return;
+        }
+        // Split into lines as the data arrives, so completed responses don't need another pass.
+        const char* begin = buffer;
+        const char* const end = buffer + bytesRead;
+        while (begin < end) {
+            const char* newline =
+                    static_cast<const char*>(memchr(begin, LINE_SEPARATOR, end - begin));
+            if (newline == nullptr) {
+                file.partialLine.append(begin, end);
+                break;
+            }
+            file.partialLine.append(begin, newline);
+            begin = newline + 1;
+            if (!file.partialLine.empty()) {
+                file.emptyLines = 0;
+                file.lines.push_back(std::move(file.partialLine));
+                file.partialLine.clear();
+            } else if (++file.emptyLines == kEndOfResponseEmptyLines) {
+                onResponse(file);
+            }
         }
-        s_buffer_ += std::string(inputBuffer, bytes_read);
     }
-    close(gnss_fd);
-    close(epoll_fd);
-
-    // Trim end of file mark(\n\n\n\n).
-    auto pos = s_buffer_.find("\n\n\n\n");
-    if (pos != std::string::npos) {
-        inputStr = s_buffer_.substr(0, pos);
-        s_buffer_ = s_buffer_.substr(pos + 4);
-    } else {
+}
+
+void DeviceFileReader::onResponse(DeviceFile& file) {
+    const int id = file.pendingStream;
+    file.pendingStream = -1;
+    file.emptyLines = 0;
+    if (id < 0) {
+        // Late response to a timed out request.
+        file.lines.clear();
         return;
     }
 
-    // Cache the injected data.
-    if (command == CMD_GET_LOCATION) {
-        // TODO validate data
-        data_[CMD_GET_LOCATION] = inputStr;
-    } else if (command == CMD_GET_RAWMEASUREMENT) {
-        if (ReplayUtils::isGnssRawMeasurement(inputStr)) {
-            data_[CMD_GET_RAWMEASUREMENT] = inputStr;
+    std::string data;
+    for (const auto& line : file.lines) {
+        if (!data.empty()) {
+            data += LINE_SEPARATOR;
         }
+        data += line;
     }
-}
-
-std::string DeviceFileReader::getLocationData() {
-    std::unique_lock<std::mutex> lock(mMutex);
-    getDataFromDeviceFile(CMD_GET_LOCATION, 20);
-    return data_[CMD_GET_LOCATION];
-}
+    // TODO validate location data
+    const bool valid = id == LOCATION || ReplayUtils::isGnssRawMeasurement(data);
+    std::shared_ptr<const GnssLocation> location;
+    std::shared_ptr<const GnssData> measurement;
+    if (id == LOCATION && !file.lines.empty()) {
+        location = FixLocationParser::getLocationFromInputStr(file.lines[0]);
+    } else if (id == RAW_MEASUREMENT && valid) {
+        measurement = GnssRawMeasurementParser::getMeasurementFromRecords(file.lines);
+    }
+    file.lines.clear();
 
-std::string DeviceFileReader::getGnssRawMeasurementData() {
     std::unique_lock<std::mutex> lock(mMutex);
-    getDataFromDeviceFile(CMD_GET_RAWMEASUREMENT, 20);
-    return data_[CMD_GET_RAWMEASUREMENT];
+    Stream& stream = mStreams[id];
+    if (valid) {
+        stream.data = std::move(data);
+        stream.location = std::move(location);
+        stream.measurement = std::move(measurement);
+    }
+    stream.responseCount++;
+    mResponseCv.notify_all();
 }
 
-DeviceFileReader::DeviceFileReader() {}
-
-DeviceFileReader::~DeviceFileReader() {}
-
 }  // namespace common
 }  // namespace gnss
 }  // namespace hardware
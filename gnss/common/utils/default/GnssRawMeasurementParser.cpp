@@ -184,6 +184,11 @@ std::unique_ptr<GnssData> GnssRawMeasurementParser::getMeasurementFromStrs(
     }
     std::vector<std::string> rawMeasurementStrRecords;
     ParseUtils::splitStr(rawMeasurementStr, LINE_SEPARATOR, rawMeasurementStrRecords);
+    return getMeasurementFromRecords(rawMeasurementStrRecords);
+}
+
+std::unique_ptr<GnssData> GnssRawMeasurementParser::getMeasurementFromRecords(
+        const std::vector<std::string>& rawMeasurementStrRecords) {
     if (rawMeasurementStrRecords.size() <= 1) {
         ALOGE("Raw GNSS Measurements parser failed. (No records) ");
         return nullptr;
@@ -228,10 +233,11 @@ std::unique_ptr<GnssData> GnssRawMeasurementParser::getMeasurementFromStrs(
                     firstRecordValues[columnNameIdMapping.at("TimeUncertaintyNanos")], 0)};
 
     std::vector<GnssMeasurement> measurementsVec;
+    measurementsVec.reserve(rawMeasurementStrRecords.size() - 1);
     for (pointer = 1; pointer < rawMeasurementStrRecords.size(); pointer++) {
         std::vector<std::string> rawMeasurementValues;
-        std::string line = rawMeasurementStrRecords[pointer];
-        ParseUtils::splitStr(line, COMMA_SEPARATOR, rawMeasurementValues);
+        ParseUtils::splitStr(rawMeasurementStrRecords[pointer], COMMA_SEPARATOR,
+                             rawMeasurementValues);
         GnssSignalType signalType = {
                 .constellation = getGnssConstellationType(ParseUtils::tryParseInt(
                         rawMeasurementValues[columnNameIdMapping.at("ConstellationType")], 0)),
@@ -291,12 +297,12 @@ std::unique_ptr<GnssData> GnssRawMeasurementParser::getMeasurementFromStrs(
                         0),
                 .satellitePvt = {},
                 .correlationVectors = {}};
-        measurementsVec.push_back(measurement);
+        measurementsVec.push_back(std::move(measurement));
     }
 
-    GnssData gnssData = {
-            .measurements = measurementsVec, .clock = clock, .elapsedRealtime = timestamp};
-    return std::make_unique<GnssData>(gnssData);
+    return std::make_unique<GnssData>(GnssData{.measurements = std::move(measurementsVec),
+                                               .clock = clock,
+                                               .elapsedRealtime = timestamp});
 }
 
 }  // namespace common
@@ -17,10 +17,16 @@
 #ifndef android_hardware_gnss_common_default_DeviceFileReader_H_
 #define android_hardware_gnss_common_default_DeviceFileReader_H_
 
+#include <aidl/android/hardware/gnss/BnGnss.h>
 #include <log/log.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <unordered_map>
+#include <thread>
+#include <vector>
 #include "Constants.h"
 #include "GnssReplayUtils.h"
 
@@ -28,22 +34,79 @@ namespace android {
 namespace hardware {
 namespace gnss {
 namespace common {
+
+/*
+ * Streams location and raw measurement data from the replay device files.
+ *
+ * A reader thread keeps the device files and an epoll instance open, issues a CMD_GET_* command
+ * for each getter call, splits the responses into lines as they arrive and parses each completed
+ * response once. The getters never perform I/O themselves: they wake up the reader thread, wait
+ * briefly for the response and return the latest sample.
+ */
 class DeviceFileReader {
   public:
     static DeviceFileReader& Instance() {
         static DeviceFileReader reader;
         return reader;
     }
+    // Latest raw response text.
     std::string getLocationData();
     std::string getGnssRawMeasurementData();
-    void getDataFromDeviceFile(const std::string& command, int mMinIntervalMs);
+    // Latest parsed sample, or nullptr if there is none.
+    std::shared_ptr<const aidl::android::hardware::gnss::GnssLocation> getLocation();
+    std::shared_ptr<const aidl::android::hardware::gnss::GnssData> getGnssRawMeasurement();
 
   private:
+    enum StreamId { LOCATION = 0, RAW_MEASUREMENT = 1, NUM_STREAMS = 2 };
+
+    struct DeviceFile {
+        std::string path;
+        int fd = -1;
+        // Bytes of the incomplete last line.
+        std::string partialLine;
+        // Lines of the response being received.
+        std::vector<std::string> lines;
+        int emptyLines = 0;
+        // Stream whose command is awaiting its response, if any.
+        int pendingStream = -1;
+        std::chrono::steady_clock::time_point requestTime;
+        std::chrono::steady_clock::time_point nextOpenTime;
+    };
+
+    struct Stream {
+        const char* command;
+        DeviceFile* file = nullptr;
+        // The fields below are guarded by mMutex.
+        // Whether a getter is waiting for the command to be issued.
+        bool requested = false;
+        // Latest samples.
+        std::string data;
+        std::shared_ptr<const aidl::android::hardware::gnss::GnssLocation> location;
+        std::shared_ptr<const aidl::android::hardware::gnss::GnssData> measurement;
+        uint64_t responseCount = 0;
+    };
+
     DeviceFileReader();
     ~DeviceFileReader();
-    std::unordered_map<std::string, std::string> data_;
-    std::string s_buffer_;
+    // Requests fresh data for |id| and waits briefly for the response.
+    void noteDemand(StreamId id, std::unique_lock<std::mutex>& lock);
+    void readerLoop();
+    bool openDeviceFile(DeviceFile& file);
+    void closeDeviceFile(DeviceFile& file);
+    void requestData(StreamId id, std::chrono::steady_clock::time_point now);
+    void readDeviceFile(DeviceFile& file);
+    void onResponse(DeviceFile& file);
+
+    Stream mStreams[NUM_STREAMS];
+    // Location and raw measurements may be served by the same device file.
+    std::vector<std::unique_ptr<DeviceFile>> mFiles;
+    int mEpollFd = -1;
+    int mWakeupFd = -1;
+    std::atomic<bool> mStopping = false;
+    std::once_flag mStartOnce;
+    std::thread mThread;
     std::mutex mMutex;
+    std::condition_variable mResponseCv;
 };
 }  // namespace common
 }  // namespace gnss
@@ -22,6 +22,7 @@
 #include <utils/SystemClock.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Constants.h"
 #include "ParseUtils.h"
@@ -34,6 +35,10 @@ namespace common {
 struct GnssRawMeasurementParser {
     static std::unique_ptr<aidl::android::hardware::gnss::GnssData> getMeasurementFromStrs(
             std::string& rawMeasurementStr);
+    // Same as getMeasurementFromStrs() for input already split into lines, the first of which
+    // is the header.
+    static std::unique_ptr<aidl::android::hardware::gnss::GnssData> getMeasurementFromRecords(
+            const std::vector<std::string>& rawMeasurementStrRecords);
     static int getClockFlags(const std::vector<std::string>& rawMeasurementRecordValues,
                              const std::unordered_map<std::string, int>& columnNameIdMapping);
     static int getElapsedRealtimeFlags(
@@ -35,7 +35,32 @@
 #include <android/hardware/graphics/composer/2.1/IComposer.h>
 #include <fmq/MessageQueue.h>
 #include <log/log.h>
+
+#ifdef __ANDROID__
 #include <sync/sync.h>
+#else
+#include <errno.h>
+#include <poll.h>
+
+// libsync is device only; host tools such as composer_replay wait on fences
+// the way sync_wait() does.
+static inline int sync_wait(int fd, int timeout) {
+    struct pollfd fds = {.fd = fd, .events = POLLIN};
+    int ret;
+    do {
+        ret = poll(&fds, 1, timeout);
+        if (ret > 0 && (fds.revents & (POLLERR | POLLNVAL))) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (ret == 0) {
+            errno = ETIME;
+            return -1;
+        }
+    } while (ret == -1 && (errno == EINTR || errno == EAGAIN));
+    return ret > 0 ? 0 : ret;
+}
+#endif
 
 namespace android {
 namespace hardware {
@@ -59,8 +84,16 @@ class CommandWriterBase {
         reset();
     }
 
-    virtual ~CommandWriterBase() { reset(); }
+    virtual ~CommandWriterBase() {
+        reset();
+        for (auto handle : mFreeTemporaryHandles) {
+            native_handle_delete(handle);
+        }
+    }
 
+    // Makes the writer ready for the next frame.  The command buffer, the queue
+    // and the temporary handles are kept for reuse, so that frames no larger than
+    // the previous ones are written without allocating.
     void reset() {
         mDataWritten = 0;
         mCommandEnd = 0;
@@ -71,7 +104,7 @@ class CommandWriterBase {
         // handles in mTemporaryHandles are owned by the writer
         for (auto handle : mTemporaryHandles) {
             native_handle_close(handle);
-            native_handle_delete(handle);
+            mFreeTemporaryHandles.push_back(handle);
         }
         mTemporaryHandles.clear();
     }
@@ -138,6 +171,9 @@ class CommandWriterBase {
         return (mQueue) ? mQueue->getDesc() : nullptr;
     }
 
+    // Number of times the command buffer had to be reallocated to fit the commands.
+    uint32_t getDataGrowCount() const { return mDataGrowCount; }
+
     static constexpr uint16_t kSelectDisplayLength = 2;
     void selectDisplay(Display display) {
         beginCommand(IComposerClient::Command::SELECT_DISPLAY, kSelectDisplayLength);
@@ -530,7 +566,18 @@ class CommandWriterBase {
     }
 
     native_handle_t* getTemporaryHandle(int numFds, int numInts) {
-        native_handle_t* handle = native_handle_create(numFds, numInts);
+        native_handle_t* handle = nullptr;
+        auto freeHandle = std::find_if(mFreeTemporaryHandles.rbegin(),
+                                       mFreeTemporaryHandles.rend(), [&](native_handle_t* h) {
+                                           return h->numFds == numFds && h->numInts == numInts;
+                                       });
+        if (freeHandle != mFreeTemporaryHandles.rend()) {
+            handle = *freeHandle;
+            *freeHandle = mFreeTemporaryHandles.back();
+            mFreeTemporaryHandles.pop_back();
+        } else {
+            handle = native_handle_create(numFds, numInts);
+        }
         if (handle) {
             mTemporaryHandles.push_back(handle);
         }
@@ -563,14 +610,18 @@ class CommandWriterBase {
         std::copy_n(mData.get(), mDataWritten, newData.get());
         mDataMaxSize = newMaxSize;
         mData = std::move(newData);
+        mDataGrowCount++;
     }
 
     uint32_t mDataMaxSize;
+    uint32_t mDataGrowCount = 0;
     // end offset of the current command
     uint32_t mCommandEnd;
 
     std::vector<hidl_handle> mDataHandles;
     std::vector<native_handle_t*> mTemporaryHandles;
+    // closed handles of previous frames, for getTemporaryHandle to reuse
+    std::vector<native_handle_t*> mFreeTemporaryHandles;
 
     std::unique_ptr<CommandQueueType> mQueue;
 };
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include <memory>
+#include <vector>
+
+#include <android/hardware/graphics/composer/2.1/IComposer.h>
+#include <log/log.h>
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+
+// A recording of the command buffers a composer client sent, one frame per
+// executeCommands call.  Handles cannot be recorded, only their number of fds
+// and ints are, so that they can be replaced by placeholders when replaying.
+//
+// The file is a header (kMagic, kVersion) followed by frames, each made of
+// the command length, the handle count, the commands and the fd and int
+// counts of each handle (-1 and -1 for a null handle).  All values are
+// 32-bit words in host byte order.
+struct CommandRecordingFrame {
+    struct Handle {
+        int32_t numFds;
+        int32_t numInts;
+
+        bool isNull() const { return numFds < 0; }
+        // how fences are passed, see CommandWriterBase::writeFence
+        bool isFence() const { return numFds == 1 && numInts == 0; }
+    };
+
+    std::vector<uint32_t> commands;
+    std::vector<Handle> handles;
+};
+
+class CommandRecordingFile {
+  public:
+    static constexpr uint32_t kMagic = 0x52435748;  // "HWCR"
+    static constexpr uint32_t kVersion = 1;
+    // larger frames are taken for corrupted recordings
+    static constexpr uint32_t kMaxFrameLength = 1 << 24;
+
+    ~CommandRecordingFile() {
+        if (mFile) {
+            fclose(mFile);
+        }
+    }
+
+    CommandRecordingFile(const CommandRecordingFile&) = delete;
+    CommandRecordingFile& operator=(const CommandRecordingFile&) = delete;
+
+    // Creates or truncates |path| to record frames to it.
+    static std::unique_ptr<CommandRecordingFile> create(const char* path) {
+        std::unique_ptr<CommandRecordingFile> file(new CommandRecordingFile(fopen(path, "we")));
+        const uint32_t header[] = {kMagic, kVersion};
+        if (!file->mFile || !file->writeWords(header, 2)) {
+            ALOGE("failed to create command recording %s", path);
+            return nullptr;
+        }
+        return file;
+    }
+
+    // Opens the recording at |path| to read its frames.
+    static std::unique_ptr<CommandRecordingFile> open(const char* path) {
+        std::unique_ptr<CommandRecordingFile> file(new CommandRecordingFile(fopen(path, "re")));
+        uint32_t header[2];
+        if (!file->mFile || !file->readWords(header, 2) || header[0] != kMagic ||
+            header[1] != kVersion) {
+            ALOGE("failed to open command recording %s", path);
+            return nullptr;
+        }
+        return file;
+    }
+
+    // Frames are buffered, and only guaranteed to be written once the file is
+    // closed, i.e. once the recording client is destroyed.
+    bool writeFrame(const uint32_t* commands, uint32_t length,
+                    const hidl_vec<hidl_handle>& handles) {
+        const uint32_t counts[] = {length, static_cast<uint32_t>(handles.size())};
+        if (!writeWords(counts, 2) || !writeWords(commands, length)) {
+            return false;
+        }
+        for (const auto& handle : handles) {
+            const native_handle_t* nativeHandle = handle.getNativeHandle();
+            const int32_t handleCounts[] = {
+                    nativeHandle ? nativeHandle->numFds : -1,
+                    nativeHandle ? nativeHandle->numInts : -1,
+            };
+            if (!writeWords(reinterpret_cast<const uint32_t*>(handleCounts), 2)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Returns false at the end of the recording, or if it is truncated.
+    bool readFrame(CommandRecordingFrame* outFrame) {
+        uint32_t counts[2];
+        if (!readWords(counts, 2) || counts[0] > kMaxFrameLength || counts[1] > counts[0]) {
+            return false;
+        }
+        outFrame->commands.resize(counts[0]);
+        outFrame->handles.resize(counts[1]);
+        return readWords(outFrame->commands.data(), counts[0]) &&
+               readWords(reinterpret_cast<uint32_t*>(outFrame->handles.data()), counts[1] * 2);
+    }
+
+  private:
+    explicit CommandRecordingFile(FILE* file) : mFile(file) {}
+
+    bool writeWords(const uint32_t* words, size_t count) {
+        return fwrite(words, sizeof(uint32_t), count, mFile) == count;
+    }
+
+    bool readWords(uint32_t* words, size_t count) {
+        return fread(words, sizeof(uint32_t), count, mFile) == count;
+    }
+
+    FILE* mFile;
+};
+
+static_assert(sizeof(CommandRecordingFrame::Handle) == 2 * sizeof(uint32_t),
+              "handles are read as pairs of words");
+
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "ComposerCommandBufferTest"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <composer-command-buffer/2.1/ComposerCommandBuffer.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+std::atomic<uint64_t> gAllocationCount{0};
+
+}  // namespace
+
+void* operator new(size_t size) {
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size);
+    if (!p) {
+        abort();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace {
+
+constexpr uint32_t kLayerCount = 24;
+constexpr int kFrameCount = 10;
+
+class CommandWriterBaseTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        mFenceFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        ASSERT_GE(mFenceFd, 0);
+    }
+
+    void TearDown() override { close(mFenceFd); }
+
+    // Writes the commands SurfaceFlinger sends for a frame of two displays.
+    void writeFrame(CommandWriterBase* writer, int frame) {
+        for (Display display = 0; display < 2; display++) {
+            writer->selectDisplay(display);
+            for (Layer layer = 1; layer <= kLayerCount; layer++) {
+                writer->selectLayer(layer);
+                writer->setLayerBuffer(frame % 3, nullptr, dup(mFenceFd));
+                writer->setLayerSurfaceDamage(mDamage);
+                writer->setLayerPlaneAlpha(1.0f);
+            }
+            writer->presentOrvalidateDisplay();
+        }
+    }
+
+    // Writes the frame to the queue and reads it back like the composer
+    // service would, without counting the allocations of the reader.
+    void sendFrame(CommandWriterBase* writer, std::vector<const native_handle_t*>* outHandles) {
+        bool queueChanged = false;
+        uint32_t commandLength = 0;
+        hidl_vec<hidl_handle> commandHandles;
+        ASSERT_TRUE(writer->writeQueue(&queueChanged, &commandLength, &commandHandles));
+
+        uint64_t allocationCount = gAllocationCount.load();
+        if (queueChanged) {
+            mReaderQueue = std::make_unique<CommandQueueType>(*writer->getMQDescriptor(), false);
+            mReaderData.resize(mReaderQueue->getQuantumCount());
+        }
+        ASSERT_TRUE(mReaderQueue->read(mReaderData.data(), commandLength));
+        outHandles->clear();
+        for (const auto& handle : commandHandles) {
+            outHandles->push_back(handle.getNativeHandle());
+        }
+        gAllocationCount = allocationCount;
+    }
+
+    int mFenceFd = -1;
+    const std::vector<IComposerClient::Rect> mDamage{{0, 0, 64, 64}};
+    std::unique_ptr<CommandQueueType> mReaderQueue;
+    std::vector<uint32_t> mReaderData;
+};
+
+// Temporary handles are allocated with malloc rather than operator new, they
+// are checked to be the ones of the first frame instead.  Memory of the size
+// of a handle is held meanwhile, so that a reallocated handle cannot get the
+// address of a freed one.
+TEST_F(CommandWriterBaseTest, SteadyStateFramesDoNotAllocate) {
+    CommandWriterBase writer(16);
+    std::vector<const native_handle_t*> handles;
+    handles.reserve(2 * kLayerCount);
+
+    writeFrame(&writer, 0);
+    sendFrame(&writer, &handles);
+    writer.reset();
+    const uint32_t growCount = writer.getDataGrowCount();
+    EXPECT_GT(growCount, 0u);
+    const std::set<const native_handle_t*> firstHandles(handles.begin(), handles.end());
+
+    std::vector<native_handle_t*> heldHandles;
+    for (int frame = 1; frame < kFrameCount; frame++) {
+        for (size_t i = 0; i < 2 * kLayerCount; i++) {
+            heldHandles.push_back(native_handle_create(1, 0));
+        }
+        uint64_t allocationCount = gAllocationCount.load();
+        writeFrame(&writer, frame);
+        sendFrame(&writer, &handles);
+        writer.reset();
+        EXPECT_EQ(allocationCount, gAllocationCount.load()) << "frame " << frame;
+        EXPECT_EQ(firstHandles, std::set<const native_handle_t*>(handles.begin(), handles.end()))
+                << "frame " << frame;
+    }
+    EXPECT_EQ(growCount, writer.getDataGrowCount());
+    for (auto handle : heldHandles) {
+        native_handle_delete(handle);
+    }
+}
+
+TEST_F(CommandWriterBaseTest, ReusedTemporaryHandlesHoldTheNewFences) {
+    CommandWriterBase writer(16);
+    std::vector<const native_handle_t*> handles;
+
+    writeFrame(&writer, 0);
+    sendFrame(&writer, &handles);
+    writer.reset();
+    ASSERT_EQ(2 * kLayerCount, handles.size());
+    std::set<const native_handle_t*> firstHandles(handles.begin(), handles.end());
+    EXPECT_EQ(2 * kLayerCount, firstHandles.size());
+
+    writeFrame(&writer, 1);
+    sendFrame(&writer, &handles);
+    for (const native_handle_t* handle : handles) {
+        ASSERT_EQ(1u, firstHandles.count(handle));
+        ASSERT_EQ(1, handle->numFds);
+        EXPECT_GE(fcntl(handle->data[0], F_GETFD), 0) << "fence of the frame must be open";
+    }
+    writer.reset();
+}
+
+}  // namespace
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
@@ -20,6 +20,17 @@
 #warning "ComposerClient.h included without LOG_TAG"
 #endif
 
+#ifdef COMPOSER_RECORD_COMMANDS
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/system_properties.h>
+#include <unistd.h>
+
+#include <atomic>
+#endif
+
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -76,6 +87,10 @@ class ComposerClientImpl : public Interface {
 
         mCommandEngine = createCommandEngine();
 
+#ifdef COMPOSER_RECORD_COMMANDS
+        startRecording();
+#endif
+
         return true;
     }
 
@@ -94,7 +109,8 @@ class ComposerClientImpl : public Interface {
          void onHotplug(Display display, IComposerCallback::Connection connected) {
              if (connected == IComposerCallback::Connection::CONNECTED) {
                  if (mResources->hasDisplay(display)) {
-                    std::lock_guard<std::recursive_mutex> lock(mResources->getLock());
+                    std::lock_guard<std::recursive_mutex> lock(
+                            mResources->getDisplayLock(display));
                      // This is a subsequent hotplug "connected" for a display. This signals a
                      // display change and thus the framework may want to reallocate buffers. We
                      // need to free all cached handles, since they are holding a strong reference
@@ -331,6 +347,28 @@ class ComposerClientImpl : public Interface {
         return std::make_unique<ComposerCommandEngine>(mHal, mResources.get());
     }
 
+#ifdef COMPOSER_RECORD_COMMANDS
+    // Records the commands of this client to <prefix>.<pid>.<client> when
+    // debug.composer.record_commands is set to <prefix> on a debuggable build,
+    // to replay them with composer_replay. Services enable this with the
+    // android.hardware.graphics.composer@2.1-record-commands defaults.
+    void startRecording() {
+        char debuggable[PROP_VALUE_MAX];
+        char prefix[PROP_VALUE_MAX];
+        if (__system_property_get("ro.debuggable", debuggable) <= 0 ||
+            strcmp(debuggable, "1") != 0 ||
+            __system_property_get("debug.composer.record_commands", prefix) <= 0) {
+            return;
+        }
+
+        static std::atomic<uint32_t> clientCount{0};
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s.%d.%" PRIu32, prefix, getpid(), clientCount++);
+        ALOGI("recording commands to %s", path);
+        mCommandEngine->setRecording(CommandRecordingFile::create(path));
+    }
+#endif
+
     static void cleanDisplayResources(Display display, ComposerResources* const resources,
                                       Hal* const hal) {
         size_t cacheSize;
@@ -23,6 +23,7 @@
 #include <vector>
 
 #include <composer-command-buffer/2.1/ComposerCommandBuffer.h>
+#include <composer-command-buffer/2.1/ComposerCommandRecording.h>
 #include <composer-hal/2.1/ComposerHal.h>
 #include <composer-resources/2.1/ComposerResources.h>
 // TODO remove hwcomposer_defs.h dependency
@@ -36,11 +37,6 @@ namespace composer {
 namespace V2_1 {
 namespace hal {
 
-#define RK_BUFFER_SLOT_SHIFT 8
-#define RK_BUFFER_CACHE_SHIFT 16
-#define RK_BUFFER_USE_CACHE_FLAG 1
-#define RK_BUFFER_USE_UNCACHE_FLAG (1 << 1)
-
 // TODO own a CommandReaderBase rather than subclassing
 class ComposerCommandEngine : protected CommandReaderBase {
    public:
@@ -55,11 +51,21 @@ class ComposerCommandEngine : protected CommandReaderBase {
         return setMQDescriptor(descriptor);
     }
 
+    // Records the command buffers passed to execute() from now on, to replay them
+    // with composer_replay.
+    void setRecording(std::unique_ptr<CommandRecordingFile> recording) {
+        mRecording = std::move(recording);
+    }
+
     Error execute(uint32_t inLength, const hidl_vec<hidl_handle>& inHandles, bool* outQueueChanged,
                   uint32_t* outCommandLength, hidl_vec<hidl_handle>* outCommandHandles) {
         if (!readQueue(inLength, inHandles)) {
             return Error::BAD_PARAMETER;
         }
+        if (mRecording && !mRecording->writeFrame(mData.get(), inLength, inHandles)) {
+            ALOGE("failed to record commands, recording stopped");
+            mRecording.reset();
+        }
 
         IComposerClient::Command command;
         uint16_t length = 0;
@@ -68,6 +74,13 @@ class ComposerCommandEngine : protected CommandReaderBase {
                 break;
             }
 
+            // Queued SET_LAYER_BUFFER commands are passed to ComposerHal before any other
+            // command that is passed to it, so that it sees the commands in their order.
+            if (command != IComposerClient::Command::SELECT_LAYER &&
+                command != IComposerClient::Command::SET_LAYER_BUFFER) {
+                executePendingLayerBuffers();
+            }
+
             bool parsed = executeCommand(command, length);
             endCommand();
 
@@ -77,6 +90,8 @@ class ComposerCommandEngine : protected CommandReaderBase {
             }
         }
 
+        executePendingLayerBuffers();
+
         if (!isEmpty()) {
             return Error::BAD_PARAMETER;
         }
@@ -91,6 +106,11 @@ class ComposerCommandEngine : protected CommandReaderBase {
     void reset() {
         CommandReaderBase::reset();
         mWriter->reset();
+        for (const auto& pending : mPendingLayerBufferCommands) {
+            close(pending.fence);
+        }
+        mPendingLayerBuffers.clear();
+        mPendingLayerBufferCommands.clear();
     }
 
    protected:
@@ -225,7 +245,7 @@ class ComposerCommandEngine : protected CommandReaderBase {
         bool closeFence = true;
 
         const native_handle_t* clientTarget;
-        std::lock_guard<std::recursive_mutex> lock(mResources->getLock());
+        std::lock_guard<std::recursive_mutex> lock(mResources->getDisplayLock(mCurrentDisplay));
         ComposerResources::ReplacedHandle replacedClientTarget(true);
         auto err = mResources->getDisplayClientTarget(mCurrentDisplay, slot, useCache, rawHandle,
                                                       &clientTarget, &replacedClientTarget);
@@ -257,7 +277,7 @@ class ComposerCommandEngine : protected CommandReaderBase {
         bool closeFence = true;
 
         const native_handle_t* outputBuffer;
-        std::lock_guard<std::recursive_mutex> lock(mResources->getLock());
+        std::lock_guard<std::recursive_mutex> lock(mResources->getDisplayLock(mCurrentDisplay));
         ComposerResources::ReplacedHandle replacedOutputBuffer(true);
         auto err = mResources->getDisplayOutputBuffer(mCurrentDisplay, slot, useCache, rawhandle,
                                                       &outputBuffer, &replacedOutputBuffer);
@@ -370,39 +390,48 @@ class ComposerCommandEngine : protected CommandReaderBase {
         auto slot = read();
         auto rawHandle = readHandle(&useCache);
         auto fence = readFence();
-        bool closeFence = true;
 
-        const native_handle_t* buffer;
-        ComposerResources::ReplacedHandle replacedBuffer(true);
+        // Consecutive SET_LAYER_BUFFER commands, possibly for different layers of the
+        // display, are looked up and passed to ComposerHal together. See execute().
+        mPendingLayerBuffers.emplace_back(mCurrentLayer, slot, useCache, rawHandle);
+        mPendingLayerBufferCommands.push_back({getCommandLoc(), fence});
 
-        std::lock_guard<std::recursive_mutex> lock(mResources->getLock());
-        auto err = mResources->getLayerBuffer(mCurrentDisplay, mCurrentLayer, slot, useCache,
-                                              rawHandle, &buffer, &replacedBuffer);
-        if (err == Error::NONE) {
-            int32_t cache_slot_mask = ((slot & 0xff) << RK_BUFFER_SLOT_SHIFT);
-            if(useCache){
-              cache_slot_mask |= (RK_BUFFER_USE_CACHE_FLAG << RK_BUFFER_CACHE_SHIFT);
-            }else{
-              cache_slot_mask |= (RK_BUFFER_USE_UNCACHE_FLAG << RK_BUFFER_CACHE_SHIFT);
-            }
-            err = mHal->setLayerBuffer(mCurrentDisplay, mCurrentLayer, buffer, cache_slot_mask * (-1));
-            if (err == Error::NONE) {
-              ALOGV("slot=%d useCache=%d cache_slot_mask=0x%x", slot, useCache, cache_slot_mask);
-            }
+        return true;
+    }
 
-            err = mHal->setLayerBuffer(mCurrentDisplay, mCurrentLayer, buffer, fence);
+    void executePendingLayerBuffers() {
+        if (mPendingLayerBuffers.empty()) {
+            return;
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(mResources->getDisplayLock(mCurrentDisplay));
+        mResources->getLayerBuffers(mCurrentDisplay, &mPendingLayerBuffers);
+        for (size_t i = 0; i < mPendingLayerBuffers.size(); i++) {
+            const auto& buffer = mPendingLayerBuffers[i];
+            const auto& command = mPendingLayerBufferCommands[i];
+            bool closeFence = true;
+
+            auto err = buffer.error;
             if (err == Error::NONE) {
-                closeFence = false;
+                mHal->setLayerBufferSlot(mCurrentDisplay, buffer.layer, buffer.bufferHandle,
+                                         buffer.slot, buffer.fromCache);
+                err = mHal->setLayerBuffer(mCurrentDisplay, buffer.layer, buffer.bufferHandle,
+                                           command.fence);
+                if (err == Error::NONE) {
+                    closeFence = false;
+                }
+            }
+            if (closeFence) {
+                close(command.fence);
+            }
+            if (err != Error::NONE) {
+                mWriter->setError(command.location, err);
             }
-        }
-        if (closeFence) {
-            close(fence);
-        }
-        if (err != Error::NONE) {
-            mWriter->setError(getCommandLoc(), err);
         }
 
-        return true;
+        // releases the replaced buffers, which ComposerHal no longer uses
+        mPendingLayerBuffers.clear();
+        mPendingLayerBufferCommands.clear();
     }
 
     bool executeSetLayerSurfaceDamage(uint16_t length) {
@@ -602,9 +631,18 @@ class ComposerCommandEngine : protected CommandReaderBase {
     ComposerHal* mHal;
     ComposerResources* mResources;
     std::unique_ptr<CommandWriterBase> mWriter;
+    std::unique_ptr<CommandRecordingFile> mRecording;
 
     Display mCurrentDisplay = 0;
     Layer mCurrentLayer = 0;
+
+    // SET_LAYER_BUFFER commands of mCurrentDisplay not executed yet
+    struct PendingLayerBufferCommand {
+        uint32_t location;
+        int fence;
+    };
+    std::vector<ComposerResources::LayerBuffer> mPendingLayerBuffers;
+    std::vector<PendingLayerBufferCommand> mPendingLayerBufferCommands;
 };
 
 }  // namespace hal
@@ -113,6 +113,13 @@ class ComposerHal {
     virtual Error setLayerCursorPosition(Display display, Layer layer, int32_t x, int32_t y) = 0;
     virtual Error setLayerBuffer(Display display, Layer layer, buffer_handle_t buffer,
                                  int32_t acquireFence) = 0;
+    // Called right before setLayerBuffer with the buffer cache slot |buffer| is in,
+    // and whether it was looked up in the cache rather than newly imported.
+    virtual Error setLayerBufferSlot(Display /*display*/, Layer /*layer*/,
+                                     buffer_handle_t /*buffer*/, uint32_t /*slot*/,
+                                     bool /*fromCache*/) {
+        return Error::NONE;
+    }
     virtual Error setLayerSurfaceDamage(Display display, Layer layer,
                                         const std::vector<hwc_rect_t>& damage) = 0;
     virtual Error setLayerBlendMode(Display display, Layer layer, int32_t mode) = 0;
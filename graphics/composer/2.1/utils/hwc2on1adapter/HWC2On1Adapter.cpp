@@ -25,8 +25,10 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 
 #include <hardware/hwcomposer.h>
@@ -329,6 +331,7 @@ Error HWC2On1Adapter::createVirtualDisplay(uint32_t width,
     const auto displayId = mHwc1VirtualDisplay->getId();
     mHwc1DisplayMap[HWC_DISPLAY_VIRTUAL] = displayId;
     mHwc1VirtualDisplay->setHwc1Id(HWC_DISPLAY_VIRTUAL);
+    std::lock_guard<std::mutex> displaysLock(mDisplaysMutex);
     mDisplays.emplace(displayId, mHwc1VirtualDisplay);
     *outDisplay = displayId;
 
@@ -344,6 +347,7 @@ Error HWC2On1Adapter::destroyVirtualDisplay(hwc2_display_t displayId) {
 
     mHwc1VirtualDisplay.reset();
     mHwc1DisplayMap.erase(HWC_DISPLAY_VIRTUAL);
+    std::lock_guard<std::mutex> displaysLock(mDisplaysMutex);
     mDisplays.erase(displayId);
 
     return Error::None;
@@ -511,6 +515,7 @@ HWC2On1Adapter::Display::Display(HWC2On1Adapter& device, HWC2::DisplayType type)
     mDevice(device),
     mStateMutex(),
     mHwc1RequestedContents(nullptr),
+    mHwc1RequestedContentsSize(0),
     mRetireFence(),
     mChanges(),
     mHwc1Id(-1),
@@ -528,6 +533,7 @@ HWC2On1Adapter::Display::Display(HWC2On1Adapter& device, HWC2::DisplayType type)
     mHwc1LayerMap(),
     mNumAvailableRects(0),
     mNextAvailableRect(nullptr),
+    mLayersChanged(true),
     mGeometryChanged(false),
     mHasPrepare(false),
     mHasSet(false)
@@ -568,6 +574,7 @@ Error HWC2On1Adapter::Display::createLayer(hwc2_layer_t* outLayerId) {
     mDevice.mLayers.emplace(std::make_pair(layer->getId(), layer));
     *outLayerId = layer->getId();
     ALOGV("[%" PRIu64 "] created layer %" PRIu64, mId, *outLayerId);
+    mLayersChanged = true;
     markGeometryChanged();
     return Error::None;
 }
@@ -591,6 +598,7 @@ Error HWC2On1Adapter::Display::destroyLayer(hwc2_layer_t layerId) {
         }
     }
     ALOGV("[%" PRIu64 "] destroyed layer %" PRIu64, mId, layerId);
+    mLayersChanged = true;
     markGeometryChanged();
     return Error::None;
 }
@@ -787,9 +795,14 @@ Error HWC2On1Adapter::Display::getType(int32_t* outType) {
 }
 
 Error HWC2On1Adapter::Display::present(int32_t* outRetireFence) {
+    // HWC1 set() also takes every display at once, so presents of different
+    // displays are serialized like validates; see validate().
+    std::unique_lock<std::recursive_timed_mutex> deviceLock(mDevice.mStateMutex);
     std::unique_lock<std::recursive_mutex> lock(mStateMutex);
     if (mChanges && !mHasSet) {
+        lock.unlock();
         Error error = mDevice.setAllDisplays();
+        lock.lock();
         if (error != Error::None) {
             ALOGE("[%" PRIu64 "] present: setAllDisplaysFailed (%s)", mId,
                     to_string(error).c_str());
@@ -974,15 +987,28 @@ Error HWC2On1Adapter::Display::setVsyncEnabled(Vsync enable) {
 
 Error HWC2On1Adapter::Display::validate(uint32_t* outNumTypes,
         uint32_t* outNumRequests) {
+    // HWC1 prepare() takes the contents of every display at once, so
+    // validating one display prepares all of them, and validates of different
+    // displays are serialized on the device lock: the first one calls
+    // prepareAllDisplays(), the others then find their changes already
+    // generated. Only layer and display state updates run concurrently across
+    // displays. The device is always locked before its displays, and this
+    // display is unlocked while prepareAllDisplays() locks every display in
+    // turn, so that display locks are never nested.
+    std::unique_lock<std::recursive_timed_mutex> deviceLock(mDevice.mStateMutex);
     std::unique_lock<std::recursive_mutex> lock(mStateMutex);
 
     if (!mChanges && !mHasPrepare) {
-        if (!mDevice.prepareAllDisplays()) {
+        lock.unlock();
+        bool prepared = mDevice.prepareAllDisplays();
+        lock.lock();
+        if (!prepared || !mChanges) {
             return Error::BadDisplay;
         }
     } else if(!mHasPrepare){
         ALOGE("Validate was called more than once!");
     }
+    deviceLock.unlock();
 
     *outNumTypes = mChanges->getNumTypes();
     *outNumRequests = mChanges->getNumLayerRequests();
@@ -1027,6 +1053,7 @@ Error HWC2On1Adapter::Display::updateLayerZ(hwc2_layer_t layerId, uint32_t z) {
 
     layer->setZ(z);
     mLayers.emplace(std::move(layer));
+    mLayersChanged = true;
     markGeometryChanged();
 
     return Error::None;
@@ -1218,8 +1245,42 @@ bool HWC2On1Adapter::Display::prepare() {
         return false;
     }
 
-    allocateRequestedContents();
-    assignHwc1LayerIds();
+    if (mHasPrepare && mHwc1RequestedContents) {
+        // Prepared again without being set, the acquire fences dup'ed by the
+        // last prepare were never handed to HWC1
+        auto& contents = *mHwc1RequestedContents;
+        for (size_t l = 0; l < contents.numHwLayers; ++l) {
+            if (contents.hwLayers[l].acquireFenceFd != -1) {
+                close(contents.hwLayers[l].acquireFenceFd);
+                contents.hwLayers[l].acquireFenceFd = -1;
+            }
+        }
+        if (contents.outbufAcquireFenceFd != -1) {
+            close(contents.outbufAcquireFenceFd);
+            contents.outbufAcquireFenceFd = -1;
+        }
+    }
+
+    bool cleared = allocateRequestedContents();
+    if (cleared) {
+        assignHwc1LayerIds();
+        for (auto& layer : mLayers) {
+            layer->markDirty(Layer::kDirtyAll);
+        }
+    }
+
+    // The visible regions of all layers are laid out again in the rect pool
+    // as soon as one of them changed.
+    bool layoutRects = cleared || std::any_of(mLayers.begin(), mLayers.end(),
+            [](const std::shared_ptr<Layer>& layer) {
+                return layer->hasDirtyVisibleRegion();
+            });
+    if (layoutRects) {
+        resetRects();
+        for (auto& layer : mLayers) {
+            layer->markDirty(Layer::kDirtyVisibleRegion);
+        }
+    }
 
     mHwc1RequestedContents->retireFenceFd = -1;
     mHwc1RequestedContents->flags = 0;
@@ -1235,12 +1296,14 @@ bool HWC2On1Adapter::Display::prepare() {
         auto& hwc1Layer = mHwc1RequestedContents->hwLayers[layer->getHwc1Id()];
         hwc1Layer.releaseFenceFd = -1;
         hwc1Layer.acquireFenceFd = -1;
+        hwc1Layer.hints = 0;
         ALOGV("Applying states for layer %" PRIu64 " ", layer->getId());
         layer->applyState(hwc1Layer);
     }
 
-    prepareFramebufferTarget();
+    prepareFramebufferTarget(layoutRects);
 
+    mLayersChanged = false;
     resetGeometryMarker();
 
     return true;
@@ -1785,7 +1848,7 @@ void HWC2On1Adapter::Display::initializeActiveConfig() {
 
 }
 
-void HWC2On1Adapter::Display::allocateRequestedContents() {
+bool HWC2On1Adapter::Display::allocateRequestedContents() {
     // What needs to be allocated:
     // 1 hwc_display_contents_1_t
     // 1 hwc_layer_1_t for each layer
@@ -1812,10 +1875,26 @@ void HWC2On1Adapter::Display::allocateRequestedContents() {
     size_t size = sizeof(hwc_display_contents_1_t) +
             sizeof(hwc_layer_1_t) * numLayers +
             sizeof(hwc_rect_t) * numRects;
+    if (mHwc1RequestedContents && size <= mHwc1RequestedContentsSize) {
+        if (!mLayersChanged) {
+            return false;
+        }
+        std::memset(mHwc1RequestedContents.get(), 0, mHwc1RequestedContentsSize);
+        return true;
+    }
     auto contents = static_cast<hwc_display_contents_1_t*>(std::calloc(size, 1));
     mHwc1RequestedContents.reset(contents);
-    mNextAvailableRect = reinterpret_cast<hwc_rect_t*>(&contents->hwLayers[numLayers]);
-    mNumAvailableRects = numRects;
+    mHwc1RequestedContentsSize = size;
+    return true;
+}
+
+void HWC2On1Adapter::Display::resetRects() {
+    auto numLayers = mLayers.size() + 1;
+    size_t offset = sizeof(hwc_display_contents_1_t) +
+            sizeof(hwc_layer_1_t) * numLayers;
+    mNextAvailableRect = reinterpret_cast<hwc_rect_t*>(
+            &mHwc1RequestedContents->hwLayers[numLayers]);
+    mNumAvailableRects = (mHwc1RequestedContentsSize - offset) / sizeof(hwc_rect_t);
 }
 
 void HWC2On1Adapter::Display::assignHwc1LayerIds() {
@@ -1870,7 +1949,7 @@ void HWC2On1Adapter::Display::updateLayerRequests(
     }
 }
 
-void HWC2On1Adapter::Display::prepareFramebufferTarget() {
+void HWC2On1Adapter::Display::prepareFramebufferTarget(bool layoutRects) {
     // We check that mActiveConfig is valid in Display::prepare
     int32_t width = mActiveConfig->getAttribute(Attribute::Width);
     int32_t height = mActiveConfig->getAttribute(Attribute::Height);
@@ -1892,7 +1971,8 @@ void HWC2On1Adapter::Display::prepareFramebufferTarget() {
     hwc1Target.planeAlpha = 255;
 
     hwc1Target.visibleRegionScreen.numRects = 1;
-    hwc_rect_t* rects = GetRects(1);
+    hwc_rect_t* rects = layoutRects ? GetRects(1) :
+            const_cast<hwc_rect_t*>(hwc1Target.visibleRegionScreen.rects);
     rects[0].left = 0;
     rects[0].top = 0;
     rects[0].right = width;
@@ -1925,7 +2005,8 @@ HWC2On1Adapter::Layer::Layer(Display& display)
     mZ(0),
     mReleaseFence(),
     mHwc1Id(0),
-    mHasUnsupportedPlaneAlpha(false) {}
+    mHasUnsupportedPlaneAlpha(false),
+    mDirtyFlags(kDirtyAll) {}
 
 bool HWC2On1Adapter::SortLayersByZ::operator()(const std::shared_ptr<Layer>& lhs,
                                                const std::shared_ptr<Layer>& rhs) const {
@@ -1970,6 +2051,7 @@ Error HWC2On1Adapter::Layer::setSurfaceDamage(hwc_region_t damage) {
 
 Error HWC2On1Adapter::Layer::setBlendMode(BlendMode mode) {
     mBlendMode = mode;
+    markDirty(kDirtyCommonState);
     mDisplay.markGeometryChanged();
     return Error::None;
 }
@@ -1988,18 +2070,21 @@ Error HWC2On1Adapter::Layer::setCompositionType(Composition type) {
 
 Error HWC2On1Adapter::Layer::setDataspace(android_dataspace_t dataspace) {
     mDataSpace = dataspace;
+    markDirty(kDirtyCommonState);
     mDisplay.markGeometryChanged();
     return Error::None;
 }
 
 Error HWC2On1Adapter::Layer::setDisplayFrame(hwc_rect_t frame) {
     mDisplayFrame = frame;
+    markDirty(kDirtyCommonState);
     mDisplay.markGeometryChanged();
     return Error::None;
 }
 
 Error HWC2On1Adapter::Layer::setPlaneAlpha(float alpha) {
     mPlaneAlpha = alpha;
+    markDirty(kDirtyCommonState);
     mDisplay.markGeometryChanged();
     return Error::None;
 }
@@ -2012,12 +2097,14 @@ Error HWC2On1Adapter::Layer::setSidebandStream(const native_handle_t* stream) {
 
 Error HWC2On1Adapter::Layer::setSourceCrop(hwc_frect_t crop) {
     mSourceCrop = crop;
+    markDirty(kDirtyCommonState);
     mDisplay.markGeometryChanged();
     return Error::None;
 }
 
 Error HWC2On1Adapter::Layer::setTransform(Transform transform) {
     mTransform = transform;
+    markDirty(kDirtyCommonState);
     mDisplay.markGeometryChanged();
     return Error::None;
 }
@@ -2035,6 +2122,7 @@ Error HWC2On1Adapter::Layer::setVisibleRegion(hwc_region_t visible) {
                     compareRects)) {
         mVisibleRegion.resize(visible.numRects);
         std::copy_n(visible.rects, visible.numRects, mVisibleRegion.begin());
+        markDirty(kDirtyVisibleRegion);
         mDisplay.markGeometryChanged();
     }
     return Error::None;
@@ -2055,7 +2143,13 @@ const sp<MiniFence>& HWC2On1Adapter::Layer::getReleaseFence() const {
 }
 
 void HWC2On1Adapter::Layer::applyState(hwc_layer_1_t& hwc1Layer) {
-    applyCommonState(hwc1Layer);
+    if ((mDirtyFlags & kDirtyCommonState) != 0) {
+        applyCommonState(hwc1Layer);
+    }
+    if ((mDirtyFlags & kDirtyVisibleRegion) != 0) {
+        applyVisibleRegion(hwc1Layer);
+    }
+    mDirtyFlags = 0;
     applyCompositionType(hwc1Layer);
     switch (mCompositionType) {
         case Composition::SolidColor : applySolidColorState(hwc1Layer); break;
@@ -2165,7 +2259,9 @@ void HWC2On1Adapter::Layer::applyCommonState(hwc_layer_1_t& hwc1Layer) {
     hwc1Layer.reserved[3] = (pendingDataSpace >> 24) & 0xFF;
 
     hwc1Layer.transform = static_cast<uint32_t>(mTransform);
+}
 
+void HWC2On1Adapter::Layer::applyVisibleRegion(hwc_layer_1_t& hwc1Layer) {
     auto& hwc1VisibleRegion = hwc1Layer.visibleRegionScreen;
     hwc1VisibleRegion.numRects = mVisibleRegion.size();
     hwc_rect_t* rects = mDisplay.GetRects(hwc1VisibleRegion.numRects);
@@ -2287,7 +2383,7 @@ void HWC2On1Adapter::populateCapabilities() {
 }
 
 HWC2On1Adapter::Display* HWC2On1Adapter::getDisplay(hwc2_display_t id) {
-    std::unique_lock<std::recursive_timed_mutex> lock(mStateMutex);
+    std::lock_guard<std::mutex> lock(mDisplaysMutex);
 
     auto display = mDisplays.find(id);
     if (display == mDisplays.end()) {
@@ -2323,16 +2419,26 @@ void HWC2On1Adapter::populatePrimary() {
     mHwc1DisplayMap[HWC_DISPLAY_PRIMARY] = display->getId();
     display->setHwc1Id(HWC_DISPLAY_PRIMARY);
     display->populateConfigs();
+    std::lock_guard<std::mutex> displaysLock(mDisplaysMutex);
     mDisplays.emplace(display->getId(), std::move(display));
 }
 
 bool HWC2On1Adapter::prepareAllDisplays() {
     ATRACE_CALL();
 
+    // The HWC1 contents of the displays are rebuilt under the state lock, as
+    // setAllDisplays() passes them to HWC1 under it.
     std::unique_lock<std::recursive_timed_mutex> lock(mStateMutex);
 
-    for (const auto& displayPair : mDisplays) {
-        auto& display = displayPair.second;
+    std::vector<std::shared_ptr<Display>> displays;
+    {
+        std::lock_guard<std::mutex> displaysLock(mDisplaysMutex);
+        displays.reserve(mDisplays.size());
+        for (const auto& displayPair : mDisplays) {
+            displays.push_back(displayPair.second);
+        }
+    }
+    for (const auto& display : displays) {
         if (!display->prepare()) {
             return false;
         }
@@ -2615,6 +2721,7 @@ Error HWC2On1Adapter::Display::destroyLayers() {
     }
 
     mLayers.clear();
+    mLayersChanged = true;
     markGeometryChanged();
 
     return Error::None;
@@ -2644,6 +2751,7 @@ void HWC2On1Adapter::hwc1Hotplug(int hwc1DisplayId, int connected) {
         display->populateConfigs();
         displayId = display->getId();
         mHwc1DisplayMap[HWC_DISPLAY_EXTERNAL] = displayId;
+        std::lock_guard<std::mutex> displaysLock(mDisplaysMutex);
         mDisplays.emplace(displayId, std::move(display));
     } else {
         if (connected != 0) {
@@ -2690,6 +2798,7 @@ void HWC2On1Adapter::hwc1Hotplug(int hwc1DisplayId, int connected) {
         // Disconnect an existing display
         mHwc1DisplayMap.erase(HWC_DISPLAY_EXTERNAL);
         display->destroyLayers();
+        std::lock_guard<std::mutex> displaysLock(mDisplaysMutex);
         mDisplays.erase(displayId);
     }
 
@@ -258,6 +258,8 @@ private:
             // Set configs for a virtual display
             void populateConfigs(uint32_t width, uint32_t height);
 
+            // Rebuilds the HWC1 contents of this display, re-applying only
+            // the layer state that changed since the last call.
             bool prepare();
 
             // Called after hwc.prepare() with responses from the device.
@@ -283,6 +285,10 @@ private:
             void resetHasPrepare() { mHasPrepare = false;}
             void markHasSet() { mHasSet = true; }
             void resetHasSet() { mHasSet = false;}
+
+            // Layer state is read by prepare(), which may run on behalf of
+            // another display, so layer calls also take this mutex.
+            std::recursive_mutex& getStateMutex() const { return mStateMutex; }
         private:
             class Config {
                 public:
@@ -392,8 +398,9 @@ private:
                     const Layer& layer);
 
             // Set all fields in HWC1 comm array for layer containing the
-            // HWC_FRAMEBUFFER_TARGET (always the last layer).
-            void prepareFramebufferTarget();
+            // HWC_FRAMEBUFFER_TARGET (always the last layer). Its visible
+            // region is taken from the rect pool if layoutRects is true.
+            void prepareFramebufferTarget(bool layoutRects);
 
             // Display ID generator.
             static std::atomic<hwc2_display_t> sNextId;
@@ -415,12 +422,19 @@ private:
 
             // Allocate RAM able to store all layers and rects used for
             // communication with HWC1. Place allocated RAM in variable
-            // mHwc1RequestedContents.
-            void allocateRequestedContents();
+            // mHwc1RequestedContents. The previous allocation is kept while
+            // it is large enough and the layers did not change. Returns true
+            // if the contents were cleared, in which case every layer has to
+            // be applied again.
+            bool allocateRequestedContents();
+
+            // Makes the whole rect pool following the layers available again.
+            void resetRects();
 
             // Array of structs exchanged between client and hwc1 device.
             // Sent to device upon calling prepare().
             std::unique_ptr<hwc_display_contents_1> mHwc1RequestedContents;
+            size_t mHwc1RequestedContentsSize;
     private:
             DeferredFence mRetireFence;
 
@@ -459,6 +473,11 @@ private:
             size_t mNumAvailableRects;
             hwc_rect_t* mNextAvailableRect;
 
+            // True if layers were created, destroyed or reordered since the
+            // last call to Display::prepare(), in which case the HWC1 ids of
+            // all layers are assigned again.
+            bool mLayersChanged;
+
             // True if any of the Layers contained in this Display have been
             // updated with anything other than a buffer since last call to
             // Display::set()
@@ -567,6 +586,19 @@ private:
             void setHwc1Id(size_t id) { mHwc1Id = id; }
             size_t getHwc1Id() const { return mHwc1Id; }
 
+            // State which is only written to the HWC1 communication struct
+            // when it changed. HWC1 may only modify the composition type and
+            // the hints of a layer, everything else is kept across frames.
+            static constexpr uint32_t kDirtyCommonState = 1 << 0;
+            static constexpr uint32_t kDirtyVisibleRegion = 1 << 1;
+            static constexpr uint32_t kDirtyAll =
+                    kDirtyCommonState | kDirtyVisibleRegion;
+
+            void markDirty(uint32_t flags) { mDirtyFlags |= flags; }
+            bool hasDirtyVisibleRegion() const {
+                return (mDirtyFlags & kDirtyVisibleRegion) != 0;
+            }
+
             // Write state to HWC1 communication struct.
             void applyState(struct hwc_layer_1& hwc1Layer);
 
@@ -584,6 +616,7 @@ private:
             }
         private:
             void applyCommonState(struct hwc_layer_1& hwc1Layer);
+            void applyVisibleRegion(struct hwc_layer_1& hwc1Layer);
             void applySolidColorState(struct hwc_layer_1& hwc1Layer);
             void applySidebandState(struct hwc_layer_1& hwc1Layer);
             void applyBufferState(struct hwc_layer_1& hwc1Layer);
@@ -613,6 +646,9 @@ private:
 
             size_t mHwc1Id;
             bool mHasUnsupportedPlaneAlpha;
+
+            // kDirty* flags of the state changed since the last applyState()
+            uint32_t mDirtyFlags;
     };
 
     // Utility tempate calling a Layer object method based on ID parameters:
@@ -627,6 +663,8 @@ private:
         auto error = std::get<HWC2::Error>(result);
         if (error == HWC2::Error::None) {
             auto layer = std::get<Layer*>(result);
+            std::unique_lock<std::recursive_mutex> lock(
+                    layer->getDisplay().getStateMutex());
             error = ((*layer).*member)(std::forward<Args>(args)...);
         }
         return static_cast<int32_t>(error);
@@ -736,6 +774,12 @@ private:
     // Mapping between HWC1 display id and Display objects.
     std::map<hwc2_display_t, std::shared_ptr<Display>> mDisplays;
 
+    // Display lookups only take this mutex rather than mStateMutex, so that
+    // calls into one display do not wait for HWC1 prepare() or set(). It is
+    // held in addition to mStateMutex to modify mDisplays, and is always
+    // taken last.
+    std::mutex mDisplaysMutex;
+
     // Map HWC1 display type (HWC_DISPLAY_PRIMARY, HWC_DISPLAY_EXTERNAL,
     // HWC_DISPLAY_VIRTUAL) to Display IDs generated by HWC2on1Adapter objects.
     std::unordered_map<int, hwc2_display_t> mHwc1DisplayMap;
@@ -42,6 +42,12 @@ namespace composer {
 namespace V2_1 {
 namespace passthrough {
 
+// Encoding of the buffer cache slot passed through setLayerBuffer
+#define RK_BUFFER_SLOT_SHIFT 8
+#define RK_BUFFER_CACHE_SHIFT 16
+#define RK_BUFFER_USE_CACHE_FLAG 1
+#define RK_BUFFER_USE_UNCACHE_FLAG (1 << 1)
+
 namespace detail {
 
 using android::hardware::graphics::common::V1_0::ColorMode;
@@ -420,6 +426,18 @@ class HwcHalImpl : public Hal {
         return static_cast<Error>(err);
     }
 
+    // The device takes the slot of the next buffer through setLayerBuffer, encoded
+    // as a negative acquire fence.
+    Error setLayerBufferSlot(Display display, Layer layer, buffer_handle_t buffer, uint32_t slot,
+                             bool fromCache) override {
+        int32_t cacheSlotMask = (slot & 0xff) << RK_BUFFER_SLOT_SHIFT;
+        cacheSlotMask |= (fromCache ? RK_BUFFER_USE_CACHE_FLAG : RK_BUFFER_USE_UNCACHE_FLAG)
+                         << RK_BUFFER_CACHE_SHIFT;
+        ALOGV("slot=%u fromCache=%d cacheSlotMask=0x%x", slot, fromCache, cacheSlotMask);
+        int32_t err = mDispatch.setLayerBuffer(mDevice, display, layer, buffer, -cacheSlotMask);
+        return static_cast<Error>(err);
+    }
+
     Error setLayerSurfaceDamage(Display display, Layer layer,
                                 const std::vector<hwc_rect_t>& damage) override {
         hwc_region region = {damage.size(), damage.data()};
@@ -0,0 +1,414 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Replays recorded composer command buffers against ComposerCommandEngine, with
+// a ComposerHal that does nothing, and reports how long parsing and dispatching
+// each frame took.
+//
+// Recordings are made on userdebug and eng builds by composer services using
+// the android.hardware.graphics.composer@2.1-record-commands defaults, by
+// setting debug.composer.record_commands to a writable path prefix before the
+// service starts (see ComposerClientImpl::startRecording), or synthesized:
+//
+//   composer_replay --synthesize <displays> <layers> <frames> <recording>
+//   composer_replay <recording> [<iterations>]
+
+#define LOG_TAG "composer_replay"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <composer-command-buffer/2.1/ComposerCommandBuffer.h>
+#include <composer-command-buffer/2.1/ComposerCommandRecording.h>
+#include <composer-hal/2.1/ComposerCommandEngine.h>
+#include <composer-hal/2.1/ComposerHal.h>
+#include <composer-resources/2.1/ComposerResources.h>
+
+namespace {
+
+std::atomic<uint64_t> gAllocationCount{0};
+
+}  // namespace
+
+// Counts the allocations made while executing a frame.
+void* operator new(size_t size) {
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size);
+    if (!p) {
+        abort();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+namespace android {
+namespace hardware {
+namespace graphics {
+namespace composer {
+namespace V2_1 {
+namespace replay {
+
+using hal::ComposerCommandEngine;
+using hal::ComposerHal;
+using hal::ComposerResources;
+
+// Buffer slots per layer and client target slots per display, as SurfaceFlinger uses.
+constexpr uint32_t kBufferSlotCount = 64;
+
+// Accepts every call, and releases the fences it is given.
+class NullComposerHal : public ComposerHal {
+  public:
+    bool hasCapability(hwc2_capability_t capability) override {
+        return capability == HWC2_CAPABILITY_SKIP_VALIDATE;
+    }
+    std::string dumpDebugInfo() override { return {}; }
+    void registerEventCallback(EventCallback*) override {}
+    void unregisterEventCallback() override {}
+
+    uint32_t getMaxVirtualDisplayCount() override { return 0; }
+    Error createVirtualDisplay(uint32_t, uint32_t, PixelFormat*, Display*) override {
+        return Error::NO_RESOURCES;
+    }
+    Error destroyVirtualDisplay(Display) override { return Error::BAD_DISPLAY; }
+    Error createLayer(Display, Layer*) override { return Error::NO_RESOURCES; }
+    Error destroyLayer(Display, Layer) override { return Error::BAD_LAYER; }
+
+    Error getActiveConfig(Display, Config*) override { return Error::UNSUPPORTED; }
+    Error getClientTargetSupport(Display, uint32_t, uint32_t, PixelFormat, Dataspace) override {
+        return Error::UNSUPPORTED;
+    }
+    Error getColorModes(Display, hidl_vec<ColorMode>*) override { return Error::UNSUPPORTED; }
+    Error getDisplayAttribute(Display, Config, IComposerClient::Attribute, int32_t*) override {
+        return Error::UNSUPPORTED;
+    }
+    Error getDisplayConfigs(Display, hidl_vec<Config>*) override { return Error::UNSUPPORTED; }
+    Error getDisplayName(Display, hidl_string*) override { return Error::UNSUPPORTED; }
+    Error getDisplayType(Display, IComposerClient::DisplayType*) override {
+        return Error::UNSUPPORTED;
+    }
+    Error getDozeSupport(Display, bool*) override { return Error::UNSUPPORTED; }
+    Error getHdrCapabilities(Display, hidl_vec<Hdr>*, float*, float*, float*) override {
+        return Error::UNSUPPORTED;
+    }
+
+    Error setActiveConfig(Display, Config) override { return Error::NONE; }
+    Error setColorMode(Display, ColorMode) override { return Error::NONE; }
+    Error setPowerMode(Display, IComposerClient::PowerMode) override { return Error::NONE; }
+    Error setVsyncEnabled(Display, IComposerClient::Vsync) override { return Error::NONE; }
+
+    Error setColorTransform(Display, const float*, int32_t) override { return Error::NONE; }
+    Error setClientTarget(Display, buffer_handle_t, int32_t acquireFence, int32_t,
+                          const std::vector<hwc_rect_t>&) override {
+        return closeFence(acquireFence);
+    }
+    Error setOutputBuffer(Display, buffer_handle_t, int32_t releaseFence) override {
+        return closeFence(releaseFence);
+    }
+    Error validateDisplay(Display, std::vector<Layer>*, std::vector<IComposerClient::Composition>*,
+                          uint32_t*, std::vector<Layer>*, std::vector<uint32_t>*) override {
+        return Error::NONE;
+    }
+    Error acceptDisplayChanges(Display) override { return Error::NONE; }
+    Error presentDisplay(Display, int32_t* outPresentFence, std::vector<Layer>*,
+                         std::vector<int32_t>*) override {
+        *outPresentFence = -1;
+        return Error::NONE;
+    }
+
+    Error setLayerCursorPosition(Display, Layer, int32_t, int32_t) override { return Error::NONE; }
+    Error setLayerBuffer(Display, Layer, buffer_handle_t, int32_t acquireFence) override {
+        return closeFence(acquireFence);
+    }
+    Error setLayerSurfaceDamage(Display, Layer, const std::vector<hwc_rect_t>&) override {
+        return Error::NONE;
+    }
+    Error setLayerBlendMode(Display, Layer, int32_t) override { return Error::NONE; }
+    Error setLayerColor(Display, Layer, IComposerClient::Color) override { return Error::NONE; }
+    Error setLayerCompositionType(Display, Layer, int32_t) override { return Error::NONE; }
+    Error setLayerDataspace(Display, Layer, int32_t) override { return Error::NONE; }
+    Error setLayerDisplayFrame(Display, Layer, const hwc_rect_t&) override { return Error::NONE; }
+    Error setLayerPlaneAlpha(Display, Layer, float) override { return Error::NONE; }
+    Error setLayerSidebandStream(Display, Layer, buffer_handle_t) override { return Error::NONE; }
+    Error setLayerSourceCrop(Display, Layer, const hwc_frect_t&) override { return Error::NONE; }
+    Error setLayerTransform(Display, Layer, int32_t) override { return Error::NONE; }
+    Error setLayerVisibleRegion(Display, Layer, const std::vector<hwc_rect_t>&) override {
+        return Error::NONE;
+    }
+    Error setLayerZOrder(Display, Layer, uint32_t) override { return Error::NONE; }
+
+  private:
+    static Error closeFence(int32_t fence) {
+        if (fence >= 0) {
+            close(fence);
+        }
+        return Error::NONE;
+    }
+};
+
+// Exposes the command buffer of the replies.
+class ReplayCommandEngine : public ComposerCommandEngine {
+  public:
+    using ComposerCommandEngine::ComposerCommandEngine;
+
+    uint32_t getWriterGrowCount() const { return mWriter->getDataGrowCount(); }
+};
+
+// Finds the displays and layers the recorded frames select, which must be
+// known to ComposerResources before their buffers are looked up.
+void addDisplaysAndLayers(const std::vector<CommandRecordingFrame>& frames,
+                          ComposerResources* resources) {
+    constexpr uint32_t opcodeMask = static_cast<uint32_t>(IComposerClient::Command::OPCODE_MASK);
+    constexpr uint32_t lengthMask = static_cast<uint32_t>(IComposerClient::Command::LENGTH_MASK);
+
+    std::set<std::pair<Display, Layer>> layers;
+    for (const auto& frame : frames) {
+        Display display = 0;
+        const std::vector<uint32_t>& commands = frame.commands;
+        for (size_t i = 0; i < commands.size();) {
+            auto command = static_cast<IComposerClient::Command>(commands[i] & opcodeMask);
+            size_t length = commands[i] & lengthMask;
+            if (i + 1 + length > commands.size()) {
+                break;
+            }
+            if (length == 2) {
+                uint64_t id = (static_cast<uint64_t>(commands[i + 2]) << 32) | commands[i + 1];
+                if (command == IComposerClient::Command::SELECT_DISPLAY) {
+                    display = id;
+                    if (!resources->hasDisplay(display)) {
+                        resources->addPhysicalDisplay(display);
+                        resources->setDisplayClientTargetCacheSize(display, kBufferSlotCount);
+                    }
+                } else if (command == IComposerClient::Command::SELECT_LAYER &&
+                           layers.emplace(display, id).second) {
+                    resources->addLayer(display, id, kBufferSlotCount);
+                }
+            }
+            i += 1 + length;
+        }
+    }
+}
+
+// The handles of a recorded frame: empty handles stand in for buffers, so
+// that they are imported as null buffers, and fences are duplicates of
+// |fenceFd|.
+class PlaceholderHandles {
+  public:
+    PlaceholderHandles(const CommandRecordingFrame& frame, int fenceFd) {
+        mNativeHandles.reserve(frame.handles.size());
+        mHandles.resize(frame.handles.size());
+        for (size_t i = 0; i < frame.handles.size(); i++) {
+            const CommandRecordingFrame::Handle& handle = frame.handles[i];
+            if (handle.isNull()) {
+                continue;
+            }
+            native_handle_t* nativeHandle = native_handle_create(handle.isFence() ? 1 : 0, 0);
+            if (handle.isFence()) {
+                nativeHandle->data[0] = fenceFd;
+            }
+            mNativeHandles.push_back(nativeHandle);
+            mHandles[i] = nativeHandle;
+        }
+    }
+
+    ~PlaceholderHandles() {
+        // fenceFd is owned by the caller
+        for (auto nativeHandle : mNativeHandles) {
+            native_handle_delete(nativeHandle);
+        }
+    }
+
+    const hidl_vec<hidl_handle>& get() const { return mHandles; }
+
+  private:
+    std::vector<native_handle_t*> mNativeHandles;
+    hidl_vec<hidl_handle> mHandles;
+};
+
+void printStats(const char* name, std::vector<uint64_t> values, const char* unit) {
+    std::sort(values.begin(), values.end());
+    auto percentile = [&](size_t p) { return values[(values.size() - 1) * p / 100]; };
+    printf("%-18s min %8" PRIu64 "  p50 %8" PRIu64 "  p90 %8" PRIu64 "  p99 %8" PRIu64
+           "  max %8" PRIu64 " %s\n",
+           name, values.front(), percentile(50), percentile(90), percentile(99), values.back(),
+           unit);
+}
+
+int replay(const char* path, int iterations) {
+    auto recording = CommandRecordingFile::open(path);
+    if (!recording) {
+        fprintf(stderr, "cannot open recording %s\n", path);
+        return 1;
+    }
+    std::vector<CommandRecordingFrame> frames;
+    uint32_t maxLength = 1;
+    for (CommandRecordingFrame frame; recording->readFrame(&frame);) {
+        maxLength = std::max(maxLength, static_cast<uint32_t>(frame.commands.size()));
+        frames.push_back(std::move(frame));
+    }
+    if (frames.empty()) {
+        fprintf(stderr, "no frames in recording %s\n", path);
+        return 1;
+    }
+
+    NullComposerHal hal;
+    // The resources are not initialized, thus no mapper is loaded. The empty
+    // placeholder buffers need none, and any other handle passed as a buffer
+    // fails to import, see ComposerHandleImporter::importBuffer.
+    ComposerResources resources;
+    addDisplaysAndLayers(frames, &resources);
+    ReplayCommandEngine engine(&hal, &resources);
+
+    CommandQueueType queue(maxLength);
+    if (!queue.isValid() || !engine.setInputMQDescriptor(*queue.getDesc())) {
+        fprintf(stderr, "cannot create a command queue of %" PRIu32 " words\n", maxLength);
+        return 1;
+    }
+
+    int fenceFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    std::vector<uint64_t> times;
+    std::vector<uint64_t> allocations;
+    times.reserve(frames.size() * iterations);
+    allocations.reserve(frames.size() * iterations);
+    size_t failedFrames = 0;
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        for (const auto& frame : frames) {
+            PlaceholderHandles handles(frame, fenceFd);
+            queue.write(frame.commands.data(), frame.commands.size());
+
+            bool outQueueChanged;
+            uint32_t outCommandLength;
+            hidl_vec<hidl_handle> outCommandHandles;
+            uint64_t allocationCount = gAllocationCount.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+            Error error = engine.execute(frame.commands.size(), handles.get(), &outQueueChanged,
+                                         &outCommandLength, &outCommandHandles);
+            engine.reset();
+            auto end = std::chrono::steady_clock::now();
+
+            times.push_back(std::chrono::nanoseconds(end - start).count());
+            allocations.push_back(gAllocationCount.load(std::memory_order_relaxed) -
+                                  allocationCount);
+            if (error != Error::NONE) {
+                failedFrames++;
+            }
+        }
+    }
+    close(fenceFd);
+
+    printf("%zu frames x %d iterations, %zu failed\n", frames.size(), iterations, failedFrames);
+    printStats("execute time", times, "ns");
+    printStats("allocations", allocations, "");
+    printf("reply buffer grew %" PRIu32 " times\n", engine.getWriterGrowCount());
+
+    return failedFrames ? 1 : 0;
+}
+
+// Writes frames like SurfaceFlinger does for |layerCount| layers on each of
+// |displayCount| displays, each layer cycling through 3 buffers.
+int synthesize(uint32_t displayCount, uint32_t layerCount, uint32_t frameCount,
+               const char* path) {
+    auto recording = CommandRecordingFile::create(path);
+    if (!recording) {
+        fprintf(stderr, "cannot create recording %s\n", path);
+        return 1;
+    }
+
+    // the handles are only recorded as fd and int counts
+    native_handle_t* buffer = native_handle_create(0, 1);
+    int fenceFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    constexpr uint32_t kBuffersPerLayer = 3;
+
+    // starts small, like the writers of clients, to report its growth
+    CommandWriterBase writer(64);
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+        for (uint32_t display = 0; display < displayCount; display++) {
+            writer.selectDisplay(display);
+            for (uint32_t layer = 0; layer < layerCount; layer++) {
+                writer.selectLayer(display * layerCount + layer + 1);
+                uint32_t slot = frame % kBuffersPerLayer;
+                writer.setLayerBuffer(slot, frame < kBuffersPerLayer ? buffer : nullptr,
+                                      dup(fenceFd));
+                writer.setLayerSurfaceDamage({{0, 0, 64, 64}});
+                if (frame == 0) {
+                    writer.setLayerCompositionType(IComposerClient::Composition::DEVICE);
+                    writer.setLayerBlendMode(IComposerClient::BlendMode::PREMULTIPLIED);
+                    writer.setLayerDisplayFrame({0, 0, 1080, 2340});
+                    writer.setLayerSourceCrop({0.0f, 0.0f, 1080.0f, 2340.0f});
+                    writer.setLayerPlaneAlpha(1.0f);
+                    writer.setLayerZOrder(layer);
+                    writer.setLayerTransform(static_cast<Transform>(0));
+                    writer.setLayerVisibleRegion({{0, 0, 1080, 2340}});
+                }
+            }
+            writer.presentOrvalidateDisplay();
+        }
+
+        bool queueChanged;
+        uint32_t commandLength;
+        hidl_vec<hidl_handle> commandHandles;
+        if (!writer.writeQueue(&queueChanged, &commandLength, &commandHandles) ||
+            !recording->writeFrame(writer.mData.get(), commandLength, commandHandles)) {
+            fprintf(stderr, "cannot write frame %" PRIu32 "\n", frame);
+            return 1;
+        }
+        writer.reset();
+    }
+    printf("%" PRIu32 " frames, command buffer grew %" PRIu32 " times\n", frameCount,
+           writer.getDataGrowCount());
+
+    close(fenceFd);
+    native_handle_delete(buffer);
+    return 0;
+}
+
+}  // namespace replay
+}  // namespace V2_1
+}  // namespace composer
+}  // namespace graphics
+}  // namespace hardware
+}  // namespace android
+
+int main(int argc, char** argv) {
+    using namespace android::hardware::graphics::composer::V2_1::replay;
+
+    if (argc == 6 && strcmp(argv[1], "--synthesize") == 0) {
+        return synthesize(atoi(argv[2]), atoi(argv[3]), atoi(argv[4]), argv[5]);
+    }
+    if (argc == 2 || argc == 3) {
+        int iterations = argc == 3 ? atoi(argv[2]) : 1;
+        return replay(argv[1], std::max(iterations, 1));
+    }
+
+    fprintf(stderr,
+            "usage: %s <recording> [<iterations>]\n"
+            "       %s --synthesize <displays> <layers> <frames> <recording>\n",
+            argv[0], argv[0]);
+    return 1;
+}
@@ -50,7 +50,12 @@ Error ComposerHandleImporter::importBuffer(const native_handle_t* rawHandle,
         return Error::NONE;
     }
 
-    const native_handle_t* bufferHandle;
+    if (!mMapper2 && !mMapper3 && !mMapper4) {
+        ALOGE("cannot import buffer without a mapper");
+        return Error::NO_RESOURCES;
+    }
+
+    const native_handle_t* bufferHandle = nullptr;
     if (mMapper2) {
         mapper::V2_0::Error error;
         mMapper2->importBuffer(rawHandle, [&](const auto& tmpError, const auto& tmpBufferHandle) {
@@ -326,6 +331,8 @@ Error ComposerResources::addVirtualDisplay(Display display, uint32_t outputBuffe
 }
 
 Error ComposerResources::removeDisplay(Display display) {
+    // the command engine uses the cached handles of the display under its display lock only
+    std::lock_guard<std::recursive_mutex> displayLock(getDisplayLock(display));
     std::lock_guard<std::recursive_mutex> lock(mDisplayResourcesMutex);
     return mDisplayResources.erase(display) > 0 ? Error::NONE : Error::BAD_DISPLAY;
 }
@@ -376,6 +383,7 @@ Error ComposerResources::addLayer(Display display, Layer layer, uint32_t bufferC
 }
 
 Error ComposerResources::removeLayer(Display display, Layer layer) {
+    std::lock_guard<std::recursive_mutex> displayLock(getDisplayLock(display));
     std::lock_guard<std::recursive_mutex> lock(mDisplayResourcesMutex);
     ComposerDisplayResource* displayResource = findDisplayResourceLocked(display);
     if (!displayResource) {
@@ -385,6 +393,15 @@ Error ComposerResources::removeLayer(Display display, Layer layer) {
     return displayResource->removeLayer(layer) ? Error::NONE : Error::BAD_LAYER;
 }
 
+std::recursive_mutex& ComposerResources::getDisplayLock(Display display) {
+    std::lock_guard<std::recursive_mutex> lock(mDisplayResourcesMutex);
+    auto& displayLock = mDisplayLocks[display];
+    if (!displayLock) {
+        displayLock = std::make_unique<std::recursive_mutex>();
+    }
+    return *displayLock;
+}
+
 Error ComposerResources::getDisplayClientTarget(Display display, uint32_t slot, bool fromCache,
                                                 const native_handle_t* rawHandle,
                                                 const native_handle_t** outBufferHandle,
@@ -417,6 +434,50 @@ Error ComposerResources::getLayerSidebandStream(Display display, Layer layer,
                      outStreamHandle, outReplacedStream);
 }
 
+void ComposerResources::getLayerBuffers(Display display, std::vector<LayerBuffer>* buffers) {
+    // import the raw handles outside of the lock
+    std::vector<const native_handle_t*> importedHandles(buffers->size(), nullptr);
+    for (size_t i = 0; i < buffers->size(); i++) {
+        LayerBuffer& buffer = (*buffers)[i];
+        if (!buffer.fromCache) {
+            buffer.error = mImporter.importBuffer(buffer.rawHandle, &importedHandles[i]);
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(mDisplayResourcesMutex);
+
+    ComposerDisplayResource* displayResource = findDisplayResourceLocked(display);
+    for (size_t i = 0; i < buffers->size(); i++) {
+        LayerBuffer& buffer = (*buffers)[i];
+        if (buffer.error != Error::NONE) {
+            continue;
+        }
+
+        ComposerLayerResource* layerResource =
+                displayResource ? displayResource->findLayerResource(buffer.layer) : nullptr;
+        const native_handle_t* replacedHandle = nullptr;
+        if (layerResource) {
+            buffer.error = layerResource->getBuffer(buffer.slot, buffer.fromCache,
+                                                    importedHandles[i], &buffer.bufferHandle,
+                                                    &replacedHandle);
+            if (buffer.error != Error::NONE) {
+                ALOGW("invalid cache %d slot %d", int(Cache::LAYER_BUFFER), int(buffer.slot));
+            }
+        } else {
+            buffer.error = displayResource ? Error::BAD_LAYER : Error::BAD_DISPLAY;
+        }
+
+        if (buffer.error != Error::NONE) {
+            if (!buffer.fromCache) {
+                mImporter.freeBuffer(importedHandles[i]);
+            }
+            continue;
+        }
+
+        buffer.replacedBuffer.reset(&mImporter, replacedHandle);
+    }
+}
+
 void ComposerResources::setDisplayMustValidateState(Display display, bool mustValidate) {
     std::lock_guard<std::recursive_mutex> lock(mDisplayResourcesMutex);
     auto* displayResource = findDisplayResourceLocked(display);
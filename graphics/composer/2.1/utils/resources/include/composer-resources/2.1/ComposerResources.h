@@ -183,12 +183,23 @@ class ComposerResources {
 
     std::recursive_mutex& getLock() { return mDisplayResourcesMutex; };
 
+    // Returns the lock to hold while handles cached for |display| are passed to
+    // ComposerHal, so that they are not released concurrently, e.g. on hotplug.
+    // Unlike getLock(), it does not serialize the work on other displays.
+    // removeDisplay() and removeLayer() take it before the resource lock, thus it
+    // must not be acquired while holding getLock().
+    std::recursive_mutex& getDisplayLock(Display display);
+
     // When a buffer in the cache is replaced by a new one, we must keep it
     // alive until it has been replaced in ComposerHal because it is still using
     // the old buffer.
     class ReplacedHandle {
       public:
         explicit ReplacedHandle(bool isBuffer) : mIsBuffer(isBuffer) {}
+        ReplacedHandle(ReplacedHandle&& other) noexcept
+            : mIsBuffer(other.mIsBuffer), mImporter(other.mImporter), mHandle(other.mHandle) {
+            other.mHandle = nullptr;
+        }
         ReplacedHandle(const ReplacedHandle&) = delete;
         ReplacedHandle& operator=(const ReplacedHandle&) = delete;
 
@@ -234,6 +245,26 @@ class ComposerResources {
                                  const native_handle_t** outStreamHandle,
                                  ReplacedHandle* outReplacedStream);
 
+    // A layer buffer to look up or update with getLayerBuffers().
+    struct LayerBuffer {
+        LayerBuffer(Layer layer, uint32_t slot, bool fromCache, const native_handle_t* rawHandle)
+            : layer(layer), slot(slot), fromCache(fromCache), rawHandle(rawHandle) {}
+
+        Layer layer;
+        uint32_t slot;
+        bool fromCache;
+        const native_handle_t* rawHandle;
+
+        // set by getLayerBuffers
+        Error error = Error::NONE;
+        const native_handle_t* bufferHandle = nullptr;
+        ReplacedHandle replacedBuffer{true};
+    };
+
+    // Same as calling getLayerBuffer for each of |buffers| in order, but finds the
+    // display resource and takes the resource lock only once.
+    void getLayerBuffers(Display display, std::vector<LayerBuffer>* buffers);
+
   protected:
     virtual std::unique_ptr<ComposerDisplayResource> createDisplayResource(
             ComposerDisplayResource::DisplayType type, uint32_t outputBufferCacheSize);
@@ -246,6 +277,9 @@ class ComposerResources {
 
     std::recursive_mutex mDisplayResourcesMutex;
     std::unordered_map<Display, std::unique_ptr<ComposerDisplayResource>> mDisplayResources;
+    // never shrinks, so that the returned locks outlive display removal
+    std::unordered_map<Display, std::unique_ptr<std::recursive_mutex>>
+            mDisplayLocks;  // GUARDED_BY(mDisplayResourcesMutex)
 
   private:
     enum class Cache {
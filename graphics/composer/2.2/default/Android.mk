@@ -28,6 +28,11 @@ LOCAL_SHARED_LIBRARIES := \
         libsync \
         libutils
 
+# Same as the android.hardware.graphics.composer@2.1-record-commands defaults.
+ifneq (,$(filter userdebug eng,$(TARGET_BUILD_VARIANT)))
+LOCAL_CFLAGS += -DCOMPOSER_RECORD_COMMANDS
+endif
+
 ifdef TARGET_USES_DISPLAY_RENDER_INTENTS
 LOCAL_CFLAGS += -DUSES_DISPLAY_RENDER_INTENTS
 endif
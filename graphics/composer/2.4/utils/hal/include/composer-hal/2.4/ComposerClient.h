@@ -52,6 +52,8 @@ class ComposerClientImpl : public V2_3::hal::detail::ComposerClientImpl<Interfac
         void onHotplug(Display display, IComposerCallback::Connection connected) override {
             if (connected == IComposerCallback::Connection::CONNECTED) {
                 if (mResources->hasDisplay(display)) {
+                    std::lock_guard<std::recursive_mutex> lock(
+                            mResources->getDisplayLock(display));
                     // This is a subsequent hotplug "connected" for a display. This signals a
                     // display change and thus the framework may want to reallocate buffers. We
                     // need to free all cached handles, since they are holding a strong reference
@@ -229,6 +229,9 @@ class ComposerClientWriter {
     std::optional<DisplayCommand> mDisplayCommand;
     std::optional<LayerCommand> mLayerCommand;
     std::vector<DisplayCommand> mCommands;
+    // Most layers a display command had so far, to size the next ones at once
+    // rather than growing them layer by layer every frame.
+    size_t mMaxLayerCount = 0;
 
     Buffer getBuffer(uint32_t slot, const native_handle_t* bufferHandle, int fence) {
         Buffer bufferCommand;
@@ -242,6 +245,7 @@ class ComposerClientWriter {
         if (mLayerCommand.has_value()) {
             mDisplayCommand->layers.emplace_back(std::move(*mLayerCommand));
             mLayerCommand.reset();
+            mMaxLayerCount = std::max(mMaxLayerCount, mDisplayCommand->layers.size());
         }
     }
 
@@ -258,6 +262,7 @@ class ComposerClientWriter {
             flushDisplayCommand();
             mDisplayCommand.emplace();
             mDisplayCommand->display = display;
+            mDisplayCommand->layers.reserve(mMaxLayerCount);
         }
         return *mDisplayCommand;
     }
@@ -40,6 +40,22 @@ using ::std::optional;
 
 using namespace ::android::hardware::identity;
 
+namespace {
+
+// Returns |item| without any semantic tags, which cppbor doesn't expose either.
+support::CborItemView cborUntagged(support::CborItemView item) {
+    while (item.majorType == cppbor::SEMANTIC) {
+        item = *support::cborParseItemView(item.content, item.end);
+    }
+    return item;
+}
+
+string cborTstrValue(const support::CborItemView& item) {
+    return string(reinterpret_cast<const char*>(item.content), item.value);
+}
+
+}  // namespace
+
 int IdentityCredential::initialize() {
     if (credentialData_.size() == 0) {
         LOG(ERROR) << "CredentialData is empty";
@@ -493,16 +509,20 @@ ndk::ScopedAStatus IdentityCredential::startRetrieval(
     // this HAL:
     if (itemsRequest.size() > 0) {
         // 1. The content must be a CBOR-encoded structure.
-        auto [item, _, message] = cppbor::parse(itemsRequest);
-        if (item == nullptr) {
+        //
+        // It's only walked, not decoded into cppbor items, as requests for
+        // documents with many data elements can be large.
+        optional<support::CborItemView> parsedItem = support::cborParseItemView(
+                itemsRequest.data(), itemsRequest.data() + itemsRequest.size());
+        if (!parsedItem) {
             return ndk::ScopedAStatus(AStatus_fromServiceSpecificErrorWithMessage(
                     IIdentityCredentialStore::STATUS_INVALID_ITEMS_REQUEST_MESSAGE,
                     "Error decoding CBOR in itemsRequest"));
         }
 
         // 2. The CBOR structure must be a map.
-        const cppbor::Map* map = item->asMap();
-        if (map == nullptr) {
+        support::CborItemView map = cborUntagged(parsedItem.value());
+        if (map.majorType != cppbor::MAP) {
             return ndk::ScopedAStatus(AStatus_fromServiceSpecificErrorWithMessage(
                     IIdentityCredentialStore::STATUS_INVALID_ITEMS_REQUEST_MESSAGE,
                     "itemsRequest is not a CBOR map"));
@@ -542,52 +562,63 @@ ndk::ScopedAStatus IdentityCredential::startRetrieval(
         //        }
         //    }
         //
-        const cppbor::Map* nsMap = nullptr;
-        for (size_t n = 0; n < map->size(); n++) {
-            const auto& [keyItem, valueItem] = (*map)[n];
-            if (keyItem->type() == cppbor::TSTR && keyItem->asTstr()->value() == "nameSpaces" &&
-                valueItem->type() == cppbor::MAP) {
-                nsMap = valueItem->asMap();
+        optional<support::CborItemView> nsMap;
+        const uint8_t* pos = map.content;
+        for (uint64_t n = 0; n < map.value; n++) {
+            support::CborItemView keyItem = *support::cborParseItemView(pos, map.end);
+            support::CborItemView valueItem = *support::cborParseItemView(keyItem.end, map.end);
+            pos = valueItem.end;
+            keyItem = cborUntagged(keyItem);
+            valueItem = cborUntagged(valueItem);
+            if (keyItem.majorType == cppbor::TSTR && cborTstrValue(keyItem) == "nameSpaces" &&
+                valueItem.majorType == cppbor::MAP) {
+                nsMap = valueItem;
                 break;
             }
         }
-        if (nsMap == nullptr) {
+        if (!nsMap) {
             return ndk::ScopedAStatus(AStatus_fromServiceSpecificErrorWithMessage(
                     IIdentityCredentialStore::STATUS_INVALID_ITEMS_REQUEST_MESSAGE,
                     "No nameSpaces map in top-most map"));
         }
 
-        for (size_t n = 0; n < nsMap->size(); n++) {
-            auto& [nsKeyItem, nsValueItem] = (*nsMap)[n];
-            const cppbor::Tstr* nsKey = nsKeyItem->asTstr();
-            const cppbor::Map* nsInnerMap = nsValueItem->asMap();
-            if (nsKey == nullptr || nsInnerMap == nullptr) {
+        pos = nsMap->content;
+        for (uint64_t n = 0; n < nsMap->value; n++) {
+            support::CborItemView nsKey = *support::cborParseItemView(pos, nsMap->end);
+            support::CborItemView nsInnerMap = *support::cborParseItemView(nsKey.end, nsMap->end);
+            pos = nsInnerMap.end;
+            nsKey = cborUntagged(nsKey);
+            nsInnerMap = cborUntagged(nsInnerMap);
+            if (nsKey.majorType != cppbor::TSTR || nsInnerMap.majorType != cppbor::MAP) {
                 return ndk::ScopedAStatus(AStatus_fromServiceSpecificErrorWithMessage(
                         IIdentityCredentialStore::STATUS_INVALID_ITEMS_REQUEST_MESSAGE,
                         "Type mismatch in nameSpaces map"));
             }
-            string requestedNamespace = nsKey->value();
+            string requestedNamespace = cborTstrValue(nsKey);
             set<string> requestedKeys;
-            for (size_t m = 0; m < nsInnerMap->size(); m++) {
-                const auto& [innerMapKeyItem, innerMapValueItem] = (*nsInnerMap)[m];
-                const cppbor::Tstr* nameItem = innerMapKeyItem->asTstr();
-                const cppbor::Simple* simple = innerMapValueItem->asSimple();
-                const cppbor::Bool* intentToRetainItem =
-                        (simple != nullptr) ? simple->asBool() : nullptr;
-                if (nameItem == nullptr || intentToRetainItem == nullptr) {
+            const uint8_t* innerPos = nsInnerMap.content;
+            for (uint64_t m = 0; m < nsInnerMap.value; m++) {
+                support::CborItemView nameItem =
+                        *support::cborParseItemView(innerPos, nsInnerMap.end);
+                support::CborItemView intentToRetainItem =
+                        *support::cborParseItemView(nameItem.end, nsInnerMap.end);
+                innerPos = intentToRetainItem.end;
+                nameItem = cborUntagged(nameItem);
+                intentToRetainItem = cborUntagged(intentToRetainItem);
+                // IntentToRetain must be a bool, i.e. a simple value other than null.
+                if (nameItem.majorType != cppbor::TSTR ||
+                    intentToRetainItem.majorType != cppbor::SIMPLE ||
+                    intentToRetainItem.value == cppbor::NULL_V) {
                     return ndk::ScopedAStatus(AStatus_fromServiceSpecificErrorWithMessage(
                             IIdentityCredentialStore::STATUS_INVALID_ITEMS_REQUEST_MESSAGE,
                             "Type mismatch in value in nameSpaces map"));
                 }
-                requestedKeys.insert(nameItem->value());
+                requestedKeys.insert(cborTstrValue(nameItem));
             }
             requestedNameSpacesAndNames_[requestedNamespace] = requestedKeys;
         }
     }
 
-    deviceNameSpacesMap_ = cppbor::Map();
-    currentNameSpaceDeviceNameSpacesMap_ = cppbor::Map();
-
     requestCountsRemaining_ = requestCounts;
     currentNameSpace_ = "";
 
@@ -605,6 +636,18 @@ ndk::ScopedAStatus IdentityCredential::startRetrieval(
         }
     }
 
+    // DeviceNameSpaces is encoded as the entries are retrieved, starting with
+    // the header of the map. The reservation is capped as the sizes of the
+    // entries are supplied by the caller.
+    deviceNameSpaces_.clear();
+    deviceNameSpaces_.reserve(std::min(expectedDeviceNameSpacesSize_, kMaxDeviceNameSpacesReserve));
+    support::cborAppendHeader(deviceNameSpaces_, cppbor::MAP, numNamespacesWithValues);
+    deviceNameSpacesNumNamespaces_ = 0;
+    deviceNameSpacesCountsMatch_ = true;
+    expectedNumNamespacesWithValues_ = numNamespacesWithValues;
+    currentNameSpaceExpectedNumEntries_ = 0;
+    currentNameSpaceNumEntries_ = 0;
+
     // Finally, pass info so the HMAC key can be derived and the TA can start
     // creating the DeviceNameSpaces CBOR...
     if (!session_) {
@@ -646,21 +689,11 @@ ndk::ScopedAStatus IdentityCredential::startRetrieval(
     return ndk::ScopedAStatus::ok();
 }
 
-size_t cborNumBytesForLength(size_t length) {
-    if (length < 24) {
-        return 0;
-    } else if (length <= 0xff) {
-        return 1;
-    } else if (length <= 0xffff) {
-        return 2;
-    } else if (length <= 0xffffffff) {
-        return 4;
-    }
-    return 8;
-}
-
-size_t cborNumBytesForTstr(const string& value) {
-    return 1 + cborNumBytesForLength(value.size()) + value.size();
+void IdentityCredential::checkDeviceNameSpacesEntryCount() {
+    if (currentNameSpaceNumEntries_ > 0 &&
+        currentNameSpaceNumEntries_ != currentNameSpaceExpectedNumEntries_) {
+        deviceNameSpacesCountsMatch_ = false;
+    }
 }
 
 void IdentityCredential::calcDeviceNameSpacesSize(uint32_t accessControlProfileMask) {
@@ -726,14 +759,14 @@ void IdentityCredential::calcDeviceNameSpacesSize(uint32_t accessControlProfileM
         }
 
         // Key: NameSpace
-        ret += cborNumBytesForTstr(rns.namespaceName);
+        ret += support::cborTstrSize(rns.namespaceName);
 
         // Value: Open the DeviceSignedItems map
-        ret += 1 + cborNumBytesForLength(itemsToInclude.size());
+        ret += support::cborHeaderSize(itemsToInclude.size());
 
         for (const RequestDataItem& item : itemsToInclude) {
             // Key: DataItemName
-            ret += cborNumBytesForTstr(item.name);
+            ret += support::cborTstrSize(item.name);
 
             // Value: DataItemValue - entryData.size is the length of serialized CBOR so we use
             // that.
@@ -743,7 +776,7 @@ void IdentityCredential::calcDeviceNameSpacesSize(uint32_t accessControlProfileM
 
     // Now that we know the number of namespaces with values, we know how many
     // bytes the DeviceNamespaces map in the beginning is going to take up.
-    ret += 1 + cborNumBytesForLength(numEntriesPerNamespace.size());
+    ret += support::cborHeaderSize(numEntriesPerNamespace.size());
 
     expectedDeviceNameSpacesSize_ = ret;
     expectedNumEntriesPerNamespace_ = numEntriesPerNamespace;
@@ -795,11 +828,8 @@ ndk::ScopedAStatus IdentityCredential::startRetrieveEntryValue(
                     "Moved to new name space but one or more entries need to be retrieved "
                     "in current name space"));
         }
-        if (currentNameSpaceDeviceNameSpacesMap_.size() > 0) {
-            deviceNameSpacesMap_.add(currentNameSpace_,
-                                     std::move(currentNameSpaceDeviceNameSpacesMap_));
-        }
-        currentNameSpaceDeviceNameSpacesMap_ = cppbor::Map();
+        checkDeviceNameSpacesEntryCount();
+        currentNameSpaceNumEntries_ = 0;
 
         requestCountsRemaining_.erase(requestCountsRemaining_.begin());
         currentNameSpace_ = nameSpace;
@@ -832,6 +862,7 @@ ndk::ScopedAStatus IdentityCredential::startRetrieveEntryValue(
         }
         newNamespaceNumEntries = expectedNumEntriesPerNamespace_[0];
         expectedNumEntriesPerNamespace_.erase(expectedNumEntriesPerNamespace_.begin());
+        currentNameSpaceExpectedNumEntries_ = newNamespaceNumEntries;
     }
 
     // Access control is enforced in the secure hardware.
@@ -911,13 +942,27 @@ ndk::ScopedAStatus IdentityCredential::retrieveEntryValue(const vector<uint8_t>&
     entryValue_.insert(entryValue_.end(), content.value().begin(), content.value().end());
 
     if (entryRemainingBytes_ == 0) {
-        auto [entryValueItem, _, message] = cppbor::parse(entryValue_);
-        if (entryValueItem == nullptr) {
+        optional<support::CborItemView> entryValueItem = support::cborParseItemView(
+                entryValue_.data(), entryValue_.data() + entryValue_.size());
+        if (!entryValueItem) {
             return ndk::ScopedAStatus(AStatus_fromServiceSpecificErrorWithMessage(
                     IIdentityCredentialStore::STATUS_INVALID_DATA,
                     "Retrieved data which is invalid CBOR"));
         }
-        currentNameSpaceDeviceNameSpacesMap_.add(currentName_, std::move(entryValueItem));
+
+        // The namespace is added once it has a value. Its map is given the
+        // expected number of entries, checkDeviceNameSpacesEntryCount() checks
+        // that this is how many were added in the end.
+        if (currentNameSpaceNumEntries_ == 0) {
+            support::cborAppendTstr(deviceNameSpaces_, currentNameSpace_);
+            support::cborAppendHeader(deviceNameSpaces_, cppbor::MAP,
+                                      currentNameSpaceExpectedNumEntries_);
+            deviceNameSpacesNumNamespaces_ += 1;
+        }
+        support::cborAppendTstr(deviceNameSpaces_, currentName_);
+        deviceNameSpaces_.insert(deviceNameSpaces_.end(), entryValueItem->begin,
+                                 entryValueItem->end);
+        currentNameSpaceNumEntries_ += 1;
     }
 
     *outContent = content.value();
@@ -931,12 +976,20 @@ ndk::ScopedAStatus IdentityCredential::finishRetrieval(vector<uint8_t>* outMac,
         return status;
     }
 
-    if (currentNameSpaceDeviceNameSpacesMap_.size() > 0) {
-        deviceNameSpacesMap_.add(currentNameSpace_,
-                                 std::move(currentNameSpaceDeviceNameSpacesMap_));
+    checkDeviceNameSpacesEntryCount();
+    if (deviceNameSpacesNumNamespaces_ != expectedNumNamespacesWithValues_) {
+        deviceNameSpacesCountsMatch_ = false;
     }
-    vector<uint8_t> encodedDeviceNameSpaces = deviceNameSpacesMap_.encode();
+    const vector<uint8_t>& encodedDeviceNameSpaces = deviceNameSpaces_;
 
+    if (!deviceNameSpacesCountsMatch_) {
+        LOG(ERROR) << "encodedDeviceNameSpaces has " << deviceNameSpacesNumNamespaces_
+                   << " name spaces with values, was expecting "
+                   << expectedNumNamespacesWithValues_ << " with the expected number of entries";
+        return ndk::ScopedAStatus(AStatus_fromServiceSpecificErrorWithMessage(
+                IIdentityCredentialStore::STATUS_INVALID_DATA,
+                "Unexpected number of entries in encodedDeviceNameSpaces"));
+    }
     if (encodedDeviceNameSpaces.size() != expectedDeviceNameSpacesSize_) {
         LOG(ERROR) << "encodedDeviceNameSpaces is " << encodedDeviceNameSpaces.size() << " bytes, "
                    << "was expecting " << expectedDeviceNameSpacesSize_;
@@ -133,21 +133,34 @@ class IdentityCredential : public BnIdentityCredential {
     vector<uint8_t> itemsRequest_;
     vector<int32_t> requestCountsRemaining_;
     map<string, set<string>> requestedNameSpacesAndNames_;
-    cppbor::Map deviceNameSpacesMap_;
-    cppbor::Map currentNameSpaceDeviceNameSpacesMap_;
+
+    // DeviceNameSpaces, encoded as the entries are retrieved.
+    vector<uint8_t> deviceNameSpaces_;
+    size_t deviceNameSpacesNumNamespaces_;
+    bool deviceNameSpacesCountsMatch_;
 
     // Calculated at startRetrieval() time.
     size_t expectedDeviceNameSpacesSize_;
     vector<unsigned int> expectedNumEntriesPerNamespace_;
+    size_t expectedNumNamespacesWithValues_;
 
     // Set at startRetrieveEntryValue() time.
     string currentNameSpace_;
+    unsigned int currentNameSpaceExpectedNumEntries_;
+    unsigned int currentNameSpaceNumEntries_;
     string currentName_;
     vector<int32_t> currentAccessControlProfileIds_;
     size_t entryRemainingBytes_;
     vector<uint8_t> entryValue_;
 
+    // Upper bound for the memory reserved for deviceNameSpaces_ up front.
+    static constexpr size_t kMaxDeviceNameSpacesReserve = 1024 * 1024;
+
     void calcDeviceNameSpacesSize(uint32_t accessControlProfileMask);
+
+    // Clears deviceNameSpacesCountsMatch_ if the current name space got a
+    // different number of entries than its map was encoded with.
+    void checkDeviceNameSpacesEntryCount();
 };
 
 }  // namespace aidl::android::hardware::identity
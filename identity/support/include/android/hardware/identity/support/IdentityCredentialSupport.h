@@ -85,6 +85,52 @@ optional<vector<uint8_t>> decodeHex(const string& hexEncoded);
 string cborPrettyPrint(const vector<uint8_t>& encodedCbor, size_t maxBStrSize = 32,
                        const vector<string>& mapKeysToNotPrint = {});
 
+// The functions below stream CBOR to and from byte buffers without building a
+// tree of cppbor items, for large structures such as DeviceNameSpaces.
+//
+// Major types are given as in cppbor::MajorType, i.e. in the top three bits.
+
+// Returns the size of the CBOR header (initial byte and argument) for the
+// argument |value|.
+size_t cborHeaderSize(uint64_t value);
+
+// Returns the size of |value| encoded as a CBOR tstr.
+size_t cborTstrSize(const string& value);
+
+// Appends a CBOR header with |majorType| and the argument |value| to |out|. For
+// an array or a map this must be followed by its encoded elements or pairs.
+void cborAppendHeader(vector<uint8_t>& out, uint8_t majorType, uint64_t value);
+
+// Appends |value| encoded as a CBOR tstr to |out|.
+void cborAppendTstr(vector<uint8_t>& out, const string& value);
+
+// A well-formed CBOR data item within an encoded buffer, see cborParseItemView().
+struct CborItemView {
+    uint8_t majorType;
+
+    // The argument of the header, i.e. the value of an integer, the length of a
+    // bstr or tstr, the number of elements of an array or of pairs of a map, the
+    // tag of a semantic item or the value of a simple item.
+    uint64_t value;
+
+    // The whole item, including nested items.
+    const uint8_t* begin;
+    const uint8_t* end;
+
+    // The first byte after the header: the data of a bstr or tstr, or the first
+    // nested item of an array, map or semantic item.
+    const uint8_t* content;
+};
+
+// Parses the CBOR data item at the start of [begin, end) without copying or
+// allocating anything. Nested items are checked as well, and can be visited by
+// parsing at |content| and then at the |end| of each nested item in turn.
+//
+// Returns nullopt if the data isn't well-formed, or uses features cppbor doesn't
+// support: indefinite lengths, negative integers not fitting in an int64_t, and
+// simple values other than false, true and null.
+optional<CborItemView> cborParseItemView(const uint8_t* begin, const uint8_t* end);
+
 // ---------------------------------------------------------------------------
 // Crypto functionality / abstraction.
 // ---------------------------------------------------------------------------
@@ -301,6 +347,9 @@ optional<vector<vector<uint8_t>>> certificateChainSplit(const vector<uint8_t>& c
 // Returns false if |certificateChain| failed validation or if each certificate
 // is not signed by its successor.
 //
+// Recently validated chains are remembered, as are parsed certificates in
+// general, so validating the same chain again is cheap.
+//
 bool certificateChainValidate(const vector<uint8_t>& certificateChain);
 
 // Returns true if |certificate| is signed by |publicKey|.
@@ -343,6 +392,22 @@ bool coseCheckEcDsaSignature(const vector<uint8_t>& signatureCoseSign1,
                              const vector<uint8_t>& detachedContent,
                              const vector<uint8_t>& publicKey);
 
+// A signature to check with coseCheckEcDsaSignatures(), the parameters are as
+// for coseCheckEcDsaSignature().
+struct CoseSign1ToCheck {
+    const vector<uint8_t>& signatureCoseSign1;
+    const vector<uint8_t>& detachedContent;
+    const vector<uint8_t>& publicKey;
+};
+
+// Checks each of |signatures| like coseCheckEcDsaSignature() does, and returns
+// whether each of them is valid. Each distinct public key is decoded only once.
+//
+// The HAL does not use this, as the reader signature of a presentation is
+// checked by secure hardware; it is for callers checking several signatures.
+//
+vector<bool> coseCheckEcDsaSignatures(const vector<CoseSign1ToCheck>& signatures);
+
 // Converts a DER-encoded signature to the format used in 'signature' bstr in COSE_Sign1.
 bool ecdsaSignatureDerToCose(const vector<uint8_t>& ecdsaDerSignature,
                              vector<uint8_t>& ecdsaCoseSignature);
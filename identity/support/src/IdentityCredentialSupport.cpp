@@ -26,6 +26,10 @@
 #include <time.h>
 #include <chrono>
 #include <iomanip>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
 
 #include <openssl/aes.h>
 #include <openssl/bn.h>
@@ -39,6 +43,7 @@
 #include <openssl/pem.h>
 #include <openssl/pkcs12.h>
 #include <openssl/rand.h>
+#include <openssl/sha.h>
 #include <openssl/x509.h>
 #include <openssl/x509_vfy.h>
 
@@ -148,6 +153,137 @@ optional<vector<uint8_t>> decodeHex(const string& hexEncoded) {
     return out;
 }
 
+// ---------------------------------------------------------------------------
+// CBOR utilities.
+// ---------------------------------------------------------------------------
+
+size_t cborHeaderSize(uint64_t value) {
+    return cppbor::headerSize(value);
+}
+
+size_t cborTstrSize(const string& value) {
+    return cppbor::headerSize(value.size()) + value.size();
+}
+
+void cborAppendHeader(vector<uint8_t>& out, uint8_t majorType, uint64_t value) {
+    size_t pos = out.size();
+    out.resize(pos + cppbor::headerSize(value));
+    cppbor::encodeHeader(static_cast<cppbor::MajorType>(majorType), value, out.data() + pos,
+                         out.data() + out.size());
+}
+
+void cborAppendTstr(vector<uint8_t>& out, const string& value) {
+    cborAppendHeader(out, cppbor::TSTR, value.size());
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+// Decodes the CBOR header at |pos|. Returns a pointer to the first byte after
+// it, or nullptr if the header is truncated or uses a reserved or indefinite
+// length encoding.
+static const uint8_t* cborParseHeader(const uint8_t* pos, const uint8_t* end,
+                                      uint8_t* outMajorType, uint64_t* outValue) {
+    if (pos >= end) {
+        return nullptr;
+    }
+    uint8_t majorType = *pos & 0xe0;
+    uint8_t addlInfo = *pos & 0x1f;
+    pos++;
+    uint64_t value = addlInfo;
+    if (addlInfo >= cppbor::ONE_BYTE_LENGTH) {
+        if (addlInfo > cppbor::EIGHT_BYTE_LENGTH) {
+            return nullptr;
+        }
+        size_t numBytes = size_t(1) << (addlInfo - cppbor::ONE_BYTE_LENGTH);
+        if (size_t(end - pos) < numBytes) {
+            return nullptr;
+        }
+        value = 0;
+        for (size_t n = 0; n < numBytes; n++) {
+            value = (value << 8) | *pos++;
+        }
+    }
+    *outMajorType = majorType;
+    *outValue = value;
+    return pos;
+}
+
+optional<CborItemView> cborParseItemView(const uint8_t* begin, const uint8_t* end) {
+    CborItemView view;
+    view.begin = begin;
+    const uint8_t* pos = cborParseHeader(begin, end, &view.majorType, &view.value);
+    if (pos == nullptr) {
+        return {};
+    }
+    view.content = pos;
+
+    // Instead of recursing into arrays, maps and semantic items, keep count of
+    // the nested items which are still to be parsed. Each of them takes up at
+    // least one byte, which bounds the count by the size of the input.
+    const uint8_t* header = begin;
+    uint8_t majorType = view.majorType;
+    uint64_t value = view.value;
+    uint64_t numPending = 1;
+    while (true) {
+        numPending--;
+        size_t bytesLeft = end - pos;
+        switch (majorType) {
+            case cppbor::UINT:
+                break;
+            case cppbor::NINT:
+                if (value > uint64_t(std::numeric_limits<int64_t>::max())) {
+                    return {};
+                }
+                break;
+            case cppbor::BSTR:
+            case cppbor::TSTR:
+                if (value > bytesLeft) {
+                    return {};
+                }
+                pos += value;
+                break;
+            case cppbor::ARRAY:
+                if (value > bytesLeft) {
+                    return {};
+                }
+                numPending += value;
+                break;
+            case cppbor::MAP:
+                if (value > bytesLeft / 2) {
+                    return {};
+                }
+                numPending += 2 * value;
+                break;
+            case cppbor::SEMANTIC:
+                numPending += 1;
+                break;
+            case cppbor::SIMPLE:
+                // Only the single byte encodings of false, true and null are
+                // accepted, not the two byte simple value nor floats with the
+                // same value.
+                if ((*header & 0x1f) >= cppbor::ONE_BYTE_LENGTH) {
+                    return {};
+                }
+                if (value != cppbor::FALSE && value != cppbor::TRUE && value != cppbor::NULL_V) {
+                    return {};
+                }
+                break;
+        }
+        if (numPending == 0) {
+            break;
+        }
+        if (numPending > size_t(end - pos)) {
+            return {};
+        }
+        header = pos;
+        pos = cborParseHeader(pos, end, &majorType, &value);
+        if (pos == nullptr) {
+            return {};
+        }
+    }
+    view.end = pos;
+    return view;
+}
+
 // ---------------------------------------------------------------------------
 // Crypto functionality / abstraction.
 // ---------------------------------------------------------------------------
@@ -605,49 +741,150 @@ vector<uint8_t> certificateChainJoin(const vector<vector<uint8_t>>& certificateC
     return ret;
 }
 
-optional<vector<vector<uint8_t>>> certificateChainSplit(const vector<uint8_t>& certificateChain) {
-    const unsigned char* pStart = (unsigned char*)certificateChain.data();
-    const unsigned char* p = pStart;
-    const unsigned char* pEnd = p + certificateChain.size();
-    vector<vector<uint8_t>> certificates;
-    while (p < pEnd) {
-        size_t begin = p - pStart;
-        auto x509 = X509_Ptr(d2i_X509(nullptr, &p, pEnd - p));
-        size_t next = p - pStart;
-        if (x509 == nullptr) {
-            LOG(ERROR) << "Error parsing X509 certificate";
+// Certificates and public keys are decoded again and again during presentation,
+// e.g. reader certificates are compared with those of each access control
+// profile, so decoded forms are kept in small caches shared by all callers.
+//
+// A thread-safe map which evicts the least recently used entry when full.
+template <typename Value>
+class LruCache {
+  public:
+    explicit LruCache(size_t maxSize) : maxSize_(maxSize) {}
+
+    optional<Value> get(const vector<uint8_t>& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) {
             return {};
         }
-        vector<uint8_t> cert =
-                vector<uint8_t>(certificateChain.begin() + begin, certificateChain.begin() + next);
-        certificates.push_back(std::move(cert));
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return it->second->second;
     }
-    return certificates;
+
+    void put(const vector<uint8_t>& key, Value value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_[key] = entries_.begin();
+        if (entries_.size() > maxSize_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+  private:
+    using Entries = std::list<pair<vector<uint8_t>, Value>>;
+
+    const size_t maxSize_;
+    std::mutex mutex_;
+    Entries entries_;                                           // GUARDED_BY(mutex_)
+    map<vector<uint8_t>, typename Entries::iterator> index_;  // GUARDED_BY(mutex_)
+};
+
+constexpr size_t kMaxCachedCertificates = 64;
+constexpr size_t kMaxCachedPublicKeys = 64;
+constexpr size_t kMaxCachedValidatedChains = 16;
+
+struct ParsedCertificate {
+    X509_Ptr x509;
+
+    // The EC public key in the format returned by ecKeyPairGetPublicKey(),
+    // empty if the certificate doesn't have one.
+    vector<uint8_t> ecPublicKey;
+};
+
+static vector<uint8_t> sha256Digest(const uint8_t* data, size_t size) {
+    vector<uint8_t> digest(SHA256_DIGEST_LENGTH);
+    SHA256(data, size, digest.data());
+    return digest;
 }
 
-static bool parseX509Certificates(const vector<uint8_t>& certificateChain,
-                                  vector<X509_Ptr>& parsedCertificates) {
-    const unsigned char* p = (unsigned char*)certificateChain.data();
-    const unsigned char* pEnd = p + certificateChain.size();
-    parsedCertificates.resize(0);
-    while (p < pEnd) {
-        auto x509 = X509_Ptr(d2i_X509(nullptr, &p, pEnd - p));
-        if (x509 == nullptr) {
-            LOG(ERROR) << "Error parsing X509 certificate";
-            return false;
+// Returns the size of the DER encoded SEQUENCE, such as a certificate, at the
+// start of [p, end). Returns 0 if there's no well-formed SEQUENCE header.
+static size_t derSequenceSize(const uint8_t* p, const uint8_t* end) {
+    size_t available = end - p;
+    if (available < 2 || p[0] != 0x30) {
+        return 0;
+    }
+    size_t headerSize = 2;
+    size_t length = p[1];
+    if (length & 0x80) {
+        size_t numLengthBytes = length & 0x7f;
+        if (numLengthBytes == 0 || numLengthBytes > sizeof(size_t) ||
+            available < 2 + numLengthBytes) {
+            return 0;
+        }
+        length = 0;
+        for (size_t n = 0; n < numLengthBytes; n++) {
+            length = (length << 8) | p[2 + n];
         }
-        parsedCertificates.push_back(std::move(x509));
+        headerSize += numLengthBytes;
     }
-    return true;
+    if (length > available - headerSize) {
+        return 0;
+    }
+    return headerSize + length;
 }
 
-bool certificateSignedByPublicKey(const vector<uint8_t>& certificate,
-                                  const vector<uint8_t>& publicKey) {
-    const unsigned char* p = certificate.data();
-    auto x509 = X509_Ptr(d2i_X509(nullptr, &p, certificate.size()));
-    if (x509 == nullptr) {
-        LOG(ERROR) << "Error parsing X509 certificate";
-        return false;
+static vector<uint8_t> ecPublicKeyFromCertificate(X509* x509) {
+    auto pkey = EVP_PKEY_Ptr(X509_get_pubkey(x509));
+    if (pkey.get() == nullptr) {
+        return {};
+    }
+    const EC_KEY* ecKey = EVP_PKEY_get0_EC_KEY(pkey.get());
+    if (ecKey == nullptr) {
+        return {};
+    }
+    auto ecGroup = EC_KEY_get0_group(ecKey);
+    auto ecPoint = EC_KEY_get0_public_key(ecKey);
+    int size = EC_POINT_point2oct(ecGroup, ecPoint, POINT_CONVERSION_UNCOMPRESSED, nullptr, 0,
+                                  nullptr);
+    if (size == 0) {
+        return {};
+    }
+    vector<uint8_t> publicKey(size);
+    EC_POINT_point2oct(ecGroup, ecPoint, POINT_CONVERSION_UNCOMPRESSED, publicKey.data(),
+                       publicKey.size(), nullptr);
+    return publicKey;
+}
+
+// Parses the DER encoded certificate in [der, der + size), or returns it from
+// the cache of certificates parsed before. Returns nullptr on error.
+static std::shared_ptr<const ParsedCertificate> getParsedCertificate(const uint8_t* der,
+                                                                     size_t size) {
+    static LruCache<std::shared_ptr<const ParsedCertificate>> cache(kMaxCachedCertificates);
+
+    vector<uint8_t> digest = sha256Digest(der, size);
+    optional<std::shared_ptr<const ParsedCertificate>> cached = cache.get(digest);
+    if (cached) {
+        return cached.value();
+    }
+
+    const unsigned char* p = der;
+    auto x509 = X509_Ptr(d2i_X509(nullptr, &p, size));
+    if (x509 == nullptr || p != der + size) {
+        return nullptr;
+    }
+    auto parsed = std::make_shared<ParsedCertificate>();
+    parsed->ecPublicKey = ecPublicKeyFromCertificate(x509.get());
+    parsed->x509 = std::move(x509);
+    cache.put(digest, parsed);
+    return parsed;
+}
+
+// Returns |publicKey|, in the format returned by ecKeyPairGetPublicKey(), as an
+// EVP_PKEY. Decoded keys are cached. Returns nullptr on error.
+static std::shared_ptr<EVP_PKEY> getEcPublicKey(const vector<uint8_t>& publicKey) {
+    static LruCache<std::shared_ptr<EVP_PKEY>> cache(kMaxCachedPublicKeys);
+
+    optional<std::shared_ptr<EVP_PKEY>> cached = cache.get(publicKey);
+    if (cached) {
+        return cached.value();
     }
 
     auto group = EC_GROUP_Ptr(EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1));
@@ -655,28 +892,80 @@ bool certificateSignedByPublicKey(const vector<uint8_t>& certificate,
     if (EC_POINT_oct2point(group.get(), point.get(), publicKey.data(), publicKey.size(), nullptr) !=
         1) {
         LOG(ERROR) << "Error decoding publicKey";
-        return false;
+        return nullptr;
     }
     auto ecKey = EC_KEY_Ptr(EC_KEY_new());
-    auto pkey = EVP_PKEY_Ptr(EVP_PKEY_new());
+    auto pkey = std::shared_ptr<EVP_PKEY>(EVP_PKEY_new(), EVP_PKEY_free);
     if (ecKey.get() == nullptr || pkey.get() == nullptr) {
         LOG(ERROR) << "Memory allocation failed";
-        return false;
+        return nullptr;
     }
     if (EC_KEY_set_group(ecKey.get(), group.get()) != 1) {
         LOG(ERROR) << "Error setting group";
-        return false;
+        return nullptr;
     }
     if (EC_KEY_set_public_key(ecKey.get(), point.get()) != 1) {
         LOG(ERROR) << "Error setting point";
-        return false;
+        return nullptr;
     }
     if (EVP_PKEY_set1_EC_KEY(pkey.get(), ecKey.get()) != 1) {
         LOG(ERROR) << "Error setting key";
+        return nullptr;
+    }
+    cache.put(publicKey, pkey);
+    return pkey;
+}
+
+// Parses the concatenated DER encoded certificates in |certificateChain|. If
+// |outCertificates| is not null, the encoded certificates are returned there.
+static bool parseX509Certificates(
+        const vector<uint8_t>& certificateChain,
+        vector<std::shared_ptr<const ParsedCertificate>>& parsedCertificates,
+        vector<vector<uint8_t>>* outCertificates = nullptr) {
+    const uint8_t* p = certificateChain.data();
+    const uint8_t* pEnd = p + certificateChain.size();
+    parsedCertificates.resize(0);
+    while (p < pEnd) {
+        size_t size = derSequenceSize(p, pEnd);
+        std::shared_ptr<const ParsedCertificate> parsed =
+                size > 0 ? getParsedCertificate(p, size) : nullptr;
+        if (parsed == nullptr) {
+            LOG(ERROR) << "Error parsing X509 certificate";
+            return false;
+        }
+        parsedCertificates.push_back(std::move(parsed));
+        if (outCertificates != nullptr) {
+            outCertificates->emplace_back(p, p + size);
+        }
+        p += size;
+    }
+    return true;
+}
+
+optional<vector<vector<uint8_t>>> certificateChainSplit(const vector<uint8_t>& certificateChain) {
+    vector<std::shared_ptr<const ParsedCertificate>> parsedCertificates;
+    vector<vector<uint8_t>> certificates;
+    if (!parseX509Certificates(certificateChain, parsedCertificates, &certificates)) {
+        return {};
+    }
+    return certificates;
+}
+
+bool certificateSignedByPublicKey(const vector<uint8_t>& certificate,
+                                  const vector<uint8_t>& publicKey) {
+    std::shared_ptr<const ParsedCertificate> parsed =
+            getParsedCertificate(certificate.data(), certificate.size());
+    if (parsed == nullptr) {
+        LOG(ERROR) << "Error parsing X509 certificate";
+        return false;
+    }
+
+    std::shared_ptr<EVP_PKEY> pkey = getEcPublicKey(publicKey);
+    if (pkey == nullptr) {
         return false;
     }
 
-    if (X509_verify(x509.get(), pkey.get()) != 1) {
+    if (X509_verify(parsed->x509.get(), pkey.get()) != 1) {
         return false;
     }
 
@@ -690,33 +979,37 @@ bool certificateSignedByPublicKey(const vector<uint8_t>& certificate,
 //       It would be nice to use X509_verify_cert() instead of doing our own thing.
 //
 bool certificateChainValidate(const vector<uint8_t>& certificateChain) {
-    vector<X509_Ptr> certs;
+    // Only the signatures are checked, so a chain which was valid once stays valid.
+    static LruCache<bool> validatedChains(kMaxCachedValidatedChains);
+
+    vector<uint8_t> digest = sha256(certificateChain);
+    if (validatedChains.get(digest)) {
+        return true;
+    }
 
+    vector<std::shared_ptr<const ParsedCertificate>> certs;
     if (!parseX509Certificates(certificateChain, certs)) {
         LOG(ERROR) << "Error parsing X509 certificates";
         return false;
     }
 
-    if (certs.size() == 1) {
-        return true;
-    }
-
     for (size_t n = 1; n < certs.size(); n++) {
-        const X509_Ptr& keyCert = certs[n - 1];
-        const X509_Ptr& signingCert = certs[n];
-        EVP_PKEY_Ptr signingPubkey(X509_get_pubkey(signingCert.get()));
-        if (X509_verify(keyCert.get(), signingPubkey.get()) != 1) {
+        X509* keyCert = certs[n - 1]->x509.get();
+        X509* signingCert = certs[n]->x509.get();
+        EVP_PKEY_Ptr signingPubkey(X509_get_pubkey(signingCert));
+        if (X509_verify(keyCert, signingPubkey.get()) != 1) {
             LOG(ERROR) << "Error validating cert at index " << n - 1
                        << " is signed by its successor";
             return false;
         }
     }
 
+    validatedChains.put(digest, true);
     return true;
 }
 
-bool checkEcDsaSignature(const vector<uint8_t>& digest, const vector<uint8_t>& signature,
-                         const vector<uint8_t>& publicKey) {
+static bool checkEcDsaSignatureWithKey(const vector<uint8_t>& digest,
+                                       const vector<uint8_t>& signature, EVP_PKEY* pkey) {
     const unsigned char* p = (unsigned char*)signature.data();
     auto sig = ECDSA_SIG_Ptr(d2i_ECDSA_SIG(nullptr, &p, signature.size()));
     if (sig.get() == nullptr) {
@@ -724,33 +1017,7 @@ bool checkEcDsaSignature(const vector<uint8_t>& digest, const vector<uint8_t>& s
         return false;
     }
 
-    auto group = EC_GROUP_Ptr(EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1));
-    auto point = EC_POINT_Ptr(EC_POINT_new(group.get()));
-    if (EC_POINT_oct2point(group.get(), point.get(), publicKey.data(), publicKey.size(), nullptr) !=
-        1) {
-        LOG(ERROR) << "Error decoding publicKey";
-        return false;
-    }
-    auto ecKey = EC_KEY_Ptr(EC_KEY_new());
-    auto pkey = EVP_PKEY_Ptr(EVP_PKEY_new());
-    if (ecKey.get() == nullptr || pkey.get() == nullptr) {
-        LOG(ERROR) << "Memory allocation failed";
-        return false;
-    }
-    if (EC_KEY_set_group(ecKey.get(), group.get()) != 1) {
-        LOG(ERROR) << "Error setting group";
-        return false;
-    }
-    if (EC_KEY_set_public_key(ecKey.get(), point.get()) != 1) {
-        LOG(ERROR) << "Error setting point";
-        return false;
-    }
-    if (EVP_PKEY_set1_EC_KEY(pkey.get(), ecKey.get()) != 1) {
-        LOG(ERROR) << "Error setting key";
-        return false;
-    }
-
-    int rc = ECDSA_do_verify(digest.data(), digest.size(), sig.get(), ecKey.get());
+    int rc = ECDSA_do_verify(digest.data(), digest.size(), sig.get(), EVP_PKEY_get0_EC_KEY(pkey));
     if (rc != 1) {
         LOG(ERROR) << "Error verifying signature (rc=" << rc << ")";
         return false;
@@ -759,6 +1026,15 @@ bool checkEcDsaSignature(const vector<uint8_t>& digest, const vector<uint8_t>& s
     return true;
 }
 
+bool checkEcDsaSignature(const vector<uint8_t>& digest, const vector<uint8_t>& signature,
+                         const vector<uint8_t>& publicKey) {
+    std::shared_ptr<EVP_PKEY> pkey = getEcPublicKey(publicKey);
+    if (pkey == nullptr) {
+        return false;
+    }
+    return checkEcDsaSignatureWithKey(digest, signature, pkey.get());
+}
+
 vector<uint8_t> sha256(const vector<uint8_t>& data) {
     vector<uint8_t> ret;
     ret.resize(SHA256_DIGEST_LENGTH);
@@ -1463,7 +1739,7 @@ tuple<bool, vector<uint8_t>, vector<uint8_t>> ecPublicKeyGetXandY(
 }
 
 optional<vector<uint8_t>> certificateChainGetTopMostKey(const vector<uint8_t>& certificateChain) {
-    vector<X509_Ptr> certs;
+    vector<std::shared_ptr<const ParsedCertificate>> certs;
     if (!parseX509Certificates(certificateChain, certs)) {
         return {};
     }
@@ -1472,36 +1748,16 @@ optional<vector<uint8_t>> certificateChainGetTopMostKey(const vector<uint8_t>& c
         return {};
     }
 
-    auto pkey = EVP_PKEY_Ptr(X509_get_pubkey(certs[0].get()));
-    if (pkey.get() == nullptr) {
-        LOG(ERROR) << "No public key";
-        return {};
-    }
-
-    auto ecKey = EC_KEY_Ptr(EVP_PKEY_get1_EC_KEY(pkey.get()));
-    if (ecKey.get() == nullptr) {
-        LOG(ERROR) << "Failed getting EC key";
-        return {};
-    }
-
-    auto ecGroup = EC_KEY_get0_group(ecKey.get());
-    auto ecPoint = EC_KEY_get0_public_key(ecKey.get());
-    int size = EC_POINT_point2oct(ecGroup, ecPoint, POINT_CONVERSION_UNCOMPRESSED, nullptr, 0,
-                                  nullptr);
-    if (size == 0) {
-        LOG(ERROR) << "Error generating public key encoding";
+    if (certs[0]->ecPublicKey.empty()) {
+        LOG(ERROR) << "No EC public key in certificate";
         return {};
     }
-    vector<uint8_t> publicKey;
-    publicKey.resize(size);
-    EC_POINT_point2oct(ecGroup, ecPoint, POINT_CONVERSION_UNCOMPRESSED, publicKey.data(),
-                       publicKey.size(), nullptr);
-    return publicKey;
+    return certs[0]->ecPublicKey;
 }
 
 optional<vector<uint8_t>> certificateGetExtension(const vector<uint8_t>& x509Certificate,
                                                   const string& oidStr) {
-    vector<X509_Ptr> certs;
+    vector<std::shared_ptr<const ParsedCertificate>> certs;
     if (!parseX509Certificates(x509Certificate, certs)) {
         return {};
     }
@@ -1517,12 +1773,13 @@ optional<vector<uint8_t>> certificateGetExtension(const vector<uint8_t>& x509Cer
         return {};
     }
 
-    int location = X509_get_ext_by_OBJ(certs[0].get(), oid.get(), -1 /* search from beginning */);
+    int location =
+            X509_get_ext_by_OBJ(certs[0]->x509.get(), oid.get(), -1 /* search from beginning */);
     if (location == -1) {
         return {};
     }
 
-    X509_EXTENSION* ext = X509_get_ext(certs[0].get(), location);
+    X509_EXTENSION* ext = X509_get_ext(certs[0]->x509.get(), location);
     if (ext == nullptr) {
         return {};
     }
@@ -1538,7 +1795,7 @@ optional<vector<uint8_t>> certificateGetExtension(const vector<uint8_t>& x509Cer
 }
 
 optional<pair<size_t, size_t>> certificateFindPublicKey(const vector<uint8_t>& x509Certificate) {
-    vector<X509_Ptr> certs;
+    vector<std::shared_ptr<const ParsedCertificate>> certs;
     if (!parseX509Certificates(x509Certificate, certs)) {
         return {};
     }
@@ -1547,7 +1804,7 @@ optional<pair<size_t, size_t>> certificateFindPublicKey(const vector<uint8_t>& x
         return {};
     }
 
-    auto pkey = EVP_PKEY_Ptr(X509_get_pubkey(certs[0].get()));
+    auto pkey = EVP_PKEY_Ptr(X509_get_pubkey(certs[0]->x509.get()));
     if (pkey.get() == nullptr) {
         LOG(ERROR) << "No public key";
         return {};
@@ -1587,7 +1844,7 @@ optional<pair<size_t, size_t>> certificateFindPublicKey(const vector<uint8_t>& x
 }
 
 optional<pair<size_t, size_t>> certificateTbsCertificate(const vector<uint8_t>& x509Certificate) {
-    vector<X509_Ptr> certs;
+    vector<std::shared_ptr<const ParsedCertificate>> certs;
     if (!parseX509Certificates(x509Certificate, certs)) {
         return {};
     }
@@ -1596,8 +1853,17 @@ optional<pair<size_t, size_t>> certificateTbsCertificate(const vector<uint8_t>&
         return {};
     }
 
+    // i2d_re_X509_tbs() updates the certificate, so use a copy of our own
+    // rather than the shared one.
+    const unsigned char* p = x509Certificate.data();
+    auto x509 = X509_Ptr(d2i_X509(nullptr, &p, x509Certificate.size()));
+    if (x509 == nullptr) {
+        LOG(ERROR) << "Error parsing X509 certificate";
+        return {};
+    }
+
     unsigned char* buf = NULL;
-    int len = i2d_re_X509_tbs(certs[0].get(), &buf);
+    int len = i2d_re_X509_tbs(x509.get(), &buf);
     if ((len < 0) || (buf == NULL)) {
         LOG(ERROR) << "fail to extract tbsCertificate in x509Certificate";
         return {};
@@ -1621,7 +1887,7 @@ optional<pair<size_t, size_t>> certificateTbsCertificate(const vector<uint8_t>&
 }
 
 optional<pair<time_t, time_t>> certificateGetValidity(const vector<uint8_t>& x509Certificate) {
-    vector<X509_Ptr> certs;
+    vector<std::shared_ptr<const ParsedCertificate>> certs;
     if (!parseX509Certificates(x509Certificate, certs)) {
         LOG(ERROR) << "Error parsing certificates";
         return {};
@@ -1633,12 +1899,12 @@ optional<pair<time_t, time_t>> certificateGetValidity(const vector<uint8_t>& x50
 
     time_t notBefore;
     time_t notAfter;
-    if (!parseAsn1Time(X509_get0_notBefore(certs[0].get()), &notBefore)) {
+    if (!parseAsn1Time(X509_get0_notBefore(certs[0]->x509.get()), &notBefore)) {
         LOG(ERROR) << "Error parsing notBefore";
         return {};
     }
 
-    if (!parseAsn1Time(X509_get0_notAfter(certs[0].get()), &notAfter)) {
+    if (!parseAsn1Time(X509_get0_notAfter(certs[0]->x509.get()), &notAfter)) {
         LOG(ERROR) << "Error parsing notAfter";
         return {};
     }
@@ -1647,7 +1913,7 @@ optional<pair<time_t, time_t>> certificateGetValidity(const vector<uint8_t>& x50
 }
 
 optional<pair<size_t, size_t>> certificateFindSignature(const vector<uint8_t>& x509Certificate) {
-    vector<X509_Ptr> certs;
+    vector<std::shared_ptr<const ParsedCertificate>> certs;
     if (!parseX509Certificates(x509Certificate, certs)) {
         return {};
     }
@@ -1658,7 +1924,8 @@ optional<pair<size_t, size_t>> certificateFindSignature(const vector<uint8_t>& x
 
     ASN1_BIT_STRING* psig;
     X509_ALGOR* palg;
-    X509_get0_signature((const ASN1_BIT_STRING**)&psig, (const X509_ALGOR**)&palg, certs[0].get());
+    X509_get0_signature((const ASN1_BIT_STRING**)&psig, (const X509_ALGOR**)&palg,
+                        certs[0]->x509.get());
 
     vector<char> signature(psig->length);
     memcpy(signature.data(), psig->data, psig->length);
@@ -1883,9 +2150,9 @@ optional<vector<uint8_t>> coseSignEcDsa(const vector<uint8_t>& key, const vector
     return signatureCoseSign1;
 }
 
-bool coseCheckEcDsaSignature(const vector<uint8_t>& signatureCoseSign1,
-                             const vector<uint8_t>& detachedContent,
-                             const vector<uint8_t>& publicKey) {
+static bool coseCheckEcDsaSignatureWithKey(const vector<uint8_t>& signatureCoseSign1,
+                                           const vector<uint8_t>& detachedContent,
+                                           EVP_PKEY* publicKey) {
     auto [item, _, message] = cppbor::parse(signatureCoseSign1);
     if (item == nullptr) {
         LOG(ERROR) << "Passed-in COSE_Sign1 is not valid CBOR: " << message;
@@ -1951,13 +2218,41 @@ bool coseCheckEcDsaSignature(const vector<uint8_t>& signatureCoseSign1,
 
     vector<uint8_t> toBeSigned =
             coseBuildToBeSigned(encodedProtectedHeaders, data, detachedContent);
-    if (!checkEcDsaSignature(support::sha256(toBeSigned), derSignature, publicKey)) {
+    if (!checkEcDsaSignatureWithKey(support::sha256(toBeSigned), derSignature, publicKey)) {
         LOG(ERROR) << "Signature check failed";
         return false;
     }
     return true;
 }
 
+bool coseCheckEcDsaSignature(const vector<uint8_t>& signatureCoseSign1,
+                             const vector<uint8_t>& detachedContent,
+                             const vector<uint8_t>& publicKey) {
+    std::shared_ptr<EVP_PKEY> pkey = getEcPublicKey(publicKey);
+    if (pkey == nullptr) {
+        return false;
+    }
+    return coseCheckEcDsaSignatureWithKey(signatureCoseSign1, detachedContent, pkey.get());
+}
+
+vector<bool> coseCheckEcDsaSignatures(const vector<CoseSign1ToCheck>& signatures) {
+    vector<bool> results;
+    results.reserve(signatures.size());
+    map<vector<uint8_t>, std::shared_ptr<EVP_PKEY>> publicKeys;
+    for (const CoseSign1ToCheck& signature : signatures) {
+        auto it = publicKeys.find(signature.publicKey);
+        if (it == publicKeys.end()) {
+            it = publicKeys.emplace(signature.publicKey, getEcPublicKey(signature.publicKey))
+                         .first;
+        }
+        results.push_back(it->second != nullptr &&
+                          coseCheckEcDsaSignatureWithKey(signature.signatureCoseSign1,
+                                                         signature.detachedContent,
+                                                         it->second.get()));
+    }
+    return results;
+}
+
 // Extracts the signature (of the ToBeSigned CBOR) from a COSE_Sign1.
 optional<vector<uint8_t>> coseSignGetSignature(const vector<uint8_t>& signatureCoseSign1) {
     auto [item, _, message] = cppbor::parse(signatureCoseSign1);
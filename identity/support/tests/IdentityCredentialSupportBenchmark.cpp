@@ -0,0 +1,163 @@
+/*
+ * Copyright 2022, The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android-base/logging.h>
+#include <benchmark/benchmark.h>
+
+#include <android/hardware/identity/support/IdentityCredentialSupport.h>
+
+#include <algorithm>
+
+/**
+ * Measures the certificate and signature checks done while presenting a
+ * credential to a reader: validating the reader's certificate chain, matching
+ * it against access control profiles and checking COSE_Sign1 signatures.
+ */
+namespace android::hardware::identity::benchmark {
+
+using std::optional;
+using std::string;
+using std::vector;
+
+struct KeyPair {
+    vector<uint8_t> privateKey;
+    vector<uint8_t> publicKey;
+};
+
+static KeyPair createKeyPair() {
+    optional<vector<uint8_t>> keyPair = support::createEcKeyPair();
+    CHECK(keyPair);
+    optional<vector<uint8_t>> privateKey = support::ecKeyPairGetPrivateKey(keyPair.value());
+    optional<vector<uint8_t>> publicKey = support::ecKeyPairGetPublicKey(keyPair.value());
+    CHECK(privateKey && publicKey);
+    return {privateKey.value(), publicKey.value()};
+}
+
+static vector<uint8_t> createCertificate(const KeyPair& subject, const KeyPair& issuer,
+                                         const string& name) {
+    optional<vector<uint8_t>> cert = support::ecPublicKeyGenerateCertificate(
+            subject.publicKey, issuer.privateKey, "1", "issuer", name, 0, 0, {});
+    CHECK(cert);
+    return cert.value();
+}
+
+// A reader certificate chain of |kReaderChainLength| certificates, and
+// certificates of access control profiles none of which matches the reader.
+class Fixture {
+  public:
+    static constexpr size_t kReaderChainLength = 3;
+    static constexpr size_t kMaxProfiles = 16;
+    static constexpr size_t kMaxSignatures = 16;
+
+    Fixture() {
+        vector<KeyPair> keys;
+        for (size_t n = 0; n < kReaderChainLength; n++) {
+            keys.push_back(createKeyPair());
+        }
+        vector<vector<uint8_t>> certs;
+        for (size_t n = 0; n < kReaderChainLength; n++) {
+            const KeyPair& issuer = keys[std::min(n + 1, kReaderChainLength - 1)];
+            certs.push_back(createCertificate(keys[n], issuer, "reader" + std::to_string(n)));
+        }
+        readerChain = support::certificateChainJoin(certs);
+        readerKey = keys[0];
+
+        for (size_t n = 0; n < kMaxProfiles; n++) {
+            KeyPair key = createKeyPair();
+            profileCertificates.push_back(createCertificate(key, key, "profile"));
+        }
+
+        for (size_t n = 0; n < kMaxSignatures; n++) {
+            optional<vector<uint8_t>> signature = support::coseSignEcDsa(
+                    readerKey.privateKey, vector<uint8_t>(256, n), {} /* detachedContent */,
+                    {} /* x5chain */);
+            CHECK(signature);
+            signatures.push_back(signature.value());
+        }
+    }
+
+    vector<uint8_t> readerChain;
+    KeyPair readerKey;
+    vector<vector<uint8_t>> profileCertificates;
+    vector<vector<uint8_t>> signatures;
+};
+
+static Fixture& fixture() {
+    static Fixture fixture;
+    return fixture;
+}
+
+static void BM_certificateChainValidate(::benchmark::State& state) {
+    const Fixture& f = fixture();
+    for (auto _ : state) {
+        CHECK(support::certificateChainValidate(f.readerChain));
+    }
+}
+BENCHMARK(BM_certificateChainValidate);
+
+// What startRetrieval() does for a reader authenticated request: compare the key
+// of each certificate in the reader chain with the key of each profile.
+static void BM_matchReaderCertificates(::benchmark::State& state) {
+    const Fixture& f = fixture();
+    size_t numProfiles = state.range(0);
+    for (auto _ : state) {
+        optional<vector<vector<uint8_t>>> certs = support::certificateChainSplit(f.readerChain);
+        CHECK(certs);
+        for (const vector<uint8_t>& cert : certs.value()) {
+            optional<vector<uint8_t>> key = support::certificateChainGetTopMostKey(cert);
+            CHECK(key);
+            for (size_t n = 0; n < numProfiles; n++) {
+                optional<vector<uint8_t>> profileKey =
+                        support::certificateChainGetTopMostKey(f.profileCertificates[n]);
+                CHECK(profileKey && profileKey.value() != key.value());
+            }
+        }
+    }
+}
+BENCHMARK(BM_matchReaderCertificates)->Arg(1)->Arg(4)->Arg(Fixture::kMaxProfiles);
+
+static void BM_coseCheckEcDsaSignature(::benchmark::State& state) {
+    const Fixture& f = fixture();
+    size_t numSignatures = state.range(0);
+    for (auto _ : state) {
+        for (size_t n = 0; n < numSignatures; n++) {
+            CHECK(support::coseCheckEcDsaSignature(f.signatures[n], {} /* detachedContent */,
+                                                   f.readerKey.publicKey));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numSignatures);
+}
+BENCHMARK(BM_coseCheckEcDsaSignature)->Arg(1)->Arg(Fixture::kMaxSignatures);
+
+static void BM_coseCheckEcDsaSignatures(::benchmark::State& state) {
+    const Fixture& f = fixture();
+    size_t numSignatures = state.range(0);
+    vector<uint8_t> detachedContent;
+    vector<support::CoseSign1ToCheck> toCheck;
+    for (size_t n = 0; n < numSignatures; n++) {
+        toCheck.push_back({f.signatures[n], detachedContent, f.readerKey.publicKey});
+    }
+    for (auto _ : state) {
+        vector<bool> results = support::coseCheckEcDsaSignatures(toCheck);
+        CHECK(std::all_of(results.begin(), results.end(), [](bool valid) { return valid; }));
+    }
+    state.SetItemsProcessed(state.iterations() * numSignatures);
+}
+BENCHMARK(BM_coseCheckEcDsaSignatures)->Arg(1)->Arg(Fixture::kMaxSignatures);
+
+}  // namespace android::hardware::identity::benchmark
+
+BENCHMARK_MAIN();
@@ -55,6 +55,102 @@ TEST(IdentityCredentialSupport, decodeHex) {
     EXPECT_FALSE(support::decodeHex("012"));
 }
 
+TEST(IdentityCredentialSupport, CborAppend) {
+    EXPECT_EQ(1, support::cborHeaderSize(23));
+    EXPECT_EQ(2, support::cborHeaderSize(24));
+    EXPECT_EQ(3, support::cborHeaderSize(0x100));
+    EXPECT_EQ(5, support::cborHeaderSize(0x10000));
+    EXPECT_EQ(9, support::cborHeaderSize(0x100000000));
+    EXPECT_EQ(cppbor::Tstr(string(300, 'x')).encode().size(),
+              support::cborTstrSize(string(300, 'x')));
+
+    vector<uint8_t> value = cppbor::Array(1, "two").encode();
+    vector<uint8_t> encoded;
+    support::cborAppendHeader(encoded, cppbor::MAP, 1);
+    support::cborAppendTstr(encoded, "org.iso.18013.5.1");
+    support::cborAppendHeader(encoded, cppbor::MAP, 2);
+    support::cborAppendTstr(encoded, "given_name");
+    encoded.insert(encoded.end(), value.begin(), value.end());
+    support::cborAppendTstr(encoded, string(30, 'x'));
+    encoded.insert(encoded.end(), value.begin(), value.end());
+
+    cppbor::Map expected;
+    expected.add("org.iso.18013.5.1", cppbor::Map()
+                                              .add("given_name", cppbor::Array(1, "two"))
+                                              .add(string(30, 'x'), cppbor::Array(1, "two")));
+    EXPECT_EQ(expected.encode(), encoded);
+}
+
+TEST(IdentityCredentialSupport, CborParseItemView) {
+    vector<uint8_t> encoded =
+            cppbor::Array(1, -2, "three", cppbor::Bstr(vector<uint8_t>(30, 4)),
+                          cppbor::Map("five", true), cppbor::Null())
+                    .encode();
+    const uint8_t* end = encoded.data() + encoded.size();
+
+    // Trailing data isn't part of the item.
+    vector<uint8_t> withTrailingData = encoded;
+    withTrailingData.push_back(0x00);
+    optional<support::CborItemView> item = support::cborParseItemView(
+            withTrailingData.data(), withTrailingData.data() + withTrailingData.size());
+    ASSERT_TRUE(item);
+    EXPECT_EQ(encoded.size(), item->end - item->begin);
+
+    item = support::cborParseItemView(encoded.data(), end);
+    ASSERT_TRUE(item);
+    EXPECT_EQ(cppbor::ARRAY, item->majorType);
+    EXPECT_EQ(6, item->value);
+    EXPECT_EQ(encoded.data(), item->begin);
+    EXPECT_EQ(end, item->end);
+    EXPECT_EQ(encoded.data() + 1, item->content);
+
+    vector<std::pair<uint8_t, uint64_t>> elements;
+    const uint8_t* pos = item->content;
+    for (uint64_t n = 0; n < item->value; n++) {
+        optional<support::CborItemView> element = support::cborParseItemView(pos, end);
+        ASSERT_TRUE(element);
+        elements.push_back({element->majorType, element->value});
+        pos = element->end;
+    }
+    EXPECT_EQ(end, pos);
+    EXPECT_EQ((vector<std::pair<uint8_t, uint64_t>>{{cppbor::UINT, 1},
+                                                    {cppbor::NINT, 1},
+                                                    {cppbor::TSTR, 5},
+                                                    {cppbor::BSTR, 30},
+                                                    {cppbor::MAP, 1},
+                                                    {cppbor::SIMPLE, cppbor::NULL_V}}),
+              elements);
+
+    // Semantic items contain one item.
+    vector<uint8_t> tagged = {0xc1, 0x1a, 0x51, 0x4b, 0x67, 0xb0};
+    item = support::cborParseItemView(tagged.data(), tagged.data() + tagged.size());
+    ASSERT_TRUE(item);
+    EXPECT_EQ(cppbor::SEMANTIC, item->majorType);
+    EXPECT_EQ(1, item->value);
+    EXPECT_EQ(tagged.data() + tagged.size(), item->end);
+
+    vector<vector<uint8_t>> invalid = {
+            {},
+            vector<uint8_t>(encoded.begin(), encoded.end() - 1),
+            {0x82, 0x01},                                            // Missing element.
+            {0x9f, 0x01, 0xff},                                      // Indefinite length.
+            {0x1c},                                                  // Reserved.
+            {0x19, 0x01},                                            // Truncated argument.
+            {0x3b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},  // NINT out of range.
+            {0xf7},                                                  // Undefined.
+            {0xf8, 0x14},                                            // Two byte false.
+            {0xf9, 0x00, 0x14},                                      // Half float.
+            {0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x16},  // Double.
+            {0x81, 0xf8, 0x15},                                      // Nested two byte true.
+            {0x9b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff},  // Too many elements.
+            {0xc1},                                                  // Missing tagged item.
+    };
+    for (const vector<uint8_t>& data : invalid) {
+        EXPECT_FALSE(support::cborParseItemView(data.data(), data.data() + data.size()))
+                << support::encodeHex(data);
+    }
+}
+
 TEST(IdentityCredentialSupport, Signatures) {
     vector<uint8_t> data = {1, 2, 3};
 
@@ -138,6 +234,40 @@ TEST(IdentityCredentialSupport, CoseSignatures) {
             out);
 }
 
+TEST(IdentityCredentialSupport, CoseSignaturesBatch) {
+    optional<vector<uint8_t>> keyPair = support::createEcKeyPair();
+    ASSERT_TRUE(keyPair);
+    optional<vector<uint8_t>> privKey = support::ecKeyPairGetPrivateKey(keyPair.value());
+    ASSERT_TRUE(privKey);
+    optional<vector<uint8_t>> pubKey = support::ecKeyPairGetPublicKey(keyPair.value());
+    ASSERT_TRUE(pubKey);
+    optional<vector<uint8_t>> otherKeyPair = support::createEcKeyPair();
+    ASSERT_TRUE(otherKeyPair);
+    optional<vector<uint8_t>> otherPubKey = support::ecKeyPairGetPublicKey(otherKeyPair.value());
+    ASSERT_TRUE(otherPubKey);
+
+    vector<uint8_t> data = {1, 2, 3};
+    vector<uint8_t> detachedContent = {4, 5, 6};
+    vector<uint8_t> noContent;
+    optional<vector<uint8_t>> coseSign1 =
+            support::coseSignEcDsa(privKey.value(), data, noContent, {} /* x5chain */);
+    ASSERT_TRUE(coseSign1);
+    optional<vector<uint8_t>> coseSign1Detached =
+            support::coseSignEcDsa(privKey.value(), {}, detachedContent, {} /* x5chain */);
+    ASSERT_TRUE(coseSign1Detached);
+    vector<uint8_t> notCbor = {0xff};
+
+    vector<bool> results = support::coseCheckEcDsaSignatures({
+            {coseSign1.value(), noContent, pubKey.value()},
+            {coseSign1Detached.value(), detachedContent, pubKey.value()},
+            {coseSign1Detached.value(), data, pubKey.value()},
+            {coseSign1.value(), noContent, otherPubKey.value()},
+            {notCbor, noContent, pubKey.value()},
+            {coseSign1.value(), noContent, notCbor},
+    });
+    EXPECT_EQ(vector<bool>({true, true, false, false, false, false}), results);
+}
+
 TEST(IdentityCredentialSupport, CoseSignaturesAdditionalData) {
     optional<vector<uint8_t>> keyPair = support::createEcKeyPair();
     ASSERT_TRUE(keyPair);
@@ -275,6 +405,21 @@ TEST(IdentityCredentialSupport, CertificateChain) {
     ASSERT_EQ(certs2combined.size(), cert.value().size() + otherCert.value().size());
     optional<vector<vector<uint8_t>>> splitCerts2 = support::certificateChainSplit(certs2combined);
     ASSERT_EQ(certs2, splitCerts2.value());
+
+    // Both certificates are signed by |privKey|, check that validation results
+    // don't change when they're answered from the caches.
+    EXPECT_TRUE(support::certificateSignedByPublicKey(otherCert.value(), pubKey.value()));
+    EXPECT_TRUE(support::certificateSignedByPublicKey(otherCert.value(), pubKey.value()));
+    EXPECT_TRUE(support::certificateChainValidate(certs2combined));
+    EXPECT_TRUE(support::certificateChainValidate(certs2combined));
+
+    vector<uint8_t> corruptedCerts2 = certs2combined;
+    corruptedCerts2[cert.value().size() - 1] ^= 0x01;
+    EXPECT_FALSE(support::certificateChainValidate(corruptedCerts2));
+    EXPECT_FALSE(support::certificateChainValidate(corruptedCerts2));
+    corruptedCerts2.pop_back();
+    EXPECT_FALSE(support::certificateChainSplit(corruptedCerts2));
+    EXPECT_FALSE(support::certificateChainGetTopMostKey(corruptedCerts2));
 }
 
 vector<uint8_t> strToVec(const string& str) {
@@ -16,7 +16,13 @@
 
 #include <keymasterV4_0/authorization_set.h>
 
-#include <assert.h>
+#include <string.h>
+
+#include <algorithm>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
 
 #include <android-base/logging.h>
 
@@ -85,13 +91,19 @@ bool keyParamEqual(const KeyParameter& a, const KeyParameter& b) {
 
 void AuthorizationSet::Sort() {
     std::sort(data_.begin(), data_.end(), keyParamLess);
+    tags_sorted_ = true;
 }
 
 void AuthorizationSet::Deduplicate() {
+    Sort();
+    DeduplicateSorted();
+}
+
+void AuthorizationSet::DeduplicateSorted() {
     if (data_.empty()) return;
 
-    Sort();
     std::vector<KeyParameter> result;
+    result.reserve(data_.size());
 
     auto curr = data_.begin();
     auto prev = curr++;
@@ -107,26 +119,57 @@ void AuthorizationSet::Deduplicate() {
     std::swap(data_, result);
 }
 
+// Returns pointers to the entries of 'params' in keyParamLess order.
+static std::vector<const KeyParameter*> sortedEntries(const std::vector<KeyParameter>& params) {
+    std::vector<const KeyParameter*> entries;
+    entries.reserve(params.size());
+    for (const auto& param : params) entries.push_back(&param);
+    auto less = [](const KeyParameter* a, const KeyParameter* b) { return keyParamLess(*a, *b); };
+    if (!std::is_sorted(entries.begin(), entries.end(), less)) {
+        std::sort(entries.begin(), entries.end(), less);
+    }
+    return entries;
+}
+
 void AuthorizationSet::Union(const AuthorizationSet& other) {
-    data_.insert(data_.end(), other.data_.begin(), other.data_.end());
-    Deduplicate();
+    if (other.empty()) {
+        Deduplicate();
+        return;
+    }
+    Sort();
+
+    std::vector<KeyParameter> result;
+    result.reserve(data_.size() + other.size());
+    auto i = data_.begin();
+    for (const KeyParameter* entry : sortedEntries(other.data_)) {
+        for (; i != data_.end() && !keyParamLess(*entry, *i); ++i) {
+            result.push_back(std::move(*i));
+        }
+        result.push_back(*entry);
+    }
+    std::move(i, data_.end(), std::back_inserter(result));
+    std::swap(data_, result);
+
+    DeduplicateSorted();
 }
 
 void AuthorizationSet::Subtract(const AuthorizationSet& other) {
     Deduplicate();
+    if (other.empty()) return;
 
-    auto i = other.begin();
-    while (i != other.end()) {
-        int pos = -1;
-        do {
-            pos = find(i->tag, pos);
-            if (pos != -1 && keyParamEqual(*i, data_[pos])) {
-                data_.erase(data_.begin() + pos);
-                break;
-            }
-        } while (pos != -1);
-        ++i;
+    // Both sides are sorted, and this set holds each entry once at most, so a single pass
+    // removes every entry that 'other' contains.
+    std::vector<KeyParameter> result;
+    result.reserve(data_.size());
+    std::vector<const KeyParameter*> entries = sortedEntries(other.data_);
+    auto entry = entries.begin();
+    for (auto& param : data_) {
+        while (entry != entries.end() && keyParamLess(**entry, param)) ++entry;
+        if (entry == entries.end() || !keyParamEqual(**entry, param)) {
+            result.push_back(std::move(param));
+        }
     }
+    std::swap(data_, result);
 }
 
 void AuthorizationSet::Filter(std::function<bool(const KeyParameter&)> doKeep) {
@@ -140,6 +183,8 @@ void AuthorizationSet::Filter(std::function<bool(const KeyParameter&)> doKeep) {
 }
 
 KeyParameter& AuthorizationSet::operator[](int at) {
+    // The caller may change the tag.
+    tags_sorted_ = false;
     return data_[at];
 }
 
@@ -149,9 +194,31 @@ const KeyParameter& AuthorizationSet::operator[](int at) const {
 
 void AuthorizationSet::Clear() {
     data_.clear();
+    tags_sorted_ = true;
+}
+
+// Sets up to this size are scanned linearly even when sorted, which is faster than a binary
+// search for entries this small.
+static constexpr ptrdiff_t kMaxLinearFindSize = 16;
+
+static std::vector<KeyParameter>::const_iterator findSortedTag(
+        std::vector<KeyParameter>::const_iterator begin,
+        std::vector<KeyParameter>::const_iterator end, Tag tag) {
+    if (end - begin > kMaxLinearFindSize) {
+        return std::lower_bound(begin, end, tag,
+                                [](const KeyParameter& param, Tag t) { return param.tag < t; });
+    }
+    while (begin != end && begin->tag < tag) ++begin;
+    return begin;
 }
 
 size_t AuthorizationSet::GetTagCount(Tag tag) const {
+    if (tags_sorted_) {
+        auto first = findSortedTag(data_.begin(), data_.end(), tag);
+        auto last = first;
+        while (last != data_.end() && last->tag == tag) ++last;
+        return last - first;
+    }
     size_t count = 0;
     for (int pos = -1; (pos = find(tag, pos)) != -1;) ++count;
     return count;
@@ -160,6 +227,12 @@ size_t AuthorizationSet::GetTagCount(Tag tag) const {
 int AuthorizationSet::find(Tag tag, int begin) const {
     auto iter = data_.begin() + (1 + begin);
 
+    if (tags_sorted_) {
+        iter = findSortedTag(iter, data_.end(), tag);
+        if (iter != data_.end() && iter->tag == tag) return iter - data_.begin();
+        return -1;
+    }
+
     while (iter != data_.end() && iter->tag != tag) ++iter;
 
     if (iter != data_.end()) return iter - data_.begin();
@@ -200,54 +273,53 @@ NullOr<const KeyParameter&> AuthorizationSet::GetEntry(Tag tag) const {
  * | 32 bit indirect_offset |
  */
 
-struct OutStreams {
-    std::ostream& indirect;
-    std::ostream& elements;
+struct OutBuffers {
+    std::vector<uint8_t> indirect;
+    std::vector<uint8_t> elements;
     size_t skipped;
+    bool bad;
 };
 
-OutStreams& serializeParamValue(OutStreams& out, const hidl_vec<uint8_t>& blob) {
-    uint32_t buffer;
+template <typename T>
+void appendValue(std::vector<uint8_t>* buffer, const T& value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    buffer->insert(buffer->end(), bytes, bytes + sizeof(T));
+}
 
-    // write blob_length
+OutBuffers& serializeParamValue(OutBuffers& out, const hidl_vec<uint8_t>& blob) {
     auto blob_length = blob.size();
-    if (blob_length > std::numeric_limits<uint32_t>::max()) {
-        out.elements.setstate(std::ios_base::badbit);
-        return out;
-    }
-    buffer = blob_length;
-    out.elements.write(reinterpret_cast<const char*>(&buffer), sizeof(uint32_t));
-
-    // write indirect_offset
-    auto offset = out.indirect.tellp();
-    if (offset < 0 || offset > std::numeric_limits<uint32_t>::max() ||
+    auto offset = out.indirect.size();
+    if (blob_length > std::numeric_limits<uint32_t>::max() ||
+        offset > std::numeric_limits<uint32_t>::max() ||
         uint32_t(offset) + uint32_t(blob_length) < uint32_t(offset)) {  // overflow check
-        out.elements.setstate(std::ios_base::badbit);
+        out.bad = true;
         return out;
     }
-    buffer = offset;
-    out.elements.write(reinterpret_cast<const char*>(&buffer), sizeof(uint32_t));
 
-    // write blob to indirect stream
-    if (blob_length) out.indirect.write(reinterpret_cast<const char*>(&blob[0]), blob_length);
+    // write blob_length and indirect_offset
+    appendValue(&out.elements, uint32_t(blob_length));
+    appendValue(&out.elements, uint32_t(offset));
+
+    // write blob to indirect buffer
+    out.indirect.insert(out.indirect.end(), blob.begin(), blob.end());
 
     return out;
 }
 
 template <typename T>
-OutStreams& serializeParamValue(OutStreams& out, const T& value) {
-    out.elements.write(reinterpret_cast<const char*>(&value), sizeof(T));
+OutBuffers& serializeParamValue(OutBuffers& out, const T& value) {
+    appendValue(&out.elements, value);
     return out;
 }
 
-OutStreams& serialize(TAG_INVALID_t&&, OutStreams& out, const KeyParameter&) {
+OutBuffers& serialize(TAG_INVALID_t&&, OutBuffers& out, const KeyParameter&) {
     // skip invalid entries.
     ++out.skipped;
     return out;
 }
 template <typename T>
-OutStreams& serialize(T ttag, OutStreams& out, const KeyParameter& param) {
-    out.elements.write(reinterpret_cast<const char*>(&param.tag), sizeof(int32_t));
+OutBuffers& serialize(T ttag, OutBuffers& out, const KeyParameter& param) {
+    appendValue(&out.elements, param.tag);
     return serializeParamValue(out, accessTagValue(ttag, param));
 }
 
@@ -255,14 +327,14 @@ template <typename... T>
 struct choose_serializer;
 template <typename... Tags>
 struct choose_serializer<MetaList<Tags...>> {
-    static OutStreams& serialize(OutStreams& out, const KeyParameter& param) {
+    static OutBuffers& serialize(OutBuffers& out, const KeyParameter& param) {
         return choose_serializer<Tags...>::serialize(out, param);
     }
 };
 
 template <>
 struct choose_serializer<> {
-    static OutStreams& serialize(OutStreams& out, const KeyParameter& param) {
+    static OutBuffers& serialize(OutBuffers& out, const KeyParameter& param) {
         LOG(WARNING) << "Trying to serialize unknown tag " << unsigned(param.tag)
                      << ". Did you forget to add it to all_tags_t?";
         ++out.skipped;
@@ -272,7 +344,7 @@ struct choose_serializer<> {
 
 template <TagType tag_type, Tag tag, typename... Tail>
 struct choose_serializer<TypedTag<tag_type, tag>, Tail...> {
-    static OutStreams& serialize(OutStreams& out, const KeyParameter& param) {
+    static OutBuffers& serialize(OutBuffers& out, const KeyParameter& param) {
         if (param.tag == tag) {
             return V4_0::serialize(TypedTag<tag_type, tag>(), out, param);
         } else {
@@ -281,82 +353,95 @@ struct choose_serializer<TypedTag<tag_type, tag>, Tail...> {
     }
 };
 
-OutStreams& serialize(OutStreams& out, const KeyParameter& param) {
+OutBuffers& serialize(OutBuffers& out, const KeyParameter& param) {
     return choose_serializer<all_tags_t>::serialize(out, param);
 }
 
 std::ostream& serialize(std::ostream& out, const std::vector<KeyParameter>& params) {
-    std::stringstream indirect;
-    std::stringstream elements;
-    OutStreams streams = {indirect, elements, 0};
+    // Entries are a tag and a value of at most 64 bits, or a blob length and offset.
+    OutBuffers buffers = {{}, {}, 0, false};
+    buffers.elements.reserve(params.size() * (sizeof(uint32_t) + sizeof(uint64_t)));
     for (const auto& param : params) {
-        serialize(streams, param);
-    }
-    if (indirect.bad() || elements.bad()) {
-        out.setstate(std::ios_base::badbit);
-        return out;
-    }
-    auto pos = indirect.tellp();
-    if (pos < 0 || pos > std::numeric_limits<uint32_t>::max()) {
-        out.setstate(std::ios_base::badbit);
-        return out;
+        serialize(buffers, param);
     }
-    uint32_t indirect_size = pos;
-    pos = elements.tellp();
-    if (pos < 0 || pos > std::numeric_limits<uint32_t>::max()) {
+    if (buffers.bad || buffers.indirect.size() > std::numeric_limits<uint32_t>::max() ||
+        buffers.elements.size() > std::numeric_limits<uint32_t>::max()) {
         out.setstate(std::ios_base::badbit);
         return out;
     }
-    uint32_t elements_size = pos;
-    uint32_t element_count = params.size() - streams.skipped;
+    uint32_t indirect_size = buffers.indirect.size();
+    uint32_t elements_size = buffers.elements.size();
+    uint32_t element_count = params.size() - buffers.skipped;
 
     out.write(reinterpret_cast<const char*>(&indirect_size), sizeof(uint32_t));
-
-    pos = out.tellp();
-    if (indirect_size) out << indirect.rdbuf();
-    assert(out.tellp() - pos == indirect_size);
+    out.write(reinterpret_cast<const char*>(buffers.indirect.data()), indirect_size);
 
     out.write(reinterpret_cast<const char*>(&element_count), sizeof(uint32_t));
     out.write(reinterpret_cast<const char*>(&elements_size), sizeof(uint32_t));
-
-    pos = out.tellp();
-    if (elements_size) out << elements.rdbuf();
-    assert(out.tellp() - pos == elements_size);
+    out.write(reinterpret_cast<const char*>(buffers.elements.data()), elements_size);
 
     return out;
 }
 
-struct InStreams {
-    std::istream& indirect;
-    std::istream& elements;
+/**
+ * Reads from a byte buffer like std::istream::read does: a short read copies what is left,
+ * and fails all further reads and seeks.
+ */
+struct InBuffer {
+    const std::string& data;
+    size_t pos;
+    bool failed;
+};
+
+bool readBytes(InBuffer& in, void* dest, size_t size) {
+    if (in.failed) return false;
+    size_t count = std::min(size, in.data.size() - in.pos);
+    if (count > 0) memcpy(dest, in.data.data() + in.pos, count);
+    in.pos += count;
+    if (count < size) in.failed = true;
+    return !in.failed;
+}
+
+void seekTo(InBuffer& in, size_t pos) {
+    if (in.failed) return;
+    if (pos > in.data.size()) {
+        in.failed = true;
+        return;
+    }
+    in.pos = pos;
+}
+
+struct InBuffers {
+    InBuffer indirect;
+    InBuffer elements;
     size_t invalids;
 };
 
-InStreams& deserializeParamValue(InStreams& in, hidl_vec<uint8_t>* blob) {
+InBuffers& deserializeParamValue(InBuffers& in, hidl_vec<uint8_t>* blob) {
     uint32_t blob_length = 0;
     uint32_t offset = 0;
-    in.elements.read(reinterpret_cast<char*>(&blob_length), sizeof(uint32_t));
+    readBytes(in.elements, &blob_length, sizeof(uint32_t));
     blob->resize(blob_length);
-    in.elements.read(reinterpret_cast<char*>(&offset), sizeof(uint32_t));
-    in.indirect.seekg(offset);
-    in.indirect.read(reinterpret_cast<char*>(&(*blob)[0]), blob->size());
+    readBytes(in.elements, &offset, sizeof(uint32_t));
+    seekTo(in.indirect, offset);
+    readBytes(in.indirect, blob->data(), blob->size());
     return in;
 }
 
 template <typename T>
-InStreams& deserializeParamValue(InStreams& in, T* value) {
-    in.elements.read(reinterpret_cast<char*>(value), sizeof(T));
+InBuffers& deserializeParamValue(InBuffers& in, T* value) {
+    readBytes(in.elements, value, sizeof(T));
     return in;
 }
 
-InStreams& deserialize(TAG_INVALID_t&&, InStreams& in, KeyParameter*) {
+InBuffers& deserialize(TAG_INVALID_t&&, InBuffers& in, KeyParameter*) {
     // there should be no invalid KeyParamaters but if handle them as zero sized.
     ++in.invalids;
     return in;
 }
 
 template <typename T>
-InStreams& deserialize(T&& ttag, InStreams& in, KeyParameter* param) {
+InBuffers& deserialize(T&& ttag, InBuffers& in, KeyParameter* param) {
     return deserializeParamValue(in, &accessTagValue(ttag, *param));
 }
 
@@ -364,21 +449,21 @@ template <typename... T>
 struct choose_deserializer;
 template <typename... Tags>
 struct choose_deserializer<MetaList<Tags...>> {
-    static InStreams& deserialize(InStreams& in, KeyParameter* param) {
+    static InBuffers& deserialize(InBuffers& in, KeyParameter* param) {
         return choose_deserializer<Tags...>::deserialize(in, param);
     }
 };
 template <>
 struct choose_deserializer<> {
-    static InStreams& deserialize(InStreams& in, KeyParameter*) {
+    static InBuffers& deserialize(InBuffers& in, KeyParameter*) {
         // encountered an unknown tag -> fail parsing
-        in.elements.setstate(std::ios_base::badbit);
+        in.elements.failed = true;
         return in;
     }
 };
 template <TagType tag_type, Tag tag, typename... Tail>
 struct choose_deserializer<TypedTag<tag_type, tag>, Tail...> {
-    static InStreams& deserialize(InStreams& in, KeyParameter* param) {
+    static InBuffers& deserialize(InBuffers& in, KeyParameter* param) {
         if (param->tag == tag) {
             return V4_0::deserialize(TypedTag<tag_type, tag>(), in, param);
         } else {
@@ -387,8 +472,8 @@ struct choose_deserializer<TypedTag<tag_type, tag>, Tail...> {
     }
 };
 
-InStreams& deserialize(InStreams& in, KeyParameter* param) {
-    in.elements.read(reinterpret_cast<char*>(&param->tag), sizeof(Tag));
+InBuffers& deserialize(InBuffers& in, KeyParameter* param) {
+    readBytes(in.elements, &param->tag, sizeof(Tag));
     return choose_deserializer<all_tags_t>::deserialize(in, param);
 }
 
@@ -416,23 +501,20 @@ std::istream& deserialize(std::istream& in, std::vector<KeyParameter>* params) {
 
     if (in.bad()) return in;
 
-    // TODO write one-shot stream buffer to avoid copying here
-    std::stringstream indirect(indirect_buffer);
-    std::stringstream elements(elements_buffer);
-    InStreams streams = {indirect, elements, 0};
+    InBuffers buffers = {{indirect_buffer, 0, false}, {elements_buffer, 0, false}, 0};
 
     params->resize(element_count);
 
     for (uint32_t i = 0; i < element_count; ++i) {
-        deserialize(streams, &(*params)[i]);
+        deserialize(buffers, &(*params)[i]);
     }
 
     /*
      * There are legacy blobs which have invalid tags in them due to a bug during serialization.
      * This makes sure that invalid tags are filtered from the result before it is returned.
      */
-    if (streams.invalids > 0) {
-        std::vector<KeyParameter> filtered(element_count - streams.invalids);
+    if (buffers.invalids > 0) {
+        std::vector<KeyParameter> filtered(element_count - buffers.invalids);
         auto ifiltered = filtered.begin();
         for (auto& p : *params) {
             if (p.tag != Tag::INVALID) {
@@ -450,6 +532,7 @@ void AuthorizationSet::Serialize(std::ostream* out) const {
 
 void AuthorizationSet::Deserialize(std::istream* in) {
     deserialize(*in, &data_);
+    UpdateTagsSorted();
 }
 
 AuthorizationSetBuilder& AuthorizationSetBuilder::RsaKey(uint32_t key_size,
@@ -0,0 +1,223 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <keymasterV4_0/authorization_set.h>
+
+namespace android::hardware::keymaster::V4_0::test {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+std::vector<KeyParameter> entries(const AuthorizationSet& set) {
+    return std::vector<KeyParameter>(set.begin(), set.end());
+}
+
+// Returns the positions of all entries with |tag|, as found by find().
+std::vector<int> findAll(const AuthorizationSet& set, Tag tag) {
+    std::vector<int> positions;
+    for (int pos = -1; (pos = set.find(tag, pos)) != -1;) positions.push_back(pos);
+    return positions;
+}
+
+// Returns the positions of all entries with |tag|, by scanning every entry.
+std::vector<int> scanAll(const AuthorizationSet& set, Tag tag) {
+    std::vector<int> positions;
+    for (size_t i = 0; i < set.size(); ++i) {
+        if (set[i].tag == tag) positions.push_back(i);
+    }
+    return positions;
+}
+
+// Checks find(), GetTagCount() and Contains() against a scan of every entry, for every tag in
+// |set| and for a tag that is not in it.
+void expectLookupsMatchScan(const AuthorizationSet& set) {
+    std::vector<Tag> tags = {Tag::CALLER_NONCE};
+    for (const auto& param : set) tags.push_back(param.tag);
+    for (Tag tag : tags) {
+        SCOPED_TRACE(toString(tag));
+        std::vector<int> expected = scanAll(set, tag);
+        EXPECT_THAT(findAll(set, tag), ElementsAreArray(expected));
+        EXPECT_EQ(expected.size(), set.GetTagCount(tag));
+        EXPECT_EQ(!expected.empty(), set.Contains(tag));
+    }
+}
+
+// A set with more entries than are scanned linearly when sorted, with repeated tags, built out of
+// tag order.
+AuthorizationSet largeUnsortedSet() {
+    AuthorizationSetBuilder builder;
+    builder.Authorization(TAG_KEY_SIZE, 256).Authorization(TAG_ALGORITHM, Algorithm::EC);
+    for (uint64_t sid = 20; sid > 0; --sid) {
+        builder.Authorization(TAG_USER_SECURE_ID, sid);
+        if (sid % 5 == 0) builder.Authorization(TAG_PURPOSE, KeyPurpose::SIGN);
+    }
+    builder.Authorization(TAG_NO_AUTH_REQUIRED);
+    return std::move(builder);
+}
+
+// The sorted, deduplicated union of |a| and |b|.
+std::vector<KeyParameter> expectedUnion(const AuthorizationSet& a, const AuthorizationSet& b) {
+    std::vector<KeyParameter> result = entries(a);
+    std::vector<KeyParameter> other = entries(b);
+    result.insert(result.end(), other.begin(), other.end());
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+// The sorted, deduplicated entries of |a| that are not in |b|.
+std::vector<KeyParameter> expectedDifference(const AuthorizationSet& a,
+                                             const AuthorizationSet& b) {
+    std::vector<KeyParameter> result = entries(a);
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    std::vector<KeyParameter> other = entries(b);
+    result.erase(std::remove_if(result.begin(), result.end(),
+                                [&](const KeyParameter& param) {
+                                    return std::find(other.begin(), other.end(), param) !=
+                                           other.end();
+                                }),
+                 result.end());
+    return result;
+}
+
+TEST(AuthorizationSetTest, LookupAfterUnsortedInsertion) {
+    AuthorizationSet set = AuthorizationSetBuilder()
+                                   .Authorization(TAG_KEY_SIZE, 256)
+                                   .Authorization(TAG_ALGORITHM, Algorithm::EC)
+                                   .Authorization(TAG_PURPOSE, KeyPurpose::SIGN);
+    EXPECT_EQ(0, set.find(Tag::KEY_SIZE));
+    EXPECT_EQ(1, set.find(Tag::ALGORITHM));
+    EXPECT_EQ(2, set.find(Tag::PURPOSE));
+    EXPECT_EQ(-1, set.find(Tag::CALLER_NONCE));
+    EXPECT_EQ(256U, set.GetTagValue(TAG_KEY_SIZE).value());
+    expectLookupsMatchScan(set);
+
+    // Appending an entry in tag order must not make the set look sorted.
+    set.push_back(TAG_USER_SECURE_ID, 1U);
+    EXPECT_EQ(3, set.find(Tag::USER_SECURE_ID));
+    expectLookupsMatchScan(set);
+
+    AuthorizationSet large = largeUnsortedSet();
+    expectLookupsMatchScan(large);
+    large.Sort();
+    expectLookupsMatchScan(large);
+}
+
+TEST(AuthorizationSetTest, LookupAfterChangingTagInPlace) {
+    AuthorizationSet set = largeUnsortedSet();
+    set.Sort();
+    const AuthorizationSet& sorted = set;
+    Tag first = sorted[0].tag;
+    ASSERT_NE(Tag::NO_AUTH_REQUIRED, first);
+    size_t firstCount = set.GetTagCount(first);
+
+    // Non-const operator[] may change the tag, after which the set is no longer sorted.
+    set[0] = Authorization(TAG_NO_AUTH_REQUIRED);
+    EXPECT_EQ(2U, set.GetTagCount(Tag::NO_AUTH_REQUIRED));
+    EXPECT_EQ(firstCount - 1, set.GetTagCount(first));
+    expectLookupsMatchScan(set);
+}
+
+TEST(AuthorizationSetTest, DuplicateTags) {
+    AuthorizationSet set = AuthorizationSetBuilder()
+                                   .Authorization(TAG_ALGORITHM, Algorithm::EC)
+                                   .Authorization(TAG_PURPOSE, KeyPurpose::SIGN)
+                                   .Authorization(TAG_KEY_SIZE, 256)
+                                   .Authorization(TAG_PURPOSE, KeyPurpose::SIGN)
+                                   .Authorization(TAG_ALGORITHM, Algorithm::EC);
+    EXPECT_THAT(findAll(set, Tag::ALGORITHM), ElementsAre(0, 4));
+    EXPECT_THAT(findAll(set, Tag::PURPOSE), ElementsAre(1, 3));
+    EXPECT_EQ(2U, set.GetTagCount(Tag::ALGORITHM));
+    expectLookupsMatchScan(set);
+
+    set.Deduplicate();
+    ASSERT_EQ(3U, set.size());
+    EXPECT_EQ(1U, set.GetTagCount(Tag::ALGORITHM));
+    EXPECT_EQ(1U, set.GetTagCount(Tag::PURPOSE));
+    expectLookupsMatchScan(set);
+}
+
+TEST(AuthorizationSetTest, RepeatableTags) {
+    AuthorizationSet set = AuthorizationSetBuilder()
+                                   .Authorization(TAG_PURPOSE, KeyPurpose::SIGN)
+                                   .Authorization(TAG_ALGORITHM, Algorithm::RSA)
+                                   .Authorization(TAG_PURPOSE, KeyPurpose::VERIFY)
+                                   .Digest(Digest::SHA_2_256, Digest::NONE)
+                                   .Authorization(TAG_PURPOSE, KeyPurpose::ENCRYPT);
+    EXPECT_THAT(findAll(set, Tag::PURPOSE), ElementsAre(0, 2, 5));
+    EXPECT_EQ(3U, set.GetTagCount(Tag::PURPOSE));
+    EXPECT_EQ(2U, set.GetTagCount(Tag::DIGEST));
+    EXPECT_TRUE(set.Contains(TAG_PURPOSE, KeyPurpose::ENCRYPT));
+    EXPECT_FALSE(set.Contains(TAG_PURPOSE, KeyPurpose::DECRYPT));
+
+    set.Sort();
+    EXPECT_EQ(3U, set.GetTagCount(Tag::PURPOSE));
+    EXPECT_EQ(2U, set.GetTagCount(Tag::DIGEST));
+    // Entries with the same tag are adjacent once sorted.
+    std::vector<int> purposes = findAll(set, Tag::PURPOSE);
+    ASSERT_EQ(3U, purposes.size());
+    EXPECT_EQ(purposes[0] + 2, purposes[2]);
+    EXPECT_TRUE(set.Contains(TAG_PURPOSE, KeyPurpose::ENCRYPT));
+    expectLookupsMatchScan(set);
+}
+
+TEST(AuthorizationSetTest, UnionAndSubtractMixedOrder) {
+    AuthorizationSet unsorted = AuthorizationSetBuilder()
+                                        .Authorization(TAG_PURPOSE, KeyPurpose::VERIFY)
+                                        .Authorization(TAG_KEY_SIZE, 256)
+                                        .Authorization(TAG_ALGORITHM, Algorithm::EC)
+                                        .Authorization(TAG_PURPOSE, KeyPurpose::SIGN)
+                                        .Authorization(TAG_PURPOSE, KeyPurpose::VERIFY);
+    AuthorizationSet sorted = AuthorizationSetBuilder()
+                                      .Authorization(TAG_ALGORITHM, Algorithm::EC)
+                                      .Authorization(TAG_PURPOSE, KeyPurpose::SIGN)
+                                      .Authorization(TAG_PURPOSE, KeyPurpose::ENCRYPT)
+                                      .Authorization(TAG_KEY_SIZE, 384);
+    AuthorizationSet large = largeUnsortedSet();
+    AuthorizationSet largeSorted = large;
+    largeSorted.Sort();
+    AuthorizationSet empty;
+
+    const std::vector<const AuthorizationSet*> sets = {&unsorted, &sorted, &large, &largeSorted,
+                                                       &empty};
+    for (size_t i = 0; i < sets.size(); ++i) {
+        for (size_t j = 0; j < sets.size(); ++j) {
+            SCOPED_TRACE(testing::Message() << "sets " << i << " and " << j);
+            const AuthorizationSet& a = *sets[i];
+            const AuthorizationSet& b = *sets[j];
+
+            AuthorizationSet merged = a;
+            merged.Union(b);
+            EXPECT_EQ(expectedUnion(a, b), entries(merged));
+            expectLookupsMatchScan(merged);
+
+            AuthorizationSet difference = a;
+            difference.Subtract(b);
+            EXPECT_EQ(expectedDifference(a, b), entries(difference));
+            expectLookupsMatchScan(difference);
+        }
+    }
+}
+
+}  // namespace
+}  // namespace android::hardware::keymaster::V4_0::test
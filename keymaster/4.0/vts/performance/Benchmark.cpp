@@ -29,6 +29,7 @@
 #include <unistd.h>
 
 #include <iostream>
+#include <sstream>
 
 #include <log/log.h>
 #include <utils/StrongPointer.h>
@@ -694,6 +695,97 @@ BENCHMARK_KM_CIPHER_ALL_RSA_KEYS(RSA/ECB/PKCS1Padding, SMALL_MESSAGE_SIZE);
 BENCHMARK_KM_CIPHER_ALL_RSA_KEYS(RSA/ECB/OAEPPadding, SMALL_MESSAGE_SIZE);
 // clang-format on
 
+/*
+ * ============= AuthorizationSet TESTS ==================
+ */
+
+// Characteristics of an RSA signing key, padded with user secure ids to 'size' entries.
+static AuthorizationSet keyCharacteristics(size_t size) {
+    AuthorizationSetBuilder builder;
+    builder.RsaSigningKey(2048, 65537)
+            .Digest(Digest::NONE, Digest::SHA_2_256, Digest::SHA_2_512)
+            .Padding(PaddingMode::RSA_PSS, PaddingMode::RSA_PKCS1_1_5_SIGN)
+            .Authorization(TAG_NO_AUTH_REQUIRED)
+            .Authorization(TAG_CREATION_DATETIME, 1600000000000ull)
+            .Authorization(TAG_APPLICATION_ID, HidlBuf("com.example.app"));
+    for (uint64_t sid = 1; builder.size() < size; ++sid) {
+        builder.Authorization(TAG_USER_SECURE_ID, sid);
+    }
+    return std::move(builder);
+}
+
+static AuthorizationSet beginParams() {
+    return AuthorizationSetBuilder()
+            .Authorization(TAG_PURPOSE, KeyPurpose::SIGN)
+            .Digest(Digest::SHA_2_256)
+            .Padding(PaddingMode::RSA_PSS);
+}
+
+static void authorizationSetSizes(benchmark::internal::Benchmark* benchmark) {
+    benchmark->Arg(8)->Arg(16)->Arg(32);
+}
+
+// The lookups done to check begin() parameters against a key.
+static void authSetLookup(benchmark::State& state, bool sorted) {
+    AuthorizationSet characteristics = keyCharacteristics(state.range(0));
+    if (sorted) characteristics.Sort();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(characteristics.GetTagValue(TAG_ALGORITHM));
+        benchmark::DoNotOptimize(characteristics.Contains(TAG_PURPOSE, KeyPurpose::SIGN));
+        benchmark::DoNotOptimize(characteristics.Contains(TAG_DIGEST, Digest::SHA_2_256));
+        benchmark::DoNotOptimize(characteristics.GetTagCount(TAG_USER_SECURE_ID));
+        benchmark::DoNotOptimize(characteristics.Contains(Tag::ACTIVE_DATETIME));
+    }
+}
+BENCHMARK_CAPTURE(authSetLookup, unsorted, false)->Apply(authorizationSetSizes);
+BENCHMARK_CAPTURE(authSetLookup, sorted, true)->Apply(authorizationSetSizes);
+
+static void authSetUnion(benchmark::State& state) {
+    AuthorizationSet characteristics = keyCharacteristics(state.range(0));
+    characteristics.Deduplicate();
+    AuthorizationSet params = beginParams();
+    for (auto _ : state) {
+        AuthorizationSet merged = characteristics;
+        merged.Union(params);
+        benchmark::DoNotOptimize(merged.data());
+    }
+}
+BENCHMARK(authSetUnion)->Apply(authorizationSetSizes);
+
+static void authSetSubtract(benchmark::State& state) {
+    AuthorizationSet characteristics = keyCharacteristics(state.range(0));
+    AuthorizationSet params = beginParams();
+    for (auto _ : state) {
+        AuthorizationSet remaining = characteristics;
+        remaining.Subtract(params);
+        benchmark::DoNotOptimize(remaining.data());
+    }
+}
+BENCHMARK(authSetSubtract)->Apply(authorizationSetSizes);
+
+static void authSetSerialize(benchmark::State& state) {
+    AuthorizationSet characteristics = keyCharacteristics(state.range(0));
+    for (auto _ : state) {
+        std::stringstream out;
+        characteristics.Serialize(&out);
+        benchmark::DoNotOptimize(out.tellp());
+    }
+}
+BENCHMARK(authSetSerialize)->Apply(authorizationSetSizes);
+
+static void authSetDeserialize(benchmark::State& state) {
+    std::stringstream serialized;
+    keyCharacteristics(state.range(0)).Serialize(&serialized);
+    const string bytes = serialized.str();
+    for (auto _ : state) {
+        std::stringstream in(bytes);
+        AuthorizationSet characteristics;
+        characteristics.Deserialize(&in);
+        benchmark::DoNotOptimize(characteristics.data());
+    }
+}
+BENCHMARK(authSetDeserialize)->Apply(authorizationSetSizes);
+
 }  // namespace test
 }  // namespace V4_0
 }  // namespace keymaster
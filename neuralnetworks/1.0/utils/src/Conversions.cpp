@@ -26,6 +26,7 @@
 #include <nnapi/Types.h>
 #include <nnapi/Validation.h>
 #include <nnapi/hal/CommonUtils.h>
+#include <nnapi/hal/ParallelConversion.h>
 
 #include <algorithm>
 #include <functional>
@@ -65,12 +66,8 @@ using UnvalidatedConvertOutput =
 template <typename Type>
 GeneralResult<std::vector<UnvalidatedConvertOutput<Type>>> unvalidatedConvert(
         const hidl_vec<Type>& arguments) {
-    std::vector<UnvalidatedConvertOutput<Type>> canonical;
-    canonical.reserve(arguments.size());
-    for (const auto& argument : arguments) {
-        canonical.push_back(NN_TRY(nn::unvalidatedConvert(argument)));
-    }
-    return canonical;
+    return hal::utils::convertInParallel(
+            arguments, [](const Type& argument) { return nn::unvalidatedConvert(argument); });
 }
 
 template <typename Type>
@@ -28,6 +28,7 @@
 #include <nnapi/hal/1.0/Conversions.h>
 #include <nnapi/hal/1.2/Conversions.h>
 #include <nnapi/hal/CommonUtils.h>
+#include <nnapi/hal/ParallelConversion.h>
 
 #include <algorithm>
 #include <chrono>
@@ -77,12 +78,8 @@ using UnvalidatedConvertOutput =
 template <typename Type>
 GeneralResult<std::vector<UnvalidatedConvertOutput<Type>>> unvalidatedConvert(
         const hidl_vec<Type>& arguments) {
-    std::vector<UnvalidatedConvertOutput<Type>> canonical;
-    canonical.reserve(arguments.size());
-    for (const auto& argument : arguments) {
-        canonical.push_back(NN_TRY(nn::unvalidatedConvert(argument)));
-    }
-    return canonical;
+    return hal::utils::convertInParallel(
+            arguments, [](const Type& argument) { return nn::unvalidatedConvert(argument); });
 }
 
 template <typename Type>
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aidl/android/hardware/neuralnetworks/Model.h>
+#include <android-base/logging.h>
+#include <benchmark/benchmark.h>
+#include <nnapi/Types.h>
+#include <nnapi/hal/aidl/Conversions.h>
+
+#include <cstring>
+#include <vector>
+
+// Measures the conversion and validation of large models between their AIDL and canonical forms,
+// which drivers and the runtime do before preparing a model.
+namespace aidl::android::hardware::neuralnetworks::benchmark {
+namespace {
+
+constexpr int32_t kTensorSize = 16;
+
+Operand makeTensor(OperandLifeTime lifetime, DataLocation location = {}) {
+    return {.type = OperandType::TENSOR_FLOAT32,
+            .dimensions = {1, kTensorSize},
+            .lifetime = lifetime,
+            .location = location};
+}
+
+// A chain of `numOperations` ADD operations, each adding the same constant to the output of the
+// previous one.
+Model makeModel(int32_t numOperations) {
+    Model model;
+    model.operandValues.resize(kTensorSize * sizeof(float) + sizeof(int32_t));
+    const int32_t activation = 0;
+    std::memcpy(model.operandValues.data() + kTensorSize * sizeof(float), &activation,
+                sizeof(activation));
+
+    auto& operands = model.main.operands;
+    operands.push_back(makeTensor(OperandLifeTime::CONSTANT_COPY,
+                                  {.offset = 0, .length = kTensorSize * sizeof(float)}));
+    operands.push_back({.type = OperandType::INT32,
+                        .lifetime = OperandLifeTime::CONSTANT_COPY,
+                        .location = {.offset = kTensorSize * sizeof(float),
+                                     .length = sizeof(int32_t)}});
+    operands.push_back(makeTensor(OperandLifeTime::SUBGRAPH_INPUT));
+    for (int32_t i = 0; i < numOperations; ++i) {
+        const int32_t input = static_cast<int32_t>(operands.size()) - 1;
+        operands.push_back(makeTensor(i + 1 < numOperations ? OperandLifeTime::TEMPORARY_VARIABLE
+                                                            : OperandLifeTime::SUBGRAPH_OUTPUT));
+        model.main.operations.push_back({.type = OperationType::ADD,
+                                         .inputs = {input, 0, 1},
+                                         .outputs = {input + 1}});
+    }
+    model.main.inputIndexes = {2};
+    model.main.outputIndexes = {static_cast<int32_t>(operands.size()) - 1};
+    return model;
+}
+
+void BM_convertToCanonical(::benchmark::State& state) {
+    const Model model = makeModel(state.range(0));
+    for (auto _ : state) {
+        CHECK(nn::convert(model).has_value());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_convertToCanonical)->Arg(100)->Arg(10000)->Arg(50000);
+
+void BM_convertFromCanonical(::benchmark::State& state) {
+    const nn::Model model = nn::convert(makeModel(state.range(0))).value();
+    for (auto _ : state) {
+        CHECK(utils::convert(model).has_value());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_convertFromCanonical)->Arg(100)->Arg(10000)->Arg(50000);
+
+}  // namespace
+}  // namespace aidl::android::hardware::neuralnetworks::benchmark
+
+BENCHMARK_MAIN();
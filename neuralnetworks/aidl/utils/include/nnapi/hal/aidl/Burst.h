@@ -25,10 +25,12 @@
 #include <nnapi/Types.h>
 #include <nnapi/hal/CommonUtils.h>
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <unordered_map>
 #include <utility>
 
@@ -77,13 +79,26 @@ class Burst final : public nn::IBurst, public std::enable_shared_from_this<Burst
                 const nn::SharedMemory& memory);
 
       private:
+        static constexpr size_t kShardBits = 4;
+        static constexpr size_t kNumShards = size_t{1} << kShardBits;
+
+        // Memory objects are spread over shards by address, so that clients executing on several
+        // threads rarely contend. Cache hits only take the lock of their shard in shared mode.
+        struct Shard {
+            // Guards cache. Not annotated because std::shared_lock is not a scoped capability.
+            std::shared_mutex mutex;
+            std::unordered_map<nn::SharedMemory, std::pair<int64_t, WeakCleanup>> cache;
+        };
+
+        Shard& getShard(const nn::SharedMemory& memory);
+        // Must be called with shard.mutex held, either shared or exclusive.
+        static std::optional<std::pair<int64_t, SharedCleanup>> getCachedMemory(
+                const Shard& shard, const nn::SharedMemory& memory);
         void tryFreeMemory(const nn::SharedMemory& memory, int64_t identifier);
 
         const std::shared_ptr<aidl_hal::IBurst> kBurst;
-        std::mutex mMutex;
-        int64_t mUnusedIdentifier GUARDED_BY(mMutex) = 0;
-        std::unordered_map<nn::SharedMemory, std::pair<int64_t, WeakCleanup>> mCache
-                GUARDED_BY(mMutex);
+        std::atomic<int64_t> mUnusedIdentifier = 0;
+        std::array<Shard, kNumShards> mShards;
     };
 
     // featureLevel is for testing purposes.
@@ -27,9 +27,11 @@
 #include <nnapi/TypeUtils.h>
 #include <nnapi/Types.h>
 
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <utility>
 
 namespace aidl::android::hardware::neuralnetworks::utils {
@@ -84,12 +86,42 @@ nn::GeneralResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> convertEx
 Burst::MemoryCache::MemoryCache(std::shared_ptr<aidl_hal::IBurst> burst)
     : kBurst(std::move(burst)) {}
 
+Burst::MemoryCache::Shard& Burst::MemoryCache::getShard(const nn::SharedMemory& memory) {
+    // Memory objects are aligned, so mix all the bits of the address before picking a shard.
+    const uint64_t address = reinterpret_cast<uintptr_t>(memory.get());
+    return mShards[(address * 0x9e3779b97f4a7c15) >> (64 - kShardBits)];
+}
+
+std::optional<std::pair<int64_t, Burst::MemoryCache::SharedCleanup>>
+Burst::MemoryCache::getCachedMemory(const Shard& shard, const nn::SharedMemory& memory) {
+    const auto iter = shard.cache.find(memory);
+    if (iter != shard.cache.end()) {
+        const auto& [identifier, maybeCleaner] = iter->second;
+        if (auto cleaner = maybeCleaner.lock()) {
+            return std::make_pair(identifier, std::move(cleaner));
+        }
+    }
+    return std::nullopt;
+}
+
 std::pair<int64_t, Burst::MemoryCache::SharedCleanup> Burst::MemoryCache::getOrCacheMemory(
         const nn::SharedMemory& memory) {
-    std::lock_guard lock(mMutex);
+    auto& shard = getShard(memory);
 
-    // Get the cache payload or create it (with default values) if it does not exist.
-    auto& cachedPayload = mCache[memory];
+    // Reuse the cache payload if it already exists, which is the common case once a client has
+    // executed with its memory objects.
+    {
+        std::shared_lock lock(shard.mutex);
+        if (auto cached = getCachedMemory(shard, memory)) {
+            return std::move(cached).value();
+        }
+    }
+
+    std::lock_guard lock(shard.mutex);
+
+    // Get the cache payload or create it (with default values) if it does not exist. Another
+    // thread may have cached the same memory object since the shared lock was released.
+    auto& cachedPayload = shard.cache[memory];
     {
         const auto& [identifier, maybeCleaner] = cachedPayload;
         // If cache payload already exists, reuse it.
@@ -102,8 +134,8 @@ std::pair<int64_t, Burst::MemoryCache::SharedCleanup> Burst::MemoryCache::getOrC
     // this call.
 
     // Allocate a new identifier.
-    CHECK_LT(mUnusedIdentifier, std::numeric_limits<int64_t>::max());
-    const int64_t identifier = mUnusedIdentifier++;
+    const int64_t identifier = mUnusedIdentifier.fetch_add(1, std::memory_order_relaxed);
+    CHECK_LT(identifier, std::numeric_limits<int64_t>::max());
 
     // Create reference-counted self-cleaning cache object.
     auto self = weak_from_this();
@@ -122,32 +154,25 @@ std::pair<int64_t, Burst::MemoryCache::SharedCleanup> Burst::MemoryCache::getOrC
 
 std::optional<std::pair<int64_t, Burst::MemoryCache::SharedCleanup>>
 Burst::MemoryCache::getMemoryIfAvailable(const nn::SharedMemory& memory) {
-    std::lock_guard lock(mMutex);
+    auto& shard = getShard(memory);
+    std::shared_lock lock(shard.mutex);
 
-    // Get the existing cached entry if it exists.
-    const auto iter = mCache.find(memory);
-    if (iter != mCache.end()) {
-        const auto& [identifier, maybeCleaner] = iter->second;
-        if (auto cleaner = maybeCleaner.lock()) {
-            return std::make_pair(identifier, std::move(cleaner));
-        }
-    }
-
-    // If the code reaches this point, the cached payload did not exist or was actively being
-    // deleted.
-    return std::nullopt;
+    // Get the existing cached entry if it exists. If it does not, the cached payload did not exist
+    // or was actively being deleted.
+    return getCachedMemory(shard, memory);
 }
 
 void Burst::MemoryCache::tryFreeMemory(const nn::SharedMemory& memory, int64_t identifier) {
     {
-        std::lock_guard guard(mMutex);
+        auto& shard = getShard(memory);
+        std::lock_guard guard(shard.mutex);
         // Remove the cached memory and payload if it is present but expired. Note that it may not
         // be present or may not be expired because another thread may have removed or cached the
-        // same memory object before the current thread locked mMutex in tryFreeMemory.
-        const auto iter = mCache.find(memory);
-        if (iter != mCache.end()) {
+        // same memory object before the current thread locked the shard in tryFreeMemory.
+        const auto iter = shard.cache.find(memory);
+        if (iter != shard.cache.end()) {
             if (std::get<WeakCleanup>(iter->second).expired()) {
-                mCache.erase(iter);
+                shard.cache.erase(iter);
             }
         }
     }
@@ -34,6 +34,7 @@
 #include <nnapi/Types.h>
 #include <nnapi/Validation.h>
 #include <nnapi/hal/CommonUtils.h>
+#include <nnapi/hal/ParallelConversion.h>
 
 #include <algorithm>
 #include <chrono>
@@ -75,12 +76,8 @@ using UnvalidatedConvertOutput =
 template <typename Type>
 GeneralResult<std::vector<UnvalidatedConvertOutput<Type>>> unvalidatedConvertVec(
         const std::vector<Type>& arguments) {
-    std::vector<UnvalidatedConvertOutput<Type>> canonical;
-    canonical.reserve(arguments.size());
-    for (const auto& argument : arguments) {
-        canonical.push_back(NN_TRY(nn::unvalidatedConvert(argument)));
-    }
-    return canonical;
+    return hal::utils::convertInParallel(
+            arguments, [](const Type& argument) { return nn::unvalidatedConvert(argument); });
 }
 
 template <typename Type>
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "MockBurst.h"
+
+#include <android/binder_auto_utils.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <nnapi/SharedMemory.h>
+#include <nnapi/Types.h>
+#include <nnapi/hal/aidl/Burst.h>
+
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace aidl::android::hardware::neuralnetworks::utils {
+namespace {
+
+using ::testing::_;
+using ::testing::InvokeWithoutArgs;
+
+constexpr size_t kNumMemories = 64;
+constexpr size_t kNumThreads = 8;
+constexpr size_t kNumIterations = 1000;
+
+constexpr auto makeStatusOk = [] { return ndk::ScopedAStatus::ok(); };
+
+std::vector<nn::SharedMemory> createMemories() {
+    std::vector<nn::SharedMemory> memories;
+    for (size_t i = 0; i < kNumMemories; ++i) {
+        memories.push_back(nn::createSharedMemory(4).value());
+    }
+    return memories;
+}
+
+}  // namespace
+
+TEST(BurstMemoryCacheTest, getOrCacheMemoryReusesIdentifier) {
+    // setup test
+    const auto mockBurst = ndk::SharedRefBase::make<MockBurst>();
+    const auto memoryCache = std::make_shared<Burst::MemoryCache>(mockBurst);
+    const auto memories = createMemories();
+
+    // run test
+    std::vector<Burst::MemoryCache::SharedCleanup> holds;
+    std::set<int64_t> identifiers;
+    for (const auto& memory : memories) {
+        const auto [identifier, hold] = memoryCache->getOrCacheMemory(memory);
+        const auto [sameIdentifier, sameHold] = memoryCache->getOrCacheMemory(memory);
+        EXPECT_EQ(identifier, sameIdentifier);
+        EXPECT_EQ(hold, sameHold);
+        identifiers.insert(identifier);
+        holds.push_back(hold);
+    }
+
+    // verify result
+    EXPECT_EQ(identifiers.size(), kNumMemories);
+
+    // teardown
+    EXPECT_CALL(*mockBurst, releaseMemoryResource(_))
+            .Times(kNumMemories)
+            .WillRepeatedly(InvokeWithoutArgs(makeStatusOk));
+}
+
+TEST(BurstMemoryCacheTest, releaseHoldFreesMemory) {
+    // setup test
+    const auto mockBurst = ndk::SharedRefBase::make<MockBurst>();
+    const auto memoryCache = std::make_shared<Burst::MemoryCache>(mockBurst);
+    const auto memory = nn::createSharedMemory(4).value();
+    auto [identifier, hold] = memoryCache->getOrCacheMemory(memory);
+    EXPECT_CALL(*mockBurst, releaseMemoryResource(identifier))
+            .Times(1)
+            .WillOnce(InvokeWithoutArgs(makeStatusOk));
+
+    // run test
+    hold.reset();
+
+    // verify result
+    EXPECT_FALSE(memoryCache->getMemoryIfAvailable(memory).has_value());
+}
+
+TEST(BurstMemoryCacheTest, concurrentGetOrCacheMemory) {
+    // setup test
+    const auto mockBurst = ndk::SharedRefBase::make<MockBurst>();
+    const auto memoryCache = std::make_shared<Burst::MemoryCache>(mockBurst);
+    const auto memories = createMemories();
+    EXPECT_CALL(*mockBurst, releaseMemoryResource(_))
+            .WillRepeatedly(InvokeWithoutArgs(makeStatusOk));
+
+    // run test
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&memoryCache, &memories, t] {
+            for (size_t i = 0; i < kNumIterations; ++i) {
+                const auto& memory = memories[(i * (t + 1)) % kNumMemories];
+                const auto [identifier, hold] = memoryCache->getOrCacheMemory(memory);
+                const auto cached = memoryCache->getMemoryIfAvailable(memory);
+                ASSERT_TRUE(cached.has_value());
+                EXPECT_EQ(cached->first, identifier);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // verify result
+    for (const auto& memory : memories) {
+        EXPECT_FALSE(memoryCache->getMemoryIfAvailable(memory).has_value());
+    }
+}
+
+}  // namespace aidl::android::hardware::neuralnetworks::utils
@@ -25,8 +25,10 @@
 #include <nnapi/IBurst.h>
 #include <nnapi/Types.h>
 
+#include <array>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -63,8 +65,19 @@ class Burst : public BnBurst {
         void remove(int64_t token) const;
 
       private:
-        mutable std::mutex mMutex;
-        mutable std::unordered_map<int64_t, Value> mCache GUARDED_BY(mMutex);
+        static constexpr size_t kNumShards = 16;
+
+        // Tokens are spread over shards, so that clients executing on several threads rarely
+        // contend. Tokens already in the cache only take the lock of their shard in shared mode.
+        struct Shard {
+            // Guards cache. Not annotated because std::shared_lock is not a scoped capability.
+            std::shared_mutex mutex;
+            std::unordered_map<int64_t, Value> cache;
+        };
+
+        Shard& getShard(int64_t token) const;
+
+        mutable std::array<Shard, kNumShards> mShards;
     };
 
   private:
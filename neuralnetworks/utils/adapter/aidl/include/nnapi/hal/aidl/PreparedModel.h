@@ -28,6 +28,7 @@
 #include <android/binder_auto_utils.h>
 #include <nnapi/IPreparedModel.h>
 #include <nnapi/Types.h>
+#include <nnapi/hal/ReusableExecutionCache.h>
 
 #include <memory>
 #include <vector>
@@ -67,6 +68,7 @@ class PreparedModel : public BnPreparedModel {
 
   protected:
     const ::android::nn::SharedPreparedModel kPreparedModel;
+    ::android::hardware::neuralnetworks::utils::ReusableExecutionCache mExecutionCache;
 };
 
 }  // namespace aidl::android::hardware::neuralnetworks::adapter
@@ -30,6 +30,7 @@
 #include <chrono>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -131,20 +132,41 @@ nn::ExecutionResult<ExecutionResult> executeSynchronously(
 
 }  // namespace
 
+Burst::ThreadSafeMemoryCache::Shard& Burst::ThreadSafeMemoryCache::getShard(int64_t token) const {
+    // Clients allocate tokens sequentially, so consecutive tokens land in different shards.
+    return mShards[static_cast<uint64_t>(token) % kNumShards];
+}
+
 Value Burst::ThreadSafeMemoryCache::add(int64_t token, const nn::SharedMemory& memory,
                                         const nn::IBurst& burst) const {
-    std::lock_guard guard(mMutex);
-    if (const auto it = mCache.find(token); it != mCache.end()) {
+    auto& shard = getShard(token);
+    {
+        std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.cache.find(token); it != shard.cache.end()) {
+            return it->second;
+        }
+    }
+
+    std::lock_guard guard(shard.mutex);
+    if (const auto it = shard.cache.find(token); it != shard.cache.end()) {
         return it->second;
     }
     auto hold = burst.cacheMemory(memory);
-    auto [it, _] = mCache.emplace(token, std::make_pair(memory, std::move(hold)));
+    auto [it, _] = shard.cache.emplace(token, std::make_pair(memory, std::move(hold)));
     return it->second;
 }
 
 void Burst::ThreadSafeMemoryCache::remove(int64_t token) const {
-    std::lock_guard guard(mMutex);
-    mCache.erase(token);
+    auto& shard = getShard(token);
+    // Release the memory and its cache hold after unlocking, as the hold may call into the driver.
+    Value removed;
+    {
+        std::lock_guard guard(shard.mutex);
+        if (const auto it = shard.cache.find(token); it != shard.cache.end()) {
+            removed = std::move(it->second);
+            shard.cache.erase(it);
+        }
+    }
 }
 
 Burst::Burst(nn::SharedBurst burst) : kBurst(std::move(burst)) {
@@ -33,6 +33,7 @@
 #include <nnapi/SharedMemory.h>
 #include <nnapi/Types.h>
 #include <nnapi/Validation.h>
+#include <nnapi/hal/ReusableExecutionCache.h>
 #include <nnapi/hal/aidl/Conversions.h>
 #include <nnapi/hal/aidl/Utils.h>
 
@@ -43,6 +44,8 @@
 namespace aidl::android::hardware::neuralnetworks::adapter {
 namespace {
 
+using ReusableExecutionCache = ::android::hardware::neuralnetworks::utils::ReusableExecutionCache;
+
 class FencedExecutionCallback : public BnFencedExecutionCallback {
   public:
     FencedExecutionCallback(nn::ExecuteFencedInfoCallback callback)
@@ -118,21 +121,8 @@ nn::GeneralResult<nn::OptionalTimePoint> makeOptionalTimePoint(int64_t durationN
     return durationNs < 0 ? nn::OptionalTimePoint{} : nn::TimePoint(makeDuration(durationNs));
 }
 
-nn::ExecutionResult<ExecutionResult> executeSynchronously(
-        const nn::IPreparedModel& preparedModel, const Request& request, bool measureTiming,
-        int64_t deadlineNs, int64_t loopTimeoutDurationNs, const std::vector<TokenValuePair>& hints,
-        const std::vector<ExtensionNameAndPrefix>& extensionNameToPrefix) {
-    const auto nnRequest = NN_TRY(convertInput(request));
-    const auto nnMeasureTiming = measureTiming ? nn::MeasureTiming::YES : nn::MeasureTiming::NO;
-    const auto nnDeadline = NN_TRY(makeOptionalTimePoint(deadlineNs));
-    const auto nnLoopTimeoutDuration = NN_TRY(makeOptionalDuration(loopTimeoutDurationNs));
-    auto nnHints = NN_TRY(convertInput(hints));
-    auto nnExtensionNameToPrefix = NN_TRY(convertInput(extensionNameToPrefix));
-
-    const auto result =
-            preparedModel.execute(nnRequest, nnMeasureTiming, nnDeadline, nnLoopTimeoutDuration,
-                                  nnHints, nnExtensionNameToPrefix);
-
+nn::ExecutionResult<ExecutionResult> makeExecutionResult(
+        const nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>>& result) {
     if (!result.ok() && result.error().code == nn::ErrorStatus::OUTPUT_INSUFFICIENT_SIZE) {
         const auto& [message, code, outputShapes] = result.error();
         LOG(ERROR) << "executeSynchronously failed with " << code << ": " << message;
@@ -147,6 +137,22 @@ nn::ExecutionResult<ExecutionResult> executeSynchronously(
                            .timing = utils::convert(timing).value()};
 }
 
+nn::ExecutionResult<ExecutionResult> executeSynchronously(
+        const nn::IPreparedModel& preparedModel, const Request& request, bool measureTiming,
+        int64_t deadlineNs, int64_t loopTimeoutDurationNs, const std::vector<TokenValuePair>& hints,
+        const std::vector<ExtensionNameAndPrefix>& extensionNameToPrefix) {
+    const auto nnRequest = NN_TRY(convertInput(request));
+    const auto nnMeasureTiming = measureTiming ? nn::MeasureTiming::YES : nn::MeasureTiming::NO;
+    const auto nnDeadline = NN_TRY(makeOptionalTimePoint(deadlineNs));
+    const auto nnLoopTimeoutDuration = NN_TRY(makeOptionalDuration(loopTimeoutDurationNs));
+    auto nnHints = NN_TRY(convertInput(hints));
+    auto nnExtensionNameToPrefix = NN_TRY(convertInput(extensionNameToPrefix));
+
+    return makeExecutionResult(preparedModel.execute(nnRequest, nnMeasureTiming, nnDeadline,
+                                                     nnLoopTimeoutDuration, nnHints,
+                                                     nnExtensionNameToPrefix));
+}
+
 nn::GeneralResult<FencedExecutionResult> executeFenced(
         const nn::IPreparedModel& preparedModel, const Request& request,
         const std::vector<ndk::ScopedFileDescriptor>& waitFor, bool measureTiming,
@@ -191,24 +197,87 @@ nn::GeneralResult<nn::SharedExecution> createReusableExecution(
                                                  nnHints, nnExtensionNameToPrefix);
 }
 
-nn::ExecutionResult<ExecutionResult> executeSynchronously(const nn::IExecution& execution,
-                                                          int64_t deadlineNs) {
-    const auto nnDeadline = NN_TRY(makeOptionalTimePoint(deadlineNs));
+// Describes everything about |request| and its execution config but the file descriptors of its
+// memory pools, which are returned in |fds|. Returns false if the request cannot be identified
+// this way: requests using driver-managed buffers or hardware buffers are never cached.
+bool getCacheKey(const Request& request, bool measureTiming, int64_t loopTimeoutDurationNs,
+                 std::vector<int64_t>* layout, std::vector<int>* fds) {
+    layout->assign({measureTiming, loopTimeoutDurationNs,
+                    static_cast<int64_t>(request.inputs.size()),
+                    static_cast<int64_t>(request.outputs.size()),
+                    static_cast<int64_t>(request.pools.size())});
+    const auto addArguments = [layout](const std::vector<RequestArgument>& arguments) {
+        for (const auto& argument : arguments) {
+            const auto& location = argument.location;
+            layout->insert(layout->end(),
+                           {argument.hasNoValue, location.poolIndex, location.offset,
+                            location.length, location.padding,
+                            static_cast<int64_t>(argument.dimensions.size())});
+            layout->insert(layout->end(), argument.dimensions.begin(), argument.dimensions.end());
+        }
+    };
+    addArguments(request.inputs);
+    addArguments(request.outputs);
 
-    const auto result = execution.compute(nnDeadline);
+    fds->clear();
+    for (const auto& pool : request.pools) {
+        if (pool.getTag() != RequestMemoryPool::Tag::pool) {
+            return false;
+        }
+        const auto& memory = pool.get<RequestMemoryPool::Tag::pool>();
+        layout->push_back(static_cast<int64_t>(memory.getTag()));
+        switch (memory.getTag()) {
+            case Memory::Tag::ashmem: {
+                const auto& ashmem = memory.get<Memory::Tag::ashmem>();
+                layout->push_back(ashmem.size);
+                fds->push_back(ashmem.fd.get());
+                break;
+            }
+            case Memory::Tag::mappableFile: {
+                const auto& mappableFile = memory.get<Memory::Tag::mappableFile>();
+                layout->insert(layout->end(),
+                               {mappableFile.length, mappableFile.prot, mappableFile.offset});
+                fds->push_back(mappableFile.fd.get());
+                break;
+            }
+            case Memory::Tag::hardwareBuffer:
+                return false;
+        }
+    }
+    return true;
+}
 
-    if (!result.ok() && result.error().code == nn::ErrorStatus::OUTPUT_INSUFFICIENT_SIZE) {
-        const auto& [message, code, outputShapes] = result.error();
-        LOG(ERROR) << "executeSynchronously failed with " << code << ": " << message;
-        return ExecutionResult{.outputSufficientSize = false,
-                               .outputShapes = utils::convert(outputShapes).value(),
-                               .timing = {.timeInDriverNs = -1, .timeOnDeviceNs = -1}};
+// Same as executeSynchronously, but repeated requests are computed with the reusable execution
+// created for the first one.
+nn::ExecutionResult<ExecutionResult> executeSynchronously(
+        const nn::IPreparedModel& preparedModel, ReusableExecutionCache* executionCache,
+        const Request& request, bool measureTiming, int64_t deadlineNs,
+        int64_t loopTimeoutDurationNs, const std::vector<TokenValuePair>& hints,
+        const std::vector<ExtensionNameAndPrefix>& extensionNameToPrefix) {
+    std::vector<int64_t> layout;
+    std::vector<int> fds;
+    if (!hints.empty() || !extensionNameToPrefix.empty() ||
+        !ReusableExecutionCache::isSupported() ||
+        !getCacheKey(request, measureTiming, loopTimeoutDurationNs, &layout, &fds)) {
+        return executeSynchronously(preparedModel, request, measureTiming, deadlineNs,
+                                    loopTimeoutDurationNs, hints, extensionNameToPrefix);
     }
 
-    const auto& [outputShapes, timing] = NN_TRY(result);
-    return ExecutionResult{.outputSufficientSize = true,
-                           .outputShapes = utils::convert(outputShapes).value(),
-                           .timing = utils::convert(timing).value()};
+    const auto nnDeadline = NN_TRY(makeOptionalTimePoint(deadlineNs));
+    const auto makeExecution = [&] {
+        return createReusableExecution(preparedModel, request, measureTiming,
+                                       loopTimeoutDurationNs, hints, extensionNameToPrefix);
+    };
+
+    return makeExecutionResult(
+            executionCache->compute(std::move(layout), fds, makeExecution, nnDeadline));
+}
+
+nn::ExecutionResult<ExecutionResult> executeSynchronously(const nn::IExecution& execution,
+                                                          int64_t deadlineNs) {
+    const auto nnDeadline = NN_TRY(makeOptionalTimePoint(deadlineNs));
+
+    return makeExecutionResult(execution.compute(nnDeadline));
 }
 
 nn::GeneralResult<FencedExecutionResult> executeFenced(
@@ -243,8 +312,9 @@ ndk::ScopedAStatus PreparedModel::executeSynchronously(const Request& request, b
                                                        int64_t deadlineNs,
                                                        int64_t loopTimeoutDurationNs,
                                                        ExecutionResult* executionResult) {
-    auto result = adapter::executeSynchronously(*kPreparedModel, request, measureTiming, deadlineNs,
-                                                loopTimeoutDurationNs, {}, {});
+    auto result = adapter::executeSynchronously(*kPreparedModel, &mExecutionCache, request,
+                                                measureTiming, deadlineNs, loopTimeoutDurationNs,
+                                                {}, {});
     if (!result.has_value()) {
         const auto& [message, code, _] = result.error();
         const auto aidlCode = utils::convert(code).value_or(ErrorStatus::GENERAL_FAILURE);
@@ -276,7 +346,7 @@ ndk::ScopedAStatus PreparedModel::executeSynchronouslyWithConfig(const Request&
                                                                  int64_t deadlineNs,
                                                                  ExecutionResult* executionResult) {
     auto result = adapter::executeSynchronously(
-            *kPreparedModel, request, config.measureTiming, deadlineNs,
+            *kPreparedModel, &mExecutionCache, request, config.measureTiming, deadlineNs,
             config.loopTimeoutDurationNs, config.executionHints, config.extensionNameToPrefix);
     if (!result.has_value()) {
         const auto& [message, code, _] = result.error();
@@ -29,6 +29,7 @@
 #include <android/hardware/neuralnetworks/1.3/types.h>
 #include <nnapi/IPreparedModel.h>
 #include <nnapi/Types.h>
+#include <nnapi/hal/ReusableExecutionCache.h>
 #include <memory>
 
 // See hardware/interfaces/neuralnetworks/utils/README.md for more information on HIDL interface
@@ -70,6 +71,7 @@ class PreparedModel final : public V1_3::IPreparedModel {
 
   private:
     const nn::SharedPreparedModel kPreparedModel;
+    utils::ReusableExecutionCache mExecutionCache;
 };
 
 }  // namespace android::hardware::neuralnetworks::adapter
@@ -36,6 +36,7 @@
 #include <nnapi/hal/1.2/Utils.h>
 #include <nnapi/hal/1.3/Conversions.h>
 #include <nnapi/hal/1.3/Utils.h>
+#include <nnapi/hal/ReusableExecutionCache.h>
 
 #include <memory>
 #include <thread>
@@ -201,14 +202,95 @@ nn::GeneralResult<void> execute_1_3(const nn::SharedPreparedModel& preparedModel
     return {};
 }
 
+void addToCacheKey(const hidl_vec<V1_0::RequestArgument>& arguments,
+                   std::vector<int64_t>* layout) {
+    for (const auto& argument : arguments) {
+        const auto& location = argument.location;
+        layout->insert(layout->end(),
+                       {argument.hasNoValue, location.poolIndex, location.offset, location.length,
+                        static_cast<int64_t>(argument.dimensions.size())});
+        layout->insert(layout->end(), argument.dimensions.begin(), argument.dimensions.end());
+    }
+}
+
+// Only ashmem and mmap_fd memory, which are fully described by their handle, are cached.
+bool addToCacheKey(const hidl_memory& memory, std::vector<int64_t>* layout,
+                   std::vector<int>* fds) {
+    const native_handle_t* handle = memory.handle();
+    if (handle == nullptr || (memory.name() != "ashmem" && memory.name() != "mmap_fd")) {
+        return false;
+    }
+    layout->insert(layout->end(), {memory.name() == "ashmem", static_cast<int64_t>(memory.size()),
+                                   handle->numFds, handle->numInts});
+    const int* ints = handle->data + handle->numFds;
+    layout->insert(layout->end(), ints, ints + handle->numInts);
+    fds->insert(fds->end(), handle->data, handle->data + handle->numFds);
+    return true;
+}
+
+bool addToCacheKey(const V1_3::Request::MemoryPool& pool, std::vector<int64_t>* layout,
+                   std::vector<int>* fds) {
+    if (pool.getDiscriminator() != V1_3::Request::MemoryPool::hidl_discriminator::hidlMemory) {
+        return false;
+    }
+    return addToCacheKey(pool.hidlMemory(), layout, fds);
+}
+
+// Describes everything about |request| and its execution config but the file descriptors of its
+// memory pools, which are returned in |fds|. Returns false if the request cannot be identified
+// this way, e.g. because it uses driver-managed buffers.
+template <typename Request>
+bool getCacheKey(const Request& request, nn::MeasureTiming measure,
+                 const nn::OptionalDuration& loopTimeoutDuration, std::vector<int64_t>* layout,
+                 std::vector<int>* fds) {
+    layout->assign({static_cast<int64_t>(measure),
+                    loopTimeoutDuration.has_value()
+                            ? static_cast<int64_t>(loopTimeoutDuration->count())
+                            : -1,
+                    static_cast<int64_t>(request.inputs.size()),
+                    static_cast<int64_t>(request.outputs.size()),
+                    static_cast<int64_t>(request.pools.size())});
+    addToCacheKey(request.inputs, layout);
+    addToCacheKey(request.outputs, layout);
+    fds->clear();
+    for (const auto& pool : request.pools) {
+        if (!addToCacheKey(pool, layout, fds)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Repeated requests are computed with the reusable execution created for the first one.
+template <typename Request>
+nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> executeCached(
+        const nn::IPreparedModel& preparedModel, utils::ReusableExecutionCache* executionCache,
+        const Request& request, nn::MeasureTiming measure, const nn::OptionalTimePoint& deadline,
+        const nn::OptionalDuration& loopTimeoutDuration) {
+    std::vector<int64_t> layout;
+    std::vector<int> fds;
+    if (!utils::ReusableExecutionCache::isSupported() ||
+        !getCacheKey(request, measure, loopTimeoutDuration, &layout, &fds)) {
+        const auto nnRequest = NN_TRY(convertInput(request));
+        return preparedModel.execute(nnRequest, measure, deadline, loopTimeoutDuration, {}, {});
+    }
+
+    const auto makeExecution = [&]() -> nn::GeneralResult<nn::SharedExecution> {
+        const auto nnRequest = NN_TRY(convertInput(request));
+        return preparedModel.createReusableExecution(nnRequest, measure, loopTimeoutDuration, {},
+                                                     {});
+    };
+    return executionCache->compute(std::move(layout), fds, makeExecution, deadline);
+}
+
 nn::ExecutionResult<std::pair<hidl_vec<V1_2::OutputShape>, V1_2::Timing>> executeSynchronously(
-        const nn::SharedPreparedModel& preparedModel, const V1_0::Request& request,
+        const nn::SharedPreparedModel& preparedModel,
+        utils::ReusableExecutionCache* executionCache, const V1_0::Request& request,
         V1_2::MeasureTiming measure) {
-    const auto nnRequest = NN_TRY(convertInput(request));
     const auto nnMeasure = NN_TRY(convertInput(measure));
 
     const auto [outputShapes, timing] =
-            NN_TRY(preparedModel->execute(nnRequest, nnMeasure, {}, {}, {}, {}));
+            NN_TRY(executeCached(*preparedModel, executionCache, request, nnMeasure, {}, {}));
 
     auto hidlOutputShapes = NN_TRY(V1_2::utils::convert(outputShapes));
     const auto hidlTiming = NN_TRY(V1_2::utils::convert(timing));
@@ -216,16 +298,16 @@ nn::ExecutionResult<std::pair<hidl_vec<V1_2::OutputShape>, V1_2::Timing>> execut
 }
 
 nn::ExecutionResult<std::pair<hidl_vec<V1_2::OutputShape>, V1_2::Timing>> executeSynchronously_1_3(
-        const nn::SharedPreparedModel& preparedModel, const V1_3::Request& request,
+        const nn::SharedPreparedModel& preparedModel,
+        utils::ReusableExecutionCache* executionCache, const V1_3::Request& request,
         V1_2::MeasureTiming measure, const V1_3::OptionalTimePoint& deadline,
         const V1_3::OptionalTimeoutDuration& loopTimeoutDuration) {
-    const auto nnRequest = NN_TRY(convertInput(request));
     const auto nnMeasure = NN_TRY(convertInput(measure));
     const auto nnDeadline = NN_TRY(convertInput(deadline));
     const auto nnLoopTimeoutDuration = NN_TRY(convertInput(loopTimeoutDuration));
 
-    const auto [outputShapes, timing] = NN_TRY(preparedModel->execute(
-            nnRequest, nnMeasure, nnDeadline, nnLoopTimeoutDuration, {}, {}));
+    const auto [outputShapes, timing] = NN_TRY(executeCached(
+            *preparedModel, executionCache, request, nnMeasure, nnDeadline, nnLoopTimeoutDuration));
 
     auto hidlOutputShapes = NN_TRY(V1_3::utils::convert(outputShapes));
     const auto hidlTiming = NN_TRY(V1_3::utils::convert(timing));
@@ -333,7 +415,7 @@ Return<V1_3::ErrorStatus> PreparedModel::execute_1_3(
 Return<void> PreparedModel::executeSynchronously(const V1_0::Request& request,
                                                  V1_2::MeasureTiming measure,
                                                  executeSynchronously_cb cb) {
-    auto result = adapter::executeSynchronously(kPreparedModel, request, measure);
+    auto result = adapter::executeSynchronously(kPreparedModel, &mExecutionCache, request, measure);
     if (!result.has_value()) {
         auto [message, code, outputShapes] = std::move(result).error();
         LOG(ERROR) << "adapter::PreparedModel::executeSynchronously failed with " << code << ": "
@@ -351,8 +433,8 @@ Return<void> PreparedModel::executeSynchronously_1_3(
         const V1_3::Request& request, V1_2::MeasureTiming measure,
         const V1_3::OptionalTimePoint& deadline,
         const V1_3::OptionalTimeoutDuration& loopTimeoutDuration, executeSynchronously_1_3_cb cb) {
-    auto result = adapter::executeSynchronously_1_3(kPreparedModel, request, measure, deadline,
-                                                    loopTimeoutDuration);
+    auto result = adapter::executeSynchronously_1_3(kPreparedModel, &mExecutionCache, request,
+                                                    measure, deadline, loopTimeoutDuration);
     if (!result.has_value()) {
         auto [message, code, outputShapes] = std::move(result).error();
         LOG(ERROR) << "adapter::PreparedModel::executeSynchronously_1_3 failed with " << code
@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_PARALLEL_CONVERSION_H
+#define ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_PARALLEL_CONVERSION_H
+
+#include <nnapi/Result.h>
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace android::hardware::neuralnetworks::utils {
+
+// Vectors with fewer elements are converted on the calling thread, as starting threads would cost
+// more than it saves.
+constexpr size_t kMinParallelConversionSize = 4096;
+constexpr size_t kMaxConversionThreads = 4;
+
+// Converts each element of `objects` with `convert`. Large vectors, such as the operands and
+// operations of large models, are split into contiguous ranges which are converted on separate
+// threads. The result is the same as converting the elements in order: when several elements fail
+// to convert, the error of the first one is returned.
+template <typename Vector, typename ConvertFn>
+auto convertInParallel(const Vector& objects, const ConvertFn& convert)
+        -> nn::GeneralResult<std::vector<std::decay_t<decltype(convert(objects[0]).value())>>> {
+    using Output = std::decay_t<decltype(convert(objects[0]).value())>;
+    using Outputs = nn::GeneralResult<std::vector<Output>>;
+
+    const auto convertRange = [&objects, &convert](size_t begin, size_t end) -> Outputs {
+        std::vector<Output> canonical;
+        canonical.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            canonical.push_back(NN_TRY(convert(objects[i])));
+        }
+        return canonical;
+    };
+
+    const size_t size = objects.size();
+    const size_t numThreads =
+            size < kMinParallelConversionSize
+                    ? 1
+                    : std::clamp<size_t>(std::thread::hardware_concurrency(), 1,
+                                         kMaxConversionThreads);
+    if (numThreads == 1) {
+        return convertRange(0, size);
+    }
+
+    const size_t rangeSize = (size + numThreads - 1) / numThreads;
+    std::vector<std::optional<Outputs>> ranges(numThreads);
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (size_t i = 1; i < numThreads; ++i) {
+        threads.emplace_back([&convertRange, &ranges, i, rangeSize, size] {
+            ranges[i] = convertRange(std::min(i * rangeSize, size),
+                                     std::min((i + 1) * rangeSize, size));
+        });
+    }
+    ranges[0] = convertRange(0, rangeSize);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<Output> canonical;
+    canonical.reserve(size);
+    for (auto& range : ranges) {
+        auto converted = NN_TRY(std::move(range).value());
+        canonical.insert(canonical.end(), std::make_move_iterator(converted.begin()),
+                         std::make_move_iterator(converted.end()));
+    }
+    return canonical;
+}
+
+}  // namespace android::hardware::neuralnetworks::utils
+
+#endif  // ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_PARALLEL_CONVERSION_H
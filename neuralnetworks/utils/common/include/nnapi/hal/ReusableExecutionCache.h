@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_REUSABLE_EXECUTION_CACHE_H
+#define ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_REUSABLE_EXECUTION_CACHE_H
+
+#include <android-base/thread_annotations.h>
+#include <android-base/unique_fd.h>
+#include <nnapi/IExecution.h>
+#include <nnapi/Result.h>
+#include <nnapi/Types.h>
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace android::hardware::neuralnetworks::utils {
+
+// Cache of the reusable executions an adapter created for the requests it was sent, so that a
+// request which only differs from a previous one by the contents of its memory pools does not
+// have to be converted, validated and prepared again.
+//
+// A request is identified by its layout, which holds everything about the request and its
+// execution config except file descriptors, and by the file descriptors of its memory pools. Two
+// file descriptors match when they refer to the same open file description, which is what a
+// client sending the same memory with each request ends up with on this side of binder. The
+// cache keeps a duplicate of these file descriptors, so the memory of a cached request stays
+// alive until its entry is evicted.
+//
+// An execution cannot be computed concurrently, so an entry is taken out of the cache while its
+// execution is computed and put back once it succeeded.
+class ReusableExecutionCache final {
+  public:
+    using Factory = std::function<nn::GeneralResult<nn::SharedExecution>()>;
+
+    static constexpr size_t kMaxEntries = 4;
+
+    // Returns false if file descriptors cannot be compared in this process, in which case
+    // requests must be executed without the cache.
+    static bool isSupported();
+
+    // Computes the execution cached for |layout| and |fds|, creating it with |makeExecution| if
+    // there is none.
+    nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>> compute(
+            std::vector<int64_t> layout, const std::vector<int>& fds, const Factory& makeExecution,
+            const nn::OptionalTimePoint& deadline) EXCLUDES(mMutex);
+
+  private:
+    struct Entry {
+        std::vector<int64_t> layout;
+        std::vector<base::unique_fd> fds;
+        nn::SharedExecution execution;
+    };
+
+    std::optional<Entry> take(const std::vector<int64_t>& layout, const std::vector<int>& fds)
+            EXCLUDES(mMutex);
+    void put(Entry entry) EXCLUDES(mMutex);
+
+    std::mutex mMutex;
+    // Most recently used first.
+    std::list<Entry> mEntries GUARDED_BY(mMutex);
+};
+
+}  // namespace android::hardware::neuralnetworks::utils
+
+#endif  // ANDROID_HARDWARE_INTERFACES_NEURALNETWORKS_UTILS_COMMON_REUSABLE_EXECUTION_CACHE_H
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ReusableExecutionCache.h"
+
+#include <android-base/logging.h>
+#include <android-base/thread_annotations.h>
+#include <android-base/unique_fd.h>
+#include <fcntl.h>
+#include <linux/kcmp.h>
+#include <nnapi/IExecution.h>
+#include <nnapi/Result.h>
+#include <nnapi/SharedMemory.h>
+#include <nnapi/Types.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace android::hardware::neuralnetworks::utils {
+namespace {
+
+bool isSameFile(int fd1, int fd2) {
+    const pid_t pid = getpid();
+    return syscall(SYS_kcmp, pid, pid, KCMP_FILE, fd1, fd2) == 0;
+}
+
+bool checkSupport() {
+    const base::unique_fd fd(open("/dev/null", O_RDONLY | O_CLOEXEC));
+    if (!fd.ok() || !isSameFile(fd.get(), fd.get())) {
+        LOG(WARNING) << "kcmp is not available, reusable executions are not cached";
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool ReusableExecutionCache::isSupported() {
+    static const bool kSupported = checkSupport();
+    return kSupported;
+}
+
+nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>>
+ReusableExecutionCache::compute(std::vector<int64_t> layout, const std::vector<int>& fds,
+                                const Factory& makeExecution,
+                                const nn::OptionalTimePoint& deadline) {
+    auto entry = take(layout, fds);
+    if (!entry.has_value()) {
+        std::vector<base::unique_fd> ownedFds;
+        ownedFds.reserve(fds.size());
+        for (int fd : fds) {
+            ownedFds.push_back(NN_TRY(nn::dupFd(fd)));
+        }
+        auto execution = NN_TRY(makeExecution());
+        entry = Entry{.layout = std::move(layout),
+                      .fds = std::move(ownedFds),
+                      .execution = std::move(execution)};
+    }
+
+    auto result = entry->execution->compute(deadline);
+    if (result.has_value()) {
+        put(std::move(entry).value());
+    }
+    return result;
+}
+
+std::optional<ReusableExecutionCache::Entry> ReusableExecutionCache::take(
+        const std::vector<int64_t>& layout, const std::vector<int>& fds) {
+    const auto matches = [&layout, &fds](const Entry& entry) {
+        return entry.layout == layout && entry.fds.size() == fds.size() &&
+               std::equal(fds.begin(), fds.end(), entry.fds.begin(),
+                          [](int fd, const base::unique_fd& ownedFd) {
+                              return isSameFile(fd, ownedFd.get());
+                          });
+    };
+
+    std::lock_guard guard(mMutex);
+    const auto it = std::find_if(mEntries.begin(), mEntries.end(), matches);
+    if (it == mEntries.end()) {
+        return std::nullopt;
+    }
+    Entry entry = std::move(*it);
+    mEntries.erase(it);
+    return entry;
+}
+
+void ReusableExecutionCache::put(Entry entry) {
+    std::list<Entry> evicted;
+    {
+        std::lock_guard guard(mMutex);
+        mEntries.push_front(std::move(entry));
+        if (mEntries.size() > kMaxEntries) {
+            evicted.splice(evicted.begin(), mEntries, std::prev(mEntries.end()));
+        }
+    }
+    // The evicted execution is released outside of the lock, as this may call into the driver.
+}
+
+}  // namespace android::hardware::neuralnetworks::utils
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <nnapi/Result.h>
+#include <nnapi/TypeUtils.h>
+#include <nnapi/hal/ParallelConversion.h>
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace android::hardware::neuralnetworks::utils {
+namespace {
+
+using ::testing::HasSubstr;
+
+constexpr size_t kLargeSize = kMinParallelConversionSize * 3 + 1;
+
+std::vector<int> makeInput(size_t size) {
+    std::vector<int> input(size);
+    std::iota(input.begin(), input.end(), 0);
+    return input;
+}
+
+nn::GeneralResult<std::string> convertToString(int value) {
+    return std::to_string(value);
+}
+
+std::string makeMessage(int value) {
+    return "element " + std::to_string(value) + " failed";
+}
+
+// Fails for the elements in [first, last].
+auto makeFailingConversion(int first, int last) {
+    return [first, last](int value) -> nn::GeneralResult<std::string> {
+        if (value >= first && value <= last) {
+            return NN_ERROR(nn::ErrorStatus::INVALID_ARGUMENT) << makeMessage(value);
+        }
+        return std::to_string(value);
+    };
+}
+
+void verifyOutput(const nn::GeneralResult<std::vector<std::string>>& result, size_t size) {
+    ASSERT_TRUE(result.has_value())
+            << "Failed with " << result.error().code << ": " << result.error().message;
+    const auto& output = result.value();
+    ASSERT_EQ(output.size(), size);
+    for (size_t i = 0; i < size; ++i) {
+        EXPECT_EQ(output[i], std::to_string(i));
+    }
+}
+
+}  // namespace
+
+TEST(ParallelConversionTest, convertEmpty) {
+    // run test
+    const auto result = convertInParallel(std::vector<int>{}, convertToString);
+
+    // verify result
+    verifyOutput(result, 0);
+}
+
+TEST(ParallelConversionTest, convertSmall) {
+    // setup test
+    const auto input = makeInput(kMinParallelConversionSize - 1);
+
+    // run test
+    const auto result = convertInParallel(input, convertToString);
+
+    // verify result
+    verifyOutput(result, input.size());
+}
+
+TEST(ParallelConversionTest, convertLarge) {
+    // setup test
+    const auto input = makeInput(kLargeSize);
+
+    // run test
+    const auto result = convertInParallel(input, convertToString);
+
+    // verify result
+    verifyOutput(result, input.size());
+}
+
+TEST(ParallelConversionTest, convertLargeFailure) {
+    // setup test
+    const auto input = makeInput(kLargeSize);
+
+    // run test
+    const auto result = convertInParallel(input, makeFailingConversion(kLargeSize - 1, kLargeSize));
+
+    // verify result
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, nn::ErrorStatus::INVALID_ARGUMENT);
+    EXPECT_THAT(result.error().message, HasSubstr(makeMessage(kLargeSize - 1)));
+}
+
+TEST(ParallelConversionTest, convertLargeReturnsFirstFailure) {
+    // setup test
+    const auto input = makeInput(kLargeSize);
+    const int first = kMinParallelConversionSize / 2;
+
+    // run test
+    const auto result = convertInParallel(input, makeFailingConversion(first, kLargeSize));
+
+    // verify result
+    ASSERT_FALSE(result.has_value());
+    EXPECT_THAT(result.error().message, HasSubstr(makeMessage(first)));
+}
+
+}  // namespace android::hardware::neuralnetworks::utils
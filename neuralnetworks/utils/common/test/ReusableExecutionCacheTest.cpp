@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <android-base/logging.h>
+#include <android-base/unique_fd.h>
+#include <gmock/gmock.h>
+#include <nnapi/TypeUtils.h>
+#include <nnapi/Types.h>
+#include <nnapi/hal/ReusableExecutionCache.h>
+#include <unistd.h>
+
+#include <utility>
+#include <vector>
+
+#include "MockExecution.h"
+
+namespace android::hardware::neuralnetworks::utils {
+namespace {
+
+using ::testing::_;
+using ::testing::Return;
+
+using MockExecutionFactory = ::testing::MockFunction<nn::GeneralResult<nn::SharedExecution>()>;
+
+constexpr auto makeError = [](nn::ErrorStatus status) {
+    return [status](const auto&... /*args*/) { return nn::error(status); };
+};
+const auto kReturnGeneralFailure = makeError(nn::ErrorStatus::GENERAL_FAILURE);
+
+const auto kNoExecutionError =
+        nn::ExecutionResult<std::pair<std::vector<nn::OutputShape>, nn::Timing>>{};
+
+const std::vector<int64_t> kLayout = {1, 2, 3};
+
+std::pair<base::unique_fd, base::unique_fd> makePipe() {
+    int fds[2];
+    CHECK_EQ(pipe(fds), 0);
+    return {base::unique_fd(fds[0]), base::unique_fd(fds[1])};
+}
+
+std::shared_ptr<const nn::MockExecution> createMockExecution(int numComputations) {
+    auto mockExecution = std::make_shared<const nn::MockExecution>();
+    EXPECT_CALL(*mockExecution, compute(_)).Times(numComputations).WillRepeatedly(
+            Return(kNoExecutionError));
+    return mockExecution;
+}
+
+}  // namespace
+
+TEST(ReusableExecutionCacheTest, reuseExecutionForSameFile) {
+    if (!ReusableExecutionCache::isSupported()) {
+        GTEST_SKIP() << "kcmp is not available";
+    }
+
+    // setup test
+    const auto [fd, otherFd] = makePipe();
+    const base::unique_fd duplicatedFd(dup(fd.get()));
+    auto mockExecution = createMockExecution(/*numComputations=*/2);
+    MockExecutionFactory mockExecutionFactory;
+    EXPECT_CALL(mockExecutionFactory, Call()).Times(1).WillOnce(Return(mockExecution));
+    ReusableExecutionCache cache;
+
+    // run test
+    const auto result =
+            cache.compute(kLayout, {fd.get()}, mockExecutionFactory.AsStdFunction(), {});
+    const auto reusedResult =
+            cache.compute(kLayout, {duplicatedFd.get()}, mockExecutionFactory.AsStdFunction(), {});
+
+    // verify result
+    EXPECT_TRUE(result.has_value()) << "Failed with " << result.error().code << ": "
+                                    << result.error().message;
+    EXPECT_TRUE(reusedResult.has_value()) << "Failed with " << reusedResult.error().code << ": "
+                                          << reusedResult.error().message;
+}
+
+TEST(ReusableExecutionCacheTest, newExecutionForDifferentFile) {
+    if (!ReusableExecutionCache::isSupported()) {
+        GTEST_SKIP() << "kcmp is not available";
+    }
+
+    // setup test
+    const auto [fd, otherFd] = makePipe();
+    MockExecutionFactory mockExecutionFactory;
+    EXPECT_CALL(mockExecutionFactory, Call())
+            .Times(2)
+            .WillOnce(Return(createMockExecution(/*numComputations=*/1)))
+            .WillOnce(Return(createMockExecution(/*numComputations=*/1)));
+    ReusableExecutionCache cache;
+
+    // run test
+    const auto result =
+            cache.compute(kLayout, {fd.get()}, mockExecutionFactory.AsStdFunction(), {});
+    const auto otherResult =
+            cache.compute(kLayout, {otherFd.get()}, mockExecutionFactory.AsStdFunction(), {});
+
+    // verify result
+    EXPECT_TRUE(result.has_value());
+    EXPECT_TRUE(otherResult.has_value());
+}
+
+TEST(ReusableExecutionCacheTest, newExecutionForDifferentLayout) {
+    if (!ReusableExecutionCache::isSupported()) {
+        GTEST_SKIP() << "kcmp is not available";
+    }
+
+    // setup test
+    const auto [fd, otherFd] = makePipe();
+    MockExecutionFactory mockExecutionFactory;
+    EXPECT_CALL(mockExecutionFactory, Call())
+            .Times(2)
+            .WillOnce(Return(createMockExecution(/*numComputations=*/1)))
+            .WillOnce(Return(createMockExecution(/*numComputations=*/1)));
+    ReusableExecutionCache cache;
+
+    // run test
+    const auto result =
+            cache.compute(kLayout, {fd.get()}, mockExecutionFactory.AsStdFunction(), {});
+    const auto otherResult =
+            cache.compute({1, 2, 4}, {fd.get()}, mockExecutionFactory.AsStdFunction(), {});
+
+    // verify result
+    EXPECT_TRUE(result.has_value());
+    EXPECT_TRUE(otherResult.has_value());
+}
+
+TEST(ReusableExecutionCacheTest, failedExecutionIsNotReused) {
+    if (!ReusableExecutionCache::isSupported()) {
+        GTEST_SKIP() << "kcmp is not available";
+    }
+
+    // setup test
+    const auto [fd, otherFd] = makePipe();
+    auto failingMockExecution = std::make_shared<const nn::MockExecution>();
+    EXPECT_CALL(*failingMockExecution, compute(_)).Times(1).WillOnce(kReturnGeneralFailure);
+    MockExecutionFactory mockExecutionFactory;
+    EXPECT_CALL(mockExecutionFactory, Call())
+            .Times(2)
+            .WillOnce(Return(failingMockExecution))
+            .WillOnce(Return(createMockExecution(/*numComputations=*/1)));
+    ReusableExecutionCache cache;
+
+    // run test
+    const auto result =
+            cache.compute(kLayout, {fd.get()}, mockExecutionFactory.AsStdFunction(), {});
+    const auto retriedResult =
+            cache.compute(kLayout, {fd.get()}, mockExecutionFactory.AsStdFunction(), {});
+
+    // verify result
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, nn::ErrorStatus::GENERAL_FAILURE);
+    EXPECT_TRUE(retriedResult.has_value());
+}
+
+TEST(ReusableExecutionCacheTest, evictLeastRecentlyUsedExecution) {
+    if (!ReusableExecutionCache::isSupported()) {
+        GTEST_SKIP() << "kcmp is not available";
+    }
+
+    // setup test
+    const auto [fd, otherFd] = makePipe();
+    MockExecutionFactory mockExecutionFactory;
+    EXPECT_CALL(mockExecutionFactory, Call())
+            .Times(ReusableExecutionCache::kMaxEntries + 2)
+            .WillRepeatedly([] { return createMockExecution(/*numComputations=*/1); });
+    ReusableExecutionCache cache;
+
+    // run test
+    for (size_t i = 0; i <= ReusableExecutionCache::kMaxEntries; ++i) {
+        const std::vector<int64_t> layout = {static_cast<int64_t>(i)};
+        EXPECT_TRUE(
+                cache.compute(layout, {fd.get()}, mockExecutionFactory.AsStdFunction(), {})
+                        .has_value());
+    }
+    const auto result = cache.compute({0}, {fd.get()}, mockExecutionFactory.AsStdFunction(), {});
+
+    // verify result
+    EXPECT_TRUE(result.has_value());
+}
+
+TEST(ReusableExecutionCacheTest, executionFactoryFailure) {
+    // setup test
+    const auto [fd, otherFd] = makePipe();
+    MockExecutionFactory mockExecutionFactory;
+    EXPECT_CALL(mockExecutionFactory, Call()).Times(1).WillOnce(kReturnGeneralFailure);
+    ReusableExecutionCache cache;
+
+    // run test
+    const auto result =
+            cache.compute(kLayout, {fd.get()}, mockExecutionFactory.AsStdFunction(), {});
+
+    // verify result
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, nn::ErrorStatus::GENERAL_FAILURE);
+}
+
+}  // namespace android::hardware::neuralnetworks::utils
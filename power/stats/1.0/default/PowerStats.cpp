@@ -22,8 +22,12 @@
 #include <android-base/properties.h>
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
+#include <ctype.h>
 #include <inttypes.h>
 #include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
 #include <algorithm>
 #include <exception>
 #include <thread>
@@ -42,8 +46,65 @@ namespace implementation {
 constexpr char kIioDirRoot[] = "/sys/bus/iio/devices/";
 constexpr char kDeviceName[] = "pm_device_name";
 constexpr char kDeviceType[] = "iio:device";
-constexpr uint32_t MAX_SAMPLING_RATE = 10;
-constexpr uint64_t WRITE_TIMEOUT_NS = 1000000000;
+constexpr uint32_t MAX_SAMPLING_RATE = 1000;
+constexpr size_t MAX_STREAMS = 4;
+// sysfs attributes are at most one page.
+constexpr size_t MAX_ENERGY_VALUE_SIZE = 4096;
+constexpr uint32_t NO_RAIL = UINT32_MAX;
+// Streams share one thread, thus a full queue must not block it for long.
+// writeBlocking is still used instead of write, as only the former wakes up
+// readers that are waiting for data.
+constexpr uint64_t WRITE_TIMEOUT_NS = 1000;
+
+// Same as strtoull, without the need for a NUL-terminated input.
+static uint64_t parseUint64(const char* begin, const char* end) {
+    while (begin != end && isspace(static_cast<unsigned char>(*begin))) {
+        begin++;
+    }
+    if (begin != end && *begin == '+') {
+        begin++;
+    }
+    uint64_t value = 0;
+    for (; begin != end && *begin >= '0' && *begin <= '9'; begin++) {
+        uint64_t digit = *begin - '0';
+        if (value > (ULLONG_MAX - digit) / 10) {
+            return ULLONG_MAX;
+        }
+        value = value * 10 + digit;
+    }
+    return value;
+}
+
+// Parses the contents of an energy_value node: a line with the timestamp,
+// followed by one "<rail name>,<energy>" line per rail. Calls
+// 'onRail(line, railName, energy)' for each rail. Returns false if the
+// contents are malformed.
+template <typename OnRail>
+static bool parseEnergyValue(const char* data, size_t size, uint64_t* timestamp, OnRail onRail) {
+    const char* pos = data;
+    const char* const end = data + size;
+    bool timestampRead = false;
+    size_t line = 0;
+    while (pos != end) {
+        const char* eol = std::find(pos, end, '\n');
+        const char* comma = std::find(pos, eol, ',');
+        if (!timestampRead) {
+            if (comma == eol) {
+                *timestamp = parseUint64(pos, eol);
+                if (*timestamp == 0 || *timestamp == ULLONG_MAX) {
+                    ALOGW("Potentially wrong timestamp: %" PRIu64, *timestamp);
+                }
+                timestampRead = true;
+            }
+        } else if (comma != eol && std::find(comma + 1, eol, ',') == eol) {
+            onRail(line++, std::string_view(pos, comma - pos), parseUint64(comma + 1, eol));
+        } else {
+            return false;
+        }
+        pos = eol == end ? end : eol + 1;
+    }
+    return true;
+}
 
 void PowerStats::findIioPowerMonitorNodes() {
     struct dirent* ent;
@@ -73,7 +134,7 @@ void PowerStats::findIioPowerMonitorNodes() {
 
             if (strncmp(devName, kDeviceName, strlen(kDeviceName)) == 0) {
                 snprintf(filePath, MAX_FILE_PATH_LEN, "%s/%s", kIioDirRoot, ent->d_name);
-                mPm.devicePaths.push_back(filePath);
+                mPm.devices.push_back({.path = filePath});
             }
             close(fd);
         }
@@ -88,7 +149,8 @@ size_t PowerStats::parsePowerRails() {
     std::string spsFileName;
     uint32_t index = 0;
     unsigned long samplingRate;
-    for (const auto& path : mPm.devicePaths) {
+    for (const auto& device : mPm.devices) {
+        const std::string& path = device.path;
         railFileName = path + "/enabled_rails";
         spsFileName = path + "/sampling_rate";
         if (!android::base::ReadFileToString(spsFileName, &data)) {
@@ -123,57 +185,84 @@ size_t PowerStats::parsePowerRails() {
     return index;
 }
 
-int PowerStats::parseIioEnergyNode(std::string devName) {
-    int ret = 0;
-    std::string data;
-    std::string fileName = devName + "/energy_value";
-    if (!android::base::ReadFileToString(fileName, &data)) {
-        ALOGE("Error reading file: %s", fileName.c_str());
-        return -1;
+void PowerStats::openIioEnergyNodes() {
+    std::vector<char> buffer(MAX_ENERGY_VALUE_SIZE);
+    for (auto& device : mPm.devices) {
+        std::string fileName = device.path + "/energy_value";
+        device.energyFd.reset(TEMP_FAILURE_RETRY(open(fileName.c_str(), O_RDONLY | O_CLOEXEC)));
+        if (device.energyFd < 0) {
+            ALOGE("Error opening file: %s", fileName.c_str());
+            continue;
+        }
+        ssize_t size = TEMP_FAILURE_RETRY(pread(device.energyFd, buffer.data(), buffer.size(), 0));
+        uint64_t timestamp;
+        if (size < 0 ||
+            !parseEnergyValue(buffer.data(), size, &timestamp,
+                              [&](size_t, std::string_view railName, uint64_t) {
+                                  auto rail = mPm.railsInfo.find(railName);
+                                  device.railOrder.emplace_back(
+                                          railName, rail != mPm.railsInfo.end() ? rail->second.index
+                                                                                : NO_RAIL);
+                              })) {
+            ALOGW("Error reading rail order from file: %s", fileName.c_str());
+            device.railOrder.clear();
+        }
+    }
+}
+
+int PowerStats::readIioEnergyNode(const IioDevice& device, EnergyReading* reading) const {
+    std::vector<char>& buffer = reading->buffer;
+    size_t size = 0;
+    while (size < buffer.size()) {
+        ssize_t ret = TEMP_FAILURE_RETRY(
+                pread(device.energyFd, buffer.data() + size, buffer.size() - size, size));
+        if (ret < 0) {
+            ALOGE("Error reading file: %s/energy_value", device.path.c_str());
+            return -1;
+        }
+        if (ret == 0) {
+            break;
+        }
+        size += ret;
     }
 
-    std::istringstream energyData(data);
-    std::string line;
     uint64_t timestamp = 0;
-    bool timestampRead = false;
-    while (std::getline(energyData, line)) {
-        std::vector<std::string> words = android::base::Split(line, ",");
-        if (timestampRead == false) {
-            if (words.size() == 1) {
-                timestamp = strtoull(words[0].c_str(), NULL, 10);
-                if (timestamp == 0 || timestamp == ULLONG_MAX) {
-                    ALOGW("Potentially wrong timestamp: %" PRIu64, timestamp);
+    bool parsed = parseEnergyValue(
+            buffer.data(), size, &timestamp,
+            [&](size_t line, std::string_view railName, uint64_t energy) {
+                uint32_t index;
+                if (line < device.railOrder.size() && device.railOrder[line].first == railName) {
+                    index = device.railOrder[line].second;
+                } else {
+                    auto rail = mPm.railsInfo.find(railName);
+                    index = rail != mPm.railsInfo.end() ? rail->second.index : NO_RAIL;
                 }
-                timestampRead = true;
-            }
-        } else if (words.size() == 2) {
-            std::string railName = words[0];
-            if (mPm.railsInfo.count(railName) != 0) {
-                size_t index = mPm.railsInfo[railName].index;
-                mPm.reading[index].index = index;
-                mPm.reading[index].timestamp = timestamp;
-                mPm.reading[index].energy = strtoull(words[1].c_str(), NULL, 10);
-                if (mPm.reading[index].energy == ULLONG_MAX) {
-                    ALOGW("Potentially wrong energy value: %" PRIu64, mPm.reading[index].energy);
+                if (index == NO_RAIL) {
+                    return;
                 }
-            }
-        } else {
-            ALOGW("Unexpected format in file: %s", fileName.c_str());
-            ret = -1;
-            break;
-        }
+                EnergyData& data = reading->data[index];
+                data.index = index;
+                data.timestamp = timestamp;
+                data.energy = energy;
+                if (energy == ULLONG_MAX) {
+                    ALOGW("Potentially wrong energy value: %" PRIu64, energy);
+                }
+            });
+    if (!parsed) {
+        ALOGW("Unexpected format in file: %s/energy_value", device.path.c_str());
+        return -1;
     }
-    return ret;
+    return 0;
 }
 
-Status PowerStats::parseIioEnergyNodes() {
+Status PowerStats::readIioEnergyNodes(EnergyReading* reading) const {
     Status ret = Status::SUCCESS;
     if (mPm.hwEnabled == false) {
         return Status::NOT_SUPPORTED;
     }
 
-    for (const auto& devicePath : mPm.devicePaths) {
-        if (parseIioEnergyNode(devicePath) < 0) {
+    for (const auto& device : mPm.devices) {
+        if (readIioEnergyNode(device, reading) < 0) {
             ALOGE("Error in parsing power stats");
             ret = Status::FILESYSTEM_ERROR;
             break;
@@ -182,14 +271,32 @@ Status PowerStats::parseIioEnergyNodes() {
     return ret;
 }
 
+void PowerStats::initEnergyReading(EnergyReading* reading) const {
+    reading->buffer.resize(MAX_ENERGY_VALUE_SIZE);
+    reading->data.resize(mPm.railsInfo.size());
+}
+
 PowerStats::PowerStats() {
     findIioPowerMonitorNodes();
     size_t numRails = parsePowerRails();
-    if (mPm.devicePaths.empty() || numRails == 0) {
+    if (mPm.devices.empty() || numRails == 0) {
         mPm.hwEnabled = false;
     } else {
         mPm.hwEnabled = true;
-        mPm.reading.resize(numRails);
+        openIioEnergyNodes();
+        initEnergyReading(&mPm.reading);
+    }
+}
+
+PowerStats::~PowerStats() {
+    if (mPm.streamThread.joinable()) {
+        uint64_t stop = 1;
+        if (TEMP_FAILURE_RETRY(write(mPm.streamStopFd, &stop, sizeof(stop))) < 0) {
+            ALOGE("Failed to stop the energy stream thread");
+            mPm.streamThread.detach();
+            return;
+        }
+        mPm.streamThread.join();
     }
 }
 
@@ -218,7 +325,8 @@ Return<void> PowerStats::getEnergyData(const hidl_vec<uint32_t>& railIndices,
                                        getEnergyData_cb _hidl_cb) {
     hidl_vec<EnergyData> eVal;
     std::lock_guard<std::mutex> _lock(mPm.mLock);
-    Status ret = parseIioEnergyNodes();
+    Status ret = readIioEnergyNodes(&mPm.reading);
+    const std::vector<EnergyData>& reading = mPm.reading.data;
 
     if (ret != Status::SUCCESS) {
         ALOGE("Failed to getEnergyData");
@@ -228,17 +336,17 @@ Return<void> PowerStats::getEnergyData(const hidl_vec<uint32_t>& railIndices,
 
     if (railIndices.size() == 0) {
         eVal.resize(mPm.railsInfo.size());
-        memcpy(&eVal[0], &mPm.reading[0], mPm.reading.size() * sizeof(EnergyData));
+        memcpy(&eVal[0], &reading[0], reading.size() * sizeof(EnergyData));
     } else {
         eVal.resize(railIndices.size());
         int i = 0;
         for (const auto& railIndex : railIndices) {
-            if (railIndex >= mPm.reading.size()) {
+            if (railIndex >= reading.size()) {
                 ret = Status::INVALID_INPUT;
                 eVal.resize(0);
                 break;
             }
-            memcpy(&eVal[i], &mPm.reading[railIndex], sizeof(EnergyData));
+            memcpy(&eVal[i], &reading[railIndex], sizeof(EnergyData));
             i++;
         }
     }
@@ -246,47 +354,114 @@ Return<void> PowerStats::getEnergyData(const hidl_vec<uint32_t>& railIndices,
     return Void();
 }
 
+bool PowerStats::startEnergyStreamThread() {
+    if (mPm.streamThread.joinable()) {
+        return true;
+    }
+    mPm.streamEpollFd.reset(epoll_create1(EPOLL_CLOEXEC));
+    mPm.streamStopFd.reset(eventfd(0, EFD_CLOEXEC));
+    if (mPm.streamEpollFd < 0 || mPm.streamStopFd < 0) {
+        ALOGE("Failed to create energy stream fds: %s", strerror(errno));
+        return false;
+    }
+    // Events with a null pointer come from the stop fd, the others from a stream timer.
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_ctl(mPm.streamEpollFd, EPOLL_CTL_ADD, mPm.streamStopFd, &event) < 0) {
+        ALOGE("Failed to watch the energy stream stop fd: %s", strerror(errno));
+        return false;
+    }
+    mPm.streamThread = std::thread(&PowerStats::energyStreamLoop, this);
+    return true;
+}
+
+bool PowerStats::sampleEnergyStream(EnergyStream* stream) {
+    if (stream->samplesLeft == 0 || readIioEnergyNodes(&stream->reading) != Status::SUCCESS) {
+        return false;
+    }
+    const std::vector<EnergyData>& reading = stream->reading.data;
+    if (!stream->fmq->writeBlocking(reading.data(), reading.size(), WRITE_TIMEOUT_NS)) {
+        ALOGW("Energy stream queue is full, dropping a sample");
+    }
+    return --stream->samplesLeft > 0;
+}
+
+void PowerStats::energyStreamLoop() {
+    epoll_event events[MAX_STREAMS + 1];
+    while (true) {
+        int count = TEMP_FAILURE_RETRY(
+                epoll_wait(mPm.streamEpollFd, events, std::size(events), -1 /*timeout*/));
+        if (count < 0) {
+            ALOGE("Failed to wait for energy stream timers: %s", strerror(errno));
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            auto stream = static_cast<EnergyStream*>(events[i].data.ptr);
+            if (stream == nullptr) {
+                return;
+            }
+            // If the loop fell behind, the missed periods are not made up for.
+            uint64_t expirations;
+            if (read(stream->timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)) {
+                continue;
+            }
+            if (!sampleEnergyStream(stream)) {
+                epoll_ctl(mPm.streamEpollFd, EPOLL_CTL_DEL, stream->timerFd, nullptr);
+                std::lock_guard<std::mutex> _lock(mPm.streamsLock);
+                mPm.streams.remove_if([stream](const EnergyStream& s) { return &s == stream; });
+            }
+        }
+    }
+}
+
 Return<void> PowerStats::streamEnergyData(uint32_t timeMs, uint32_t samplingRate,
                                           streamEnergyData_cb _hidl_cb) {
-    std::lock_guard<std::mutex> _lock(mPm.mLock);
-    if (mPm.fmqSynchronized != nullptr) {
-        _hidl_cb(MessageQueueSync::Descriptor(), 0, 0, Status::INSUFFICIENT_RESOURCES);
+    if (mPm.hwEnabled == false) {
+        _hidl_cb(MessageQueueSync::Descriptor(), 0, 0, Status::NOT_SUPPORTED);
         return Void();
     }
     uint32_t sps = std::min(samplingRate, MAX_SAMPLING_RATE);
-    uint32_t numSamples = timeMs * sps / 1000;
-    mPm.fmqSynchronized.reset(new (std::nothrow) MessageQueueSync(MAX_QUEUE_SIZE, true));
-    if (mPm.fmqSynchronized == nullptr || mPm.fmqSynchronized->isValid() == false) {
-        mPm.fmqSynchronized = nullptr;
+    if (sps == 0) {
+        _hidl_cb(MessageQueueSync::Descriptor(), 0, 0, Status::INVALID_INPUT);
+        return Void();
+    }
+    uint32_t numSamples = static_cast<uint64_t>(timeMs) * sps / 1000;
+
+    std::lock_guard<std::mutex> _lock(mPm.streamsLock);
+    if (mPm.streams.size() >= MAX_STREAMS || !startEnergyStreamThread()) {
         _hidl_cb(MessageQueueSync::Descriptor(), 0, 0, Status::INSUFFICIENT_RESOURCES);
         return Void();
     }
-    std::thread pollThread = std::thread([this, sps, numSamples]() {
-        uint64_t sleepTimeUs = 1000000 / sps;
-        uint32_t currSamples = 0;
-        while (currSamples < numSamples) {
-            mPm.mLock.lock();
-            if (parseIioEnergyNodes() == Status::SUCCESS) {
-                mPm.fmqSynchronized->writeBlocking(&mPm.reading[0], mPm.reading.size(),
-                                                   WRITE_TIMEOUT_NS);
-                mPm.mLock.unlock();
-                currSamples++;
-                if (usleep(sleepTimeUs) < 0) {
-                    ALOGW("Sleep interrupted");
-                    break;
-                }
-            } else {
-                mPm.mLock.unlock();
-                break;
-            }
-        }
-        mPm.mLock.lock();
-        mPm.fmqSynchronized = nullptr;
-        mPm.mLock.unlock();
-        return;
-    });
-    pollThread.detach();
-    _hidl_cb(*(mPm.fmqSynchronized)->getDesc(), numSamples, mPm.reading.size(), Status::SUCCESS);
+    EnergyStream& stream = mPm.streams.emplace_back();
+    stream.samplesLeft = numSamples;
+    initEnergyReading(&stream.reading);
+    stream.fmq.reset(new (std::nothrow) MessageQueueSync(MAX_QUEUE_SIZE, true));
+    stream.timerFd.reset(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC));
+    // The first sample is taken right away.
+    const uint64_t periodNs = 1000000000 / sps;
+    const itimerspec period = {
+            .it_interval = {.tv_sec = static_cast<time_t>(periodNs / 1000000000),
+                            .tv_nsec = static_cast<long>(periodNs % 1000000000)},
+            .it_value = {.tv_sec = 0, .tv_nsec = 1},
+    };
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.ptr = &stream;
+    if (stream.fmq == nullptr || stream.fmq->isValid() == false || stream.timerFd < 0 ||
+        epoll_ctl(mPm.streamEpollFd, EPOLL_CTL_ADD, stream.timerFd, &event) < 0) {
+        mPm.streams.pop_back();
+        _hidl_cb(MessageQueueSync::Descriptor(), 0, 0, Status::INSUFFICIENT_RESOURCES);
+        return Void();
+    }
+    if (timerfd_settime(stream.timerFd, 0, &period, nullptr) < 0) {
+        epoll_ctl(mPm.streamEpollFd, EPOLL_CTL_DEL, stream.timerFd, nullptr);
+        mPm.streams.pop_back();
+        _hidl_cb(MessageQueueSync::Descriptor(), 0, 0, Status::INSUFFICIENT_RESOURCES);
+        return Void();
+    }
+    // The stream thread removes the stream only with 'streamsLock' held.
+    _hidl_cb(*stream.fmq->getDesc(), numSamples, stream.reading.data.size(), Status::SUCCESS);
     return Void();
 }
 
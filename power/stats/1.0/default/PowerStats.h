@@ -17,10 +17,14 @@
 #ifndef ANDROID_HARDWARE_POWERSTATS_V1_0_POWERSTATS_H
 #define ANDROID_HARDWARE_POWERSTATS_V1_0_POWERSTATS_H
 
+#include <android-base/unique_fd.h>
 #include <android/hardware/power/stats/1.0/IPowerStats.h>
 #include <fmq/MessageQueue.h>
 #include <hidl/MQDescriptor.h>
 #include <hidl/Status.h>
+#include <list>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 
 namespace android {
@@ -52,13 +56,42 @@ struct RailData {
     uint32_t samplingRate;
 };
 
+// An IIO power monitor. Its energy_value node is kept open, so that sampling
+// does not need to look the file up again.
+struct IioDevice {
+    std::string path;
+    android::base::unique_fd energyFd;
+    // Rail index for each line of energy_value as listed at startup, used to
+    // avoid name lookups as long as the order of the rails does not change.
+    std::vector<std::pair<std::string, uint32_t>> railOrder;
+};
+
+// Buffers for reading all energy nodes. Each reader has its own, thus readers
+// do not need to be serialized.
+struct EnergyReading {
+    std::vector<char> buffer;
+    std::vector<EnergyData> data;
+};
+
+struct EnergyStream {
+    android::base::unique_fd timerFd;
+    std::unique_ptr<MessageQueueSync> fmq;
+    uint32_t samplesLeft;
+    EnergyReading reading;
+};
+
 struct OnDeviceMmt {
     std::mutex mLock;
     bool hwEnabled;
-    std::vector<std::string> devicePaths;
-    std::map<std::string, RailData> railsInfo;
-    std::vector<EnergyData> reading;
-    std::unique_ptr<MessageQueueSync> fmqSynchronized;
+    // Devices and rails are only modified by the constructor.
+    std::vector<IioDevice> devices;
+    std::map<std::string, RailData, std::less<>> railsInfo;
+    EnergyReading reading;  // GUARDED_BY(mLock)
+    std::mutex streamsLock;
+    std::list<EnergyStream> streams;  // GUARDED_BY(streamsLock)
+    android::base::unique_fd streamEpollFd;
+    android::base::unique_fd streamStopFd;
+    std::thread streamThread;
 };
 
 class IStateResidencyDataProvider {
@@ -72,6 +105,7 @@ class IStateResidencyDataProvider {
 struct PowerStats : public IPowerStats {
    public:
     PowerStats();
+    ~PowerStats();
     uint32_t addPowerEntity(const std::string& name, PowerEntityType type);
     void addStateResidencyDataProvider(std::shared_ptr<IStateResidencyDataProvider> p);
     // Methods from ::android::hardware::power::stats::V1_0::IPowerStats follow.
@@ -94,8 +128,13 @@ struct PowerStats : public IPowerStats {
     OnDeviceMmt mPm;
     void findIioPowerMonitorNodes();
     size_t parsePowerRails();
-    int parseIioEnergyNode(std::string devName);
-    Status parseIioEnergyNodes();
+    void openIioEnergyNodes();
+    int readIioEnergyNode(const IioDevice& device, EnergyReading* reading) const;
+    Status readIioEnergyNodes(EnergyReading* reading) const;
+    void initEnergyReading(EnergyReading* reading) const;
+    bool startEnergyStreamThread();
+    void energyStreamLoop();
+    bool sampleEnergyStream(EnergyStream* stream);
     std::vector<PowerEntityInfo> mPowerEntityInfos;
     std::unordered_map<uint32_t, PowerEntityStateSpace> mPowerEntityStateSpaces;
     std::unordered_map<uint32_t, std::shared_ptr<IStateResidencyDataProvider>>
@@ -16,8 +16,11 @@
 
 #include "PowerStats.h"
 
+#include <android-base/file.h>
 #include <android-base/logging.h>
+#include <android-base/strings.h>
 
+#include <memory>
 #include <numeric>
 
 namespace aidl {
@@ -37,6 +40,13 @@ void PowerStats::addStateResidencyDataProvider(std::unique_ptr<IStateResidencyDa
     size_t index = mStateResidencyDataProviders.size();
     mStateResidencyDataProviders.emplace_back(std::move(p));
 
+    std::vector<std::string> entityNames;
+    for (const auto& [entityName, states] : info) {
+        entityNames.push_back(entityName);
+    }
+    mStateResidencyQueries.emplace_back(std::make_unique<ProviderQuery<StateResidencies>>(
+            "StateResidencyDataProvider[" + ::android::base::Join(entityNames, ",") + "]"));
+
     for (const auto& [entityName, states] : info) {
         PowerEntity i = {
                 .id = id++,
@@ -61,10 +71,21 @@ void PowerStats::addEnergyConsumer(std::unique_ptr<IEnergyConsumer> p) {
     mEnergyConsumerInfos.emplace_back(
             EnergyConsumer{.id = id, .ordinal = count, .type = type, .name = name});
     mEnergyConsumers.emplace_back(std::move(p));
+    mEnergyConsumerQueries.emplace_back(
+            std::make_unique<ProviderQuery<std::optional<EnergyConsumerResult>>>(
+                    "EnergyConsumer[" + name + "]"));
 }
 
 void PowerStats::setEnergyMeter(std::unique_ptr<IEnergyMeter> p) {
     mEnergyMeter = std::move(p);
+    mEnergyMeterQuery =
+            mEnergyMeter ? std::make_unique<ProviderQuery<std::vector<EnergyMeasurement>>>(
+                                   "EnergyMeter")
+                         : nullptr;
+}
+
+void PowerStats::setCacheTtl(std::chrono::milliseconds ttl) {
+    mCacheTtl = ttl;
 }
 
 ndk::ScopedAStatus PowerStats::getPowerEntityInfo(std::vector<PowerEntity>* _aidl_return) {
@@ -85,24 +106,50 @@ ndk::ScopedAStatus PowerStats::getStateResidency(const std::vector<int32_t>& in_
         return getStateResidency(v, _aidl_return);
     }
 
-    std::unordered_map<std::string, std::vector<StateResidency>> stateResidencies;
-
+    // Query each of the needed providers once, concurrently. The results are shared with
+    // the queries, as those that time out keep running.
+    auto stateResidencies =
+            std::make_shared<std::vector<StateResidencies>>(mStateResidencyDataProviders.size());
+    std::vector<bool> queried(mStateResidencyDataProviders.size(), false);
+    std::vector<size_t> queriedIndexes;  // Parallel to queries
+    std::vector<std::function<void()>> queries;
     for (const int32_t id : in_powerEntityIds) {
         // check for invalid ids
         if (id < 0 || id >= mPowerEntityInfos.size()) {
             return ndk::ScopedAStatus(AStatus_fromExceptionCode(EX_ILLEGAL_ARGUMENT));
         }
 
-        // Check to see if we already have data for the given id
-        std::string powerEntityName = mPowerEntityInfos[id].name;
-        if (stateResidencies.find(powerEntityName) == stateResidencies.end()) {
-            mStateResidencyDataProviders.at(mStateResidencyDataProviderIndex.at(id))
-                    ->getStateResidencies(&stateResidencies);
+        size_t index = mStateResidencyDataProviderIndex.at(id);
+        if (queried[index]) {
+            continue;
         }
+        queried[index] = true;
+        queriedIndexes.push_back(index);
+        queries.emplace_back([this, index, stateResidencies] {
+            (*stateResidencies)[index] = mStateResidencyQueries[index]->get(
+                    mCacheTtl, [this, index](StateResidencies* residencies) {
+                        return mStateResidencyDataProviders[index]->getStateResidencies(
+                                residencies);
+                    });
+        });
+    }
+    std::vector<bool> completed = mExecutor.runAll(std::move(queries), kQueryTimeout);
 
+    std::vector<bool> available(mStateResidencyDataProviders.size(), false);
+    for (size_t i = 0; i < queriedIndexes.size(); i++) {
+        available[queriedIndexes[i]] = completed[i];
+    }
+    for (const int32_t id : in_powerEntityIds) {
         // Append results if we have them
-        auto stateResidency = stateResidencies.find(powerEntityName);
-        if (stateResidency != stateResidencies.end()) {
+        const std::string& powerEntityName = mPowerEntityInfos[id].name;
+        size_t index = mStateResidencyDataProviderIndex[id];
+        if (!available[index]) {
+            LOG(ERROR) << "Timed out getting results for " << powerEntityName;
+            continue;
+        }
+        const StateResidencies& residencies = (*stateResidencies)[index];
+        auto stateResidency = residencies.find(powerEntityName);
+        if (stateResidency != residencies.end()) {
             StateResidencyResult res = {
                     .id = id,
                     .stateResidencyData = stateResidency->second,
@@ -140,10 +187,30 @@ ndk::ScopedAStatus PowerStats::getEnergyConsumed(const std::vector<int32_t>& in_
         if (id < 0 || id >= mEnergyConsumers.size()) {
             return ndk::ScopedAStatus(AStatus_fromExceptionCode(EX_ILLEGAL_ARGUMENT));
         }
+    }
+
+    // The results are shared with the queries, as those that time out keep running.
+    auto results = std::make_shared<std::vector<std::optional<EnergyConsumerResult>>>(
+            in_energyConsumerIds.size());
+    std::vector<std::function<void()>> queries;
+    queries.reserve(in_energyConsumerIds.size());
+    for (size_t i = 0; i < in_energyConsumerIds.size(); i++) {
+        queries.emplace_back([this, id = in_energyConsumerIds[i], i, results] {
+            (*results)[i] = mEnergyConsumerQueries[id]->get(
+                    mCacheTtl, [this, id](std::optional<EnergyConsumerResult>* r) {
+                        *r = mEnergyConsumers[id]->getEnergyConsumed();
+                        return r->has_value();
+                    });
+        });
+    }
+    std::vector<bool> completed = mExecutor.runAll(std::move(queries), kQueryTimeout);
 
-        auto optionalResult = mEnergyConsumers[id]->getEnergyConsumed();
-        if (optionalResult) {
-            EnergyConsumerResult result = optionalResult.value();
+    for (size_t i = 0; i < in_energyConsumerIds.size(); i++) {
+        const auto id = in_energyConsumerIds[i];
+        if (!completed[i]) {
+            LOG(ERROR) << "Timed out getting results for " << mEnergyConsumerInfos[id].name;
+        } else if ((*results)[i]) {
+            EnergyConsumerResult result = (*results)[i].value();
             result.id = id;
             _aidl_return->emplace_back(result);
         } else {
@@ -169,7 +236,34 @@ ndk::ScopedAStatus PowerStats::readEnergyMeter(const std::vector<int32_t>& in_ch
         return ndk::ScopedAStatus::ok();
     }
 
-    return mEnergyMeter->readEnergyMeter(in_channelIds, _aidl_return);
+    // Not cached, as results depend on the requested channels.
+    ndk::ScopedAStatus status;
+    *_aidl_return = mEnergyMeterQuery->get(
+            ProviderQuery<std::vector<EnergyMeasurement>>::Clock::duration::zero(),
+            [&](std::vector<EnergyMeasurement>* measurements) {
+                status = mEnergyMeter->readEnergyMeter(in_channelIds, measurements);
+                return status.isOk();
+            });
+    return status;
+}
+
+binder_status_t PowerStats::dump(int fd, const char**, uint32_t) {
+    std::string dump = "PowerStats provider queries (cache TTL " +
+                       std::to_string(mCacheTtl.count()) + " ms):\n";
+    for (const auto& query : mStateResidencyQueries) {
+        dump += "  " + query->dump() + "\n";
+    }
+    for (const auto& query : mEnergyConsumerQueries) {
+        dump += "  " + query->dump() + "\n";
+    }
+    if (mEnergyMeterQuery) {
+        dump += "  " + mEnergyMeterQuery->dump() + "\n";
+    }
+    if (!::android::base::WriteStringToFd(dump, fd)) {
+        PLOG(ERROR) << "Failed to dump provider queries";
+        return STATUS_UNKNOWN_ERROR;
+    }
+    return STATUS_OK;
 }
 
 }  // namespace stats
@@ -18,6 +18,9 @@
 
 #include <aidl/android/hardware/power/stats/BnPowerStats.h>
 
+#include "ProviderExecutor.h"
+
+#include <chrono>
 #include <unordered_map>
 
 namespace aidl {
@@ -58,6 +61,10 @@ class PowerStats : public BnPowerStats {
     void addStateResidencyDataProvider(std::unique_ptr<IStateResidencyDataProvider> p);
     void addEnergyConsumer(std::unique_ptr<IEnergyConsumer> p);
     void setEnergyMeter(std::unique_ptr<IEnergyMeter> p);
+    // Results of state residency data providers and energy consumers are reused for
+    // this long. Zero, the default, disables caching. Must be set before the service
+    // is registered.
+    void setCacheTtl(std::chrono::milliseconds ttl);
 
     // Methods from aidl::android::hardware::power::stats::IPowerStats
     ndk::ScopedAStatus getPowerEntityInfo(std::vector<PowerEntity>* _aidl_return) override;
@@ -70,16 +77,36 @@ class PowerStats : public BnPowerStats {
     ndk::ScopedAStatus readEnergyMeter(const std::vector<int32_t>& in_channelIds,
                                        std::vector<EnergyMeasurement>* _aidl_return) override;
 
+    binder_status_t dump(int fd, const char** args, uint32_t numArgs) override;
+
   private:
+    using StateResidencies = std::unordered_map<std::string, std::vector<StateResidency>>;
+
+    // Providers are queried on these, and the results of those that take longer than
+    // kQueryTimeout are left out.
+    static constexpr size_t kNumWorkerThreads = 3;
+    static constexpr std::chrono::milliseconds kQueryTimeout{1000};
+    std::chrono::milliseconds mCacheTtl{0};
+
     std::vector<std::unique_ptr<IStateResidencyDataProvider>> mStateResidencyDataProviders;
     std::vector<PowerEntity> mPowerEntityInfos;
     /* Index that maps each power entity id to an entry in mStateResidencyDataProviders */
     std::vector<size_t> mStateResidencyDataProviderIndex;
+    /* Parallel to mStateResidencyDataProviders */
+    std::vector<std::unique_ptr<ProviderQuery<StateResidencies>>> mStateResidencyQueries;
 
     std::vector<std::unique_ptr<IEnergyConsumer>> mEnergyConsumers;
     std::vector<EnergyConsumer> mEnergyConsumerInfos;
+    /* Parallel to mEnergyConsumers */
+    std::vector<std::unique_ptr<ProviderQuery<std::optional<EnergyConsumerResult>>>>
+            mEnergyConsumerQueries;
 
     std::unique_ptr<IEnergyMeter> mEnergyMeter;
+    std::unique_ptr<ProviderQuery<std::vector<EnergyMeasurement>>> mEnergyMeterQuery;
+
+    // Declared last so that it is destroyed first, as queries still running refer to
+    // the providers.
+    ProviderExecutor mExecutor{kNumWorkerThreads};
 };
 
 }  // namespace stats
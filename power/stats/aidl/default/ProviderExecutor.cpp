@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProviderExecutor.h"
+
+#include <memory>
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace power {
+namespace stats {
+
+ProviderExecutor::ProviderExecutor(size_t numThreads) {
+    mThreads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; i++) {
+        mThreads.emplace_back(&ProviderExecutor::threadLoop, this);
+    }
+}
+
+ProviderExecutor::~ProviderExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mTaskAvailable.notify_all();
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+}
+
+std::vector<bool> ProviderExecutor::runAll(std::vector<std::function<void()>>&& tasks,
+                                           Clock::duration timeout) {
+    if (mThreads.empty()) {
+        for (auto& task : tasks) {
+            task();
+        }
+        return std::vector<bool>(tasks.size(), true);
+    }
+
+    // Shared with the tasks, as they may outlive this call.
+    struct Batch {
+        std::mutex lock;
+        std::condition_variable done;
+        std::vector<bool> completed;  // GUARDED_BY(lock)
+        size_t pending;               // GUARDED_BY(lock)
+        bool abandoned = false;       // GUARDED_BY(lock)
+    };
+    auto batch = std::make_shared<Batch>();
+    batch->completed.resize(tasks.size(), false);
+    batch->pending = tasks.size();
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        for (size_t i = 0; i < tasks.size(); i++) {
+            mTasks.emplace_back([batch, i, task = std::move(tasks[i])] {
+                {
+                    std::lock_guard<std::mutex> lock(batch->lock);
+                    if (batch->abandoned) {
+                        return;
+                    }
+                }
+                task();
+                std::lock_guard<std::mutex> lock(batch->lock);
+                batch->completed[i] = true;
+                if (--batch->pending == 0) {
+                    batch->done.notify_one();
+                }
+            });
+        }
+    }
+    mTaskAvailable.notify_all();
+
+    // Tasks are only run on the workers, as a task run here could not time out.
+    std::unique_lock<std::mutex> lock(batch->lock);
+    batch->done.wait_for(lock, timeout, [&] { return batch->pending == 0; });
+    batch->abandoned = true;
+    return batch->completed;
+}
+
+void ProviderExecutor::threadLoop() {
+    std::unique_lock<std::mutex> lock(mLock);
+    while (true) {
+        mTaskAvailable.wait(lock, [this] { return mStop || !mTasks.empty(); });
+        if (mStop) {
+            return;
+        }
+        std::function<void()> task = std::move(mTasks.front());
+        mTasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+}  // namespace stats
+}  // namespace power
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
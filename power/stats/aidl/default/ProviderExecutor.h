@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace power {
+namespace stats {
+
+// Runs the queries of independent data providers concurrently on a fixed set of
+// worker threads.
+class ProviderExecutor {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ProviderExecutor(size_t numThreads);
+    ~ProviderExecutor();
+
+    // Runs all 'tasks' and returns once they have completed, or once 'timeout'
+    // has passed. Returns whether each task completed in time. A task that did
+    // not keeps running, and one that has not started by then is skipped, so
+    // tasks must share ownership of what they write to. Without worker threads
+    // the tasks are run on the calling thread and cannot time out.
+    std::vector<bool> runAll(std::vector<std::function<void()>>&& tasks, Clock::duration timeout);
+
+  private:
+    void threadLoop();
+
+    std::mutex mLock;
+    std::condition_variable mTaskAvailable;
+    std::deque<std::function<void()>> mTasks;  // GUARDED_BY(mLock)
+    bool mStop = false;                         // GUARDED_BY(mLock)
+    std::vector<std::thread> mThreads;
+};
+
+// Calls to a data provider, serialized since providers are not required to be
+// thread-safe. Keeps the last successful result to serve callers that poll more
+// often than 'ttl', and records how long the provider takes to respond.
+template <typename Result>
+class ProviderQuery {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ProviderQuery(std::string name) : mName(std::move(name)) {}
+
+    // 'query' returns whether it succeeded, only successful results are cached.
+    // A zero 'ttl' disables caching.
+    template <typename Query>
+    Result get(Clock::duration ttl, Query query) {
+        std::lock_guard<std::mutex> lock(mLock);
+        Clock::time_point start = Clock::now();
+        if (mCachedAt && start - *mCachedAt < ttl) {
+            mCacheHits++;
+            return mResult;
+        }
+        Result result;
+        bool success = query(&result);
+        Clock::duration latency = Clock::now() - start;
+        mCalls++;
+        mTotalLatency += latency;
+        mMaxLatency = std::max(mMaxLatency, latency);
+        if (!success) {
+            mFailures++;
+            mCachedAt.reset();
+        } else if (ttl > Clock::duration::zero()) {
+            mResult = result;
+            mCachedAt = start;
+        }
+        return result;
+    }
+
+    // Prints the name of the provider, call counts and latencies on one line.
+    std::string dump() {
+        std::lock_guard<std::mutex> lock(mLock);
+        int64_t averageUs = mCalls == 0 ? 0 : toMicros(mTotalLatency) / mCalls;
+        return mName + ": calls=" + std::to_string(mCalls) +
+               " failures=" + std::to_string(mFailures) +
+               " cacheHits=" + std::to_string(mCacheHits) +
+               " avgLatencyUs=" + std::to_string(averageUs) +
+               " maxLatencyUs=" + std::to_string(toMicros(mMaxLatency));
+    }
+
+  private:
+    static int64_t toMicros(Clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    }
+
+    const std::string mName;
+    std::mutex mLock;
+    Result mResult;                              // GUARDED_BY(mLock)
+    std::optional<Clock::time_point> mCachedAt;  // GUARDED_BY(mLock)
+    int64_t mCalls = 0;                          // GUARDED_BY(mLock)
+    int64_t mFailures = 0;                       // GUARDED_BY(mLock)
+    int64_t mCacheHits = 0;                      // GUARDED_BY(mLock)
+    Clock::duration mTotalLatency{0};            // GUARDED_BY(mLock)
+    Clock::duration mMaxLatency{0};              // GUARDED_BY(mLock)
+};
+
+}  // namespace stats
+}  // namespace power
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
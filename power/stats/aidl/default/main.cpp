@@ -31,6 +31,9 @@ using aidl::android::hardware::power::stats::FakeStateResidencyDataProvider;
 using aidl::android::hardware::power::stats::PowerStats;
 using aidl::android::hardware::power::stats::State;
 
+// Polls that arrive within this long of each other are served the same provider results.
+constexpr std::chrono::milliseconds kCacheTtl{100};
+
 void setFakeEnergyMeter(std::shared_ptr<PowerStats> p) {
     p->setEnergyMeter(
             std::make_unique<FakeEnergyMeter>(std::vector<std::pair<std::string, std::string>>{
@@ -71,6 +74,8 @@ int main() {
     addFakeEnergyConsumer1(p);
     addFakeEnergyConsumer2(p);
 
+    p->setCacheTtl(kCacheTtl);
+
     const std::string instance = std::string() + PowerStats::descriptor + "/default";
     binder_status_t status = AServiceManager_addService(p->asBinder().get(), instance.c_str());
     CHECK_EQ(status, STATUS_OK);
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ProviderExecutor.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace power {
+namespace stats {
+namespace {
+
+using namespace std::chrono_literals;
+
+// Generous enough not to be hit on a loaded test machine.
+constexpr auto kLongTimeout = 10s;
+
+// A one-shot event that tasks can wait for.
+class Latch {
+  public:
+    void open() {
+        std::lock_guard<std::mutex> lock(mLock);
+        mOpen = true;
+        mCondition.notify_all();
+    }
+
+    bool wait(std::chrono::steady_clock::duration timeout) {
+        std::unique_lock<std::mutex> lock(mLock);
+        return mCondition.wait_for(lock, timeout, [this] { return mOpen; });
+    }
+
+  private:
+    std::mutex mLock;
+    std::condition_variable mCondition;
+    bool mOpen = false;
+};
+
+TEST(ProviderExecutorTest, RunsTasksConcurrently) {
+    constexpr size_t kNumTasks = 3;
+    ProviderExecutor executor(kNumTasks);
+
+    // Each task waits for all of them to have started, which only happens if
+    // they run at the same time.
+    auto started = std::make_shared<std::atomic<size_t>>(0);
+    auto allStarted = std::make_shared<Latch>();
+    auto sawAll = std::make_shared<std::atomic<size_t>>(0);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < kNumTasks; i++) {
+        tasks.emplace_back([=] {
+            if (++*started == kNumTasks) {
+                allStarted->open();
+            }
+            if (allStarted->wait(kLongTimeout)) {
+                ++*sawAll;
+            }
+        });
+    }
+
+    std::vector<bool> completed = executor.runAll(std::move(tasks), kLongTimeout);
+    EXPECT_EQ(std::vector<bool>(kNumTasks, true), completed);
+    EXPECT_EQ(kNumTasks, sawAll->load());
+}
+
+TEST(ProviderExecutorTest, SlowTaskTimesOut) {
+    ProviderExecutor executor(3);
+
+    auto release = std::make_shared<Latch>();
+    auto results = std::make_shared<std::vector<int>>(3, 0);
+    std::vector<std::function<void()>> tasks;
+    tasks.emplace_back([results] { (*results)[0] = 1; });
+    tasks.emplace_back([results, release] {
+        release->wait(kLongTimeout);
+        (*results)[1] = 2;
+    });
+    tasks.emplace_back([results] { (*results)[2] = 3; });
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<bool> completed = executor.runAll(std::move(tasks), 100ms);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(std::vector<bool>({true, false, true}), completed);
+    EXPECT_GE(elapsed, 100ms);
+    EXPECT_LT(elapsed, kLongTimeout);
+    EXPECT_EQ(1, (*results)[0]);
+    EXPECT_EQ(3, (*results)[2]);
+
+    // The slow task keeps running after the call has returned, and its worker
+    // is then available again.
+    release->open();
+    std::vector<std::function<void()>> more(3, [] {});
+    EXPECT_EQ(std::vector<bool>(3, true), executor.runAll(std::move(more), kLongTimeout));
+}
+
+TEST(ProviderExecutorTest, SkipsTasksNotStartedInTime) {
+    ProviderExecutor executor(1);
+
+    auto release = std::make_shared<Latch>();
+    auto ran = std::make_shared<std::atomic<bool>>(false);
+    std::vector<std::function<void()>> tasks;
+    tasks.emplace_back([release] { release->wait(kLongTimeout); });
+    tasks.emplace_back([ran] { *ran = true; });
+    EXPECT_EQ(std::vector<bool>({false, false}), executor.runAll(std::move(tasks), 50ms));
+
+    // Runs after the skipped task on the only worker.
+    release->open();
+    std::vector<std::function<void()>> next(1, [] {});
+    EXPECT_EQ(std::vector<bool>({true}), executor.runAll(std::move(next), kLongTimeout));
+    EXPECT_FALSE(*ran);
+}
+
+TEST(ProviderExecutorTest, RunsOnCallingThreadWithoutWorkers) {
+    ProviderExecutor executor(0);
+
+    std::thread::id caller = std::this_thread::get_id();
+    std::vector<std::thread::id> ranOn(2);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < ranOn.size(); i++) {
+        tasks.emplace_back([&ranOn, i] { ranOn[i] = std::this_thread::get_id(); });
+    }
+    EXPECT_EQ(std::vector<bool>(2, true), executor.runAll(std::move(tasks), 0ms));
+    EXPECT_EQ(caller, ranOn[0]);
+    EXPECT_EQ(caller, ranOn[1]);
+}
+
+TEST(ProviderQueryTest, CachesSuccessfulResults) {
+    ProviderQuery<int> query("Provider");
+    int calls = 0;
+    auto provider = [&](int* result) {
+        *result = ++calls;
+        return true;
+    };
+
+    EXPECT_EQ(1, query.get(kLongTimeout, provider));
+    EXPECT_EQ(1, query.get(kLongTimeout, provider));
+    EXPECT_EQ(1, calls);
+
+    // Expired results are not served.
+    EXPECT_EQ(2, query.get(0s, provider));
+    EXPECT_EQ(3, query.get(1ns, provider));
+    EXPECT_EQ(3, calls);
+
+    EXPECT_EQ(0u, query.dump().find("Provider: calls=3 failures=0 cacheHits=1 "));
+}
+
+TEST(ProviderQueryTest, DoesNotCacheFailures) {
+    ProviderQuery<int> query("Provider");
+    int calls = 0;
+    auto failing = [&](int* result) {
+        *result = ++calls;
+        return false;
+    };
+
+    EXPECT_EQ(1, query.get(kLongTimeout, failing));
+    EXPECT_EQ(2, query.get(kLongTimeout, failing));
+    EXPECT_EQ(0u, query.dump().find("Provider: calls=2 failures=2 cacheHits=0 "));
+}
+
+TEST(ProviderQueryTest, SerializesCallsToProvider) {
+    constexpr size_t kNumTasks = 4;
+    ProviderExecutor executor(kNumTasks);
+    auto query = std::make_shared<ProviderQuery<int>>("Provider");
+
+    auto inProvider = std::make_shared<std::atomic<int>>(0);
+    auto maxInProvider = std::make_shared<std::atomic<int>>(0);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < kNumTasks; i++) {
+        tasks.emplace_back([=] {
+            query->get(0s, [&](int* result) {
+                int current = ++*inProvider;
+                int max = maxInProvider->load();
+                while (current > max && !maxInProvider->compare_exchange_weak(max, current)) {
+                }
+                std::this_thread::sleep_for(5ms);
+                --*inProvider;
+                *result = 0;
+                return true;
+            });
+        });
+    }
+
+    EXPECT_EQ(std::vector<bool>(kNumTasks, true), executor.runAll(std::move(tasks), kLongTimeout));
+    EXPECT_EQ(1, maxInProvider->load());
+}
+
+}  // namespace
+}  // namespace stats
+}  // namespace power
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
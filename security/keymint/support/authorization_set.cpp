@@ -26,13 +26,19 @@ namespace aidl::android::hardware::security::keymint {
 
 void AuthorizationSet::Sort() {
     std::sort(data_.begin(), data_.end());
+    tags_sorted_ = true;
 }
 
 void AuthorizationSet::Deduplicate() {
+    Sort();
+    DeduplicateSorted();
+}
+
+void AuthorizationSet::DeduplicateSorted() {
     if (data_.empty()) return;
 
-    Sort();
     std::vector<KeyParameter> result;
+    result.reserve(data_.size());
 
     auto curr = data_.begin();
     auto prev = curr++;
@@ -48,29 +54,62 @@ void AuthorizationSet::Deduplicate() {
     std::swap(data_, result);
 }
 
+// Returns pointers to the entries of 'params' in sorted order.
+static std::vector<const KeyParameter*> sortedEntries(const std::vector<KeyParameter>& params) {
+    std::vector<const KeyParameter*> entries;
+    entries.reserve(params.size());
+    for (const auto& param : params) entries.push_back(&param);
+    auto less = [](const KeyParameter* a, const KeyParameter* b) { return *a < *b; };
+    if (!std::is_sorted(entries.begin(), entries.end(), less)) {
+        std::sort(entries.begin(), entries.end(), less);
+    }
+    return entries;
+}
+
 void AuthorizationSet::Union(const AuthorizationSet& other) {
-    data_.insert(data_.end(), other.data_.begin(), other.data_.end());
-    Deduplicate();
+    if (other.empty()) {
+        Deduplicate();
+        return;
+    }
+    Sort();
+
+    std::vector<KeyParameter> result;
+    result.reserve(data_.size() + other.size());
+    auto i = data_.begin();
+    for (const KeyParameter* entry : sortedEntries(other.data_)) {
+        for (; i != data_.end() && !(*entry < *i); ++i) {
+            result.push_back(std::move(*i));
+        }
+        result.push_back(*entry);
+    }
+    std::move(i, data_.end(), std::back_inserter(result));
+    std::swap(data_, result);
+
+    DeduplicateSorted();
 }
 
 void AuthorizationSet::Subtract(const AuthorizationSet& other) {
     Deduplicate();
+    if (other.empty()) return;
 
-    auto i = other.begin();
-    while (i != other.end()) {
-        int pos = -1;
-        do {
-            pos = find(i->tag, pos);
-            if (pos != -1 && (*i == data_[pos])) {
-                data_.erase(data_.begin() + pos);
-                break;
-            }
-        } while (pos != -1);
-        ++i;
+    // Both sides are sorted, and this set holds each entry once at most, so a single pass
+    // removes every entry that 'other' contains.
+    std::vector<KeyParameter> result;
+    result.reserve(data_.size());
+    std::vector<const KeyParameter*> entries = sortedEntries(other.data_);
+    auto entry = entries.begin();
+    for (auto& param : data_) {
+        while (entry != entries.end() && **entry < param) ++entry;
+        if (entry == entries.end() || !(**entry == param)) {
+            result.push_back(std::move(param));
+        }
     }
+    std::swap(data_, result);
 }
 
 KeyParameter& AuthorizationSet::operator[](int at) {
+    // The caller may change the tag.
+    tags_sorted_ = false;
     return data_[at];
 }
 
@@ -80,9 +119,31 @@ const KeyParameter& AuthorizationSet::operator[](int at) const {
 
 void AuthorizationSet::Clear() {
     data_.clear();
+    tags_sorted_ = true;
+}
+
+// Sets up to this size are scanned linearly even when sorted, which is faster than a binary
+// search for entries this small.
+static constexpr ptrdiff_t kMaxLinearFindSize = 16;
+
+static std::vector<KeyParameter>::const_iterator findSortedTag(
+        std::vector<KeyParameter>::const_iterator begin,
+        std::vector<KeyParameter>::const_iterator end, Tag tag) {
+    if (end - begin > kMaxLinearFindSize) {
+        return std::lower_bound(begin, end, tag,
+                                [](const KeyParameter& param, Tag t) { return param.tag < t; });
+    }
+    while (begin != end && begin->tag < tag) ++begin;
+    return begin;
 }
 
 size_t AuthorizationSet::GetTagCount(Tag tag) const {
+    if (tags_sorted_) {
+        auto first = findSortedTag(data_.begin(), data_.end(), tag);
+        auto last = first;
+        while (last != data_.end() && last->tag == tag) ++last;
+        return last - first;
+    }
     size_t count = 0;
     for (int pos = -1; (pos = find(tag, pos)) != -1;) ++count;
     return count;
@@ -91,6 +152,12 @@ size_t AuthorizationSet::GetTagCount(Tag tag) const {
 int AuthorizationSet::find(Tag tag, int begin) const {
     auto iter = data_.begin() + (1 + begin);
 
+    if (tags_sorted_) {
+        iter = findSortedTag(iter, data_.end(), tag);
+        if (iter != data_.end() && iter->tag == tag) return iter - data_.begin();
+        return -1;
+    }
+
     while (iter != data_.end() && iter->tag != tag) ++iter;
 
     if (iter != data_.end()) return iter - data_.begin();
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include <aidl/android/hardware/security/keymint/BlockMode.h>
@@ -34,6 +35,10 @@ class AuthorizationSetBuilder;
 /**
  * A collection of KeyParameters. It provides memory ownership and some convenient functionality for
  * sorting, deduplicating, joining, and subtracting sets of KeyParameters.
+ *
+ * The set keeps track of whether its entries are ordered by tag, which is the case after Sort(),
+ * Deduplicate(), Union() and Subtract(), and for sets that were built in tag order. Tag lookups are
+ * binary searches while that holds, and linear scans otherwise.
  */
 class AuthorizationSet {
   public:
@@ -45,10 +50,12 @@ class AuthorizationSet {
     AuthorizationSet(){};
 
     // Copy constructor.
-    AuthorizationSet(const AuthorizationSet& other) : data_(other.data_) {}
+    AuthorizationSet(const AuthorizationSet& other)
+        : data_(other.data_), tags_sorted_(other.tags_sorted_) {}
 
     // Move constructor.
-    AuthorizationSet(AuthorizationSet&& other) noexcept : data_(std::move(other.data_)) {}
+    AuthorizationSet(AuthorizationSet&& other) noexcept
+        : data_(std::move(other.data_)), tags_sorted_(other.tags_sorted_) {}
 
     // Constructor from vector<KeyParameter>
     AuthorizationSet(const vector<KeyParameter>& other) { *this = other; }
@@ -56,12 +63,14 @@ class AuthorizationSet {
     // Copy assignment.
     AuthorizationSet& operator=(const AuthorizationSet& other) {
         data_ = other.data_;
+        tags_sorted_ = other.tags_sorted_;
         return *this;
     }
 
     // Move assignment.
     AuthorizationSet& operator=(AuthorizationSet&& other) noexcept {
         data_ = std::move(other.data_);
+        tags_sorted_ = other.tags_sorted_;
         return *this;
     }
 
@@ -73,6 +82,7 @@ class AuthorizationSet {
                  * See assignment operator/copy constructor of vector.*/
                 data_[i] = other[i];
             }
+            UpdateTagsSorted();
         }
         return *this;
     }
@@ -136,13 +146,20 @@ class AuthorizationSet {
     /**
      * Returns iterator (pointer) to beginning of elems array, to enable STL-style iteration
      */
-    auto begin() { return data_.begin(); }
+    auto begin() {
+        // The caller may change tags.
+        tags_sorted_ = false;
+        return data_.begin();
+    }
     auto begin() const { return data_.begin(); }
 
     /**
      * Returns iterator (pointer) one past end of elems array, to enable STL-style iteration
      */
-    auto end() { return data_.end(); }
+    auto end() {
+        tags_sorted_ = false;
+        return data_.end();
+    }
     auto end() const { return data_.end(); }
 
     /**
@@ -184,8 +201,14 @@ class AuthorizationSet {
         return {};
     }
 
-    void push_back(const KeyParameter& param) { data_.push_back(param); }
-    void push_back(KeyParameter&& param) { data_.push_back(std::move(param)); }
+    void push_back(const KeyParameter& param) {
+        UpdateTagsSorted(param);
+        data_.push_back(param);
+    }
+    void push_back(KeyParameter&& param) {
+        UpdateTagsSorted(param);
+        data_.push_back(std::move(param));
+    }
     void push_back(const AuthorizationSet& set) {
         for (auto& entry : set) {
             push_back(entry);
@@ -221,7 +244,23 @@ class AuthorizationSet {
   private:
     std::optional<std::reference_wrapper<const KeyParameter>> GetEntry(Tag tag) const;
 
+    // Removes duplicates from the already sorted data_.
+    void DeduplicateSorted();
+
+    // Updates tags_sorted_ for \p param being appended.
+    void UpdateTagsSorted(const KeyParameter& param) {
+        tags_sorted_ = tags_sorted_ && (data_.empty() || !(param.tag < data_.back().tag));
+    }
+
+    void UpdateTagsSorted() {
+        tags_sorted_ = std::is_sorted(
+                data_.begin(), data_.end(),
+                [](const KeyParameter& a, const KeyParameter& b) { return a.tag < b.tag; });
+    }
+
     std::vector<KeyParameter> data_;
+    // Whether data_ is ordered by tag, so that entries with the same tag are adjacent.
+    bool tags_sorted_ = true;
 };
 
 class AuthorizationSetBuilder : public AuthorizationSet {
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vibrator-impl/CallbackScheduler.h"
+
+#include <android-base/logging.h>
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace vibrator {
+
+CallbackScheduler::~CallbackScheduler() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+        thread = std::move(mThread);
+    }
+    mCondition.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void CallbackScheduler::schedule(std::chrono::milliseconds delay, std::function<void()> task,
+                                 bool runOnCancel) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto it = mTasks.emplace(Clock::now() + delay, Task{std::move(task), runOnCancel});
+    if (!mThread.joinable()) {
+        mThread = std::thread(&CallbackScheduler::threadLoop, this);
+    } else if (it == mTasks.begin()) {
+        // The new task is due before the one the thread is waiting for.
+        mCondition.notify_one();
+    }
+}
+
+void CallbackScheduler::cancel() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mTasks.empty()) {
+        return;
+    }
+    const Clock::time_point now = Clock::now();
+    std::multimap<Clock::time_point, Task> remaining;
+    for (auto& [deadline, task] : mTasks) {
+        if (task.runOnCancel) {
+            remaining.emplace_hint(remaining.end(), now, std::move(task));
+        }
+    }
+    mTasks = std::move(remaining);
+    mCondition.notify_one();
+}
+
+void CallbackScheduler::threadLoop() {
+    LOG(VERBOSE) << "Callback scheduler thread started";
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        if (mTasks.empty()) {
+            if (mStop) break;
+            mCondition.wait(lock);
+            continue;
+        }
+        auto first = mTasks.begin();
+        if (!mStop && first->first > Clock::now()) {
+            mCondition.wait_until(lock, first->first);
+            continue;
+        }
+        Task task = std::move(first->second);
+        mTasks.erase(first);
+        if (mStop && !task.runOnCancel) {
+            continue;
+        }
+        // Tasks call into clients, which may call back into the vibrator.
+        lock.unlock();
+        task.run();
+        lock.lock();
+    }
+    LOG(VERBOSE) << "Callback scheduler thread exiting";
+}
+
+}  // namespace vibrator
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
@@ -17,7 +17,6 @@
 #include "vibrator-impl/Vibrator.h"
 
 #include <android-base/logging.h>
-#include <thread>
 
 namespace aidl {
 namespace android {
@@ -52,6 +51,8 @@ ndk::ScopedAStatus Vibrator::getCapabilities(int32_t* _aidl_return) {
 
 ndk::ScopedAStatus Vibrator::off() {
     LOG(VERBOSE) << "Vibrator off";
+    // Pending completion callbacks are still delivered, but remaining primitives are dropped.
+    mScheduler.cancel();
     return ndk::ScopedAStatus::ok();
 }
 
@@ -59,17 +60,15 @@ ndk::ScopedAStatus Vibrator::on(int32_t timeoutMs,
                                 const std::shared_ptr<IVibratorCallback>& callback) {
     LOG(VERBOSE) << "Vibrator on for timeoutMs: " << timeoutMs;
     if (callback != nullptr) {
-        // Note that thread lambdas aren't using implicit capture [=], to avoid capturing "this",
-        // which may be asynchronously destructed.
-        // If "this" is needed, use [sharedThis = this->ref<Vibrator>()].
-        std::thread([timeoutMs, callback] {
-            LOG(VERBOSE) << "Starting on on another thread";
-            usleep(timeoutMs * 1000);
-            LOG(VERBOSE) << "Notifying on complete";
-            if (!callback->onComplete().isOk()) {
-                LOG(ERROR) << "Failed to call onComplete";
-            }
-        }).detach();
+        mScheduler.schedule(
+                std::chrono::milliseconds(timeoutMs),
+                [callback] {
+                    LOG(VERBOSE) << "Notifying on complete";
+                    if (!callback->onComplete().isOk()) {
+                        LOG(ERROR) << "Failed to call onComplete";
+                    }
+                },
+                true /*runOnCancel*/);
     }
     return ndk::ScopedAStatus::ok();
 }
@@ -90,12 +89,13 @@ ndk::ScopedAStatus Vibrator::perform(Effect effect, EffectStrength strength,
     constexpr size_t kEffectMillis = 100;
 
     if (callback != nullptr) {
-        std::thread([callback] {
-            LOG(VERBOSE) << "Starting perform on another thread";
-            usleep(kEffectMillis * 1000);
-            LOG(VERBOSE) << "Notifying perform complete";
-            callback->onComplete();
-        }).detach();
+        mScheduler.schedule(
+                std::chrono::milliseconds(kEffectMillis),
+                [callback] {
+                    LOG(VERBOSE) << "Notifying perform complete";
+                    callback->onComplete();
+                },
+                true /*runOnCancel*/);
     }
 
     *_aidl_return = kEffectMillis;
@@ -177,27 +177,29 @@ ndk::ScopedAStatus Vibrator::compose(const std::vector<CompositeEffect>& composi
         }
     }
 
-    // The thread may theoretically outlive the vibrator, so take a proper reference to it.
-    std::thread([sharedThis = this->ref<Vibrator>(), composite, callback] {
-        LOG(VERBOSE) << "Starting compose on another thread";
-
-        for (auto& e : composite) {
-            if (e.delayMs) {
-                usleep(e.delayMs * 1000);
-            }
-            LOG(VERBOSE) << "triggering primitive " << static_cast<int>(e.primitive) << " @ scale "
-                         << e.scale;
-
-            int32_t durationMs;
-            sharedThis->getPrimitiveDuration(e.primitive, &durationMs);
-            usleep(durationMs * 1000);
-        }
+    // Each primitive is triggered after its delay and the previous primitive have elapsed.
+    std::chrono::milliseconds elapsed(0);
+    for (auto& e : composite) {
+        elapsed += std::chrono::milliseconds(e.delayMs);
+        mScheduler.schedule(elapsed, [primitive = e.primitive, scale = e.scale] {
+            LOG(VERBOSE) << "triggering primitive " << static_cast<int>(primitive) << " @ scale "
+                         << scale;
+        });
+
+        int32_t durationMs;
+        getPrimitiveDuration(e.primitive, &durationMs);
+        elapsed += std::chrono::milliseconds(durationMs);
+    }
 
-        if (callback != nullptr) {
-            LOG(VERBOSE) << "Notifying perform complete";
-            callback->onComplete();
-        }
-    }).detach();
+    if (callback != nullptr) {
+        mScheduler.schedule(
+                elapsed,
+                [callback] {
+                    LOG(VERBOSE) << "Notifying perform complete";
+                    callback->onComplete();
+                },
+                true /*runOnCancel*/);
+    }
 
     return ndk::ScopedAStatus::ok();
 }
@@ -400,14 +402,15 @@ ndk::ScopedAStatus Vibrator::composePwle(const std::vector<PrimitivePwle> &compo
         }
     }
 
-    std::thread([totalDuration, callback] {
-        LOG(VERBOSE) << "Starting composePwle on another thread";
-        usleep(totalDuration * 1000);
-        if (callback != nullptr) {
-            LOG(VERBOSE) << "Notifying compose PWLE complete";
-            callback->onComplete();
-        }
-    }).detach();
+    if (callback != nullptr) {
+        mScheduler.schedule(
+                std::chrono::milliseconds(totalDuration),
+                [callback] {
+                    LOG(VERBOSE) << "Notifying compose PWLE complete";
+                    callback->onComplete();
+                },
+                true /*runOnCancel*/);
+    }
 
     return ndk::ScopedAStatus::ok();
 }
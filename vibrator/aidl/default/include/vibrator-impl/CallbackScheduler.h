@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace aidl {
+namespace android {
+namespace hardware {
+namespace vibrator {
+
+// Runs delayed tasks, like composition steps and completion callbacks, on a single
+// thread that is started on first use. Tasks with the same deadline run in the
+// order they were scheduled.
+class CallbackScheduler {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    CallbackScheduler() = default;
+    // Drops pending tasks, except those scheduled with 'runOnCancel', which are run
+    // before the thread exits.
+    ~CallbackScheduler();
+
+    CallbackScheduler(const CallbackScheduler&) = delete;
+    CallbackScheduler& operator=(const CallbackScheduler&) = delete;
+
+    // Runs 'task' once 'delay' has elapsed. A task scheduled with 'runOnCancel' is
+    // not dropped by 'cancel' but run right away instead. This is what completion
+    // callbacks need, as they must be called even if the vibration is cancelled.
+    void schedule(std::chrono::milliseconds delay, std::function<void()> task,
+                  bool runOnCancel = false);
+
+    // Drops all pending tasks that were not scheduled with 'runOnCancel', and
+    // makes the remaining ones due immediately. Does not wait for them to run.
+    void cancel();
+
+  private:
+    struct Task {
+        std::function<void()> run;
+        bool runOnCancel;
+    };
+
+    void threadLoop();
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::multimap<Clock::time_point, Task> mTasks;  // GUARDED_BY(mMutex)
+    bool mStop = false;                             // GUARDED_BY(mMutex)
+    std::thread mThread;                            // GUARDED_BY(mMutex)
+};
+
+}  // namespace vibrator
+}  // namespace hardware
+}  // namespace android
+}  // namespace aidl
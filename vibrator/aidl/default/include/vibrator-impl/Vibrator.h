@@ -18,6 +18,8 @@
 
 #include <aidl/android/hardware/vibrator/BnVibrator.h>
 
+#include "vibrator-impl/CallbackScheduler.h"
+
 namespace aidl {
 namespace android {
 namespace hardware {
@@ -55,6 +57,10 @@ class Vibrator : public BnVibrator {
     ndk::ScopedAStatus composePwle(const std::vector<PrimitivePwle> &composite,
                                    const std::shared_ptr<IVibratorCallback> &callback) override;
 
+  private:
+    // Delivers completion callbacks and plays compositions, shared by all vibrations so
+    // that vibrating does not create threads.
+    CallbackScheduler mScheduler;
 };
 
 }  // namespace vibrator
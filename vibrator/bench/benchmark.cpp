@@ -21,6 +21,8 @@
 #include <android/hardware/vibrator/IVibrator.h>
 #include <binder/IServiceManager.h>
 
+#include <future>
+
 using ::android::enum_range;
 using ::android::sp;
 using ::android::hardware::hidl_enum_range;
@@ -34,6 +36,7 @@ using ::benchmark::internal::Benchmark;
 using ::std::chrono::duration;
 using ::std::chrono::duration_cast;
 using ::std::chrono::high_resolution_clock;
+using ::std::chrono::milliseconds;
 
 namespace Aidl = ::android::hardware::vibrator;
 namespace V1_0 = ::android::hardware::vibrator::V1_0;
@@ -574,4 +577,108 @@ BENCHMARK_WRAPPER(VibratorPrimitivesBench_Aidl, compose, {
     }
 });
 
+class TimedHalCallback : public Aidl::BnVibratorCallback {
+  public:
+    android::binder::Status onComplete() override {
+        mCompleted.set_value(high_resolution_clock::now());
+        return android::binder::Status::ok();
+    }
+
+    // Returns false if the callback was not called within 'timeout'.
+    bool waitForCompletion(milliseconds timeout, high_resolution_clock::time_point* completed) {
+        auto future = mCompleted.get_future();
+        if (future.wait_for(timeout) != std::future_status::ready) {
+            return false;
+        }
+        *completed = future.get();
+        return true;
+    }
+
+  private:
+    std::promise<high_resolution_clock::time_point> mCompleted;
+};
+
+// Measures the delivery of completion callbacks. The iteration time spans from starting a
+// vibration until its callback arrives, and the "lateUs" counters tell how much later than
+// the expected end of the vibration that was.
+class VibratorCallbackBench_Aidl : public VibratorBench_Aidl {
+  public:
+    static void DefaultConfig(Benchmark* b) { b->Unit(kMicrosecond)->UseManualTime(); }
+
+  protected:
+    static constexpr milliseconds kCallbackTimeout{1000};
+
+    // 'start' starts a vibration which reports to the given callback, and returns
+    // whether that succeeded.
+    template <typename F>
+    void callbackBench(State* state, milliseconds expected, F start) {
+        double totalLateUs = 0;
+        double maxLateUs = 0;
+
+        for (auto _ : *state) {
+            sp<TimedHalCallback> cb = new TimedHalCallback();
+            auto started = high_resolution_clock::now();
+            if (!start(cb)) {
+                state->SkipWithError("Failed to start vibration");
+                break;
+            }
+            high_resolution_clock::time_point completed;
+            if (!cb->waitForCompletion(expected + kCallbackTimeout, &completed)) {
+                state->SkipWithError("Completion callback was not called");
+                break;
+            }
+            state->SetIterationTime(duration<double>(completed - started).count());
+            double lateUs = duration<double, std::micro>(completed - started - expected).count();
+            totalLateUs += lateUs;
+            maxLateUs = std::max(maxLateUs, lateUs);
+        }
+
+        state->counters["lateUs"] = Counter(totalLateUs, Counter::kAvgIterations);
+        state->counters["maxLateUs"] = maxLateUs;
+    }
+};
+
+// Back-to-back short vibrations, as produced by haptic feedback on scrolling and typing.
+BENCHMARK_WRAPPER(VibratorCallbackBench_Aidl, onCallback, {
+    int32_t capabilities = 0;
+    mVibrator->getCapabilities(&capabilities);
+    if ((capabilities & Aidl::IVibrator::CAP_ON_CALLBACK) == 0) {
+        return;
+    }
+
+    int32_t ms = getOtherArg(state, 0);
+
+    callbackBench(&state, milliseconds(ms), [&](const sp<TimedHalCallback>& cb) {
+        return mVibrator->on(ms, cb).isOk();
+    });
+})->ArgNames({"DurationMs"})->Arg(1)->Arg(5)->Arg(20);
+
+BENCHMARK_WRAPPER(VibratorCallbackBench_Aidl, composeCallback, {
+    int32_t capabilities = 0;
+    mVibrator->getCapabilities(&capabilities);
+    if ((capabilities & Aidl::IVibrator::CAP_COMPOSE_EFFECTS) == 0) {
+        return;
+    }
+
+    Aidl::CompositeEffect effect;
+    effect.primitive = Aidl::CompositePrimitive::CLICK;
+    effect.scale = 1.0f;
+    effect.delayMs = 0;
+
+    std::vector<Aidl::CompositePrimitive> supported;
+    mVibrator->getSupportedPrimitives(&supported);
+    if (std::find(supported.begin(), supported.end(), effect.primitive) == supported.end()) {
+        return;
+    }
+
+    int32_t durationMs = 0;
+    mVibrator->getPrimitiveDuration(effect.primitive, &durationMs);
+    std::vector<Aidl::CompositeEffect> effects(getOtherArg(state, 0), effect);
+
+    callbackBench(&state, milliseconds(durationMs * effects.size()),
+                  [&](const sp<TimedHalCallback>& cb) {
+                      return mVibrator->compose(effects, cb).isOk();
+                  });
+})->ArgNames({"Primitives"})->Arg(1)->Arg(4);
+
 BENCHMARK_MAIN();
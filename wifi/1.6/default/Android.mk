@@ -172,6 +172,7 @@ LOCAL_PROPRIETARY_MODULE := true
 LOCAL_CPPFLAGS := -Wall -Werror -Wextra
 LOCAL_SRC_FILES := \
     tests/hidl_struct_util_unit_tests.cpp \
+    tests/hidl_sync_util_unit_tests.cpp \
     tests/main.cpp \
     tests/mock_interface_tool.cpp \
     tests/mock_wifi_feature_flags.cpp \
@@ -43,7 +43,7 @@ template <typename ObjT, typename WorkFuncT, typename... Args>
 Return<void> validateAndCall(ObjT* obj, WifiStatusCode status_code_if_invalid, WorkFuncT&& work,
                              const std::function<void(const WifiStatus&)>& hidl_cb,
                              Args&&... args) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireLockFor(obj);
     if (obj->isValid()) {
         hidl_cb((obj->*work)(std::forward<Args>(args)...));
     } else {
@@ -75,7 +75,7 @@ template <typename ObjT, typename WorkFuncT, typename ReturnT, typename... Args>
 Return<void> validateAndCall(ObjT* obj, WifiStatusCode status_code_if_invalid, WorkFuncT&& work,
                              const std::function<void(const WifiStatus&, ReturnT)>& hidl_cb,
                              Args&&... args) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireLockFor(obj);
     if (obj->isValid()) {
         const auto& ret_pair = (obj->*work)(std::forward<Args>(args)...);
         const WifiStatus& status = std::get<0>(ret_pair);
@@ -94,7 +94,7 @@ template <typename ObjT, typename WorkFuncT, typename ReturnT1, typename ReturnT
 Return<void> validateAndCall(
         ObjT* obj, WifiStatusCode status_code_if_invalid, WorkFuncT&& work,
         const std::function<void(const WifiStatus&, ReturnT1, ReturnT2)>& hidl_cb, Args&&... args) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireLockFor(obj);
     if (obj->isValid()) {
         const auto& ret_tuple = (obj->*work)(std::forward<Args>(args)...);
         const WifiStatus& status = std::get<0>(ret_tuple);
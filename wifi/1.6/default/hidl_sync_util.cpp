@@ -14,10 +14,25 @@
  * limitations under the License.
  */
 
+#include <android-base/logging.h>
+
+#include <array>
+
 #include "hidl_sync_util.h"
 
 namespace {
-std::recursive_mutex g_mutex;
+android::hardware::wifi::V1_6::implementation::hidl_sync_util::GlobalMutex g_mutex;
+std::array<std::recursive_mutex,
+           static_cast<size_t>(
+                   android::hardware::wifi::V1_6::implementation::hidl_sync_util::LockDomain::
+                           NUM_DOMAINS)>
+        g_domain_mutexes;
+
+// Shared mode recursion depth of |g_mutex| on this thread.
+thread_local unsigned t_shared_depth = 0;
+// Whether the outermost shared acquisition on this thread actually locked
+// |g_mutex| (it doesn't if the thread held it exclusively at the time).
+thread_local bool t_shared_locked = false;
 }  // namespace
 
 namespace android {
@@ -27,8 +42,58 @@ namespace V1_6 {
 namespace implementation {
 namespace hidl_sync_util {
 
-std::unique_lock<std::recursive_mutex> acquireGlobalLock() {
-    return std::unique_lock<std::recursive_mutex>{g_mutex};
+void GlobalMutex::lock() {
+    if (owner_.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+        exclusive_depth_++;
+        return;
+    }
+    if (t_shared_depth > 0) {
+        LOG(FATAL) << "Global lock can't be upgraded from shared to exclusive";
+    }
+    mutex_.lock();
+    owner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    exclusive_depth_ = 1;
+}
+
+void GlobalMutex::unlock() {
+    if (--exclusive_depth_ > 0) {
+        return;
+    }
+    owner_.store(std::thread::id(), std::memory_order_relaxed);
+    mutex_.unlock();
+}
+
+void GlobalMutex::lock_shared() {
+    if (t_shared_depth++ > 0) {
+        return;
+    }
+    if (owner_.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+        t_shared_locked = false;
+        return;
+    }
+    mutex_.lock_shared();
+    t_shared_locked = true;
+}
+
+void GlobalMutex::unlock_shared() {
+    if (--t_shared_depth > 0) {
+        return;
+    }
+    if (t_shared_locked) {
+        t_shared_locked = false;
+        mutex_.unlock_shared();
+    }
+}
+
+DomainLock::DomainLock(LockDomain domain)
+    : global_lock_(g_mutex), domain_lock_(g_domain_mutexes[static_cast<size_t>(domain)]) {}
+
+GlobalLock acquireGlobalLock() {
+    return GlobalLock{g_mutex};
+}
+
+DomainLock acquireDomainLock(LockDomain domain) {
+    return DomainLock{domain};
 }
 
 }  // namespace hidl_sync_util
@@ -17,17 +17,113 @@
 #ifndef HIDL_SYNC_UTIL_H_
 #define HIDL_SYNC_UTIL_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
 
-// Utility that provides a global lock to synchronize access between
-// the HIDL thread and the legacy HAL's event loop.
+// Utility that provides the locks to synchronize access between the HIDL
+// thread and the legacy HAL's event loop. See THREADING.README.
 namespace android {
 namespace hardware {
 namespace wifi {
 namespace V1_6 {
 namespace implementation {
 namespace hidl_sync_util {
-std::unique_lock<std::recursive_mutex> acquireGlobalLock();
+
+// Every HIDL object and every asynchronous legacy HAL callback belongs to one
+// of these domains. (NAN_IFACE rather than NAN, which is a math.h macro.)
+enum class LockDomain { CHIP, STA, AP, P2P, NAN_IFACE, RTT, NUM_DOMAINS };
+
+// Reader/writer lock allowing per-thread recursion: a thread holding it
+// exclusively may acquire it again in either mode, a thread holding it shared
+// may acquire it shared again. Upgrading from shared to exclusive is not
+// supported. Recursion state is kept per thread, so there must only be a
+// single instance of this lock (the one behind acquireGlobalLock()).
+class GlobalMutex {
+  public:
+    void lock();
+    void unlock();
+    void lock_shared();
+    void unlock_shared();
+
+  private:
+    std::shared_mutex mutex_;
+    std::atomic<std::thread::id> owner_;
+    unsigned exclusive_depth_ = 0;
+};
+using GlobalLock = std::unique_lock<GlobalMutex>;
+
+// Locks held on behalf of a single domain: the global lock in shared mode and
+// the domain's own (recursive) lock.
+class DomainLock {
+  public:
+    explicit DomainLock(LockDomain domain);
+
+  private:
+    std::shared_lock<GlobalMutex> global_lock_;
+    std::unique_lock<std::recursive_mutex> domain_lock_;
+};
+
+// Acquires the global lock exclusively, which excludes every domain.
+GlobalLock acquireGlobalLock();
+// Acquires the lock of |domain|. Holders of different domains' locks run
+// concurrently.
+DomainLock acquireDomainLock(LockDomain domain);
+
+// Acquires the lock a HIDL method of |ObjT| must hold. Methods of CHIP domain
+// objects (IWifi, IWifiChip) may add or remove interfaces, so they hold the
+// global lock exclusively.
+template <typename ObjT>
+auto acquireLockFor(ObjT* /* obj */) {
+    if constexpr (ObjT::kLockDomain == LockDomain::CHIP) {
+        return acquireGlobalLock();
+    } else {
+        return acquireDomainLock(ObjT::kLockDomain);
+    }
+}
+
+// Holder for a legacy HAL std::function callback which may be replaced on one
+// thread while being invoked on another. Invocation works on a snapshot, so a
+// callback replaced (or reset) while running stays alive until it returns.
+template <typename Signature>
+class CallbackSlot;
+
+template <typename... Args>
+class CallbackSlot<void(Args...)> {
+  public:
+    using Function = std::function<void(Args...)>;
+
+    CallbackSlot& operator=(Function function) {
+        std::shared_ptr<const Function> next;
+        if (function) {
+            next = std::make_shared<const Function>(std::move(function));
+        }
+        std::atomic_store(&function_, std::move(next));
+        return *this;
+    }
+
+    CallbackSlot& operator=(std::nullptr_t) {
+        std::atomic_store(&function_, std::shared_ptr<const Function>());
+        return *this;
+    }
+
+    explicit operator bool() const { return std::atomic_load(&function_) != nullptr; }
+
+    // Invokes the callback, if one is set.
+    void operator()(Args... args) const {
+        const auto function = std::atomic_load(&function_);
+        if (function) {
+            (*function)(std::forward<Args>(args)...);
+        }
+    }
+
+  private:
+    std::shared_ptr<const Function> function_;
+};
+
 }  // namespace hidl_sync_util
 }  // namespace implementation
 }  // namespace V1_6
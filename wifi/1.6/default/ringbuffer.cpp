@@ -15,16 +15,29 @@
  */
 
 #include <android-base/logging.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
 
 #include "ringbuffer.h"
 
+namespace {
+// Initial capacity of the record size index.
+constexpr size_t kInitialRecordCapacity = 64;
+// Smallest byte ring allocated, unless |maxSize| is smaller.
+constexpr size_t kMinDataCapacity = 16 * 1024;
+}  // namespace
+
 namespace android {
 namespace hardware {
 namespace wifi {
 namespace V1_6 {
 namespace implementation {
 
-Ringbuffer::Ringbuffer(size_t maxSize) : size_(0), maxSize_(maxSize) {}
+Ringbuffer::Ringbuffer(size_t maxSize)
+    : head_(0), size_(0), record_head_(0), num_records_(0), maxSize_(maxSize) {}
 
 enum Ringbuffer::AppendStatus Ringbuffer::append(const std::vector<uint8_t>& input) {
     if (input.size() == 0) {
@@ -34,27 +47,139 @@ enum Ringbuffer::AppendStatus Ringbuffer::append(const std::vector<uint8_t>& inp
         LOG(INFO) << "Oversized message of " << input.size() << " bytes is dropped";
         return AppendStatus::FAIL_IP_BUFFER_EXCEEDED_MAXSIZE;
     }
-    data_.push_back(input);
-    size_ += input.size() * sizeof(input[0]);
-    while (size_ > maxSize_) {
-        if (data_.front().size() <= 0 || data_.front().size() > maxSize_) {
-            LOG(ERROR) << "First buffer in the ring buffer is Invalid. Size: "
-                       << data_.front().size();
+    if (record_sizes_.empty()) {
+        record_sizes_.resize(kInitialRecordCapacity);
+    }
+    while (size_ + input.size() > maxSize_) {
+        if (num_records_ == 0) {
+            LOG(ERROR) << "Ring buffer accounts " << size_ << " bytes without any records";
             return AppendStatus::FAIL_RING_BUFFER_CORRUPTED;
         }
-        size_ -= data_.front().size() * sizeof(data_.front()[0]);
-        data_.pop_front();
+        popRecord();
+    }
+    if (size_ + input.size() > data_.size()) {
+        grow(size_ + input.size());
     }
+
+    const size_t capacity = data_.size();
+    const size_t tail = (head_ + size_) % capacity;
+    const size_t first_part = std::min(input.size(), capacity - tail);
+    memcpy(data_.data() + tail, input.data(), first_part);
+    memcpy(data_.data(), input.data() + first_part, input.size() - first_part);
+    size_ += input.size();
+    pushRecordSize(input.size());
     return AppendStatus::SUCCESS;
 }
 
-const std::list<std::vector<uint8_t>>& Ringbuffer::getData() const {
-    return data_;
+size_t Ringbuffer::getCapacity() const {
+    return data_.size();
+}
+
+bool Ringbuffer::empty() const {
+    return num_records_ == 0;
+}
+
+size_t Ringbuffer::getNumRecords() const {
+    return num_records_;
+}
+
+std::vector<std::vector<uint8_t>> Ringbuffer::getRecords() const {
+    std::vector<std::vector<uint8_t>> records;
+    records.reserve(num_records_);
+    const size_t capacity = data_.size();
+    size_t offset = head_;
+    for (size_t i = 0; i < num_records_; i++) {
+        const size_t record_size = record_sizes_[(record_head_ + i) % record_sizes_.size()];
+        std::vector<uint8_t>& record = records.emplace_back(record_size);
+        const size_t first_part = std::min(record_size, capacity - offset);
+        memcpy(record.data(), data_.data() + offset, first_part);
+        memcpy(record.data() + first_part, data_.data(), record_size - first_part);
+        offset = (offset + record_size) % capacity;
+    }
+    return records;
+}
+
+bool Ringbuffer::writeTo(int fd) const {
+    if (size_ == 0) {
+        return true;
+    }
+    const size_t first_part = std::min(size_, data_.size() - head_);
+    struct iovec iov[2] = {
+            {const_cast<uint8_t*>(data_.data()) + head_, first_part},
+            {const_cast<uint8_t*>(data_.data()), size_ - first_part},
+    };
+    int iovcnt = iov[1].iov_len > 0 ? 2 : 1;
+    struct iovec* cur = iov;
+    while (iovcnt > 0) {
+        const ssize_t written = TEMP_FAILURE_RETRY(writev(fd, cur, iovcnt));
+        if (written < 0) {
+            PLOG(ERROR) << "Error writing to file";
+            return false;
+        }
+        // Skip over whatever got written in case of a partial write.
+        size_t remaining = written;
+        while (iovcnt > 0 && remaining >= cur->iov_len) {
+            remaining -= cur->iov_len;
+            cur++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            cur->iov_base = static_cast<uint8_t*>(cur->iov_base) + remaining;
+            cur->iov_len -= remaining;
+        }
+    }
+    return true;
 }
 
 void Ringbuffer::clear() {
-    data_.clear();
+    head_ = 0;
     size_ = 0;
+    record_head_ = 0;
+    num_records_ = 0;
+}
+
+void Ringbuffer::swap(Ringbuffer& other) {
+    std::swap(data_, other.data_);
+    std::swap(head_, other.head_);
+    std::swap(size_, other.size_);
+    std::swap(record_sizes_, other.record_sizes_);
+    std::swap(record_head_, other.record_head_);
+    std::swap(num_records_, other.num_records_);
+    std::swap(maxSize_, other.maxSize_);
+}
+
+void Ringbuffer::grow(size_t min_capacity) {
+    const size_t capacity =
+            std::min(maxSize_, std::max({min_capacity, 2 * data_.size(), kMinDataCapacity}));
+    // Linearize into the larger ring.
+    std::vector<uint8_t> grown(capacity);
+    const size_t first_part = std::min(size_, data_.size() - head_);
+    memcpy(grown.data(), data_.data() + head_, first_part);
+    memcpy(grown.data() + first_part, data_.data(), size_ - first_part);
+    data_.swap(grown);
+    head_ = 0;
+}
+
+void Ringbuffer::pushRecordSize(size_t size) {
+    if (num_records_ == record_sizes_.size()) {
+        // Linearize into a twice as large index.
+        std::vector<uint32_t> grown(record_sizes_.size() * 2);
+        for (size_t i = 0; i < num_records_; i++) {
+            grown[i] = record_sizes_[(record_head_ + i) % record_sizes_.size()];
+        }
+        record_sizes_.swap(grown);
+        record_head_ = 0;
+    }
+    record_sizes_[(record_head_ + num_records_) % record_sizes_.size()] = size;
+    num_records_++;
+}
+
+void Ringbuffer::popRecord() {
+    const size_t record_size = record_sizes_[record_head_];
+    head_ = (head_ + record_size) % data_.size();
+    size_ -= record_size;
+    record_head_ = (record_head_ + 1) % record_sizes_.size();
+    num_records_--;
 }
 
 }  // namespace implementation
@@ -17,7 +17,6 @@
 #ifndef RINGBUFFER_H_
 #define RINGBUFFER_H_
 
-#include <list>
 #include <vector>
 
 namespace android {
@@ -26,9 +25,11 @@ namespace wifi {
 namespace V1_6 {
 namespace implementation {
 
-/**
- * Ringbuffer object used to store debug data.
- */
+// Ring of variable length records stored back to back in a single contiguous
+// byte buffer of at most |maxSize| bytes. The byte buffer grows geometrically
+// with the data it holds and is reused afterwards, so appending and evicting
+// records does not allocate in steady state, and rings that only see a little
+// data don't take |maxSize| bytes.
 class Ringbuffer {
   public:
     // Error codes for the append ring buffer operation
@@ -44,12 +45,36 @@ class Ringbuffer {
     // Appends the data buffer and deletes from the front until buffer is
     // within |maxSize_|.
     enum AppendStatus append(const std::vector<uint8_t>& input);
-    const std::list<std::vector<uint8_t>>& getData() const;
+    bool empty() const;
+    // Bytes of storage currently allocated for record payloads.
+    size_t getCapacity() const;
+    size_t getNumRecords() const;
+    // Copies out all records, oldest first.
+    std::vector<std::vector<uint8_t>> getRecords() const;
+    // Writes all records, oldest first, back to back to |fd| with at most one
+    // writev call per wrap-around segment.
+    bool writeTo(int fd) const;
     void clear();
+    // Exchanges contents and storage with |other|. Used to detach the data
+    // from the ring before writing it out, so the ring's lock doesn't need to
+    // be held across file I/O. Clearing |other| afterwards keeps its storage
+    // for the next swap.
+    void swap(Ringbuffer& other);
 
   private:
-    std::list<std::vector<uint8_t>> data_;
+    void grow(size_t min_capacity);
+    void pushRecordSize(size_t size);
+    void popRecord();
+
+    // Byte ring holding record payloads, wrapping at its size.
+    std::vector<uint8_t> data_;
+    size_t head_;
     size_t size_;
+    // Circular index of record sizes, oldest at |record_head_|. Only grows
+    // when the number of live records exceeds its capacity.
+    std::vector<uint32_t> record_sizes_;
+    size_t record_head_;
+    size_t num_records_;
     size_t maxSize_;
 };
 
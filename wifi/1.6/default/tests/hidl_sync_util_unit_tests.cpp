@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2022, The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "hidl_sync_util.h"
+
+using testing::Test;
+
+namespace {
+constexpr auto kBlockedTimeout = std::chrono::milliseconds(100);
+constexpr auto kUnblockedTimeout = std::chrono::seconds(10);
+constexpr int kStressIterations = 2000;
+}  // namespace
+
+namespace android {
+namespace hardware {
+namespace wifi {
+namespace V1_6 {
+namespace implementation {
+namespace hidl_sync_util {
+
+class HidlSyncUtilTest : public Test {
+  protected:
+    // Runs |acquire| on another thread and returns a future which is ready once
+    // it acquired the lock (which is released right away).
+    template <typename AcquireFunc>
+    std::future<void> acquireAsync(AcquireFunc acquire) {
+        return std::async(std::launch::async, [acquire]() { const auto lock = acquire(); });
+    }
+
+    static DomainLock acquireSta() { return acquireDomainLock(LockDomain::STA); }
+    static DomainLock acquireNan() { return acquireDomainLock(LockDomain::NAN_IFACE); }
+};
+
+TEST_F(HidlSyncUtilTest, DifferentDomainsDoNotBlockEachOther) {
+    const auto lock = acquireDomainLock(LockDomain::STA);
+    auto other = acquireAsync(&HidlSyncUtilTest::acquireNan);
+    EXPECT_EQ(std::future_status::ready, other.wait_for(kUnblockedTimeout));
+}
+
+TEST_F(HidlSyncUtilTest, SameDomainIsSerialized) {
+    auto lock = std::make_unique<DomainLock>(acquireDomainLock(LockDomain::STA));
+    auto other = acquireAsync(&HidlSyncUtilTest::acquireSta);
+    EXPECT_EQ(std::future_status::timeout, other.wait_for(kBlockedTimeout));
+    lock.reset();
+    EXPECT_EQ(std::future_status::ready, other.wait_for(kUnblockedTimeout));
+}
+
+TEST_F(HidlSyncUtilTest, GlobalLockExcludesAllDomains) {
+    auto lock = acquireGlobalLock();
+    auto sta = acquireAsync(&HidlSyncUtilTest::acquireSta);
+    auto nan = acquireAsync(&HidlSyncUtilTest::acquireNan);
+    EXPECT_EQ(std::future_status::timeout, sta.wait_for(kBlockedTimeout));
+    EXPECT_EQ(std::future_status::timeout, nan.wait_for(kBlockedTimeout));
+    lock.unlock();
+    EXPECT_EQ(std::future_status::ready, sta.wait_for(kUnblockedTimeout));
+    EXPECT_EQ(std::future_status::ready, nan.wait_for(kUnblockedTimeout));
+}
+
+TEST_F(HidlSyncUtilTest, DomainLockBlocksGlobalLock) {
+    auto lock = std::make_unique<DomainLock>(acquireDomainLock(LockDomain::RTT));
+    auto global = acquireAsync(&acquireGlobalLock);
+    EXPECT_EQ(std::future_status::timeout, global.wait_for(kBlockedTimeout));
+    lock.reset();
+    EXPECT_EQ(std::future_status::ready, global.wait_for(kUnblockedTimeout));
+}
+
+TEST_F(HidlSyncUtilTest, LocksAreRecursive) {
+    {
+        const auto global = acquireGlobalLock();
+        const auto global_again = acquireGlobalLock();
+        const auto domain = acquireDomainLock(LockDomain::NAN_IFACE);
+        const auto domain_again = acquireDomainLock(LockDomain::NAN_IFACE);
+        const auto other_domain = acquireDomainLock(LockDomain::RTT);
+    }
+    {
+        const auto domain = acquireDomainLock(LockDomain::STA);
+        const auto nested = acquireDomainLock(LockDomain::NAN_IFACE);
+        const auto domain_again = acquireDomainLock(LockDomain::STA);
+    }
+    // Everything must have been released.
+    auto global = acquireAsync(&acquireGlobalLock);
+    EXPECT_EQ(std::future_status::ready, global.wait_for(kUnblockedTimeout));
+}
+
+TEST_F(HidlSyncUtilTest, StressDomainsAndGlobalLock) {
+    constexpr LockDomain kDomains[] = {LockDomain::STA, LockDomain::AP, LockDomain::NAN_IFACE,
+                                       LockDomain::RTT};
+    constexpr size_t kNumDomains = sizeof(kDomains) / sizeof(kDomains[0]);
+    // Only modified while holding the corresponding domain lock.
+    int counters[kNumDomains] = {};
+    std::atomic<int> in_domain{0};
+    std::atomic<bool> exclusion_violated{false};
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < kNumDomains; i++) {
+        // Two threads per domain.
+        for (int t = 0; t < 2; t++) {
+            threads.emplace_back([&, i]() {
+                for (int n = 0; n < kStressIterations; n++) {
+                    const auto lock = acquireDomainLock(kDomains[i]);
+                    in_domain++;
+                    counters[i]++;
+                    in_domain--;
+                }
+            });
+        }
+    }
+    threads.emplace_back([&]() {
+        for (int n = 0; n < kStressIterations / 10; n++) {
+            const auto lock = acquireGlobalLock();
+            if (in_domain != 0) exclusion_violated = true;
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(exclusion_violated);
+    for (size_t i = 0; i < kNumDomains; i++) {
+        EXPECT_EQ(2 * kStressIterations, counters[i]);
+    }
+}
+
+TEST_F(HidlSyncUtilTest, CallbackSlotSetInvokeReset) {
+    CallbackSlot<void(int)> slot;
+    EXPECT_FALSE(slot);
+    slot(1);  // No-op.
+
+    int value = 0;
+    slot = [&value](int v) { value = v; };
+    EXPECT_TRUE(slot);
+    slot(5);
+    EXPECT_EQ(5, value);
+
+    slot = nullptr;
+    EXPECT_FALSE(slot);
+    slot(7);
+    EXPECT_EQ(5, value);
+
+    slot = std::function<void(int)>();
+    EXPECT_FALSE(slot);
+}
+
+TEST_F(HidlSyncUtilTest, CallbackSlotResetWhileInvoking) {
+    CallbackSlot<void()> slot;
+    auto state = std::make_shared<int>(0);
+    slot = [&slot, state]() {
+        slot = nullptr;
+        // The captured state must still be alive.
+        (*state)++;
+    };
+    slot();
+    EXPECT_FALSE(slot);
+    EXPECT_EQ(1, *state);
+    EXPECT_EQ(1, state.use_count());
+}
+
+TEST_F(HidlSyncUtilTest, StressCallbackSlotReplaceWhileInvoking) {
+    CallbackSlot<void(int*)> slot;
+    std::atomic<bool> done{false};
+    std::thread invoker([&]() {
+        int calls = 0;
+        while (!done) {
+            slot(&calls);
+        }
+    });
+    for (int n = 0; n < kStressIterations; n++) {
+        auto increment = std::make_shared<int>(1);
+        slot = [increment](int* calls) { *calls += *increment; };
+        if (n % 3 == 0) slot = nullptr;
+    }
+    done = true;
+    invoker.join();
+}
+
+}  // namespace hidl_sync_util
+}  // namespace implementation
+}  // namespace V1_6
+}  // namespace wifi
+}  // namespace hardware
+}  // namespace android
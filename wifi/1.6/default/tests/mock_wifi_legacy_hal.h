@@ -35,7 +35,7 @@ class MockWifiLegacyHal : public WifiLegacyHal {
     MOCK_METHOD0(initialize, wifi_error());
     MOCK_METHOD0(start, wifi_error());
     MOCK_METHOD2(stop,
-                 wifi_error(std::unique_lock<std::recursive_mutex>*, const std::function<void()>&));
+                 wifi_error(hidl_sync_util::GlobalLock*, const std::function<void()>&));
     MOCK_METHOD2(setDfsFlag, wifi_error(const std::string&, bool));
     MOCK_METHOD2(registerRadioModeChangeCallbackHandler,
                  wifi_error(const std::string&, const on_radio_mode_change_callback&));
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <android-base/file.h>
 #include <gmock/gmock.h>
 
 #include "ringbuffer.h"
@@ -34,7 +35,7 @@ class RingbufferTest : public Test {
 };
 
 TEST_F(RingbufferTest, CreateEmptyBuffer) {
-    ASSERT_TRUE(buffer_.getData().empty());
+    ASSERT_TRUE(buffer_.getRecords().empty());
 }
 
 TEST_F(RingbufferTest, CanUseFullBufferCapacity) {
@@ -42,9 +43,9 @@ TEST_F(RingbufferTest, CanUseFullBufferCapacity) {
     const std::vector<uint8_t> input2(maxBufferSize_ / 2, '1');
     buffer_.append(input);
     buffer_.append(input2);
-    ASSERT_EQ(2u, buffer_.getData().size());
-    EXPECT_EQ(input, buffer_.getData().front());
-    EXPECT_EQ(input2, buffer_.getData().back());
+    ASSERT_EQ(2u, buffer_.getRecords().size());
+    EXPECT_EQ(input, buffer_.getRecords().front());
+    EXPECT_EQ(input2, buffer_.getRecords().back());
 }
 
 TEST_F(RingbufferTest, OldDataIsRemovedOnOverflow) {
@@ -54,9 +55,9 @@ TEST_F(RingbufferTest, OldDataIsRemovedOnOverflow) {
     buffer_.append(input);
     buffer_.append(input2);
     buffer_.append(input3);
-    ASSERT_EQ(2u, buffer_.getData().size());
-    EXPECT_EQ(input2, buffer_.getData().front());
-    EXPECT_EQ(input3, buffer_.getData().back());
+    ASSERT_EQ(2u, buffer_.getRecords().size());
+    EXPECT_EQ(input2, buffer_.getRecords().front());
+    EXPECT_EQ(input3, buffer_.getRecords().back());
 }
 
 TEST_F(RingbufferTest, MultipleOldDataIsRemovedOnOverflow) {
@@ -66,20 +67,20 @@ TEST_F(RingbufferTest, MultipleOldDataIsRemovedOnOverflow) {
     buffer_.append(input);
     buffer_.append(input2);
     buffer_.append(input3);
-    ASSERT_EQ(1u, buffer_.getData().size());
-    EXPECT_EQ(input3, buffer_.getData().front());
+    ASSERT_EQ(1u, buffer_.getRecords().size());
+    EXPECT_EQ(input3, buffer_.getRecords().front());
 }
 
 TEST_F(RingbufferTest, AppendingEmptyBufferDoesNotAddGarbage) {
     const std::vector<uint8_t> input = {};
     buffer_.append(input);
-    ASSERT_TRUE(buffer_.getData().empty());
+    ASSERT_TRUE(buffer_.getRecords().empty());
 }
 
 TEST_F(RingbufferTest, OversizedAppendIsDropped) {
     const std::vector<uint8_t> input(maxBufferSize_ + 1, '0');
     buffer_.append(input);
-    ASSERT_TRUE(buffer_.getData().empty());
+    ASSERT_TRUE(buffer_.getRecords().empty());
 }
 
 TEST_F(RingbufferTest, OversizedAppendDoesNotDropExistingData) {
@@ -87,8 +88,94 @@ TEST_F(RingbufferTest, OversizedAppendDoesNotDropExistingData) {
     const std::vector<uint8_t> input2(maxBufferSize_ + 1, '1');
     buffer_.append(input);
     buffer_.append(input2);
-    ASSERT_EQ(1u, buffer_.getData().size());
-    EXPECT_EQ(input, buffer_.getData().front());
+    ASSERT_EQ(1u, buffer_.getRecords().size());
+    EXPECT_EQ(input, buffer_.getRecords().front());
+}
+
+TEST_F(RingbufferTest, RecordsWrapAroundBufferEnd) {
+    const std::vector<uint8_t> input = {'0', '1', '2', '3'};
+    const std::vector<uint8_t> input2 = {'4', '5', '6', '7'};
+    const std::vector<uint8_t> input3 = {'8', '9', 'A', 'B', 'C'};
+    buffer_.append(input);
+    buffer_.append(input2);
+    buffer_.append(input3);
+    ASSERT_EQ(2u, buffer_.getNumRecords());
+    EXPECT_EQ(input2, buffer_.getRecords().front());
+    EXPECT_EQ(input3, buffer_.getRecords().back());
+}
+
+TEST_F(RingbufferTest, ManySmallRecordsAreKept) {
+    for (uint8_t i = 0; i < 3 * maxBufferSize_; i++) {
+        buffer_.append({i});
+    }
+    const auto records = buffer_.getRecords();
+    ASSERT_EQ(maxBufferSize_, records.size());
+    for (uint8_t i = 0; i < maxBufferSize_; i++) {
+        EXPECT_EQ(std::vector<uint8_t>{uint8_t(2 * maxBufferSize_ + i)}, records[i]);
+    }
+}
+
+TEST_F(RingbufferTest, WriteToConcatenatesRecords) {
+    buffer_.append({'a', 'b', 'c', 'd'});
+    buffer_.append({'e', 'f', 'g', 'h'});
+    buffer_.append({'i', 'j', 'k', 'l', 'm'});
+
+    TemporaryFile file;
+    ASSERT_TRUE(buffer_.writeTo(file.fd));
+    std::string contents;
+    ASSERT_TRUE(android::base::ReadFileToString(file.path, &contents));
+    EXPECT_EQ("efghijklm", contents);
+}
+
+TEST_F(RingbufferTest, SwapDetachesData) {
+    const std::vector<uint8_t> input = {'0', '1'};
+    buffer_.append(input);
+
+    Ringbuffer snapshot(maxBufferSize_);
+    snapshot.swap(buffer_);
+    EXPECT_TRUE(buffer_.empty());
+    ASSERT_EQ(1u, snapshot.getNumRecords());
+    EXPECT_EQ(input, snapshot.getRecords().front());
+
+    const std::vector<uint8_t> input2 = {'2'};
+    buffer_.append(input2);
+    ASSERT_EQ(1u, buffer_.getNumRecords());
+    EXPECT_EQ(input2, buffer_.getRecords().front());
+}
+
+TEST_F(RingbufferTest, StorageGrowsWithData) {
+    const size_t maxSize = 256 * 1024;
+    Ringbuffer buffer(maxSize);
+    EXPECT_EQ(0u, buffer.getCapacity());
+
+    const std::vector<uint8_t> input(1000, '0');
+    buffer.append(input);
+    EXPECT_GE(buffer.getCapacity(), input.size());
+    EXPECT_LT(buffer.getCapacity(), maxSize);
+
+    // Fill past the limit so records wrap around and the oldest are evicted.
+    for (uint32_t i = 0; i < 2 * maxSize / input.size(); i++) {
+        buffer.append(std::vector<uint8_t>(input.size(), uint8_t(i)));
+    }
+    EXPECT_EQ(maxSize, buffer.getCapacity());
+    const auto records = buffer.getRecords();
+    ASSERT_EQ(maxSize / input.size(), records.size());
+    EXPECT_EQ(std::vector<uint8_t>(input.size(), uint8_t(2 * maxSize / input.size() - 1)),
+              records.back());
+}
+
+TEST_F(RingbufferTest, ClearedSwapKeepsStorage) {
+    buffer_.append({'0', '1'});
+    Ringbuffer spare(maxBufferSize_);
+    spare.swap(buffer_);
+    spare.clear();
+    const size_t capacity = spare.getCapacity();
+
+    buffer_.append({'2'});
+    spare.swap(buffer_);
+    EXPECT_EQ(capacity, buffer_.getCapacity());
+    ASSERT_EQ(1u, spare.getNumRecords());
+    EXPECT_EQ(std::vector<uint8_t>{'2'}, spare.getRecords().front());
 }
 }  // namespace implementation
 }  // namespace V1_6
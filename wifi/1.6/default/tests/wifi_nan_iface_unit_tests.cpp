@@ -19,6 +19,11 @@
 #include <cutils/properties.h>
 #include <gmock/gmock.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+
 #undef NAN  // This is weird, NAN is defined in bionic/libc/include/math.h:38
 #include "wifi_nan_iface.h"
 
@@ -33,6 +38,17 @@ using testing::Test;
 
 namespace {
 constexpr char kIfaceName[] = "mockWlan0";
+constexpr auto kConcurrencyTimeout = std::chrono::seconds(30);
+constexpr int kConcurrencyIterations = 200;
+
+// The callbacks of wifi_legacy_hal.cpp, as handed to the vendor HAL.
+NanCallbackHandler legacy_nan_callback_handlers = {};
+
+wifi_error CaptureLegacyNanCallbackHandlers(wifi_interface_handle /* iface */,
+                                            NanCallbackHandler handlers) {
+    legacy_nan_callback_handlers = handlers;
+    return WIFI_SUCCESS;
+}
 }  // namespace
 
 namespace android {
@@ -131,6 +147,87 @@ TEST_F(WifiNanIfaceTest, IfacEventHandlers_OnStateToggleOffOn) {
     // Trigger the iface state toggle callback.
     captured_iface_event_handlers.on_state_toggle_off_on(kIfaceName);
 }
+
+TEST_F(WifiNanIfaceTest, ConcurrentHidlCallsAndLegacyHalEvents) {
+    // Events go through the real legacy HAL callbacks and iface util, only the
+    // vendor HAL and the kernel are faked.
+    legacy_hal::wifi_hal_fn func_table = {};
+    func_table.wifi_nan_register_handler = CaptureLegacyNanCallbackHandlers;
+    auto hal = std::make_shared<NiceMock<legacy_hal::MockWifiLegacyHal>>(iface_tool_, func_table,
+                                                                         true);
+    const auto register_nan_handlers = [raw_hal = hal.get()](
+                                               const std::string& iface_name,
+                                               const legacy_hal::NanCallbackHandlers& handlers) {
+        return raw_hal->legacy_hal::WifiLegacyHal::nanRegisterCallbackHandlers(iface_name,
+                                                                               handlers);
+    };
+    ON_CALL(*hal, nanRegisterCallbackHandlers(testing::_, testing::_))
+            .WillByDefault(testing::Invoke(register_nan_handlers));
+    ON_CALL(*hal, nanDisableRequest(testing::_, testing::_))
+            .WillByDefault(testing::Return(legacy_hal::WIFI_SUCCESS));
+    ON_CALL(*iface_tool_, SetUpState(testing::_, testing::_)).WillByDefault(testing::Return(true));
+    ON_CALL(*iface_tool_, SetMacAddress(testing::_, testing::_))
+            .WillByDefault(testing::Return(true));
+    auto iface_util = std::make_shared<iface_util::WifiIfaceUtil>(iface_tool_, hal);
+
+    legacy_nan_callback_handlers = {};
+    sp<WifiNanIface> nan_iface = new WifiNanIface(kIfaceName, false, hal, iface_util);
+    ASSERT_NE(nullptr, legacy_nan_callback_handlers.EventDisabled);
+
+    std::atomic<int> num_events_disabled{0};
+    const auto make_event_callback = [&num_events_disabled]() {
+        sp<NiceMock<MockNanIfaceEventCallback>> callback{new NiceMock<MockNanIfaceEventCallback>};
+        ON_CALL(*callback, eventDisabled(testing::_))
+                .WillByDefault(testing::InvokeWithoutArgs([&num_events_disabled]() {
+                    num_events_disabled++;
+                    return Return<void>();
+                }));
+        return callback;
+    };
+    nan_iface->registerEventCallback_1_5(make_event_callback(), [](const WifiStatus& status) {
+        ASSERT_EQ(WifiStatusCode::SUCCESS, status.code);
+    });
+
+    // Events delivered by the legacy HAL event loop.
+    auto legacy_hal_events = std::async(std::launch::async, [&]() {
+        legacy_hal::NanDisabledInd ind = {};
+        for (int n = 0; n < kConcurrencyIterations; n++) {
+            legacy_nan_callback_handlers.EventDisabled(&ind);
+        }
+    });
+    // Iface state toggles caused by a MAC address change on a STA iface,
+    // whose HIDL methods only hold the STA domain lock.
+    auto sta_hidl_calls = std::async(std::launch::async, [&]() {
+        const std::array<uint8_t, 6> mac = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+        for (int n = 0; n < kConcurrencyIterations; n++) {
+            const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::STA);
+            EXPECT_TRUE(iface_util->setMacAddress(kIfaceName, mac));
+        }
+    });
+    // HIDL calls on the NAN iface, including ones which modify the set of
+    // callbacks iterated by the events above.
+    auto nan_hidl_calls = std::async(std::launch::async, [&]() {
+        for (int n = 0; n < kConcurrencyIterations; n++) {
+            nan_iface->registerEventCallback_1_5(
+                    make_event_callback(), [](const WifiStatus& status) {
+                        EXPECT_EQ(WifiStatusCode::SUCCESS, status.code);
+                    });
+            nan_iface->disableRequest(n, [](const WifiStatus& status) {
+                EXPECT_EQ(WifiStatusCode::SUCCESS, status.code);
+            });
+            nan_iface->getName([](const WifiStatus& status, const hidl_string& name) {
+                EXPECT_EQ(WifiStatusCode::SUCCESS, status.code);
+                EXPECT_EQ(kIfaceName, std::string(name));
+            });
+        }
+    });
+
+    ASSERT_EQ(std::future_status::ready, legacy_hal_events.wait_for(kConcurrencyTimeout));
+    ASSERT_EQ(std::future_status::ready, sta_hidl_calls.wait_for(kConcurrencyTimeout));
+    ASSERT_EQ(std::future_status::ready, nan_hidl_calls.wait_for(kConcurrencyTimeout));
+    // Every event reached at least the callback registered up front.
+    EXPECT_LE(2 * kConcurrencyIterations, num_events_disabled);
+}
 }  // namespace implementation
 }  // namespace V1_6
 }  // namespace wifi
@@ -45,6 +45,8 @@ namespace implementation {
  */
 class Wifi : public V1_6::IWifi {
   public:
+    static constexpr hidl_sync_util::LockDomain kLockDomain = hidl_sync_util::LockDomain::CHIP;
+
     Wifi(const std::shared_ptr<wifi_system::InterfaceTool> iface_tool,
          const std::shared_ptr<legacy_hal::WifiLegacyHalFactory> legacy_hal_factory,
          const std::shared_ptr<mode_controller::WifiModeController> mode_controller,
@@ -73,13 +75,13 @@ class Wifi : public V1_6::IWifi {
     WifiStatus registerEventCallbackInternal_1_5(
             const sp<V1_5::IWifiEventCallback>& event_callback);
     WifiStatus startInternal();
-    WifiStatus stopInternal(std::unique_lock<std::recursive_mutex>* lock);
+    WifiStatus stopInternal(hidl_sync_util::GlobalLock* lock);
     std::pair<WifiStatus, std::vector<ChipId>> getChipIdsInternal();
     std::pair<WifiStatus, sp<V1_4::IWifiChip>> getChipInternal(ChipId chip_id);
 
     WifiStatus initializeModeControllerAndLegacyHal();
     WifiStatus stopLegacyHalAndDeinitializeModeController(
-            std::unique_lock<std::recursive_mutex>* lock);
+            hidl_sync_util::GlobalLock* lock);
     ChipId getChipIdFromWifiChip(sp<WifiChip>& chip);
 
     // Instance is created in this root level |IWifi| HIDL interface object
@@ -35,6 +35,8 @@ using namespace android::hardware::wifi::V1_0;
  */
 class WifiApIface : public V1_5::IWifiApIface {
   public:
+    static constexpr hidl_sync_util::LockDomain kLockDomain = hidl_sync_util::LockDomain::AP;
+
     WifiApIface(const std::string& ifname, const std::vector<std::string>& instances,
                 const std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal,
                 const std::weak_ptr<iface_util::WifiIfaceUtil> iface_util);
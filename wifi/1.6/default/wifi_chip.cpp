@@ -864,7 +864,7 @@ WifiChip::getAvailableModesInternal() {
 }
 
 WifiStatus WifiChip::configureChipInternal(
-        /* NONNULL */ std::unique_lock<std::recursive_mutex>* lock, ChipModeId mode_id) {
+        /* NONNULL */ hidl_sync_util::GlobalLock* lock, ChipModeId mode_id) {
     if (!isValidModeId(mode_id)) {
         return createWifiStatus(WifiStatusCode::ERROR_INVALID_ARGS);
     }
@@ -1580,7 +1580,7 @@ WifiChip::getAvailableModesInternal_1_6() {
 }
 
 WifiStatus WifiChip::handleChipConfiguration(
-        /* NONNULL */ std::unique_lock<std::recursive_mutex>* lock, ChipModeId mode_id) {
+        /* NONNULL */ hidl_sync_util::GlobalLock* lock, ChipModeId mode_id) {
     // If the chip is already configured in a different mode, stop
     // the legacy HAL and then start it after firmware mode change.
     if (isValidModeId(current_mode_id_)) {
@@ -1990,37 +1990,42 @@ bool WifiChip::writeRingbufferFilesInternal() {
         LOG(ERROR) << "Error occurred while deleting old tombstone files";
         return false;
     }
-    // write ringbuffers to file
+    std::unique_lock<std::mutex> dump_lk(ringbuffer_dump_lock_);
+    // Swap ringbuffer contents with their spares under the lock, write them to files without
+    // it.
+    std::vector<std::pair<const std::string*, Ringbuffer*>> snapshots;
     {
         std::unique_lock<std::mutex> lk(lock_t);
         for (auto& item : ringbuffer_map_) {
             Ringbuffer& cur_buffer = item.second;
-            if (cur_buffer.getData().empty()) {
+            if (cur_buffer.empty()) {
                 continue;
             }
-            const std::string file_path_raw = kTombstoneFolderPath + item.first + "XXXXXXXXXX";
+            auto spare = ringbuffer_spares_.try_emplace(item.first, kMaxBufferSizeBytes).first;
+            spare->second.swap(cur_buffer);
+            snapshots.emplace_back(&spare->first, &spare->second);
+        }
+        // unique_lock unlocked here
+    }
+    bool success = true;
+    for (const auto& [ring_name, snapshot] : snapshots) {
+        if (success) {
+            const std::string file_path_raw = kTombstoneFolderPath + *ring_name + "XXXXXXXXXX";
             const int dump_fd = mkstemp(makeCharVec(file_path_raw).data());
             if (dump_fd == -1) {
                 PLOG(ERROR) << "create file failed";
-                return false;
-            }
-            unique_fd file_auto_closer(dump_fd);
-            for (const auto& cur_block : cur_buffer.getData()) {
-                if (cur_block.size() <= 0 || cur_block.size() > kMaxBufferSizeBytes) {
-                    PLOG(ERROR) << "Ring buffer: " << item.first
-                                << " is corrupted. Invalid block size: " << cur_block.size();
-                    break;
-                }
-                if (write(dump_fd, cur_block.data(), sizeof(cur_block[0]) * cur_block.size()) ==
-                    -1) {
-                    PLOG(ERROR) << "Error writing to file";
+                success = false;
+            } else {
+                unique_fd file_auto_closer(dump_fd);
+                if (!snapshot->writeTo(dump_fd)) {
+                    LOG(ERROR) << "Error writing ring buffer " << *ring_name << " to file";
                 }
             }
-            cur_buffer.clear();
         }
-        // unique_lock unlocked here
+        // Keep the storage for the next swap.
+        snapshot->clear();
     }
-    return true;
+    return success;
 }
 
 std::string WifiChip::getWlanIfaceNameWithType(IfaceType type, unsigned idx) {
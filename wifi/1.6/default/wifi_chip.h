@@ -57,6 +57,8 @@ using V1_5::WifiBand;
  */
 class WifiChip : public V1_6::IWifiChip {
   public:
+    static constexpr hidl_sync_util::LockDomain kLockDomain = hidl_sync_util::LockDomain::CHIP;
+
     WifiChip(ChipId chip_id, bool is_primary,
              const std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal,
              const std::weak_ptr<mode_controller::WifiModeController> mode_controller,
@@ -182,7 +184,7 @@ class WifiChip : public V1_6::IWifiChip {
             const sp<V1_0::IWifiChipEventCallback>& event_callback);
     std::pair<WifiStatus, uint32_t> getCapabilitiesInternal();
     std::pair<WifiStatus, std::vector<V1_0::IWifiChip::ChipMode>> getAvailableModesInternal();
-    WifiStatus configureChipInternal(std::unique_lock<std::recursive_mutex>* lock,
+    WifiStatus configureChipInternal(hidl_sync_util::GlobalLock* lock,
                                      ChipModeId mode_id);
     std::pair<WifiStatus, uint32_t> getModeInternal();
     std::pair<WifiStatus, IWifiChip::ChipDebugInfo> requestChipDebugInfoInternal();
@@ -241,7 +243,7 @@ class WifiChip : public V1_6::IWifiChip {
     WifiStatus setCountryCodeInternal(const std::array<int8_t, 2>& code);
     std::pair<WifiStatus, std::vector<V1_5::WifiUsableChannel>> getUsableChannelsInternal(
             WifiBand band, uint32_t ifaceModeMask, uint32_t filterMask);
-    WifiStatus handleChipConfiguration(std::unique_lock<std::recursive_mutex>* lock,
+    WifiStatus handleChipConfiguration(hidl_sync_util::GlobalLock* lock,
                                        ChipModeId mode_id);
     WifiStatus registerDebugRingBufferCallback();
     WifiStatus registerRadioModeChangeCallback();
@@ -292,6 +294,11 @@ class WifiChip : public V1_6::IWifiChip {
     std::vector<sp<WifiStaIface>> sta_ifaces_;
     std::vector<sp<WifiRttController>> rtt_controllers_;
     std::map<std::string, Ringbuffer> ringbuffer_map_;
+    // Emptied storage swapped into each ring when its data is written out,
+    // so dumps don't make the rings allocate again. Guarded by
+    // ringbuffer_dump_lock_.
+    std::map<std::string, Ringbuffer> ringbuffer_spares_;
+    std::mutex ringbuffer_dump_lock_;
     bool is_valid_;
     // Members pertaining to chip configuration.
     uint32_t current_mode_id_;
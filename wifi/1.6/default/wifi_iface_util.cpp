@@ -82,9 +82,12 @@ bool WifiIfaceUtil::setMacAddress(const std::string& iface_name,
     }
 #endif
     IfaceEventHandlers event_handlers = {};
-    const auto it = event_handlers_map_.find(iface_name);
-    if (it != event_handlers_map_.end()) {
-        event_handlers = it->second;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = event_handlers_map_.find(iface_name);
+        if (it != event_handlers_map_.end()) {
+            event_handlers = it->second;
+        }
     }
     if (event_handlers.on_state_toggle_off_on != nullptr) {
         event_handlers.on_state_toggle_off_on(iface_name);
@@ -98,6 +101,7 @@ bool WifiIfaceUtil::setMacAddress(const std::string& iface_name,
 }
 
 std::array<uint8_t, 6> WifiIfaceUtil::getOrCreateRandomMacAddress() {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (random_mac_address_) {
         return *random_mac_address_.get();
     }
@@ -107,10 +111,12 @@ std::array<uint8_t, 6> WifiIfaceUtil::getOrCreateRandomMacAddress() {
 
 void WifiIfaceUtil::registerIfaceEventHandlers(const std::string& iface_name,
                                                IfaceEventHandlers handlers) {
+    std::lock_guard<std::mutex> lock(mutex_);
     event_handlers_map_[iface_name] = handlers;
 }
 
 void WifiIfaceUtil::unregisterIfaceEventHandlers(const std::string& iface_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
     event_handlers_map_.erase(iface_name);
 }
 
@@ -17,6 +17,8 @@
 #ifndef WIFI_IFACE_UTIL_H_
 #define WIFI_IFACE_UTIL_H_
 
+#include <mutex>
+
 #include <wifi_system/interface_tool.h>
 
 #include <android/hardware/wifi/1.0/IWifi.h>
@@ -73,6 +75,8 @@ class WifiIfaceUtil {
   private:
     std::weak_ptr<wifi_system::InterfaceTool> iface_tool_;
     std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal_;
+    // Shared by the ifaces of all lock domains.
+    std::mutex mutex_;
     std::unique_ptr<std::array<uint8_t, 6>> random_mac_address_;
     std::map<std::string, IfaceEventHandlers> event_handlers_map_;
 };
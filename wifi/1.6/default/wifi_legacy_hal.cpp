@@ -61,9 +61,14 @@ namespace legacy_hal {
 // Legacy HAL functions accept "C" style function pointers, so use global
 // functions to pass to the legacy HAL function and store the corresponding
 // std::function methods to be invoked.
+// The asynchronous callbacks are invoked on the event loop thread and only
+// hold the lock of the domain owning the callback (see THREADING.README), so
+// the ones which may be replaced from another domain are kept in a
+// |CallbackSlot|. The synchronous ones are only ever set and invoked from
+// within the same HIDL call.
 //
 // Callback to be invoked once |stop| is complete
-std::function<void(wifi_handle handle)> on_stop_complete_internal_callback;
+hidl_sync_util::CallbackSlot<void(wifi_handle handle)> on_stop_complete_internal_callback;
 void onAsyncStopComplete(wifi_handle handle) {
     const auto lock = hidl_sync_util::acquireGlobalLock();
     if (on_stop_complete_internal_callback) {
@@ -90,20 +95,21 @@ void onSyncFirmwareMemoryDump(char* buffer, int buffer_size) {
 }
 
 // Callback to be invoked for Gscan events.
-std::function<void(wifi_request_id, wifi_scan_event)> on_gscan_event_internal_callback;
+hidl_sync_util::CallbackSlot<void(wifi_request_id, wifi_scan_event)>
+        on_gscan_event_internal_callback;
 void onAsyncGscanEvent(wifi_request_id id, wifi_scan_event event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::STA);
     if (on_gscan_event_internal_callback) {
         on_gscan_event_internal_callback(id, event);
     }
 }
 
 // Callback to be invoked for Gscan full results.
-std::function<void(wifi_request_id, wifi_scan_result*, uint32_t)>
+hidl_sync_util::CallbackSlot<void(wifi_request_id, wifi_scan_result*, uint32_t)>
         on_gscan_full_result_internal_callback;
 void onAsyncGscanFullResult(wifi_request_id id, wifi_scan_result* result,
                             uint32_t buckets_scanned) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::STA);
     if (on_gscan_full_result_internal_callback) {
         on_gscan_full_result_internal_callback(id, result, buckets_scanned);
     }
@@ -120,59 +126,61 @@ void onSyncLinkLayerStatsResult(wifi_request_id id, wifi_iface_stat* iface_stat,
 }
 
 // Callback to be invoked for rssi threshold breach.
-std::function<void((wifi_request_id, uint8_t*, int8_t))>
+hidl_sync_util::CallbackSlot<void((wifi_request_id, uint8_t*, int8_t))>
         on_rssi_threshold_breached_internal_callback;
 void onAsyncRssiThresholdBreached(wifi_request_id id, uint8_t* bssid, int8_t rssi) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::STA);
     if (on_rssi_threshold_breached_internal_callback) {
         on_rssi_threshold_breached_internal_callback(id, bssid, rssi);
     }
 }
 
 // Callback to be invoked for ring buffer data indication.
-std::function<void(char*, char*, int, wifi_ring_buffer_status*)>
+hidl_sync_util::CallbackSlot<void(char*, char*, int, wifi_ring_buffer_status*)>
         on_ring_buffer_data_internal_callback;
 void onAsyncRingBufferData(char* ring_name, char* buffer, int buffer_size,
                            wifi_ring_buffer_status* status) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::CHIP);
     if (on_ring_buffer_data_internal_callback) {
         on_ring_buffer_data_internal_callback(ring_name, buffer, buffer_size, status);
     }
 }
 
 // Callback to be invoked for error alert indication.
-std::function<void(wifi_request_id, char*, int, int)> on_error_alert_internal_callback;
+hidl_sync_util::CallbackSlot<void(wifi_request_id, char*, int, int)>
+        on_error_alert_internal_callback;
 void onAsyncErrorAlert(wifi_request_id id, char* buffer, int buffer_size, int err_code) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::CHIP);
     if (on_error_alert_internal_callback) {
         on_error_alert_internal_callback(id, buffer, buffer_size, err_code);
     }
 }
 
 // Callback to be invoked for radio mode change indication.
-std::function<void(wifi_request_id, uint32_t, wifi_mac_info*)>
+hidl_sync_util::CallbackSlot<void(wifi_request_id, uint32_t, wifi_mac_info*)>
         on_radio_mode_change_internal_callback;
 void onAsyncRadioModeChange(wifi_request_id id, uint32_t num_macs, wifi_mac_info* mac_infos) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::CHIP);
     if (on_radio_mode_change_internal_callback) {
         on_radio_mode_change_internal_callback(id, num_macs, mac_infos);
     }
 }
 
 // Callback to be invoked to report subsystem restart
-std::function<void(const char*)> on_subsystem_restart_internal_callback;
+hidl_sync_util::CallbackSlot<void(const char*)> on_subsystem_restart_internal_callback;
 void onAsyncSubsystemRestart(const char* error) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::CHIP);
     if (on_subsystem_restart_internal_callback) {
         on_subsystem_restart_internal_callback(error);
     }
 }
 
 // Callback to be invoked for rtt results results.
-std::function<void(wifi_request_id, unsigned num_results, wifi_rtt_result* rtt_results[])>
+hidl_sync_util::CallbackSlot<void(wifi_request_id, unsigned num_results,
+                                  wifi_rtt_result* rtt_results[])>
         on_rtt_results_internal_callback;
 void onAsyncRttResults(wifi_request_id id, unsigned num_results, wifi_rtt_result* rtt_results[]) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::RTT);
     if (on_rtt_results_internal_callback) {
         on_rtt_results_internal_callback(id, num_results, rtt_results);
         on_rtt_results_internal_callback = nullptr;
@@ -183,184 +191,199 @@ void onAsyncRttResults(wifi_request_id id, unsigned num_results, wifi_rtt_result
 // NOTE: These have very little conversions to perform before invoking the user
 // callbacks.
 // So, handle all of them here directly to avoid adding an unnecessary layer.
-std::function<void(transaction_id, const NanResponseMsg&)> on_nan_notify_response_user_callback;
+hidl_sync_util::CallbackSlot<void(transaction_id, const NanResponseMsg&)>
+        on_nan_notify_response_user_callback;
 void onAysncNanNotifyResponse(transaction_id id, NanResponseMsg* msg) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_notify_response_user_callback && msg) {
         on_nan_notify_response_user_callback(id, *msg);
     }
 }
 
-std::function<void(const NanPublishRepliedInd&)> on_nan_event_publish_replied_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanPublishRepliedInd&)>
+        on_nan_event_publish_replied_user_callback;
 void onAysncNanEventPublishReplied(NanPublishRepliedInd* /* event */) {
     LOG(ERROR) << "onAysncNanEventPublishReplied triggered";
 }
 
-std::function<void(const NanPublishTerminatedInd&)> on_nan_event_publish_terminated_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanPublishTerminatedInd&)>
+        on_nan_event_publish_terminated_user_callback;
 void onAysncNanEventPublishTerminated(NanPublishTerminatedInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_publish_terminated_user_callback && event) {
         on_nan_event_publish_terminated_user_callback(*event);
     }
 }
 
-std::function<void(const NanMatchInd&)> on_nan_event_match_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanMatchInd&)> on_nan_event_match_user_callback;
 void onAysncNanEventMatch(NanMatchInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_match_user_callback && event) {
         on_nan_event_match_user_callback(*event);
     }
 }
 
-std::function<void(const NanMatchExpiredInd&)> on_nan_event_match_expired_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanMatchExpiredInd&)>
+        on_nan_event_match_expired_user_callback;
 void onAysncNanEventMatchExpired(NanMatchExpiredInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_match_expired_user_callback && event) {
         on_nan_event_match_expired_user_callback(*event);
     }
 }
 
-std::function<void(const NanSubscribeTerminatedInd&)>
+hidl_sync_util::CallbackSlot<void(const NanSubscribeTerminatedInd&)>
         on_nan_event_subscribe_terminated_user_callback;
 void onAysncNanEventSubscribeTerminated(NanSubscribeTerminatedInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_subscribe_terminated_user_callback && event) {
         on_nan_event_subscribe_terminated_user_callback(*event);
     }
 }
 
-std::function<void(const NanFollowupInd&)> on_nan_event_followup_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanFollowupInd&)> on_nan_event_followup_user_callback;
 void onAysncNanEventFollowup(NanFollowupInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_followup_user_callback && event) {
         on_nan_event_followup_user_callback(*event);
     }
 }
 
-std::function<void(const NanDiscEngEventInd&)> on_nan_event_disc_eng_event_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanDiscEngEventInd&)>
+        on_nan_event_disc_eng_event_user_callback;
 void onAysncNanEventDiscEngEvent(NanDiscEngEventInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_disc_eng_event_user_callback && event) {
         on_nan_event_disc_eng_event_user_callback(*event);
     }
 }
 
-std::function<void(const NanDisabledInd&)> on_nan_event_disabled_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanDisabledInd&)> on_nan_event_disabled_user_callback;
 void onAysncNanEventDisabled(NanDisabledInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_disabled_user_callback && event) {
         on_nan_event_disabled_user_callback(*event);
     }
 }
 
-std::function<void(const NanTCAInd&)> on_nan_event_tca_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanTCAInd&)> on_nan_event_tca_user_callback;
 void onAysncNanEventTca(NanTCAInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_tca_user_callback && event) {
         on_nan_event_tca_user_callback(*event);
     }
 }
 
-std::function<void(const NanBeaconSdfPayloadInd&)> on_nan_event_beacon_sdf_payload_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanBeaconSdfPayloadInd&)>
+        on_nan_event_beacon_sdf_payload_user_callback;
 void onAysncNanEventBeaconSdfPayload(NanBeaconSdfPayloadInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_beacon_sdf_payload_user_callback && event) {
         on_nan_event_beacon_sdf_payload_user_callback(*event);
     }
 }
 
-std::function<void(const NanDataPathRequestInd&)> on_nan_event_data_path_request_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanDataPathRequestInd&)>
+        on_nan_event_data_path_request_user_callback;
 void onAysncNanEventDataPathRequest(NanDataPathRequestInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_data_path_request_user_callback && event) {
         on_nan_event_data_path_request_user_callback(*event);
     }
 }
-std::function<void(const NanDataPathConfirmInd&)> on_nan_event_data_path_confirm_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanDataPathConfirmInd&)>
+        on_nan_event_data_path_confirm_user_callback;
 void onAysncNanEventDataPathConfirm(NanDataPathConfirmInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_data_path_confirm_user_callback && event) {
         on_nan_event_data_path_confirm_user_callback(*event);
     }
 }
 
-std::function<void(const NanDataPathEndInd&)> on_nan_event_data_path_end_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanDataPathEndInd&)>
+        on_nan_event_data_path_end_user_callback;
 void onAysncNanEventDataPathEnd(NanDataPathEndInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_data_path_end_user_callback && event) {
         on_nan_event_data_path_end_user_callback(*event);
     }
 }
 
-std::function<void(const NanTransmitFollowupInd&)> on_nan_event_transmit_follow_up_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanTransmitFollowupInd&)>
+        on_nan_event_transmit_follow_up_user_callback;
 void onAysncNanEventTransmitFollowUp(NanTransmitFollowupInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_transmit_follow_up_user_callback && event) {
         on_nan_event_transmit_follow_up_user_callback(*event);
     }
 }
 
-std::function<void(const NanRangeRequestInd&)> on_nan_event_range_request_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanRangeRequestInd&)>
+        on_nan_event_range_request_user_callback;
 void onAysncNanEventRangeRequest(NanRangeRequestInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_range_request_user_callback && event) {
         on_nan_event_range_request_user_callback(*event);
     }
 }
 
-std::function<void(const NanRangeReportInd&)> on_nan_event_range_report_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanRangeReportInd&)>
+        on_nan_event_range_report_user_callback;
 void onAysncNanEventRangeReport(NanRangeReportInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_range_report_user_callback && event) {
         on_nan_event_range_report_user_callback(*event);
     }
 }
 
-std::function<void(const NanDataPathScheduleUpdateInd&)> on_nan_event_schedule_update_user_callback;
+hidl_sync_util::CallbackSlot<void(const NanDataPathScheduleUpdateInd&)>
+        on_nan_event_schedule_update_user_callback;
 void onAsyncNanEventScheduleUpdate(NanDataPathScheduleUpdateInd* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
     if (on_nan_event_schedule_update_user_callback && event) {
         on_nan_event_schedule_update_user_callback(*event);
     }
 }
 
 // Callbacks for the various TWT operations.
-std::function<void(const TwtSetupResponse&)> on_twt_event_setup_response_callback;
+hidl_sync_util::CallbackSlot<void(const TwtSetupResponse&)> on_twt_event_setup_response_callback;
 void onAsyncTwtEventSetupResponse(TwtSetupResponse* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::STA);
     if (on_twt_event_setup_response_callback && event) {
         on_twt_event_setup_response_callback(*event);
     }
 }
 
-std::function<void(const TwtTeardownCompletion&)> on_twt_event_teardown_completion_callback;
+hidl_sync_util::CallbackSlot<void(const TwtTeardownCompletion&)>
+        on_twt_event_teardown_completion_callback;
 void onAsyncTwtEventTeardownCompletion(TwtTeardownCompletion* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::STA);
     if (on_twt_event_teardown_completion_callback && event) {
         on_twt_event_teardown_completion_callback(*event);
     }
 }
 
-std::function<void(const TwtInfoFrameReceived&)> on_twt_event_info_frame_received_callback;
+hidl_sync_util::CallbackSlot<void(const TwtInfoFrameReceived&)>
+        on_twt_event_info_frame_received_callback;
 void onAsyncTwtEventInfoFrameReceived(TwtInfoFrameReceived* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::STA);
     if (on_twt_event_info_frame_received_callback && event) {
         on_twt_event_info_frame_received_callback(*event);
     }
 }
 
-std::function<void(const TwtDeviceNotify&)> on_twt_event_device_notify_callback;
+hidl_sync_util::CallbackSlot<void(const TwtDeviceNotify&)> on_twt_event_device_notify_callback;
 void onAsyncTwtEventDeviceNotify(TwtDeviceNotify* event) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::STA);
     if (on_twt_event_device_notify_callback && event) {
         on_twt_event_device_notify_callback(*event);
     }
 }
 
 // Callback to report current CHRE NAN state
-std::function<void(chre_nan_rtt_state)> on_chre_nan_rtt_internal_callback;
+hidl_sync_util::CallbackSlot<void(chre_nan_rtt_state)> on_chre_nan_rtt_internal_callback;
 void onAsyncChreNanRttState(chre_nan_rtt_state state) {
-    const auto lock = hidl_sync_util::acquireGlobalLock();
+    const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::CHIP);
     if (on_chre_nan_rtt_internal_callback) {
         on_chre_nan_rtt_internal_callback(state);
     }
@@ -426,7 +449,7 @@ wifi_error WifiLegacyHal::start() {
 }
 
 wifi_error WifiLegacyHal::stop(
-        /* NONNULL */ std::unique_lock<std::recursive_mutex>* lock,
+        /* NONNULL */ hidl_sync_util::GlobalLock* lock,
         const std::function<void()>& on_stop_complete_user_callback) {
     if (!is_started_) {
         LOG(DEBUG) << "Legacy HAL already stopped";
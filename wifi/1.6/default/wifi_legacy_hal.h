@@ -26,6 +26,8 @@
 #include <hardware_legacy/wifi_hal.h>
 #include <wifi_system/interface_tool.h>
 
+#include "hidl_sync_util.h"
+
 namespace android {
 namespace hardware {
 namespace wifi {
@@ -484,7 +486,7 @@ class WifiLegacyHal {
     virtual wifi_error start();
     // Deinitialize the legacy HAL and wait for the event loop thread to exit
     // using a predefined timeout.
-    virtual wifi_error stop(std::unique_lock<std::recursive_mutex>* lock,
+    virtual wifi_error stop(hidl_sync_util::GlobalLock* lock,
                             const std::function<void()>& on_complete_callback);
     virtual wifi_error waitForDriverReady();
     // Checks if legacy HAL has successfully started
@@ -454,6 +454,9 @@ WifiNanIface::WifiNanIface(const std::string& ifname, bool is_dedicated_iface,
     // Register for iface state toggle events.
     iface_util::IfaceEventHandlers event_handlers = {};
     event_handlers.on_state_toggle_off_on = [weak_ptr_this](const std::string& /* iface_name */) {
+        // Invoked from the HIDL method of another iface, which only holds its
+        // own domain's lock.
+        const auto lock = hidl_sync_util::acquireDomainLock(hidl_sync_util::LockDomain::NAN_IFACE);
         const auto shared_ptr_this = weak_ptr_this.promote();
         if (!shared_ptr_this.get() || !shared_ptr_this->isValid()) {
             LOG(ERROR) << "Callback invoked on an invalid object";
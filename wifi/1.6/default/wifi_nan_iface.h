@@ -40,6 +40,8 @@ using namespace android::hardware::wifi::V1_6;
  */
 class WifiNanIface : public V1_6::IWifiNanIface {
   public:
+    static constexpr hidl_sync_util::LockDomain kLockDomain = hidl_sync_util::LockDomain::NAN_IFACE;
+
     WifiNanIface(const std::string& ifname, bool is_dedicated_iface,
                  const std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal,
                  const std::weak_ptr<iface_util::WifiIfaceUtil> iface_util);
@@ -34,6 +34,8 @@ using namespace android::hardware::wifi::V1_0;
  */
 class WifiP2pIface : public V1_0::IWifiP2pIface {
   public:
+    static constexpr hidl_sync_util::LockDomain kLockDomain = hidl_sync_util::LockDomain::P2P;
+
     WifiP2pIface(const std::string& ifname,
                  const std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal);
     // Refer to |WifiChip::invalidate()|.
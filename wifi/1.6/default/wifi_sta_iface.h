@@ -37,6 +37,8 @@ using namespace android::hardware::wifi::V1_0;
  */
 class WifiStaIface : public V1_6::IWifiStaIface {
   public:
+    static constexpr hidl_sync_util::LockDomain kLockDomain = hidl_sync_util::LockDomain::STA;
+
     WifiStaIface(const std::string& ifname,
                  const std::weak_ptr<legacy_hal::WifiLegacyHal> legacy_hal,
                  const std::weak_ptr<iface_util::WifiIfaceUtil> iface_util);